@@ -38,7 +38,9 @@ struct CmdOptions {
         ScoreTransposeOptions,
         ForceMode,
         SoundProfile,
-        ExtensionUri
+        ExtensionUri,
+        JobsCount,
+        JobWorkerArguments
 
         // Video
     };
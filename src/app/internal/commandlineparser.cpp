@@ -22,6 +22,7 @@
 #include "commandlineparser.h"
 
 #include <QDir>
+#include <QSet>
 
 #include "global/io/dir.h"
 #include "global/internal/baseapplication.h"
@@ -86,6 +87,7 @@ void CommandLineParser::init()
     m_parser.addOption(QCommandLineOption({ "o", "export-to" }, "Export to 'file'. Format depends on file's extension", "file"));
     m_parser.addOption(QCommandLineOption({ "j", "job" }, "Process a conversion job", "file"));
     m_parser.addOption(QCommandLineOption("extension", "Use extension to process a conversion job", "uri"));
+    m_parser.addOption(QCommandLineOption("jobs", "Use with '-j <file>', process up to N conversion jobs in parallel", "N"));
 
     m_parser.addOption(QCommandLineOption({ "F", "factory-settings" }, "Use factory settings"));
     m_parser.addOption(QCommandLineOption({ "R", "revert-settings" }, "Revert to factory settings, but keep default preferences"));
@@ -309,6 +311,16 @@ void CommandLineParser::parse(int argc, char** argv)
         m_options.converterTask.inputFile = fromUserInputPath(m_parser.value("j"));
     }
 
+    if (m_parser.isSet("jobs")) {
+        std::optional<int> val = intValue("jobs");
+        if (val && val.value() > 0) {
+            m_options.converterTask.params[CmdOptions::ParamKey::JobsCount] = val.value();
+            m_options.converterTask.params[CmdOptions::ParamKey::JobWorkerArguments] = jobWorkerArguments();
+        } else {
+            LOGE() << "Option: --jobs not recognized jobs count: " << m_parser.value("jobs");
+        }
+    }
+
     if (m_parser.isSet("score-media")) {
         m_options.runMode = IApplication::RunMode::ConsoleApp;
         m_options.converterTask.type = ConvertType::ExportScoreMedia;
@@ -503,6 +515,33 @@ void CommandLineParser::parse(int argc, char** argv)
     }
 }
 
+//! NOTE The options given to this process, without the job file and the jobs count,
+//! for the processes that convert the jobs of a batch in parallel
+QStringList CommandLineParser::jobWorkerArguments() const
+{
+    static const QStringList EXCLUDED_OPTIONS = { "j", "job", "jobs" };
+
+    QStringList args;
+    QSet<QString> addedOptions;
+
+    for (const QString& name : m_parser.optionNames()) {
+        if (EXCLUDED_OPTIONS.contains(name) || addedOptions.contains(name)) {
+            continue;
+        }
+
+        addedOptions.insert(name);
+        args << (name.size() == 1 ? QString("-") : QString("--")) + name;
+
+        //! NOTE Only the options that take a value have values, the last one is in effect
+        const QStringList values = m_parser.values(name);
+        if (!values.isEmpty()) {
+            args << values.last();
+        }
+    }
+
+    return args;
+}
+
 void CommandLineParser::processBuiltinArgs(const QCoreApplication& app)
 {
     //! NOTE: some options require an instance of QCoreApplication
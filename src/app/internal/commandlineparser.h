@@ -54,6 +54,7 @@ public:
 
 private:
     void printLongVersion() const;
+    QStringList jobWorkerArguments() const;
 
     QCommandLineParser m_parser;
     CmdOptions m_options;
@@ -276,9 +276,12 @@ int ConsoleApp::processConverter(const CmdOptions::ConverterTask& task)
     }
 
     switch (task.type) {
-    case ConvertType::Batch:
-        ret = converter()->batchConvert(task.inputFile, stylePath, forceMode, soundProfile, extensionUri);
-        break;
+    case ConvertType::Batch: {
+        size_t jobsCount = static_cast<size_t>(task.params.value(CmdOptions::ParamKey::JobsCount, 1).toInt());
+        StringList jobWorkerArgs = task.params.value(CmdOptions::ParamKey::JobWorkerArguments).toStringList();
+        ret = converter()->batchConvert(task.inputFile, stylePath, forceMode, soundProfile, extensionUri, nullptr, jobsCount,
+                                        jobWorkerArgs);
+    } break;
     case ConvertType::File:
         ret = converter()->fileConvert(task.inputFile, task.outputFile, stylePath, forceMode, soundProfile, extensionUri);
         break;
@@ -25,6 +25,7 @@
 #include "modularity/imoduleinterface.h"
 #include "global/types/ret.h"
 #include "global/types/uri.h"
+#include "global/types/string.h"
 #include "global/io/path.h"
 #include "global/progress.h"
 
@@ -43,7 +44,8 @@ public:
     virtual muse::Ret batchConvert(const muse::io::path_t& batchJobFile,
                                    const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false,
                                    const muse::String& soundProfile = muse::String(),
-                                   const muse::UriQuery& extensionUri = muse::UriQuery(), muse::ProgressPtr progress = nullptr) = 0;
+                                   const muse::UriQuery& extensionUri = muse::UriQuery(), muse::ProgressPtr progress = nullptr,
+                                   size_t jobsCount = 1, const muse::StringList& jobWorkerArgs = {}) = 0;
 
     virtual muse::Ret convertScoreParts(const muse::io::path_t& in, const muse::io::path_t& out,
                                         const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false) = 0;
@@ -21,10 +21,15 @@
  */
 #include "convertercontroller.h"
 
+#include <cstdio>
+
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QJsonParseError>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QProcess>
 
 #include "global/io/file.h"
 #include "global/io/dir.h"
@@ -46,7 +51,8 @@ static const std::string PNG_SUFFIX = "png";
 static const std::string SVG_SUFFIX = "svg";
 
 Ret ConverterController::batchConvert(const muse::io::path_t& batchJobFile, const muse::io::path_t& stylePath, bool forceMode,
-                                      const String& soundProfile, const muse::UriQuery& extensionUri, muse::ProgressPtr progress)
+                                      const String& soundProfile, const muse::UriQuery& extensionUri, muse::ProgressPtr progress,
+                                      size_t jobsCount, const muse::StringList& jobWorkerArgs)
 {
     TRACEFUNC;
 
@@ -65,9 +71,33 @@ Ret ConverterController::batchConvert(const muse::io::path_t& batchJobFile, cons
 
     StringList errors;
 
+    if (jobsCount > 1 && batchJob.val.size() > 1) {
+        runBatchJobsInParallel(batchJob.val, progress, jobsCount, jobWorkerArgs, errors);
+    } else {
+        runBatchJobsSequentially(batchJob.val, stylePath, forceMode, soundProfile, extensionUri, progress, errors);
+    }
+
+    Ret ret;
+    if (!errors.empty()) {
+        ret = make_ret(Err::ConvertFailed, errors.join(u"\n").toStdString());
+    } else {
+        ret = make_ret(Ret::Code::Ok);
+    }
+
+    if (progress) {
+        progress->finished.send(ProgressResult(ret));
+    }
+
+    return ret;
+}
+
+void ConverterController::runBatchJobsSequentially(const BatchJob& batchJob, const muse::io::path_t& stylePath, bool forceMode,
+                                                   const String& soundProfile, const muse::UriQuery& extensionUri,
+                                                   muse::ProgressPtr progress, StringList& errors)
+{
     int64_t current = 0;
-    int64_t total = batchJob.val.size();
-    for (const Job& job : batchJob.val) {
+    int64_t total = batchJob.size();
+    for (const Job& job : batchJob) {
         if (progress) {
             ++current;
             progress->progressChanged.send(current, total, job.in.toStdString());
@@ -79,19 +109,97 @@ Ret ConverterController::batchConvert(const muse::io::path_t& batchJobFile, cons
                                 .arg(String::fromStdString(ret.toString())).arg(job.in.toString()).arg(job.out.toString()));
         }
     }
+}
 
-    Ret ret;
-    if (!errors.empty()) {
-        ret = make_ret(Err::ConvertFailed, errors.join(u"\n").toStdString());
-    } else {
-        ret = make_ret(Ret::Code::Ok);
-    }
+void ConverterController::runBatchJobsInParallel(const BatchJob& batchJob, muse::ProgressPtr progress, size_t jobsCount,
+                                                 const StringList& jobWorkerArgs, StringList& errors) const
+{
+    TRACEFUNC;
 
-    if (progress) {
-        progress->finished.send(ProgressResult(ret));
+    //! NOTE: The engraving and project modules keep global state (current project, MScore statics, allocators),
+    //! so each job is converted by its own console instance of the application.
+    //! This gives every job an isolated project context, while fonts, styles and instrument templates
+    //! are read-only files that all the workers share through the OS file cache.
+    //! The workers get the options this process was given (style, dpi, trim, bitrate, import options, log level...),
+    //! so the output is the same as the one of the sequential conversion
+    const QString program = QCoreApplication::applicationFilePath();
+    const QStringList commonArgs = jobWorkerArgs.toQStringList();
+
+    LOGI() << "jobs: " << batchJob.size() << ", workers: " << jobsCount;
+
+    QEventLoop loop;
+    BatchJob::const_iterator nextJob = batchJob.cbegin();
+    size_t runningJobs = 0;
+    int64_t finishedJobs = 0;
+    int64_t total = batchJob.size();
+
+    std::function<void()> startNextJob;
+
+    auto onJobFinished = [&](const Job& job, bool success, const QString& errorOutput) {
+        --runningJobs;
+        ++finishedJobs;
+
+        if (!success) {
+            String error = String(u"failed convert, in: %1, out: %2").arg(job.in.toString()).arg(job.out.toString());
+            if (!errorOutput.isEmpty()) {
+                error += u"\n" + String::fromQString(errorOutput);
+            }
+            errors.emplace_back(error);
+        }
+
+        if (progress) {
+            progress->progressChanged.send(finishedJobs, total, job.in.toStdString());
+        }
+
+        startNextJob();
+    };
+
+    startNextJob = [&]() {
+        if (nextJob == batchJob.cend()) {
+            if (runningJobs == 0) {
+                loop.quit();
+            }
+            return;
+        }
+
+        const Job job = *nextJob;
+        ++nextJob;
+
+        //! NOTE The output is forwarded, the errors are kept to be reported with the job
+        QProcess* process = new QProcess();
+        process->setProcessChannelMode(QProcess::ForwardedOutputChannel);
+
+        QObject::connect(process, &QProcess::finished, [process, job, &onJobFinished](int exitCode, QProcess::ExitStatus exitStatus) {
+            process->deleteLater();
+
+            const QByteArray errorOutput = process->readAllStandardError();
+            const bool success = exitStatus == QProcess::NormalExit && exitCode == 0;
+            if (success && !errorOutput.isEmpty()) {
+                std::fwrite(errorOutput.constData(), 1, errorOutput.size(), stderr);
+            }
+
+            onJobFinished(job, success, QString::fromUtf8(errorOutput).trimmed());
+        });
+
+        QObject::connect(process, &QProcess::errorOccurred, [process, job, &onJobFinished](QProcess::ProcessError error) {
+            //! NOTE: finished() isn't emitted if the process could not be started
+            if (error == QProcess::FailedToStart) {
+                process->deleteLater();
+                onJobFinished(job, false, process->errorString());
+            }
+        });
+
+        ++runningJobs;
+        process->start(program, QStringList(commonArgs) << "-o" << job.out.toQString() << job.in.toQString());
+    };
+
+    for (size_t i = 0; i < jobsCount && nextJob != batchJob.cend(); ++i) {
+        startNextJob();
     }
 
-    return ret;
+    if (runningJobs > 0) {
+        loop.exec();
+    }
 }
 
 Ret ConverterController::fileConvert(const muse::io::path_t& in, const muse::io::path_t& out, const muse::io::path_t& stylePath,
@@ -56,7 +56,8 @@ public:
     muse::Ret batchConvert(const muse::io::path_t& batchJobFile,
                            const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false,
                            const muse::String& soundProfile = muse::String(),
-                           const muse::UriQuery& extensionUri = muse::UriQuery(), muse::ProgressPtr progress = nullptr) override;
+                           const muse::UriQuery& extensionUri = muse::UriQuery(), muse::ProgressPtr progress = nullptr,
+                           size_t jobsCount = 1, const muse::StringList& jobWorkerArgs = {}) override;
 
     muse::Ret convertScoreParts(const muse::io::path_t& in, const muse::io::path_t& out,
                                 const muse::io::path_t& stylePath = muse::io::path_t(), bool forceMode = false) override;
@@ -88,6 +89,12 @@ private:
 
     muse::RetVal<BatchJob> parseBatchJob(const muse::io::path_t& batchJobFile) const;
 
+    void runBatchJobsSequentially(const BatchJob& batchJob, const muse::io::path_t& stylePath, bool forceMode,
+                                  const muse::String& soundProfile, const muse::UriQuery& extensionUri,
+                                  muse::ProgressPtr progress, muse::StringList& errors);
+    void runBatchJobsInParallel(const BatchJob& batchJob, muse::ProgressPtr progress, size_t jobsCount,
+                                const muse::StringList& jobWorkerArgs, muse::StringList& errors) const;
+
     muse::Ret convertByExtension(project::INotationWriterPtr writer, notation::INotationPtr notation, const muse::io::path_t& out,
                                  const muse::UriQuery& extensionUri);
     bool isConvertPageByPage(const std::string& suffix) const;
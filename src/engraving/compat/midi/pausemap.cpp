@@ -73,7 +73,7 @@ void PauseMap::calculate(const Score* s)
             if (RealIsNull(it->second.pause)) {
                 // We have a regular tempo change. Don't include tempo change from first tick of next RepeatSegment (it will be included later).
                 if (tick != endTick) {
-                    m_tempomapWithPauses->insert(std::pair<const int, TEvent>(tickWithPauses(utick), it->second));
+                    m_tempomapWithPauses->insertEvent(tickWithPauses(utick), it->second);
                 }
             } else {
                 // We have a pause event. Don't include pauses from first tick of current RepeatSegment (it was included in the previous one).
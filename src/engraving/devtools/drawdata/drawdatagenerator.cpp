@@ -131,6 +131,7 @@ DrawDataPtr DrawDataGenerator::genDrawData(const muse::io::path_t& scorePath, co
         option.printPageBackground = true;
         option.isSetViewport = true;
         option.isPrinting = true;
+        option.useDisplayLists = false;
 
         scoreRenderer()->paintScore(&painter, score, option);
     }
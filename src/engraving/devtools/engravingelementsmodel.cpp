@@ -21,6 +21,8 @@
  */
 #include "engravingelementsmodel.h"
 
+#include <set>
+
 #include <QTextStream>
 
 #include "engraving/dom/engravingobject.h"
@@ -343,8 +345,14 @@ void EngravingElementsModel::updateInfo()
 {
     const EngravingObjectSet& elements = elementsProvider()->elements();
     QHash<QString, int> els;
+    std::set<const MasterScore*> masterScores;
     for (const mu::engraving::EngravingObject* el : elements) {
         els[el->typeName()] += 1;
+
+        //! NOTE The scores themselves are not registered
+        if (el->score() && el->score()->masterScore()) {
+            masterScores.insert(el->score()->masterScore());
+        }
     }
 
     {
@@ -353,6 +361,13 @@ void EngravingElementsModel::updateInfo()
         for (auto it = els.constBegin(); it != els.constEnd(); ++it) {
             stream << it.key() << ": " << it.value() << "\n";
         }
+
+        for (const MasterScore* score : masterScores) {
+            const LayoutStatistics& layoutStats = score->layoutStatistics();
+            stream << "Last layout " << score->name().toQString() << ": "
+                   << "systems relaid: " << layoutStats.relaidSystems << ", reused: " << layoutStats.reusedSystems
+                   << ", pages relaid: " << layoutStats.relaidPages << ", reused: " << layoutStats.reusedPages << "\n";
+        }
     }
 
     {
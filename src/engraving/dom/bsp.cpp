@@ -20,7 +20,9 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cmath>
+#include <limits>
 
 #include "bsp.h"
 #include "engravingitem.h"
@@ -37,8 +39,9 @@ class InsertItemBspTreeVisitor : public BspTreeVisitor
     OBJECT_ALLOCATOR(engraving, InsertItemBspTreeVisitor)
 public:
     EngravingItem* item;
+    RectF bbox;
 
-    inline void visit(std::list<EngravingItem*>* items) { items->push_front(item); }
+    inline void visit(BspTree::Leaf* leaf) { leaf->add(item, bbox); }
 };
 
 //---------------------------------------------------------
@@ -51,31 +54,163 @@ class RemoveItemBspTreeVisitor : public BspTreeVisitor
 public:
     EngravingItem* item;
 
-    inline void visit(std::list<EngravingItem*>* items) { items->remove(item); }
+    inline void visit(BspTree::Leaf* leaf) { leaf->remove(item); }
 };
 
 //---------------------------------------------------------
 //   FindItemBspTreeVisitor
+//    Collects every item of the visited leaves once.
+//    Leaf items are visited from the last inserted to the
+//    first one, and the found items are in reverse order
+//    of discovery.
 //---------------------------------------------------------
 
 class FindItemBspTreeVisitor : public BspTreeVisitor
 {
     OBJECT_ALLOCATOR(engraving, FindItemBspTreeVisitor)
 public:
-    std::list<EngravingItem*> foundItems;
+    std::vector<EngravingItem*> foundItems;
 
-    void visit(std::list<EngravingItem*>* items)
+    void visit(BspTree::Leaf* leaf)
     {
-        for (auto it = items->begin(); it != items->end(); ++it) {
-            EngravingItem* item = *it;
+        for (size_t i = leaf->size(); i > 0; --i) {
+            EngravingItem* item = leaf->items[i - 1];
             if (!item->itemDiscovered) {
                 item->itemDiscovered = true;
-                foundItems.push_front(item);
+                foundItems.push_back(item);
             }
         }
     }
 };
 
+//---------------------------------------------------------
+//   FindItemInRectBspTreeVisitor
+//    Like FindItemBspTreeVisitor, but only collects the
+//    items whose bounding box intersects the rect.
+//    The bounding boxes of a leaf are tested in one
+//    branchless pass, which the compiler vectorizes.
+//    The boxes are as of insertion, so the hits are
+//    checked again with the current bounding boxes.
+//---------------------------------------------------------
+
+class FindItemInRectBspTreeVisitor : public BspTreeVisitor
+{
+    OBJECT_ALLOCATOR(engraving, FindItemInRectBspTreeVisitor)
+public:
+    double left = 0.0;
+    double top = 0.0;
+    double right = 0.0;
+    double bottom = 0.0;
+    RectF rect;
+
+    std::vector<EngravingItem*> foundItems;
+
+    void visit(BspTree::Leaf* leaf)
+    {
+        const size_t size = leaf->size();
+        if (size == 0) {
+            return;
+        }
+
+        m_hits.resize(size);
+
+        const double* leafLeft = leaf->left.data();
+        const double* leafTop = leaf->top.data();
+        const double* leafRight = leaf->right.data();
+        const double* leafBottom = leaf->bottom.data();
+        uint8_t* hits = m_hits.data();
+
+        for (size_t i = 0; i < size; ++i) {
+            hits[i] = (leafLeft[i] < right) & (left < leafRight[i]) & (leafTop[i] < bottom) & (top < leafBottom[i]);
+        }
+
+        for (size_t i = size; i > 0; --i) {
+            if (!hits[i - 1]) {
+                continue;
+            }
+
+            EngravingItem* item = leaf->items[i - 1];
+            if (!item->itemDiscovered) {
+                item->itemDiscovered = true;
+                m_discoveredItems.push_back(item);
+                if (item->pageBoundingRect().intersects(rect)) {
+                    foundItems.push_back(item);
+                }
+            }
+        }
+    }
+
+    void resetDiscovered()
+    {
+        for (EngravingItem* item : m_discoveredItems) {
+            item->itemDiscovered = false;
+        }
+    }
+
+private:
+    std::vector<EngravingItem*> m_discoveredItems;
+    std::vector<uint8_t> m_hits;
+};
+
+//---------------------------------------------------------
+//   normalizedBounds
+//    Same rules as RectF::intersects: null rects never
+//    intersect, so they get empty bounds.
+//---------------------------------------------------------
+
+static void normalizedBounds(const RectF& r, double& left, double& top, double& right, double& bottom)
+{
+    left = std::min(r.left(), r.right());
+    right = std::max(r.left(), r.right());
+    top = std::min(r.top(), r.bottom());
+    bottom = std::max(r.top(), r.bottom());
+
+    if (muse::RealIsEqual(left, right) || muse::RealIsEqual(top, bottom)) {
+        left = top = std::numeric_limits<double>::infinity();
+        right = bottom = -std::numeric_limits<double>::infinity();
+    }
+}
+
+//---------------------------------------------------------
+//   Leaf
+//---------------------------------------------------------
+
+void BspTree::Leaf::add(EngravingItem* item, const RectF& bbox)
+{
+    double l, t, r, b;
+    normalizedBounds(bbox, l, t, r, b);
+
+    items.push_back(item);
+    left.push_back(l);
+    top.push_back(t);
+    right.push_back(r);
+    bottom.push_back(b);
+}
+
+void BspTree::Leaf::remove(EngravingItem* item)
+{
+    size_t to = 0;
+    for (size_t from = 0; from < items.size(); ++from) {
+        if (items[from] == item) {
+            continue;
+        }
+        if (to != from) {
+            items[to] = items[from];
+            left[to] = left[from];
+            top[to] = top[from];
+            right[to] = right[from];
+            bottom[to] = bottom[from];
+        }
+        ++to;
+    }
+
+    items.resize(to);
+    left.resize(to);
+    top.resize(to);
+    right.resize(to);
+    bottom.resize(to);
+}
+
 //---------------------------------------------------------
 //   BspTree
 //---------------------------------------------------------
@@ -107,10 +242,25 @@ void BspTree::initialize(const RectF& rec, int n)
 
     m_nodes.resize((1 << (m_depth + 1)) - 1);
     m_leaves.resize(1LL << m_depth);
-    std::fill(m_leaves.begin(), m_leaves.end(), std::list<EngravingItem*>());
+    for (Leaf& leaf : m_leaves) {
+        leaf = Leaf();
+    }
     initialize(rec, m_depth, 0);
 }
 
+//---------------------------------------------------------
+//   build
+//---------------------------------------------------------
+
+void BspTree::build(const RectF& rec, const std::vector<EngravingItem*>& items)
+{
+    initialize(rec, static_cast<int>(items.size()));
+
+    for (EngravingItem* item : items) {
+        insert(item);
+    }
+}
+
 //---------------------------------------------------------
 //   clear
 //---------------------------------------------------------
@@ -130,7 +280,8 @@ void BspTree::insert(EngravingItem* element)
 {
     InsertItemBspTreeVisitor insertVisitor;
     insertVisitor.item = element;
-    climbTree(&insertVisitor, element->pageBoundingRect());
+    insertVisitor.bbox = element->pageBoundingRect();
+    climbTree(&insertVisitor, insertVisitor.bbox);
 }
 
 //---------------------------------------------------------
@@ -150,16 +301,20 @@ void BspTree::remove(EngravingItem* element)
 
 std::vector<EngravingItem*> BspTree::items(const RectF& rec)
 {
-    FindItemBspTreeVisitor findVisitor;
-    climbTree(&findVisitor, rec);
-    std::vector<EngravingItem*> l;
-    for (EngravingItem* e : findVisitor.foundItems) {
-        e->itemDiscovered = false;
-        if (e->pageBoundingRect().intersects(rec)) {
-            l.push_back(e);
-        }
+    FindItemInRectBspTreeVisitor findVisitor;
+    normalizedBounds(rec, findVisitor.left, findVisitor.top, findVisitor.right, findVisitor.bottom);
+    if (findVisitor.left > findVisitor.right) {
+        return {};
     }
-    return l;
+
+    findVisitor.rect = rec;
+    climbTree(&findVisitor, rec);
+    findVisitor.resetDiscovered();
+
+    std::vector<EngravingItem*>& l = findVisitor.foundItems;
+    std::reverse(l.begin(), l.end());
+
+    return std::move(l);
 }
 
 //---------------------------------------------------------
@@ -172,7 +327,8 @@ std::vector<EngravingItem*> BspTree::items(const PointF& pos)
     climbTree(&findVisitor, pos);
 
     std::vector<EngravingItem*> l;
-    for (EngravingItem* e : findVisitor.foundItems) {
+    for (auto it = findVisitor.foundItems.rbegin(); it != findVisitor.foundItems.rend(); ++it) {
+        EngravingItem* e = *it;
         e->itemDiscovered = false;
         if (e->contains(pos)) {
             l.push_back(e);
@@ -207,7 +363,9 @@ void BspTree::nearestNeighbor(const PointF& pos, EngravingItem** bestItem, doubl
 
     // Base case: go through the items in the leaf node (if any), and update bestItem/bestDistance accordingly
     if (node->type == Node::Type::LEAF) {
-        for (auto item : m_leaves[node->leafIndex]) {
+        const std::vector<EngravingItem*>& items = m_leaves[node->leafIndex].items;
+        for (auto it = items.rbegin(); it != items.rend(); ++it) {
+            EngravingItem* item = *it;
             PointF itemPos = item->pageBoundingRect().center();
             double currDistance = std::sqrt(std::pow(pos.x() - itemPos.x(), 2) + std::pow(pos.y() - itemPos.y(), 2));
             if (currDistance < bestDistance) {
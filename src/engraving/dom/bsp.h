@@ -23,7 +23,7 @@
 #ifndef MU_ENGRAVING_BSP_H
 #define MU_ENGRAVING_BSP_H
 
-#include <list>
+#include <vector>
 
 #include "global/allocator.h"
 #include "types/string.h"
@@ -55,22 +55,40 @@ public:
         };
         Type type;
     };
+
+    //! NOTE: The items of a leaf are stored next to their bounding boxes (as of insertion, in page coordinates),
+    //! as a structure of arrays, so that rectangle queries can test a whole leaf in one tight loop
+    //! without touching the items themselves. Only the items that pass this test are checked with
+    //! their current bounding box, so an item moved since its insertion is not found where it was.
+    //! As with the leaves, which are chosen by the box as of insertion, an item moved into the rect may be missed:
+    //! the tree must be rebuilt after the layout (see Page::invalidateBspTree)
+    struct Leaf {
+        std::vector<EngravingItem*> items;
+        std::vector<double> left;
+        std::vector<double> top;
+        std::vector<double> right;
+        std::vector<double> bottom;
+
+        size_t size() const { return items.size(); }
+        bool empty() const { return items.empty(); }
+
+        void add(EngravingItem* item, const RectF& bbox);
+        void remove(EngravingItem* item);
+    };
+
 private:
 
     void initialize(const RectF& rect, int depth, int index);
     void climbTree(BspTreeVisitor* visitor, const PointF& pos, int index = 0);
     void climbTree(BspTreeVisitor* visitor, const RectF& rect, int index = 0);
 
-    void findItems(std::list<EngravingItem*>* foundItems, const RectF& rect, int index);
-    void findItems(std::list<EngravingItem*>* foundItems, const PointF& pos, int index);
-
     void nearestNeighbor(const PointF& pos, EngravingItem** bestItem, double& bestDistance, int nodeIndex = 0);
 
     RectF rectForIndex(int index) const;
 
     unsigned int m_depth = 0;
     std::vector<Node> m_nodes;
-    std::vector<std::list<EngravingItem*> > m_leaves;
+    std::vector<Leaf> m_leaves;
     int m_leafCnt = 0;
     RectF m_rect;
 
@@ -80,6 +98,9 @@ public:
     void initialize(const RectF& rect, int depth);
     void clear();
 
+    // bulk (re)build, e.g. after layout
+    void build(const RectF& rect, const std::vector<EngravingItem*>& items);
+
     void insert(EngravingItem* item);
     void remove(EngravingItem* item);
 
@@ -110,7 +131,7 @@ class BspTreeVisitor
     OBJECT_ALLOCATOR(engraving, BspTreeVisitor)
 public:
     virtual ~BspTreeVisitor() {}
-    virtual void visit(std::list<EngravingItem*>* items) = 0;
+    virtual void visit(BspTree::Leaf* leaf) = 0;
 };
 } // namespace mu::engraving
 #endif
@@ -28,6 +28,8 @@
 #include <assert.h>
 
 #include "translation.h"
+#include "global/allocator.h"
+#include "global/concurrency/taskscheduler.h"
 
 #include "infrastructure/messagebox.h"
 #include "style/style.h"
@@ -340,6 +342,8 @@ void Score::startCmd()
         return;
     }
     undoStack()->beginMacro(this);
+
+    masterScore()->beginCmdArenaScope();
 }
 
 //---------------------------------------------------------
@@ -357,6 +361,8 @@ void Score::undoRedo(bool undo, EditData* ed)
     //! 2. for the redo operation, the list of changed elements will be available after redo()
     UndoMacro::ChangesInfo changes = changesInfo(undoStack());
 
+    muse::AllocatorArena::Scope arenaScope(masterScore()->allocatorArena());
+
     cmdState().reset();
     if (undo) {
         undoStack()->undo(ed);
@@ -432,6 +438,8 @@ void Score::endCmd(bool rollback, bool layoutAllParts)
     if (!rollback) {
         changesChannel().send(range);
     }
+
+    masterScore()->endCmdArenaScope();
 }
 
 ScoreChangesRange Score::changesRange() const
@@ -462,6 +470,21 @@ void CmdState::dump()
 
 #endif
 
+//---------------------------------------------------------
+//   doLayoutRangeConcurrently
+//    see MScore::parallelPartsLayout
+//---------------------------------------------------------
+
+static void doLayoutRangeConcurrently(const std::vector<Score*>& scores, const Fraction& st, const Fraction& et)
+{
+    muse::AllocatorArena* arena = muse::AllocatorArena::current();
+
+    muse::TaskScheduler::shared().parallelFor(scores.size(), [&](size_t index) {
+        muse::AllocatorArena::Scope arenaScope(arena);
+        scores.at(index)->doLayoutRange(st, et);
+    });
+}
+
 //---------------------------------------------------------
 //   update
 //    layout & update
@@ -475,6 +498,8 @@ void Score::update(bool resetCmdState, bool layoutAllParts)
 
     TRACEFUNC;
 
+    muse::AllocatorArena::Scope arenaScope(masterScore()->allocatorArena());
+
     bool updateAll = false;
     {
         MasterScore* ms = masterScore();
@@ -482,11 +507,22 @@ void Score::update(bool resetCmdState, bool layoutAllParts)
         ms->deletePostponed();
 
         if (cs.layoutRange()) {
+            std::vector<Score*> scores;
             for (Score* s : ms->scoreList()) {
                 if (s != this && !s->isOpen() && ms->scoreList().size() > 1 && !layoutAllParts) {
                     continue;
                 }
-                s->doLayoutRange(cs.startTick(), cs.endTick());
+                scores.push_back(s);
+            }
+
+            if (MScore::parallelPartsLayout && layoutAllParts && !muse::ObjectAllocator::enabled()) {
+                //! NOTE The fallback font is resolved lazily, so it is resolved here, before the layout
+                engravingFonts()->fallbackFont();
+                doLayoutRangeConcurrently(scores, cs.startTick(), cs.endTick());
+            } else {
+                for (Score* s : scores) {
+                    s->doLayoutRange(cs.startTick(), cs.endTick());
+                }
             }
             updateAll = true;
         }
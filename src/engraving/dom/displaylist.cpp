@@ -0,0 +1,99 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "displaylist.h"
+
+#include <unordered_set>
+
+using namespace mu::engraving;
+using namespace muse::draw;
+
+void DisplayList::setContext(size_t context)
+{
+    std::lock_guard lock(m_mutex);
+    if (m_context != context) {
+        m_entries.clear();
+        m_context = context;
+    }
+}
+
+DrawDataPtr DisplayList::find(const EngravingItem* item, size_t signature)
+{
+    std::lock_guard lock(m_mutex);
+    auto it = m_entries.find(item);
+    if (it == m_entries.end() || it->second.signature != signature) {
+        ++m_stats.misses;
+        return nullptr;
+    }
+
+    ++m_stats.hits;
+    return it->second.data;
+}
+
+void DisplayList::insert(const EngravingItem* item, size_t signature, const DrawDataPtr& data)
+{
+    std::lock_guard lock(m_mutex);
+    Entry& entry = m_entries[item];
+    entry.signature = signature;
+    entry.data = data;
+}
+
+void DisplayList::retain(const std::vector<EngravingItem*>& items)
+{
+    std::lock_guard lock(m_mutex);
+    if (m_entries.empty()) {
+        return;
+    }
+
+    std::unordered_set<const EngravingItem*> itemSet(items.begin(), items.end());
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+        if (itemSet.find(it->first) == itemSet.end()) {
+            it = m_entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void DisplayList::clear()
+{
+    std::lock_guard lock(m_mutex);
+    m_entries.clear();
+}
+
+size_t DisplayList::size() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_entries.size();
+}
+
+DisplayList::Stats DisplayList::stats() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_stats;
+}
+
+void DisplayList::resetStats()
+{
+    std::lock_guard lock(m_mutex);
+    m_stats = Stats();
+}
@@ -0,0 +1,84 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MU_ENGRAVING_DISPLAYLIST_H
+#define MU_ENGRAVING_DISPLAYLIST_H
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "draw/types/drawdata.h"
+
+namespace mu::engraving {
+class EngravingItem;
+
+//---------------------------------------------------------
+//   DisplayList
+//    what the items of a page draw, recorded in the item coordinates,
+//    so that the page is painted again without going through the items
+//---------------------------------------------------------
+
+class DisplayList
+{
+public:
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+    };
+
+    DisplayList() = default;
+
+    //! NOTE The recordings are not copied, a copy starts empty
+    DisplayList(const DisplayList&) {}
+    DisplayList& operator=(const DisplayList&) { clear(); return *this; }
+
+    //! NOTE The context describes the global state the recordings depend on (ex. printing, colors),
+    //! all the recordings are dropped when it changes
+    void setContext(size_t context);
+
+    //! NOTE The signature describes the state of the item when it was recorded,
+    //! a recording with another signature is not returned
+    muse::draw::DrawDataPtr find(const EngravingItem* item, size_t signature);
+    void insert(const EngravingItem* item, size_t signature, const muse::draw::DrawDataPtr& data);
+
+    //! NOTE Drops the recordings of the items which are not in the list
+    void retain(const std::vector<EngravingItem*>& items);
+    void clear();
+
+    size_t size() const;
+    Stats stats() const;
+    void resetStats();
+
+private:
+    struct Entry {
+        size_t signature = 0;
+        muse::draw::DrawDataPtr data;
+    };
+
+    mutable std::mutex m_mutex;
+    size_t m_context = 0;
+    std::unordered_map<const EngravingItem*, Entry> m_entries;
+    Stats m_stats;
+};
+} // namespace mu::engraving
+#endif
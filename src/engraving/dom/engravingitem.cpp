@@ -27,6 +27,7 @@
 
 #include "engravingitem.h"
 
+#include <atomic>
 #include <cmath>
 
 #include "containers.h"
@@ -2593,6 +2594,19 @@ EngravingItem::LayoutData* EngravingItem::mutldata()
     return mutldataInternal();
 }
 
+size_t EngravingItem::heapSize() const
+{
+    if (!m_layoutData) {
+        return 0;
+    }
+
+    size_t bytes = layoutDataSize();
+    if (m_layoutData->m_shape.has_value()) {
+        bytes += m_layoutData->m_shape.value(LD_ACCESS::PASS).elements().capacity() * sizeof(ShapeElement);
+    }
+    return bytes;
+}
+
 const EngravingItem::LayoutData* EngravingItem::ldataInternal() const
 {
     if (!m_layoutData) {
@@ -2608,6 +2622,7 @@ EngravingItem::LayoutData* EngravingItem::mutldataInternal()
         m_layoutData = createLayoutData();
         m_layoutData->m_item = this;
     }
+    ++m_layoutData->m_revision;
     return m_layoutData;
 }
 
@@ -2633,6 +2648,12 @@ bool EngravingItem::elementAppliesToTrack(const track_idx_t elementTrack, const
     return false;
 }
 
+uint64_t EngravingItem::LayoutData::nextId()
+{
+    static std::atomic<uint64_t> s_lastId = 0;
+    return ++s_lastId;
+}
+
 void EngravingItem::LayoutData::setBbox(const RectF& r)
 {
     DO_ASSERT(!std::isnan(r.x()) && !std::isinf(r.x()));
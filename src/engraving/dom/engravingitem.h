@@ -49,6 +49,7 @@
     const LayoutData* ldata() const { return static_cast<const Class::LayoutData*>(EngravingItem::ldata()); } \
     LayoutData* mutldata() { return static_cast<Class::LayoutData*>(EngravingItem::mutldata()); } \
     LayoutData* createLayoutData() const override { return new Class::LayoutData(); } \
+    size_t layoutDataSize() const override { return sizeof(Class::LayoutData); } \
 
 namespace mu::engraving {
 template<typename T>
@@ -603,6 +604,11 @@ public:
             m_staffCenteringInfo.availableVertSpaceBelow = availSpaceBelow;
         }
 
+        //! NOTE The id is unique for each layout data, the revision changes
+        //! each time the layout data is taken for writing (see DisplayList)
+        uint64_t id() const { return m_id; }
+        uint64_t revision() const { return m_revision; }
+
         void dump(std::stringstream& ss) const;
 
     protected:
@@ -628,7 +634,11 @@ public:
 
         friend class EngravingItem;
 
+        static uint64_t nextId();
+
         const EngravingItem* m_item = nullptr;
+        uint64_t m_id = nextId();
+        uint64_t m_revision = 0;
         bool m_isSkipDraw = false;
         double m_mag = 1.0;                     // standard magnification (derived value)
         ld_field<PointF> m_pos = "pos";         // Reference position, relative to _parent, set by autoplace
@@ -642,6 +652,7 @@ public:
 
     const LayoutData* ldata() const;
     LayoutData* mutldata();
+    size_t heapSize() const override;
 
     virtual double mag() const;
     Shape shape(LD_ACCESS mode = LD_ACCESS::CHECK) const { return ldata()->shape(mode); }
@@ -700,6 +711,7 @@ protected:
 #endif
 
     virtual LayoutData* createLayoutData() const;
+    virtual size_t layoutDataSize() const { return sizeof(LayoutData); }
     virtual const LayoutData* ldataInternal() const;
     virtual LayoutData* mutldataInternal();
 
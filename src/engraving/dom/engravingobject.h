@@ -208,6 +208,10 @@ public:
     const char* typeName() const;
     virtual TranslatableString typeUserName() const;
     virtual String translatedTypeUserName() const;
+    //! NOTE Size of the object class, see DECLARE_CLASSOF
+    virtual size_t objectSize() const { return sizeof(EngravingObject); }
+    //! NOTE Memory held by the object outside of it (ex. the layout data), an estimate
+    virtual size_t heapSize() const { return 0; }
 
     inline EID eid() const { return m_eid; }
     inline void setEID(EID id) { m_eid = id; }
@@ -146,6 +146,32 @@ String MasterScore::name() const
     return fileInfo()->displayName();
 }
 
+//---------------------------------------------------------
+//   beginCmdArenaScope
+///   The arena stays current from startCmd to endCmd, which
+///   may span several events (ex. dragging), so it is made
+///   current only if no arena is, and the scope can't outlive
+///   the one it would restore.
+//---------------------------------------------------------
+
+void MasterScore::beginCmdArenaScope()
+{
+    if (!m_allocatorArena || m_cmdArenaScope || muse::AllocatorArena::current()) {
+        return;
+    }
+
+    m_cmdArenaScope.emplace(m_allocatorArena);
+}
+
+//---------------------------------------------------------
+//   endCmdArenaScope
+//---------------------------------------------------------
+
+void MasterScore::endCmdArenaScope()
+{
+    m_cmdArenaScope.reset();
+}
+
 //---------------------------------------------------------
 //   setPlaylistDirty
 //---------------------------------------------------------
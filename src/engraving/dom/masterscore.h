@@ -23,6 +23,7 @@
 #define MU_ENGRAVING_MASTERSCORE_H
 
 #include <array>
+#include <optional>
 
 #include "../infrastructure/ifileinfoprovider.h"
 #include "../infrastructure/geteid.h"
@@ -193,6 +194,12 @@ public:
     void setWidthOfSegmentCell(double val) { m_widthOfSegmentCell = val; }
     double widthOfSegmentCell() const { return m_widthOfSegmentCell; }
 
+    //! NOTE The objects created by the loading, the commands (startCmd...endCmd), undo/redo and layout
+    //! of the score are allocated from the arena of its project, if any
+    muse::AllocatorArena* allocatorArena() const { return m_allocatorArena; }
+    void beginCmdArenaScope();
+    void endCmdArenaScope();
+
 private:
 
     void reorderMidiMapping();
@@ -245,6 +252,9 @@ private:
     IFileInfoProviderPtr m_fileInfoProvider;
 
     bool m_saved = false;
+
+    muse::AllocatorArena* m_allocatorArena = nullptr;
+    std::optional<muse::AllocatorArena::Scope> m_cmdArenaScope;
 };
 
 extern MasterScore* gpaletteScore;
@@ -652,20 +652,7 @@ Segment* Measure::tick2segment(const Fraction& _t, SegmentType st)
 
 Segment* Measure::findSegmentR(SegmentType st, const Fraction& t) const
 {
-    Segment* s;
-    if (t > (ticks() * Fraction(1, 2))) {
-        // search backwards
-        for (s = last(); s && s->rtick() > t; s = s->prev()) {
-        }
-        while (s && s->prev() && s->prev()->rtick() == t) {
-            s = s->prev();
-        }
-    } else {
-        // search forwards
-        for (s = first(); s && s->rtick() < t; s = s->next()) {
-        }
-    }
-    for (; s && s->rtick() == t; s = s->next()) {
+    for (Segment* s = m_segments.lowerBound(t); s && s->rtick() == t; s = s->next()) {
         if (s->segmentType() & st) {
             return s;
         }
@@ -22,6 +22,8 @@
 
 #include "measurebase.h"
 
+#include <algorithm>
+
 #include "factory.h"
 #include "layoutbreak.h"
 #include "measure.h"
@@ -688,6 +690,7 @@ MeasureBaseList::MeasureBaseList()
 
 void MeasureBaseList::push_back(MeasureBase* e)
 {
+    invalidateIndex(m_last);
     ++m_size;
     if (m_last) {
         m_last->setNext(e);
@@ -699,6 +702,7 @@ void MeasureBaseList::push_back(MeasureBase* e)
         e->setNext(0);
     }
     m_last = e;
+    updateIndex();
 }
 
 //---------------------------------------------------------
@@ -707,6 +711,7 @@ void MeasureBaseList::push_back(MeasureBase* e)
 
 void MeasureBaseList::push_front(MeasureBase* e)
 {
+    invalidateIndex(nullptr);
     ++m_size;
     if (m_first) {
         m_first->setPrev(e);
@@ -718,6 +723,7 @@ void MeasureBaseList::push_front(MeasureBase* e)
         e->setNext(0);
     }
     m_first = e;
+    updateIndex();
 }
 
 //---------------------------------------------------------
@@ -736,10 +742,12 @@ void MeasureBaseList::add(MeasureBase* e)
         push_front(e);
         return;
     }
+    invalidateIndex(el->prev());
     ++m_size;
     e->setPrev(el->prev());
     el->prev()->setNext(e);
     el->setPrev(e);
+    updateIndex();
 }
 
 //---------------------------------------------------------
@@ -748,6 +756,7 @@ void MeasureBaseList::add(MeasureBase* e)
 
 void MeasureBaseList::remove(MeasureBase* el)
 {
+    invalidateIndex(el->prev());
     --m_size;
     if (el->prev()) {
         el->prev()->setNext(el->next());
@@ -759,6 +768,7 @@ void MeasureBaseList::remove(MeasureBase* el)
     } else {
         m_last = el->prev();
     }
+    updateIndex();
 }
 
 //---------------------------------------------------------
@@ -767,6 +777,7 @@ void MeasureBaseList::remove(MeasureBase* el)
 
 void MeasureBaseList::insert(MeasureBase* fm, MeasureBase* lm)
 {
+    invalidateIndex(fm->prev());
     ++m_size;
     for (MeasureBase* m = fm; m != lm; m = m->next()) {
         ++m_size;
@@ -783,6 +794,7 @@ void MeasureBaseList::insert(MeasureBase* fm, MeasureBase* lm)
     } else {
         m_last = lm;
     }
+    updateIndex();
 }
 
 //---------------------------------------------------------
@@ -791,6 +803,7 @@ void MeasureBaseList::insert(MeasureBase* fm, MeasureBase* lm)
 
 void MeasureBaseList::remove(MeasureBase* fm, MeasureBase* lm)
 {
+    invalidateIndex(fm->prev());
     --m_size;
     for (MeasureBase* m = fm; m != lm; m = m->next()) {
         --m_size;
@@ -807,6 +820,7 @@ void MeasureBaseList::remove(MeasureBase* fm, MeasureBase* lm)
     } else {
         m_last = pm;
     }
+    updateIndex();
 }
 
 //---------------------------------------------------------
@@ -815,6 +829,7 @@ void MeasureBaseList::remove(MeasureBase* fm, MeasureBase* lm)
 
 void MeasureBaseList::change(MeasureBase* ob, MeasureBase* nb)
 {
+    invalidateIndex(ob->prev());
     nb->setPrev(ob->prev());
     nb->setNext(ob->next());
     if (ob->prev()) {
@@ -836,4 +851,69 @@ void MeasureBaseList::change(MeasureBase* ob, MeasureBase* nb)
     for (EngravingItem* e : nb->el()) {
         e->setParent(nb);
     }
+    updateIndex();
+}
+
+//---------------------------------------------------------
+//   invalidateIndex
+//    the index stays valid up to and including validUntil,
+//    nullptr invalidates it completely
+//---------------------------------------------------------
+
+void MeasureBaseList::invalidateIndex(const MeasureBase* validUntil)
+{
+    if (!validUntil) {
+        m_indexValidCount = 0;
+        return;
+    }
+
+    size_t pos = validUntil->m_listIndex;
+    if (pos < m_indexValidCount && m_index[pos] == validUntil) {
+        m_indexValidCount = pos + 1;
+    }
+    // otherwise it is not in the valid part of the index, nothing to do
+}
+
+//---------------------------------------------------------
+//   updateIndex
+//    rebuilds the invalidated part of the index. Called by
+//    every change of the list, on the thread editing the score,
+//    so the lookups only read it
+//---------------------------------------------------------
+
+void MeasureBaseList::updateIndex()
+{
+    if (m_indexValidCount == m_index.size() && (m_index.empty() ? !m_first : m_index.back() == m_last)) {
+        return;
+    }
+
+    m_index.resize(m_indexValidCount);
+
+    MeasureBase* mb = m_index.empty() ? m_first : m_index.back()->next();
+    for (; mb; mb = mb->next()) {
+        mb->m_listIndex = m_index.size();
+        m_index.push_back(mb);
+    }
+
+    m_indexValidCount = m_index.size();
+}
+
+//---------------------------------------------------------
+//   findByTick
+//    return the last measure base starting at or before tick.
+//    Relies on the list being sorted by tick, which the
+//    tick2measure functions always did.
+//---------------------------------------------------------
+
+MeasureBase* MeasureBaseList::findByTick(const Fraction& tick) const
+{
+    auto it = std::upper_bound(m_index.cbegin(), m_index.cend(), tick, [](const Fraction& t, const MeasureBase* mb) {
+        return t < mb->tick();
+    });
+
+    if (it == m_index.cbegin()) {
+        return nullptr;
+    }
+
+    return *(--it);
 }
@@ -28,6 +28,8 @@
  Definition of MeasureBase class.
 */
 
+#include <vector>
+
 #include "engravingitem.h"
 
 namespace mu::engraving {
@@ -198,6 +200,9 @@ private:
     int m_no = 0;                         // Measure number, counting from zero
     int m_noOffset = 0;                   // Offset to measure number
     double m_oldWidth = 0.0;              // Used to restore layout during recalculations in Score::collectSystem()
+
+    friend class MeasureBaseList;
+    size_t m_listIndex = 0;               // position in MeasureBaseList index
 };
 
 //---------------------------------------------------------
@@ -210,7 +215,7 @@ public:
     MeasureBaseList();
     MeasureBase* first() const { return m_first; }
     MeasureBase* last()  const { return m_last; }
-    void clear() { m_first = m_last = 0; m_size = 0; }
+    void clear() { m_first = m_last = 0; m_size = 0; invalidateIndex(nullptr); updateIndex(); }
     void add(MeasureBase*);
     void remove(MeasureBase*);
     void insert(MeasureBase*, MeasureBase*);
@@ -219,13 +224,25 @@ public:
     int size() const { return m_size; }
     bool empty() const { return m_size == 0; }
 
+    MeasureBase* findByTick(const Fraction& tick) const;   // last measure base with tick() <= tick
+
 private:
     void push_back(MeasureBase* e);
     void push_front(MeasureBase* e);
 
+    void invalidateIndex(const MeasureBase* validUntil);
+    void updateIndex();
+
     int m_size = 0;
     MeasureBase* m_first = nullptr;
     MeasureBase* m_last = nullptr;
+
+    //! NOTE The index holds the measure bases in list order, for binary search by tick.
+    //! Ticks are read from the measure bases themselves, so changing the length of measures
+    //! (e.g. time signature changes) keeps it valid; structural changes rebuild it right away,
+    //! from the changed position on, so the const lookups never write to it.
+    std::vector<MeasureBase*> m_index;
+    size_t m_indexValidCount = 0;
 };
 } // namespace mu::engraving
 #endif
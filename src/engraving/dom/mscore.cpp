@@ -66,6 +66,8 @@ int MScore::defaultPlayDuration;
 
 bool MScore::noExcerpts = false;
 bool MScore::noImages = false;
+size_t MScore::undoHistoryLimitBytes = 0;
+bool MScore::parallelPartsLayout = false;
 bool MScore::pdfPrinting = false;
 bool MScore::svgPrinting = false;
 
@@ -233,6 +233,15 @@ public:
 
     static bool noExcerpts;
     static bool noImages;
+    static size_t undoHistoryLimitBytes; // 0 - unlimited
+
+    //! NOTE Lays out the parts concurrently, when all of them are laid out. Off, not safe yet:
+    //! the layout pushes undo commands (autoplace, DomAccessor::undo) to the shared undo stack,
+    //! and they change the linked elements of the other parts; the links, the EIDs, the object allocators,
+    //! the text caches of FontsEngine and the regex caches of TempoText are shared as well.
+    //! The style is per score, the text style lists and the engraving fonts are read-only during the layout,
+    //! pixelRatio is only read by the painting
+    static bool parallelPartsLayout;
 
     static bool pdfPrinting;
     static bool svgPrinting;
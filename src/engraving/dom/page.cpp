@@ -301,28 +301,14 @@ void Page::scanElements(void* data, void (* func)(void*, EngravingItem*), bool a
     func(data, this);
 }
 
-//---------------------------------------------------------
-//   bspInsert
-//---------------------------------------------------------
-
-static void bspInsert(void* bspTree, EngravingItem* e)
-{
-    ((BspTree*)bspTree)->insert(e);
-}
-
-static void countElements(void* data, EngravingItem* /*e*/)
-{
-    ++(*(int*)data);
-}
-
 //---------------------------------------------------------
 //   doRebuildBspTree
 //---------------------------------------------------------
 
 void Page::doRebuildBspTree()
 {
-    int n = 0;
-    scanElements(&n, countElements, false);
+    std::vector<EngravingItem*> items;
+    scanElements(&items, collectElements, false);
 
     RectF r;
     if (score()->linearMode()) {
@@ -340,9 +326,11 @@ void Page::doRebuildBspTree()
         r = pageBoundingRect();
     }
 
-    bspTree.initialize(r, n);
-    scanElements(&bspTree, &bspInsert, false);
+    bspTree.build(r, items);
     m_bspTreeValid = true;
+
+    //! NOTE The items removed from the page may be deleted, their recordings are dropped
+    m_displayList.retain(items);
 }
 
 //---------------------------------------------------------
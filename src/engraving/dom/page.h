@@ -27,6 +27,7 @@
 
 #include "engravingitem.h"
 #include "bsp.h"
+#include "displaylist.h"
 #include "text.h"
 
 namespace mu::engraving {
@@ -77,6 +78,7 @@ public:
     std::vector<EngravingItem*> items(const RectF& r);
     std::vector<EngravingItem*> items(const PointF& p);
     void invalidateBspTree() { m_bspTreeValid = false; }
+    DisplayList& displayList() { return m_displayList; }
     PointF pagePos() const override { return PointF(); }       ///< position in page coordinates
     std::vector<EngravingItem*> elements() const;              ///< list of visible elements
     RectF tbbox() const;                             // tight bounding box, excluding white space
@@ -102,6 +104,8 @@ private:
 
     BspTree bspTree;
     bool m_bspTreeValid = false;
+
+    DisplayList m_displayList;
 };
 } // namespace mu::engraving
 #endif
@@ -23,6 +23,7 @@
 #include "repeatlist.h"
 
 #include <algorithm>
+#include <limits>
 #include <list>
 #include <utility> // std::pair
 
@@ -248,6 +249,59 @@ double RepeatList::utick2utime(int tick) const
     return 0.0;
 }
 
+//---------------------------------------------------------
+//   utick2utime
+//    Converts count uticks into the times given by the caller.
+//    The uticks in a row which fall in the same repeat segment
+//    are converted at once by the tempo map, sorted uticks are
+//    converted in linear time
+//---------------------------------------------------------
+
+void RepeatList::utick2utime(const int* uticks, double* times, size_t count) const
+{
+    const size_t n = size();
+    std::vector<int> ticks;
+
+    size_t segIdx = 0; // the repeat segment after the one of the current utick
+    size_t i = 0;
+    while (i < count) {
+        if (segIdx > 0 && uticks[i] < at(segIdx - 1)->utick) {
+            segIdx = 0;
+        }
+        while (segIdx < n && uticks[i] >= at(segIdx)->utick) {
+            ++segIdx;
+        }
+
+        if (segIdx == 0) {
+            // before the first repeat segment
+            times[i++] = 0.0;
+            continue;
+        }
+
+        const RepeatSegment* rs = at(segIdx - 1);
+        const int startUtick = rs->utick;
+        const int endUtick = segIdx < n ? at(segIdx)->utick : std::numeric_limits<int>::max();
+        const int tickOffset = rs->utick - rs->tick;
+
+        size_t last = i + 1;
+        while (last < count && uticks[last] >= startUtick && uticks[last] < endUtick) {
+            ++last;
+        }
+
+        ticks.resize(last - i);
+        for (size_t j = i; j < last; ++j) {
+            ticks[j - i] = uticks[j] - tickOffset;
+        }
+
+        m_score->tempomap()->tick2time(ticks.data(), times + i, ticks.size());
+        for (size_t j = i; j < last; ++j) {
+            times[j] += rs->timeOffset;
+        }
+
+        i = last;
+    }
+}
+
 //---------------------------------------------------------
 //   utime2utick
 //---------------------------------------------------------
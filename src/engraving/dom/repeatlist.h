@@ -93,6 +93,7 @@ public:
     int tick2utick(int tick) const;
     int utime2utick(double secs) const;
     double utick2utime(int) const;
+    void utick2utime(const int* uticks, double* times, size_t count) const;
     void updateTempo();
     int ticks() const;
 
@@ -863,6 +863,9 @@ public:
     bool linearMode() const { return m_layoutOptions.isLinearMode(); }
     // ----
 
+    const LayoutStatistics& layoutStatistics() const { return m_layoutStatistics; }
+    void setLayoutStatistics(const LayoutStatistics& s) { m_layoutStatistics = s; }
+
     void cmdSelectAll();
     void cmdSelectSection();
     void transposeSemitone(int semitone);
@@ -1141,6 +1144,7 @@ private:
 
     RootItem* m_rootItem = nullptr;
     LayoutOptions m_layoutOptions;
+    LayoutStatistics m_layoutStatistics;
 
     muse::async::Channel<EngravingItem*> m_elementDestroyed;
 
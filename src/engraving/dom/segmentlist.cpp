@@ -21,6 +21,9 @@
  */
 
 #include "segmentlist.h"
+
+#include <algorithm>
+
 #include "segment.h"
 #include "score.h"
 
@@ -138,6 +141,7 @@ void SegmentList::insert(Segment* e, Segment* el)
         e->setPrev(el->prev());
         el->prev()->setNext(e);
         el->setPrev(e);
+        m_index.insert(std::find(m_index.begin(), m_index.end(), el), e);
     }
     check();
 }
@@ -161,6 +165,10 @@ void SegmentList::remove(Segment* e)
         ASSERT_X(String(u"segment %1 not in list").arg(String::fromAscii(e->subTypeName())));
     }
 #endif
+    auto it = std::find(m_index.begin(), m_index.end(), e);
+    if (it != m_index.end()) {
+        m_index.erase(it);
+    }
     --m_size;
     if (e == m_first) {
         m_first = m_first->next();
@@ -188,6 +196,7 @@ void SegmentList::remove(Segment* e)
 void SegmentList::push_back(Segment* e)
 {
     ++m_size;
+    m_index.push_back(e);
     e->setNext(0);
     if (m_last) {
         m_last->setNext(e);
@@ -206,6 +215,7 @@ void SegmentList::push_back(Segment* e)
 void SegmentList::push_front(Segment* e)
 {
     ++m_size;
+    m_index.insert(m_index.begin(), e);
     e->setPrev(0);
     if (m_first) {
         m_first->setPrev(e);
@@ -217,6 +227,32 @@ void SegmentList::push_front(Segment* e)
     check();
 }
 
+//---------------------------------------------------------
+//   lowerBound
+///   Return the first segment with rtick not less than \a rtick.
+///   Relies on segments being sorted by rtick, as the rest of the code does.
+//---------------------------------------------------------
+
+Segment* SegmentList::lowerBound(const Fraction& rtick) const
+{
+    // walking is faster than maintaining the index for small measures
+    static constexpr int MIN_INDEXED_SIZE = 16;
+
+    if (m_size < MIN_INDEXED_SIZE) {
+        Segment* s = m_first;
+        while (s && s->rtick() < rtick) {
+            s = s->next();
+        }
+        return s;
+    }
+
+    auto it = std::lower_bound(m_index.cbegin(), m_index.cend(), rtick, [](const Segment* s, const Fraction& t) {
+        return s->rtick() < t;
+    });
+
+    return it != m_index.cend() ? *it : nullptr;
+}
+
 //---------------------------------------------------------
 //   firstCRSegment
 //---------------------------------------------------------
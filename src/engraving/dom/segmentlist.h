@@ -23,6 +23,8 @@
 #ifndef MU_ENGRAVING_SEGMENTLIST_H
 #define MU_ENGRAVING_SEGMENTLIST_H
 
+#include <vector>
+
 #include "segment.h"
 
 namespace mu::engraving {
@@ -36,7 +38,7 @@ class SegmentList
 {
 public:
     SegmentList() { clear(); }
-    void clear() { m_first = m_last = 0; m_size = 0; }
+    void clear() { m_first = m_last = 0; m_size = 0; m_index.clear(); }
 #ifndef NDEBUG
     void check();
 #else
@@ -58,6 +60,8 @@ public:
     void push_front(Segment*);
     void insert(Segment* e, Segment* el);    // insert e before el
 
+    Segment* lowerBound(const Fraction& rtick) const;   // first segment with rtick() >= rtick
+
     class iterator
     {
         Segment* p;
@@ -87,6 +91,11 @@ private:
     Segment* m_first = nullptr;          // First item of segment list
     Segment* m_last = nullptr;           // Last item of segment list
     int m_size = 0;                      // Number of items in segment list
+
+    // segments in list order, for binary search by rtick in larger measures.
+    // Only the order is kept, ticks are read from the segments themselves.
+    // Updated by every change of the list, so the const lookups never write to it
+    std::vector<Segment*> m_index;
 };
 
 // Segment* begin(SegmentList& l) { return l.first(); }
@@ -21,6 +21,9 @@
  */
 
 #include "spannermap.h"
+
+#include <algorithm>
+
 #include "spanner.h"
 #include "part.h"
 
@@ -45,34 +48,92 @@ SpannerMap::SpannerMap()
 //---------------------------------------------------------
 
 void SpannerMap::update() const
+{
+    std::lock_guard<std::mutex> lock(m_updateMutex);
+    doUpdate();
+}
+
+void SpannerMap::doUpdate() const
 {
     IntervalList regularIntervals;
     IntervalList collisionFreeIntervals;
 
     collectIntervals(regularIntervals, collisionFreeIntervals);
 
+    m_treeSize = regularIntervals.size();
     m_tree = interval_tree::IntervalTree<Spanner*>(std::move(regularIntervals));
     m_collisionFreeTree = interval_tree::IntervalTree<Spanner*>(std::move(collisionFreeIntervals));
+    m_pending.clear();
+    m_removedFromTree.clear();
     m_dirty = false;
+    m_collisionFreeDirty = false;
 }
 
 //---------------------------------------------------------
-//   findContained
+//   rebuildTree
+//   folds the pending changes into the regular tree
 //---------------------------------------------------------
 
-const SpannerMap::IntervalList& SpannerMap::findContained(int start, int stop, bool excludeCollisions) const
+void SpannerMap::rebuildTree() const
+{
+    IntervalList regularIntervals;
+    regularIntervals.reserve(size());
+
+    for (const auto& pair : *this) {
+        const Spanner* spanner = pair.second;
+        regularIntervals.emplace_back(spanner->tick().ticks(), spanner->tick2().ticks(), pair.second);
+    }
+
+    m_treeSize = regularIntervals.size();
+    m_tree = interval_tree::IntervalTree<Spanner*>(std::move(regularIntervals));
+    m_pending.clear();
+    m_removedFromTree.clear();
+}
+
+//---------------------------------------------------------
+//   ensureUpdated
+//---------------------------------------------------------
+
+void SpannerMap::ensureUpdated(bool excludeCollisions, bool foldChanges) const
 {
+    //! NOTE Queries are const and may be issued from several threads,
+    //! so the lazy rebuild must only happen once
+    std::lock_guard<std::mutex> lock(m_updateMutex);
+
     if (m_dirty) {
-        update();
+        doUpdate();
+        return;
     }
 
-    m_results.clear();
+    // The visitors scan the pending changes linearly, keep them small relative to the tree
+    const size_t maxChanges = std::max<size_t>(32, m_treeSize / 8);
+    if (foldChanges ? hasChanges() : m_pending.size() + m_removedFromTree.size() > maxChanges) {
+        rebuildTree();
+    }
 
-    if (excludeCollisions) {
-        m_results = m_collisionFreeTree.findContained(start, stop);
-    } else {
-        m_results = m_tree.findContained(start, stop);
+    if (excludeCollisions && m_collisionFreeDirty) {
+        IntervalList regularIntervals;
+        IntervalList collisionFreeIntervals;
+        collectIntervals(regularIntervals, collisionFreeIntervals);
+        m_collisionFreeTree = interval_tree::IntervalTree<Spanner*>(std::move(collisionFreeIntervals));
+        m_collisionFreeDirty = false;
     }
+}
+
+//---------------------------------------------------------
+//   findContained
+//---------------------------------------------------------
+
+const SpannerMap::IntervalList& SpannerMap::findContained(int start, int stop, bool excludeCollisions) const
+{
+    ensureUpdated(excludeCollisions, true);
+
+    m_results.clear();
+
+    const interval_tree::IntervalTree<Spanner*>& tree = excludeCollisions ? m_collisionFreeTree : m_tree;
+    tree.visit_contained(start, stop, [this](const Interval& interval) {
+        m_results.push_back(interval);
+    });
 
     return m_results;
 }
@@ -83,17 +144,14 @@ const SpannerMap::IntervalList& SpannerMap::findContained(int start, int stop, b
 
 const SpannerMap::IntervalList& SpannerMap::findOverlapping(int start, int stop, bool excludeCollisions) const
 {
-    if (m_dirty) {
-        update();
-    }
+    ensureUpdated(excludeCollisions, true);
 
     m_results.clear();
 
-    if (excludeCollisions) {
-        m_results = m_collisionFreeTree.findOverlapping(start, stop);
-    } else {
-        m_results = m_tree.findOverlapping(start, stop);
-    }
+    const interval_tree::IntervalTree<Spanner*>& tree = excludeCollisions ? m_collisionFreeTree : m_tree;
+    tree.visit_overlapping(start, stop, [this](const Interval& interval) {
+        m_results.push_back(interval);
+    });
 
     return m_results;
 }
@@ -153,7 +211,14 @@ void SpannerMap::collectIntervals(IntervalList& regularIntervals, IntervalList&
 void SpannerMap::addSpanner(Spanner* s)
 {
     insert(std::pair<int, Spanner*>(s->tick().ticks(), s));
-    m_dirty = true;
+
+    if (m_bulkInsertLevel > 0 || m_dirty) {
+        m_dirty = true;
+        return;
+    }
+
+    m_pending.emplace_back(s->tick().ticks(), s->tick2().ticks(), s);
+    m_collisionFreeDirty = true;
 }
 
 //---------------------------------------------------------
@@ -165,7 +230,23 @@ bool SpannerMap::removeSpanner(Spanner* s)
     for (auto i = begin(); i != end(); ++i) {
         if (i->second == s) {
             erase(i);
-            m_dirty = true;
+
+            if (m_bulkInsertLevel > 0 || m_dirty) {
+                m_dirty = true;
+                return true;
+            }
+
+            auto pendingIt = std::find_if(m_pending.begin(), m_pending.end(), [s](const Interval& interval) {
+                return interval.value == s;
+            });
+
+            if (pendingIt != m_pending.end()) {
+                m_pending.erase(pendingIt);
+            } else {
+                m_removedFromTree.insert(s);
+            }
+
+            m_collisionFreeDirty = true;
             return true;
         }
     }
@@ -173,6 +254,30 @@ bool SpannerMap::removeSpanner(Spanner* s)
     return false;
 }
 
+//---------------------------------------------------------
+//   beginBulkInsert
+//---------------------------------------------------------
+
+void SpannerMap::beginBulkInsert()
+{
+    ++m_bulkInsertLevel;
+}
+
+//---------------------------------------------------------
+//   endBulkInsert
+//---------------------------------------------------------
+
+void SpannerMap::endBulkInsert()
+{
+    IF_ASSERT_FAILED(m_bulkInsertLevel > 0) {
+        return;
+    }
+
+    if (--m_bulkInsertLevel == 0 && m_dirty) {
+        update();
+    }
+}
+
 #ifndef NDEBUG
 //---------------------------------------------------------
 //   dump
@@ -24,6 +24,8 @@
 #define MU_ENGRAVING_SPANNERMAP_H
 
 #include <map>
+#include <mutex>
+#include <unordered_set>
 
 #include "thirdparty/intervaltree/IntervalTree.h"
 
@@ -44,8 +46,20 @@ public:
 
     SpannerMap();
 
+    //! NOTE The intervals are in the order of a lookup tree built from the whole map, whatever the edits
+    //! since the last update, so the changes made since then are folded into the tree first.
+    //! The returned list is reused by the next query: use the visitors to query the map from several threads
     const IntervalList& findContained(int start, int stop, bool excludeCollisions = false) const;
     const IntervalList& findOverlapping(int start, int stop, bool excludeCollisions = false) const;
+
+    //! NOTE Same as above, but calls func(const Interval&) for every match instead of collecting them.
+    //! The changes made since the last update are not folded into the tree but visited last, so the order
+    //! depends on the edits. Several threads may visit the map at the same time as long as nobody modifies it
+    template<typename Func>
+    void visitContained(int start, int stop, Func func, bool excludeCollisions = false) const;
+    template<typename Func>
+    void visitOverlapping(int start, int stop, Func func, bool excludeCollisions = false) const;
+
     const std::multimap<int, Spanner*>& map() const { return *this; }
 
     void collectIntervals(IntervalList& regularIntervals, IntervalList& collisionFreeIntervals) const;
@@ -60,17 +74,86 @@ public:
     bool empty() const { return std::multimap<int, Spanner*>::empty(); }
     void update() const;
     void setDirty() const { m_dirty = true; }     // must be called if a spanner changes start/length
+
+    //! NOTE Between these calls added and removed spanners are only stored in the map,
+    //! the lookup trees are built once by endBulkInsert() (used by the file readers)
+    void beginBulkInsert();
+    void endBulkInsert();
 #ifndef NDEBUG
     void dump() const;
 #endif
 
 private:
+    using Interval = interval_tree::Interval<Spanner*>;
 
-    mutable bool m_dirty = false;
+    void ensureUpdated(bool excludeCollisions, bool foldChanges) const;
+    void doUpdate() const;
+    void rebuildTree() const;
+    bool hasChanges() const { return !m_pending.empty() || !m_removedFromTree.empty(); }
+    bool isRemovedFromTree(const Spanner* s) const { return !m_removedFromTree.empty() && m_removedFromTree.count(s) > 0; }
+
+    mutable bool m_dirty = false;                   // both trees must be rebuilt from scratch
+    mutable bool m_collisionFreeDirty = false;      // collision free intervals depend on the neighbours, so no incremental updates here
     mutable interval_tree::IntervalTree<Spanner*> m_tree;
     mutable interval_tree::IntervalTree<Spanner*> m_collisionFreeTree;
-    mutable std::vector<interval_tree::Interval<Spanner*> > m_results;
+
+    // Changes made since m_tree was built. Queries merge them into the tree results
+    // until there are too many of them and the tree gets rebuilt
+    mutable size_t m_treeSize = 0;
+    mutable IntervalList m_pending;
+    mutable std::unordered_set<const Spanner*> m_removedFromTree;
+
+    mutable IntervalList m_results;
+
+    mutable std::mutex m_updateMutex;
+    int m_bulkInsertLevel = 0;
 };
+
+template<typename Func>
+void SpannerMap::visitContained(int start, int stop, Func func, bool excludeCollisions) const
+{
+    ensureUpdated(excludeCollisions, false);
+
+    if (excludeCollisions) {
+        m_collisionFreeTree.visit_contained(start, stop, func);
+        return;
+    }
+
+    m_tree.visit_contained(start, stop, [&](const Interval& interval) {
+        if (!isRemovedFromTree(interval.value)) {
+            func(interval);
+        }
+    });
+
+    for (const Interval& interval : m_pending) {
+        if (interval.start >= start && interval.stop <= stop) {
+            func(interval);
+        }
+    }
+}
+
+template<typename Func>
+void SpannerMap::visitOverlapping(int start, int stop, Func func, bool excludeCollisions) const
+{
+    ensureUpdated(excludeCollisions, false);
+
+    if (excludeCollisions) {
+        m_collisionFreeTree.visit_overlapping(start, stop, func);
+        return;
+    }
+
+    m_tree.visit_overlapping(start, stop, [&](const Interval& interval) {
+        if (!isRemovedFromTree(interval.value)) {
+            func(interval);
+        }
+    });
+
+    for (const Interval& interval : m_pending) {
+        if (interval.stop >= start && interval.start <= stop) {
+            func(interval);
+        }
+    }
+}
 } // namespace mu::engraving
 
 #endif
@@ -22,6 +22,9 @@
 
 #include "tempo.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "types/constants.h"
 
 #include "global/containers.h"
@@ -91,7 +94,7 @@ void TempoMap::setPause(int tick, double pause)
     }
 
     m_pauses[tick] = pause;
-    normalize();
+    normalize(tick);
 }
 
 //---------------------------------------------------------
@@ -110,7 +113,19 @@ void TempoMap::setTempo(int tick, BeatsPerSecond tempo)
     } else {
         insert(std::pair<const int, TEvent>(tick, TEvent(tempo, 0.0, TempoType::FIX)));
     }
-    normalize();
+    normalize(tick);
+}
+
+//---------------------------------------------------------
+//   insertEvent
+//---------------------------------------------------------
+
+void TempoMap::insertEvent(int tick, const TEvent& event)
+{
+    if (!insert(std::pair<const int, TEvent>(tick, event)).second) {
+        return;
+    }
+    normalize(tick);
 }
 
 //---------------------------------------------------------
@@ -119,10 +134,39 @@ void TempoMap::setTempo(int tick, BeatsPerSecond tempo)
 
 void TempoMap::normalize()
 {
+    m_segments.clear();
+    normalize(empty() ? 0 : begin()->first);
+}
+
+//---------------------------------------------------------
+//   TempoMap::normalize
+//    Recomputes the events from the given tick on,
+//    the ones before it are left alone
+//---------------------------------------------------------
+
+void TempoMap::normalize(int fromTick)
+{
+    auto e = lower_bound(fromTick);
+    size_t idx = std::lower_bound(m_segments.ticks.begin(), m_segments.ticks.end(), fromTick) - m_segments.ticks.begin();
+
     double time  = 0;
     int tick    = 0;
     BeatsPerSecond tempo = 2.0;
-    for (auto e = begin(); e != end(); ++e) {
+    if (idx > 0) {
+        time  = m_segments.times[idx - 1];
+        tick  = m_segments.ticks[idx - 1];
+        tempo = m_segments.tempos[idx - 1];
+    }
+
+    for (; e != end(); ++e, ++idx) {
+        // keep the arrays in sync with the events inserted or removed at the tick
+        while (idx < m_segments.size() && m_segments.ticks[idx] < e->first) {
+            m_segments.erase(idx, idx + 1);
+        }
+        if (idx == m_segments.size() || m_segments.ticks[idx] != e->first) {
+            m_segments.insert(idx, e->first);
+        }
+
         // entries that represent a pause *only* (not tempo change also)
         // need to be corrected to continue previous tempo
         if (!(e->second.type & (TempoType::FIX | TempoType::RAMP))) {
@@ -134,7 +178,14 @@ void TempoMap::normalize()
         e->second.time = time;
         tick  = e->first;
         tempo = e->second.tempo.val;
+
+        m_segments.times[idx] = time;
+        m_segments.pauses[idx] = e->second.pause;
+        m_segments.tempos[idx] = tempo.val;
     }
+
+    m_segments.erase(idx, m_segments.size());
+
     ++m_tempoSN;
 }
 
@@ -158,6 +209,7 @@ void TempoMap::dump() const
 void TempoMap::clear()
 {
     std::map<int, TEvent>::clear();
+    m_segments.clear();
     m_pauses.clear();
     ++m_tempoSN;
 }
@@ -183,7 +235,7 @@ void TempoMap::clearRange(int tick1, int tick2)
     }
 
     erase(first, last);
-    ++m_tempoSN;
+    normalize(tick1);
 }
 
 //---------------------------------------------------------
@@ -192,30 +244,10 @@ void TempoMap::clearRange(int tick1, int tick2)
 
 BeatsPerSecond TempoMap::tempo(int tick) const
 {
-    auto findTempo = [this](int tick) -> BeatsPerSecond {
-        if (empty()) {
-            return 2.0;
-        }
-
-        auto i = lower_bound(tick);
-        if (i == end()) {
-            --i;
-            return i->second.tempo;
-        }
+    size_t idx = segmentIndex(tick);
+    BeatsPerSecond tempo = idx == muse::nidx ? 2.0 : m_segments.tempos[idx];
 
-        if (i->first == tick) {
-            return i->second.tempo;
-        }
-
-        if (i == begin()) {
-            return 2.0;
-        }
-
-        --i;
-        return i->second.tempo;
-    };
-
-    return findTempo(tick) * m_tempoMultiplier;
+    return tempo * m_tempoMultiplier;
 }
 
 double TempoMap::pauseSecs(int tick) const
@@ -241,7 +273,7 @@ void TempoMap::del(int tick)
     } else {
         erase(e);
     }
-    normalize();
+    normalize(tick);
 }
 
 BeatsPerSecond TempoMap::tempoMultiplier() const
@@ -294,6 +326,21 @@ int TempoMap::time2tick(double time, int t, int* sn) const
     return (*sn == m_tempoSN) ? t : time2tick(time, sn);
 }
 
+//---------------------------------------------------------
+//   segmentIndex
+//    the last segment starting at the tick or before it,
+//    nidx if there is none
+//---------------------------------------------------------
+
+size_t TempoMap::segmentIndex(int tick) const
+{
+    auto it = std::upper_bound(m_segments.ticks.begin(), m_segments.ticks.end(), tick);
+    if (it == m_segments.ticks.begin()) {
+        return muse::nidx;
+    }
+    return (it - m_segments.ticks.begin()) - 1;
+}
+
 //---------------------------------------------------------
 //   tick2time
 //---------------------------------------------------------
@@ -301,40 +348,68 @@ int TempoMap::time2tick(double time, int t, int* sn) const
 double TempoMap::tick2time(int tick, int* sn) const
 {
     double time  = 0.0;
-    double delta = double(tick);
-    BeatsPerSecond tempo = 2.0;
+    int ptick    = 0;
+    double tempo = 2.0;
 
     if (!empty()) {
-        int ptick  = 0;
-        auto e = lower_bound(tick);
-        if (e == end()) {
-            auto pe = e;
-            --pe;
-            ptick = pe->first;
-            tempo = pe->second.tempo;
-            time  = pe->second.time;
-        } else if (e->first == tick) {
-            ptick = tick;
-            tempo = e->second.tempo;
-            time  = e->second.time;
-        } else if (e != begin()) {
-            auto pe = e;
-            --pe;
-            ptick = pe->first;
-            tempo = pe->second.tempo;
-            time  = pe->second.time;
+        size_t idx = segmentIndex(tick);
+        if (idx != muse::nidx) {
+            ptick = m_segments.ticks[idx];
+            tempo = m_segments.tempos[idx];
+            time  = m_segments.times[idx];
         }
-        delta = double(tick - ptick);
     } else {
         LOGD("TempoMap: empty");
     }
     if (sn) {
         *sn = m_tempoSN;
     }
-    time += delta / (Constants::DIVISION * tempo.val * m_tempoMultiplier.val);
+    double delta = double(tick - ptick);
+    time += delta / (Constants::DIVISION * tempo * m_tempoMultiplier.val);
     return time;
 }
 
+//---------------------------------------------------------
+//   tick2time
+//    Converts count ticks into the times given by the caller.
+//    The ticks in a row which fall in the same segment are converted
+//    in one loop, sorted ticks are converted in linear time
+//---------------------------------------------------------
+
+void TempoMap::tick2time(const int* tickData, double* timeData, size_t count) const
+{
+    size_t i = 0;
+    while (i < count) {
+        size_t idx = segmentIndex(tickData[i]);
+
+        int ptick    = 0;
+        double tempo = 2.0;
+        double time  = 0.0;
+        int startTick = std::numeric_limits<int>::min();
+        if (idx != muse::nidx) {
+            ptick = m_segments.ticks[idx];
+            tempo = m_segments.tempos[idx];
+            time  = m_segments.times[idx];
+            startTick = ptick;
+        }
+
+        const size_t nextIdx = idx == muse::nidx ? 0 : idx + 1;
+        const int endTick = nextIdx < m_segments.size() ? m_segments.ticks[nextIdx] : std::numeric_limits<int>::max();
+
+        size_t last = i + 1;
+        while (last < count && tickData[last] >= startTick && tickData[last] < endTick) {
+            ++last;
+        }
+
+        const double divisor = Constants::DIVISION * tempo * m_tempoMultiplier.val;
+        for (size_t j = i; j < last; ++j) {
+            timeData[j] = time + double(tickData[j] - ptick) / divisor;
+        }
+
+        i = last;
+    }
+}
+
 //---------------------------------------------------------
 //   time2tick
 //---------------------------------------------------------
@@ -342,29 +417,59 @@ double TempoMap::tick2time(int tick, int* sn) const
 int TempoMap::time2tick(double time, int* sn) const
 {
     int tick     = 0;
-    double delta = time;
-    BeatsPerSecond tempo = m_tempo;
-
-    delta = 0.0;
-    tempo = 2.0;
-    for (auto e = begin(); e != end(); ++e) {
-        // if in a pause period, wait on previous tick
-        if ((time <= e->second.time) && (time > e->second.time - e->second.pause)) {
-            delta = (time - (e->second.time - e->second.pause) + delta);
-            break;
-        }
-        if (e->second.time >= time) {
-            break;
-        }
-        delta = e->second.time;
-        tick  = e->first;
-        tempo = e->second.tempo;
+    double delta = 0.0;
+    double tempo = 2.0;
+
+    // the first segment which ends at the time or after it
+    const size_t idx = std::lower_bound(m_segments.times.begin(), m_segments.times.end(), time) - m_segments.times.begin();
+    if (idx > 0) {
+        delta = m_segments.times[idx - 1];
+        tick  = m_segments.ticks[idx - 1];
+        tempo = m_segments.tempos[idx - 1];
     }
+
+    // if in a pause period, wait on previous tick
+    if (idx < m_segments.size() && time > m_segments.times[idx] - m_segments.pauses[idx]) {
+        delta = (time - (m_segments.times[idx] - m_segments.pauses[idx]) + delta);
+    }
+
     delta = time - delta;
-    tick += lrint(delta * m_tempoMultiplier.val * Constants::DIVISION * tempo.val);
+    tick += lrint(delta * m_tempoMultiplier.val * Constants::DIVISION * tempo);
     if (sn) {
         *sn = m_tempoSN;
     }
     return tick;
 }
+
+//---------------------------------------------------------
+//   Segments
+//---------------------------------------------------------
+
+void TempoMap::Segments::insert(size_t idx, int tick)
+{
+    ticks.insert(ticks.begin() + idx, tick);
+    times.insert(times.begin() + idx, 0.0);
+    pauses.insert(pauses.begin() + idx, 0.0);
+    tempos.insert(tempos.begin() + idx, 0.0);
+}
+
+void TempoMap::Segments::erase(size_t first, size_t last)
+{
+    if (first >= last) {
+        return;
+    }
+
+    ticks.erase(ticks.begin() + first, ticks.begin() + last);
+    times.erase(times.begin() + first, times.begin() + last);
+    pauses.erase(pauses.begin() + first, pauses.begin() + last);
+    tempos.erase(tempos.begin() + first, tempos.begin() + last);
+}
+
+void TempoMap::Segments::clear()
+{
+    ticks.clear();
+    times.clear();
+    pauses.clear();
+    tempos.clear();
+}
 }
@@ -25,6 +25,7 @@
 
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 #include "global/allocator.h"
 #include "types/bps.h"
@@ -64,6 +65,9 @@ struct TEvent {
 
 //---------------------------------------------------------
 //   Tempomap
+//    The events are mirrored as flat arrays in the order of the ticks,
+//    which the conversions search. The events must be changed through
+//    the TempoMap methods, which keep the arrays in sync.
 //---------------------------------------------------------
 
 class TempoMap : public std::map<int, TEvent>
@@ -82,6 +86,7 @@ public:
 
     double tick2time(int tick, int* sn = 0) const;
     double tick2time(int tick, double time, int* sn) const;
+    void tick2time(const int* ticks, double* times, size_t count) const;
     int time2tick(double time, int* sn = 0) const;
     int time2tick(double time, int tick, int* sn) const;
     int tempoSN() const { return m_tempoSN; }
@@ -90,14 +95,35 @@ public:
     void setPause(int t, double);
     void delTempo(int tick);
 
+    //! NOTE Inserts the event as is, unless there is one at the tick already
+    void insertEvent(int tick, const TEvent& event);
+
     BeatsPerSecond tempoMultiplier() const;
     bool setTempoMultiplier(BeatsPerSecond val);
 
 private:
 
+    //! NOTE The events as structure of arrays, the time is the one at the tick, after the pause
+    struct Segments {
+        std::vector<int> ticks;
+        std::vector<double> times;
+        std::vector<double> pauses;
+        std::vector<double> tempos;
+
+        size_t size() const { return ticks.size(); }
+        void insert(size_t idx, int tick);
+        void erase(size_t first, size_t last);
+        void clear();
+    };
+
     void normalize();
+    void normalize(int tick);
     void del(int tick);
 
+    size_t segmentIndex(int tick) const;
+
+    Segments m_segments;
+
     int m_tempoSN = 0; // serial no to track tempo changes
     BeatsPerSecond m_tempo; // tempo if not using tempo list (beats per second)
     BeatsPerSecond m_tempoMultiplier;
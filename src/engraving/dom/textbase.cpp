@@ -2532,6 +2532,15 @@ String TextBase::plainText() const
     return s;
 }
 
+//---------------------------------------------------------
+//   heapSize
+//---------------------------------------------------------
+
+size_t TextBase::heapSize() const
+{
+    return EngravingItem::heapSize() + m_text.size() * sizeof(char16_t);
+}
+
 //---------------------------------------------------------
 //   xmlText
 //---------------------------------------------------------
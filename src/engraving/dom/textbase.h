@@ -318,6 +318,8 @@ public:
     void checkCustomFormatting(const String&);
     String xmlText() const;
     String plainText() const;
+
+    size_t heapSize() const override;
     void resetFormatting();
 
     void insertText(EditData&, const String&);
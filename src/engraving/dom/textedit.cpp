@@ -113,6 +113,7 @@ void TextBase::startEdit(EditData& ed)
 
     ted->oldXmlText = xmlText();
     ted->startUndoIdx = score()->undoStack()->getCurIdx();
+    score()->undoStack()->lockCompaction();         // keep startUndoIdx valid until endEdit
 
     const LayoutData* ldata = this->ldata();
     if (!ldata || ldata->layoutInvalid) {
@@ -135,18 +136,22 @@ void TextBase::startEdit(EditData& ed)
 
 void TextBase::endEdit(EditData& ed)
 {
-    TextEditData* ted = static_cast<TextEditData*>(ed.getData(this).get());
-    IF_ASSERT_FAILED(ted && ted->cursor()) {
+    UndoStack* undo = score()->undoStack();
+    IF_ASSERT_FAILED(undo) {
         return;
     }
 
-    ted->cursor()->endEdit();
+    //! NOTE Unlocked before any return, see startEdit. No macro is ended before the last use of startUndoIdx below,
+    //! so the history is not compacted meanwhile
+    undo->unlockCompaction();
 
-    UndoStack* undo = score()->undoStack();
-    IF_ASSERT_FAILED(undo) {
+    TextEditData* ted = static_cast<TextEditData*>(ed.getData(this).get());
+    IF_ASSERT_FAILED(ted && ted->cursor()) {
         return;
     }
 
+    ted->cursor()->endEdit();
+
     const String actualXmlText = xmlText();
     const String actualPlainText = plainText();
 
@@ -111,6 +111,50 @@ static std::vector<const EngravingObject*> compoundObjects(const EngravingObject
     return objects;
 }
 
+//---------------------------------------------------------
+//   objectTreeSizeBytes
+//    memory of an object which is not in the score
+//    anymore, with all of its children
+//---------------------------------------------------------
+
+static size_t objectTreeSizeBytes(const EngravingObject* object)
+{
+    size_t bytes = object->objectSize() + object->heapSize();
+    for (const EngravingObject* child : object->children()) {
+        bytes += objectTreeSizeBytes(child);
+    }
+    return bytes;
+}
+
+//---------------------------------------------------------
+//   propertyValueSizeBytes
+//    the value data is shared between the copies of
+//    a value, so this is an upper bound
+//---------------------------------------------------------
+
+static size_t propertyValueSizeBytes(const PropertyValue& value)
+{
+    if (!value.isValid()) {
+        return 0;
+    }
+
+    // the control block and the boxed value, an estimate
+    static constexpr size_t VALUE_DATA_BYTES = 64;
+
+    size_t bytes = VALUE_DATA_BYTES;
+    switch (value.type()) {
+    case P_TYPE::STRING:
+        bytes += value.value<String>().size() * sizeof(char16_t);
+        break;
+    case P_TYPE::INT_VEC:
+        bytes += value.value<std::vector<int> >().size() * sizeof(int);
+        break;
+    default:
+        break;
+    }
+    return bytes;
+}
+
 //---------------------------------------------------------
 //   updateNoteLines
 //    compute line position of noteheads after
@@ -182,6 +226,19 @@ void UndoCommand::cleanup(bool undo)
     }
 }
 
+//---------------------------------------------------------
+//   UndoCommand::sizeBytes
+//---------------------------------------------------------
+
+size_t UndoCommand::sizeBytes() const
+{
+    size_t bytes = objectSize();
+    for (const UndoCommand* c : childList) {
+        bytes += c->sizeBytes();
+    }
+    return bytes;
+}
+
 //---------------------------------------------------------
 //   undo
 //---------------------------------------------------------
@@ -221,6 +278,104 @@ void UndoCommand::appendChildren(UndoCommand* other)
     other->childList.clear();
 }
 
+//---------------------------------------------------------
+//   coalescableChangeProperty
+//---------------------------------------------------------
+
+static const ChangeProperty* coalescableChangeProperty(const UndoCommand* cmd)
+{
+    if (cmd->type() != CommandType::ChangeProperty) {
+        return nullptr;
+    }
+
+    const ChangeProperty* change = static_cast<const ChangeProperty*>(cmd);
+    return change->canBeCoalesced() ? change : nullptr;
+}
+
+//---------------------------------------------------------
+//   visitCompactedChildren
+///   Calls \p func(cmd, coalesced) for each of the
+///   \p appended commands in order. In a run of property
+///   changes, a change which follows the change of the same
+///   property of the same object is coalesced: undo of the
+///   first change restores the value from before both, and
+///   its redo restores the value from after both.
+//---------------------------------------------------------
+
+template<typename Func>
+static void visitCompactedChildren(const std::list<UndoCommand*>& children, const std::list<UndoCommand*>& appended, Func func)
+{
+    // the last change of each object in the run at the end of the children
+    std::unordered_map<const EngravingObject*, const ChangeProperty*> lastChanges;
+    for (auto it = children.rbegin(); it != children.rend(); ++it) {
+        const ChangeProperty* change = coalescableChangeProperty(*it);
+        if (!change) {
+            break;
+        }
+        lastChanges.emplace(change->getElement(), change);
+    }
+
+    for (UndoCommand* cmd : appended) {
+        const ChangeProperty* change = coalescableChangeProperty(cmd);
+        if (!change) {
+            lastChanges.clear();
+            func(cmd, false);
+            continue;
+        }
+
+        auto it = lastChanges.find(change->getElement());
+        if (it != lastChanges.end() && it->second->getId() == change->getId()) {
+            func(cmd, true);
+            continue;
+        }
+
+        lastChanges[change->getElement()] = change;
+        func(cmd, false);
+    }
+}
+
+//---------------------------------------------------------
+//   appendChildrenCompacted
+///   Append children of \p other into this UndoCommand,
+///   both being in the done state, the coalesced property
+///   changes are dropped (see visitCompactedChildren).
+///   Returns the size of the dropped commands.
+//---------------------------------------------------------
+
+size_t UndoCommand::appendChildrenCompacted(UndoCommand* other)
+{
+    size_t droppedBytes = 0;
+    visitCompactedChildren(childList, other->childList, [this, &droppedBytes](UndoCommand* cmd, bool coalesced) {
+        if (coalesced) {
+            droppedBytes += cmd->sizeBytes();
+            delete cmd;
+        } else {
+            childList.push_back(cmd);
+        }
+    });
+    other->childList.clear();
+
+    return droppedBytes;
+}
+
+//---------------------------------------------------------
+//   compactedChildrenBytes
+///   The size of the children of \p other which
+///   appendChildrenCompacted would drop
+//---------------------------------------------------------
+
+size_t UndoCommand::compactedChildrenBytes(const UndoCommand* other) const
+{
+    size_t droppedBytes = 0;
+    visitCompactedChildren(childList, other->childList, [&droppedBytes](const UndoCommand* cmd, bool coalesced) {
+        if (coalesced) {
+            droppedBytes += cmd->sizeBytes();
+        }
+    });
+
+    return droppedBytes;
+}
+
 //---------------------------------------------------------
 //   hasFilteredChildren
 //---------------------------------------------------------
@@ -426,6 +581,7 @@ void UndoStack::mergeCommands(size_t startIdx)
         startMacro->append(std::move(*list[idx]));
     }
     remove(startIdx + 1);   // TODO: remove from startIdx to curIdx only
+    startMacro->updateSizeBytes();
 }
 
 //---------------------------------------------------------
@@ -468,11 +624,91 @@ void UndoStack::endMacro(bool rollback)
             cmd->cleanup(false);        // delete elements for which UndoCommand() holds ownership
             delete cmd;
         }
+        curCmd->updateSizeBytes();
         list.push_back(curCmd);
         stateList.push_back(nextState++);
         ++curIdx;
     }
     curCmd = 0;
+
+    if (!rollback) {
+        compactHistory();
+    }
+}
+
+//---------------------------------------------------------
+//   compactHistory
+//    merge the oldest done macros into the first one while
+//    the history is over the budget; the newest macros and
+//    the redo stack are kept as they are
+//---------------------------------------------------------
+
+void UndoStack::compactHistory()
+{
+    const size_t limitBytes = MScore::undoHistoryLimitBytes;
+    if (limitBytes == 0 || m_compactionLocks > 0) {
+        return;
+    }
+
+    size_t bytes = historyBytes();
+    while (bytes > limitBytes && curIdx > UNCOMPACTED_MACRO_COUNT + 1) {
+        UndoMacro* first = list[0];
+        UndoMacro* next = list[1];
+
+        //! NOTE Merging only saves the coalesced property changes, the steps are kept apart when it saves nothing
+        if (first->compactedBytes(*next) == 0) {
+            break;
+        }
+
+        bytes -= first->cachedSizeBytes() + next->cachedSizeBytes();
+        first->appendCompacted(std::move(*next));
+        bytes += first->cachedSizeBytes();
+
+        delete next;
+        list.erase(list.begin() + 1);
+        stateList.erase(stateList.begin() + 1);     // the clean state may be lost, it can't be reached anymore
+        --curIdx;
+        ++m_compactedMacroCount;
+    }
+}
+
+//---------------------------------------------------------
+//   unlockCompaction
+//---------------------------------------------------------
+
+void UndoStack::unlockCompaction()
+{
+    IF_ASSERT_FAILED(m_compactionLocks > 0) {
+        return;
+    }
+
+    --m_compactionLocks;
+}
+
+//---------------------------------------------------------
+//   historyBytes
+//---------------------------------------------------------
+
+size_t UndoStack::historyBytes() const
+{
+    size_t bytes = 0;
+    for (const UndoMacro* macro : list) {
+        bytes += macro->cachedSizeBytes();
+    }
+    return bytes;
+}
+
+UndoStack::HistoryStats UndoStack::historyStats() const
+{
+    HistoryStats stats;
+    stats.macroCount = list.size();
+    stats.bytes = historyBytes();
+    stats.limitBytes = MScore::undoHistoryLimitBytes;
+    stats.compactedMacroCount = m_compactedMacroCount;
+    for (const UndoMacro* macro : list) {
+        stats.compactedCommandCount += macro->compactedCommandCount();
+    }
+    return stats;
 }
 
 //---------------------------------------------------------
@@ -617,6 +853,16 @@ bool UndoMacro::empty() const
     return childCount() == 0;
 }
 
+size_t UndoMacro::sizeBytes() const
+{
+    return UndoCommand::sizeBytes() - objectSize() + ownSizeBytes();
+}
+
+size_t UndoMacro::ownSizeBytes() const
+{
+    return objectSize() + (m_undoSelectionInfo.elements.size() + m_redoSelectionInfo.elements.size()) * sizeof(EngravingItem*);
+}
+
 void UndoMacro::append(UndoMacro&& other)
 {
     appendChildren(&other);
@@ -626,6 +872,29 @@ void UndoMacro::append(UndoMacro&& other)
     }
 }
 
+//---------------------------------------------------------
+//   appendCompacted
+//    used by the compaction of the undo history,
+//    both macros are in the done state
+//---------------------------------------------------------
+
+void UndoMacro::appendCompacted(UndoMacro&& other)
+{
+    const size_t childrenBytes = other.m_sizeBytes - other.ownSizeBytes();
+    const size_t oldOwnBytes = ownSizeBytes();
+    const size_t childCountBefore = childCount() + other.childCount();
+
+    const size_t droppedBytes = appendChildrenCompacted(&other);
+    m_compactedCommandCount += other.m_compactedCommandCount + childCountBefore - childCount();
+
+    if (m_score == other.m_score) {
+        m_redoInputState = std::move(other.m_redoInputState);
+        m_redoSelectionInfo = std::move(other.m_redoSelectionInfo);
+    }
+
+    m_sizeBytes = m_sizeBytes - oldOwnBytes + ownSizeBytes() + childrenBytes - droppedBytes;
+}
+
 const InputState& UndoMacro::undoInputState() const
 {
     return m_undoInputState;
@@ -1072,6 +1341,16 @@ void RemoveElement::cleanup(bool undo)
     }
 }
 
+//---------------------------------------------------------
+//   sizeBytes
+//    the removed element is owned by the command
+//---------------------------------------------------------
+
+size_t RemoveElement::sizeBytes() const
+{
+    return UndoCommand::sizeBytes() + (element ? objectTreeSizeBytes(element) : 0);
+}
+
 //---------------------------------------------------------
 //   undo
 //---------------------------------------------------------
@@ -2032,6 +2311,15 @@ static void changeStyleValue(Score* score, Sid idx, const PropertyValue& oldValu
     }
 }
 
+size_t ChangeStyleValues::sizeBytes() const
+{
+    size_t bytes = UndoCommand::sizeBytes();
+    for (const auto& pair : m_values) {
+        bytes += sizeof(pair) + propertyValueSizeBytes(pair.second);
+    }
+    return bytes;
+}
+
 void ChangeStyleValues::flip(EditData*)
 {
     if (!m_score) {
@@ -2300,6 +2588,32 @@ void InsertRemoveMeasures::insertMeasures()
     }
 }
 
+//---------------------------------------------------------
+//   measuresSizeBytes
+//---------------------------------------------------------
+
+size_t InsertRemoveMeasures::measuresSizeBytes() const
+{
+    size_t bytes = 0;
+    for (const MeasureBase* mb = fm; mb; mb = mb->next()) {
+        bytes += objectTreeSizeBytes(mb);
+        if (mb == lm) {
+            break;
+        }
+    }
+    return bytes;
+}
+
+//---------------------------------------------------------
+//   RemoveMeasures::sizeBytes
+//    the removed measures are owned by the command
+//---------------------------------------------------------
+
+size_t RemoveMeasures::sizeBytes() const
+{
+    return UndoCommand::sizeBytes() + measuresSizeBytes();
+}
+
 //---------------------------------------------------------
 //   removeMeasures
 //---------------------------------------------------------
@@ -2721,6 +3035,11 @@ std::vector<const EngravingObject*> ChangeProperty::objectItems() const
     return compoundObjects(element);
 }
 
+size_t ChangeProperty::sizeBytes() const
+{
+    return UndoCommand::sizeBytes() + propertyValueSizeBytes(property);
+}
+
 //---------------------------------------------------------
 //   ChangeBracketProperty::flip
 //---------------------------------------------------------
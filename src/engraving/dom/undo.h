@@ -98,7 +98,9 @@ class TremoloBar;
 enum class PlayEventType : char;
 
 #define UNDO_TYPE(t) CommandType type() const override { return t; }
-#define UNDO_NAME(a) const char* name() const override { return a; }
+#define UNDO_NAME(a) \
+    const char* name() const override { return a; } \
+    size_t objectSize() const override { return sizeof(*this); }
 #define UNDO_CHANGED_OBJECTS(...) std::vector<const EngravingObject*> objectItems() const override { return __VA_ARGS__; }
 
 class UndoCommand
@@ -110,6 +112,8 @@ class UndoCommand
 protected:
     virtual void flip(EditData*) {}
     void appendChildren(UndoCommand*);
+    size_t appendChildrenCompacted(UndoCommand*);
+    size_t compactedChildrenBytes(const UndoCommand*) const;
 
 public:
     enum class Filter {
@@ -132,6 +136,11 @@ public:
     const std::list<UndoCommand*>& commands() const { return childList; }
     virtual std::vector<const EngravingObject*> objectItems() const { return {}; }
     virtual void cleanup(bool undo);
+    //! NOTE Size of the command class, see UNDO_NAME
+    virtual size_t objectSize() const { return sizeof(UndoCommand); }
+    //! NOTE Memory held by the command and its children in the done state
+    //! (ex. the removed elements), used for the undo history budget
+    virtual size_t sizeBytes() const;
 // #ifndef QT_NO_DEBUG
     virtual const char* name() const { return "UndoCommand"; }
 // #endif
@@ -168,6 +177,8 @@ public:
     void redo(EditData*) override;
     bool empty() const;
     void append(UndoMacro&& other);
+    void appendCompacted(UndoMacro&& other);
+    size_t compactedBytes(const UndoMacro& other) const { return compactedChildrenBytes(&other); }
 
     const InputState& undoInputState() const;
     const InputState& redoInputState() const;
@@ -183,6 +194,11 @@ public:
 
     ChangesInfo changesInfo() const;
 
+    size_t sizeBytes() const override;
+    size_t cachedSizeBytes() const { return m_sizeBytes; }
+    void updateSizeBytes() { m_sizeBytes = sizeBytes(); }
+    size_t compactedCommandCount() const { return m_compactedCommandCount; }
+
     static bool canRecordSelectedElement(const EngravingItem* e);
 
     UNDO_NAME("UndoMacro")
@@ -194,6 +210,10 @@ private:
     SelectionInfo m_redoSelectionInfo;
 
     Score* m_score = nullptr;
+    size_t m_sizeBytes = 0;
+    size_t m_compactedCommandCount = 0;
+
+    size_t ownSizeBytes() const;
 
     static void fillSelectionInfo(SelectionInfo&, const Selection&);
     static void applySelectionInfo(const SelectionInfo&, Selection&);
@@ -209,9 +229,29 @@ class UndoStack
     size_t curIdx = 0;
     bool isLocked = false;
 
+    //! NOTE To stay within MScore::undoHistoryLimitBytes, the oldest macros are merged into the first one:
+    //! they are undone and redone together, nothing is lost. It only frees the repeated property changes,
+    //! the removed elements and the other commands are kept in memory: there is no eviction of the history yet,
+    //! so the limit is off by default. The compaction changes the indexes of the macros,
+    //! so it waits while someone holds an index (see getCurIdx and mergeCommands)
+    size_t m_compactionLocks = 0;
+    size_t m_compactedMacroCount = 0;
+
     void remove(size_t idx);
+    void compactHistory();
 
 public:
+    //! NOTE The newest undo steps which are never merged by the compaction
+    static constexpr size_t UNCOMPACTED_MACRO_COUNT = 20;
+
+    struct HistoryStats {
+        size_t macroCount = 0;
+        size_t bytes = 0;
+        size_t limitBytes = 0;
+        size_t compactedMacroCount = 0;
+        size_t compactedCommandCount = 0;
+    };
+
     UndoStack();
     ~UndoStack();
 
@@ -236,6 +276,12 @@ public:
 
     void mergeCommands(size_t startIdx);
     void cleanRedoStack() { remove(curIdx); }
+
+    void lockCompaction() { ++m_compactionLocks; }
+    void unlockCompaction();
+
+    size_t historyBytes() const;
+    HistoryStats historyStats() const;
 };
 
 class InsertPart : public UndoCommand
@@ -641,6 +687,7 @@ public:
     AddElement(EngravingItem*);
     EngravingItem* getElement() const { return element; }
     void cleanup(bool) override;
+    size_t objectSize() const override { return sizeof(AddElement); }
     const char* name() const override;
 
     bool isFiltered(UndoCommand::Filter f, const EngravingItem* target) const override;
@@ -661,6 +708,8 @@ public:
     void undo(EditData*) override;
     void redo(EditData*) override;
     void cleanup(bool) override;
+    size_t objectSize() const override { return sizeof(RemoveElement); }
+    size_t sizeBytes() const override;
     const char* name() const override;
 
     bool isFiltered(UndoCommand::Filter f, const EngravingItem* target) const override;
@@ -803,6 +852,8 @@ public:
 
     const std::unordered_map<Sid, PropertyValue>& values() const { return m_values; }
 
+    size_t sizeBytes() const override;
+
     UNDO_TYPE(CommandType::ChangeStyleValues)
     UNDO_NAME("ChangeStyleValues")
     UNDO_CHANGED_OBJECTS({ m_score })
@@ -898,6 +949,7 @@ class InsertRemoveMeasures : public UndoCommand
 protected:
     void removeMeasures();
     void insertMeasures();
+    size_t measuresSizeBytes() const;
 
 public:
     InsertRemoveMeasures(MeasureBase* _fm, MeasureBase* _lm, bool _moveStc)
@@ -915,6 +967,7 @@ public:
         : InsertRemoveMeasures(m1, m2, moveStc) {}
     void undo(EditData*) override { insertMeasures(); }
     void redo(EditData*) override { removeMeasures(); }
+    size_t sizeBytes() const override;
 
     UNDO_TYPE(CommandType::RemoveMeasures)
     UNDO_NAME("RemoveMeasures")
@@ -1128,6 +1181,11 @@ public:
     EngravingObject* getElement() const { return element; }
     PropertyValue data() const { return property; }
 
+    //! NOTE A later change of the same property can be dropped from the compacted undo history,
+    //! see UndoCommand::appendChildrenCompacted
+    virtual bool canBeCoalesced() const { return element != nullptr; }
+    size_t sizeBytes() const override;
+
     UNDO_TYPE(CommandType::ChangeProperty)
     UNDO_NAME("ChangeProperty")
 
@@ -1151,6 +1209,7 @@ class ChangeBracketProperty : public ChangeProperty
 public:
     ChangeBracketProperty(Staff* s, size_t l, Pid i, const PropertyValue& v, PropertyFlags ps = PropertyFlags::NOSTYLE)
         : ChangeProperty(nullptr, i, v, ps), staff(s), level(l) {}
+    bool canBeCoalesced() const override { return false; }
     UNDO_NAME("ChangeBracketProperty")
     UNDO_CHANGED_OBJECTS({ staff })
 };
@@ -1164,6 +1223,7 @@ class ChangeTextLineProperty : public ChangeProperty
 public:
     ChangeTextLineProperty(EngravingObject* e, PropertyValue v)
         : ChangeProperty(e, Pid::SYSTEM_FLAG, v, PropertyFlags::NOSTYLE) {}
+    bool canBeCoalesced() const override { return false; }
     UNDO_NAME("ChangeTextLineProperty")
 };
 
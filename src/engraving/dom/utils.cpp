@@ -71,20 +71,21 @@ Measure* Score::tick2measure(const Fraction& tick) const
         return firstMeasure();
     }
 
-    Measure* lm = 0;
-    for (Measure* m = firstMeasure(); m; m = m->nextMeasure()) {
-        if (tick < m->tick()) {
-            assert(lm);
-            return lm;
-        }
-        lm = m;
+    MeasureBase* mb = m_measures.findByTick(tick);
+    while (mb && !mb->isMeasure()) {
+        mb = mb->prev();
+    }
+    if (!mb) {
+        return nullptr;
     }
+
+    Measure* m = toMeasure(mb);
     // check last measure
-    if (lm && (tick >= lm->tick()) && (tick <= lm->endTick())) {
-        return lm;
+    if (!m->nextMeasure() && tick > m->endTick()) {
+        LOGD("tick2measure %d (max %d) not found", tick.ticks(), m->tick().ticks());
+        return nullptr;
     }
-    LOGD("tick2measure %d (max %d) not found", tick.ticks(), lm ? lm->tick().ticks() : -1);
-    return 0;
+    return m;
 }
 
 //---------------------------------------------------------
@@ -101,15 +102,11 @@ Measure* Score::tick2measureMM(const Fraction& t) const
         tick = Fraction(0, 1);
     }
 
-    Measure* lm = 0;
-
-    for (Measure* m = firstMeasureMM(); m; m = m->nextMeasureMM()) {
-        if (tick < m->tick()) {
-            assert(lm);
-            return lm;
-        }
-        lm = m;
+    Measure* lm = tick2measure(tick);
+    if (lm) {
+        lm = const_cast<Measure*>(lm->coveringMMRestOrThis());
     }
+
     // check last measure
     if (lm && (tick >= lm->tick()) && (tick <= lm->endTick())) {
         return lm;
@@ -124,12 +121,12 @@ Measure* Score::tick2measureMM(const Fraction& t) const
 
 MeasureBase* Score::tick2measureBase(const Fraction& tick) const
 {
-    for (MeasureBase* mb = first(); mb; mb = mb->next()) {
-        Fraction st = mb->tick();
-        Fraction l  = mb->ticks();
-        if (tick >= st && tick < (st + l)) {
-            return mb;
-        }
+    MeasureBase* mb = m_measures.findByTick(tick);
+    while (mb && mb->ticks().isZero()) {
+        mb = mb->prev();
+    }
+    if (mb && tick >= mb->tick() && tick < mb->endTick()) {
+        return mb;
     }
 //      LOGD("tick2measureBase %d not found", tick);
     return 0;
@@ -172,21 +169,18 @@ Segment* Score::tick2segment(const Fraction& t, bool first, SegmentType st, bool
         LOGD() << "no measure for tick " << tick.ticks();
         return 0;
     }
-    for (Segment* segment   = m->first(st); segment;) {
-        Fraction t1       = segment->tick();
-        Segment* nsegment = segment->next(st);
-        if (tick == t1) {
-            if (first) {
-                return segment;
-            } else {
-                if (!nsegment || tick < nsegment->tick()) {
-                    return segment;
-                }
-            }
+    const Fraction rtick = tick - m->tick();
+    Segment* result = nullptr;
+    for (Segment* segment = m->segments().lowerBound(rtick); segment && segment->rtick() == rtick; segment = segment->next()) {
+        if (!(segment->segmentType() & st)) {
+            continue;
+        }
+        if (first) {
+            return segment;
         }
-        segment = nsegment;
+        result = segment;
     }
-    return 0;
+    return result;
 }
 
 Segment* Score::tick2segment(const Fraction& tick) const
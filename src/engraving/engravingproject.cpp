@@ -59,12 +59,20 @@ EngravingProject::EngravingProject(const modularity::ContextPtr& iocCtx)
     : muse::Injectable(iocCtx)
 {
     muse::ObjectAllocator::used();
+
+    //! NOTE The objects of the score are allocated from an arena while the project
+    //! loads or edits it, so the memory is returned to the system when the project is closed
+    if (muse::ObjectAllocator::enabled()) {
+        m_allocatorArena = std::make_unique<muse::AllocatorArena>("EngravingProject");
+    }
 }
 
 EngravingProject::~EngravingProject()
 {
     delete m_masterScore;
 
+    m_allocatorArena.reset();
+
     muse::ObjectAllocator::unused();
 
     // muse::AllocatorsRegister::instance()->printStatistic("=== Destroy engraving project ===");
@@ -74,7 +82,10 @@ EngravingProject::~EngravingProject()
 
 void EngravingProject::init(const MStyle& style)
 {
+    muse::AllocatorArena::Scope arenaScope(m_allocatorArena.get());
+
     m_masterScore = new MasterScore(iocContext(), style, weak_from_this());
+    m_masterScore->m_allocatorArena = m_allocatorArena.get();
 }
 
 IFileInfoProviderPtr EngravingProject::fileInfoProvider() const
@@ -111,6 +122,8 @@ Ret EngravingProject::doSetupMasterScore(bool forceMode)
 {
     TRACEFUNC;
 
+    muse::AllocatorArena::Scope arenaScope(m_allocatorArena.get());
+
     m_masterScore->createPaddingTable();
     m_masterScore->connectTies();
 
@@ -143,6 +156,8 @@ Ret EngravingProject::loadMscz(const MscReader& msc, SettingsCompat& settingsCom
 {
     TRACEFUNC;
 
+    muse::AllocatorArena::Scope arenaScope(m_allocatorArena.get());
+
     MScore::setError(MsError::MS_NO_ERROR);
     MscLoader loader;
     return loader.loadMscz(m_masterScore, msc, settingsCompat, ignoreVersionError);
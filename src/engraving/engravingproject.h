@@ -43,6 +43,10 @@
 //! we need to strive to ensure that there is work with the project everywhere;
 //! accordingly, only the project should create and load the master score.
 
+namespace muse {
+class AllocatorArena;
+}
+
 namespace mu::engraving {
 class MasterScore;
 class MStyle;
@@ -85,6 +89,7 @@ private:
     muse::Ret doSetupMasterScore(bool forceMode);
 
     MasterScore* m_masterScore = nullptr;
+    std::unique_ptr<muse::AllocatorArena> m_allocatorArena;
 
     bool m_isCorruptedUponLoading = false;
 };
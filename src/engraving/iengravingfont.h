@@ -46,8 +46,8 @@ public:
     virtual RectF bbox(const SymIdList& s, const SizeF& mag) const = 0;
     virtual Shape shape(const SymIdList& s, double mag) const = 0;
     virtual Shape shape(const SymIdList& s, const SizeF& mag) const = 0;
-    virtual Shape shapeWithCutouts(SymId id, double mag) = 0;
-    virtual Shape shapeWithCutouts(SymId id, const SizeF& mag) = 0;
+    virtual Shape shapeWithCutouts(SymId id, double mag) const = 0;
+    virtual Shape shapeWithCutouts(SymId id, const SizeF& mag) const = 0;
 
     virtual PointF smuflAnchor(SymId symId, SmuflAnchorId anchorId, double mag) const = 0;
 
@@ -460,6 +460,8 @@ StringList MscReader::XmlFileReader::fileList() const
         return StringList();
     }
 
+    const std::lock_guard lock(m_deviceMutex);
+
     StringList files;
 
     m_device->seek(0);
@@ -491,6 +493,8 @@ bool MscReader::XmlFileReader::fileExists(const String& fileName) const
         return false;
     }
 
+    const std::lock_guard lock(m_deviceMutex);
+
     m_device->seek(0);
     XmlStreamReader xml(m_device);
     while (xml.readNextStartElement()) {
@@ -520,6 +524,8 @@ ByteArray MscReader::XmlFileReader::fileData(const String& fileName) const
         return ByteArray();
     }
 
+    const std::lock_guard lock(m_deviceMutex);
+
     m_device->seek(0);
     XmlStreamReader xml(m_device);
     while (xml.readNextStartElement()) {
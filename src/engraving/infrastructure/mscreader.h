@@ -22,6 +22,8 @@
 #ifndef MU_ENGRAVING_MSCREADER_H
 #define MU_ENGRAVING_MSCREADER_H
 
+#include <mutex>
+
 #include "types/ret.h"
 #include "types/string.h"
 #include "io/path.h"
@@ -131,6 +133,7 @@ private:
     private:
         muse::io::IODevice* m_device = nullptr;
         bool m_selfDeviceOwner = false;
+        mutable std::mutex m_deviceMutex;
     };
 
     IReader* reader() const;
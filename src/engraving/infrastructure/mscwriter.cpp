@@ -100,10 +100,14 @@ bool MscWriter::hasError() const
 
 MscWriter::IWriter* MscWriter::writer() const
 {
+    if (!m_writer && m_params.snapshot) {
+        m_writer = new SnapshotWriter(m_params.snapshot);
+    }
+
     if (!m_writer) {
         switch (m_params.mode) {
         case MscIoMode::Zip:
-            m_writer = new ZipFileWriter();
+            m_writer = new ZipFileWriter(m_params.compressionLevel);
             break;
         case MscIoMode::Dir:
             m_writer = new DirWriter();
@@ -203,6 +207,32 @@ void MscWriter::writeViewSettingsJsonFile(const ByteArray& data, const muse::io:
     addFileData(pathPrefix.toString() + u"viewsettings.json", data);
 }
 
+Ret MscWriter::writeSnapshot(const Snapshot& snapshot)
+{
+    IF_ASSERT_FAILED(!m_params.snapshot) {
+        return make_ret(Ret::Code::InternalError);
+    }
+
+    Ret ret = open();
+    if (!ret) {
+        return ret;
+    }
+
+    for (const auto& [fileName, data] : snapshot.files) {
+        if (!addFileData(fileName, data)) {
+            close();
+            return make_ret(Ret::Code::UnknownError);
+        }
+    }
+
+    //! NOTE The meta is already in the snapshot
+    m_meta.isWritten = true;
+
+    close();
+
+    return hasError() ? make_ret(Ret::Code::UnknownError) : make_ok();
+}
+
 void MscWriter::writeMeta()
 {
     if (m_meta.isWritten) {
@@ -235,6 +265,16 @@ void MscWriter::writeContainer(const std::vector<String>& paths)
     addFileData(u"META-INF/container.xml", data);
 }
 
+size_t MscWriter::Snapshot::dataSize() const
+{
+    size_t size = 0;
+    for (const auto& file : files) {
+        size += file.second.size();
+    }
+
+    return size;
+}
+
 bool MscWriter::Meta::contains(const String& file) const
 {
     if (std::find(files.begin(), files.end(), file) != files.end()) {
@@ -254,6 +294,11 @@ void MscWriter::Meta::addFile(const String& file)
 // Writers
 // =======================================================================
 
+MscWriter::ZipFileWriter::ZipFileWriter(ZipWriter::CompressionLevel compressionLevel)
+    : m_compressionLevel(compressionLevel)
+{
+}
+
 MscWriter::ZipFileWriter::~ZipFileWriter()
 {
     delete m_zip;
@@ -278,6 +323,7 @@ Ret MscWriter::ZipFileWriter::open(io::IODevice* device, const path_t& filePath)
     }
 
     m_zip = new ZipWriter(m_device);
+    m_zip->setCompressionLevel(m_compressionLevel);
 
     return true;
 }
@@ -469,3 +515,42 @@ bool MscWriter::XmlFileWriter::addFileData(const String& fileName, const ByteArr
 
     return true;
 }
+
+MscWriter::SnapshotWriter::SnapshotWriter(Snapshot* snapshot)
+    : m_snapshot(snapshot)
+{
+}
+
+Ret MscWriter::SnapshotWriter::open(io::IODevice*, const path_t&)
+{
+    m_snapshot->files.clear();
+    m_isOpened = true;
+
+    return true;
+}
+
+void MscWriter::SnapshotWriter::close()
+{
+    m_isOpened = false;
+}
+
+bool MscWriter::SnapshotWriter::isOpened() const
+{
+    return m_isOpened;
+}
+
+bool MscWriter::SnapshotWriter::hasError() const
+{
+    return false;
+}
+
+bool MscWriter::SnapshotWriter::addFileData(const String& fileName, const ByteArray& data)
+{
+    if (!m_isOpened) {
+        return false;
+    }
+
+    m_snapshot->files.emplace_back(fileName, data);
+
+    return true;
+}
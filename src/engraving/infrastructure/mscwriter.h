@@ -22,14 +22,16 @@
 #ifndef MU_ENGRAVING_MSCWRITER_H
 #define MU_ENGRAVING_MSCWRITER_H
 
+#include <vector>
+
 #include "types/string.h"
 #include "types/ret.h"
 #include "io/path.h"
 #include "io/iodevice.h"
+#include "serialization/zipwriter.h"
 #include "mscio.h"
 
 namespace muse {
-class ZipWriter;
 class TextStream;
 }
 
@@ -38,12 +40,25 @@ class MscWriter
 {
 public:
 
+    //! NOTE The files of a project, kept in memory as they are, ex. not compressed yet
+    struct Snapshot
+    {
+        std::vector<std::pair<muse::String, muse::ByteArray> > files;
+
+        size_t dataSize() const;
+    };
+
     struct Params
     {
         muse::io::IODevice* device = nullptr;
         muse::io::path_t filePath;
         muse::String mainFileName;
         MscIoMode mode = MscIoMode::Zip;
+        muse::ZipWriter::CompressionLevel compressionLevel = muse::ZipWriter::CompressionLevel::Default;
+
+        //! NOTE If set, the files are only collected to the snapshot (the mode is ignored),
+        //! to be written later with writeSnapshot, ex. on a worker thread
+        Snapshot* snapshot = nullptr;
     };
 
     MscWriter() = default;
@@ -69,6 +84,9 @@ public:
     void writeAudioSettingsJsonFile(const muse::ByteArray& data, const muse::io::path_t& pathPrefix = "");
     void writeViewSettingsJsonFile(const muse::ByteArray& data, const muse::io::path_t& pathPrefix = "");
 
+    //! NOTE Opens, writes all the files of the snapshot (with its meta) and closes
+    muse::Ret writeSnapshot(const Snapshot& snapshot);
+
 private:
 
     struct IWriter {
@@ -83,6 +101,7 @@ private:
 
     struct ZipFileWriter : public IWriter
     {
+        ZipFileWriter(muse::ZipWriter::CompressionLevel compressionLevel);
         ~ZipFileWriter() override;
         muse::Ret open(muse::io::IODevice* device, const muse::io::path_t& filePath) override;
         void close() override;
@@ -94,6 +113,7 @@ private:
         muse::io::IODevice* m_device = nullptr;
         bool m_selfDeviceOwner = false;
         muse::ZipWriter* m_zip = nullptr;
+        muse::ZipWriter::CompressionLevel m_compressionLevel = muse::ZipWriter::CompressionLevel::Default;
     };
 
     struct DirWriter : public IWriter
@@ -122,6 +142,19 @@ private:
         muse::TextStream* m_stream = nullptr;
     };
 
+    struct SnapshotWriter : public IWriter
+    {
+        SnapshotWriter(Snapshot* snapshot);
+        muse::Ret open(muse::io::IODevice* device, const muse::io::path_t& filePath) override;
+        void close() override;
+        bool isOpened() const override;
+        bool hasError() const override;
+        bool addFileData(const muse::String& fileName, const muse::ByteArray& data) override;
+    private:
+        Snapshot* m_snapshot = nullptr;
+        bool m_isOpened = false;
+    };
+
     struct Meta {
         std::vector<muse::String> files;
         bool isWritten = false;
@@ -31,6 +31,7 @@ namespace mu::engraving {
 public: \
     static bool classof(const ElementType type) noexcept { return type == Type; } \
     static bool classof(const EngravingObject * item) noexcept { return item->type() == Type; } \
+    size_t objectSize() const override { return sizeof(*this); } \
 
 template<typename To, typename From>
 bool is_classof(From* p) noexcept
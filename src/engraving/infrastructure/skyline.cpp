@@ -22,6 +22,8 @@
 
 #include "skyline.h"
 
+#include <algorithm>
+
 #include "realfn.h"
 #include "draw/painter.h"
 
@@ -103,6 +105,7 @@ SkylineLine SkylineLine::getFilteredCopy(std::function<bool(const ShapeElement&)
     SkylineLine newSkylineLine(*this);
 
     newSkylineLine.m_shape.clear();
+    newSkylineLine.m_envelope.invalidate();
 
     for (const ShapeElement& shapeEl : m_shape.elements()) {
         if (filterOut(shapeEl)) {
@@ -187,6 +190,222 @@ void SkylineLine::clear()
 {
     m_staffLineEdges.clear();
     m_shape.clear();
+    m_envelope.invalidate();
+}
+
+//-------------------------------------------------------------------
+//   Envelope
+//    Elements that don't count for the distance queries (no height
+//    or no width) are left out, like in Shape::minVerticalDistance.
+//-------------------------------------------------------------------
+
+static bool countsForDistance(const RectF& r)
+{
+    return r.height() > 0.0 && r.left() != r.right();
+}
+
+void SkylineLine::Envelope::build(const std::vector<ShapeElement>& elements)
+{
+    m_edges.clear();
+    m_edges.reserve(elements.size() * 2);
+
+    for (const ShapeElement& el : elements) {
+        if (countsForDistance(el)) {
+            m_edges.push_back(el.left());
+            m_edges.push_back(el.right());
+        }
+    }
+
+    std::sort(m_edges.begin(), m_edges.end());
+    m_edges.erase(std::unique(m_edges.begin(), m_edges.end()), m_edges.end());
+
+    size_t segmentCount = m_edges.size() > 1 ? m_edges.size() - 1 : 0;
+    m_leafCount = 1;
+    while (m_leafCount < segmentCount) {
+        m_leafCount <<= 1;
+    }
+
+    m_maxBottomTree.assign(2 * m_leafCount, -DBL_MAX);
+    m_minTopTree.assign(2 * m_leafCount, DBL_MAX);
+
+    // Apply every element to the nodes that cover its range of segments...
+    for (const ShapeElement& el : elements) {
+        if (!countsForDistance(el)) {
+            continue;
+        }
+
+        size_t from = std::lower_bound(m_edges.begin(), m_edges.end(), el.left()) - m_edges.begin();
+        size_t to = std::lower_bound(m_edges.begin(), m_edges.end(), el.right()) - m_edges.begin();
+        double bottom = el.bottom();
+        double top = el.top();
+
+        for (from += m_leafCount, to += m_leafCount; from < to; from >>= 1, to >>= 1) {
+            if (from & 1) {
+                m_maxBottomTree[from] = std::max(m_maxBottomTree[from], bottom);
+                m_minTopTree[from] = std::min(m_minTopTree[from], top);
+                ++from;
+            }
+            if (to & 1) {
+                --to;
+                m_maxBottomTree[to] = std::max(m_maxBottomTree[to], bottom);
+                m_minTopTree[to] = std::min(m_minTopTree[to], top);
+            }
+        }
+    }
+
+    // ...push them down to the segments...
+    for (size_t i = 1; i < m_leafCount; ++i) {
+        for (size_t child = 2 * i; child <= 2 * i + 1; ++child) {
+            m_maxBottomTree[child] = std::max(m_maxBottomTree[child], m_maxBottomTree[i]);
+            m_minTopTree[child] = std::min(m_minTopTree[child], m_minTopTree[i]);
+        }
+    }
+
+    // ...and aggregate them back up for the range queries
+    for (size_t i = m_leafCount - 1; i > 0; --i) {
+        m_maxBottomTree[i] = std::max(m_maxBottomTree[2 * i], m_maxBottomTree[2 * i + 1]);
+        m_minTopTree[i] = std::min(m_minTopTree[2 * i], m_minTopTree[2 * i + 1]);
+    }
+
+    m_indexedCount = elements.size();
+    m_isValid = true;
+}
+
+bool SkylineLine::Envelope::segmentRange(double x1, double x2, size_t& from, size_t& to) const
+{
+    if (m_edges.size() < 2 || x2 <= m_edges.front() || x1 >= m_edges.back()) {
+        return false;
+    }
+
+    // segment i spans (m_edges[i], m_edges[i + 1]) and overlaps (x1, x2) if m_edges[i] < x2 and m_edges[i + 1] > x1
+    size_t firstAfterX1 = std::upper_bound(m_edges.begin(), m_edges.end(), x1) - m_edges.begin();
+    size_t firstFromX2 = std::lower_bound(m_edges.begin(), m_edges.end(), x2) - m_edges.begin();
+
+    from = firstAfterX1 > 0 ? firstAfterX1 - 1 : 0;
+    to = std::min(firstFromX2, m_edges.size() - 1);
+
+    return from < to;
+}
+
+double SkylineLine::Envelope::maxBottom(double x1, double x2) const
+{
+    double result = -DBL_MAX;
+
+    size_t from = 0;
+    size_t to = 0;
+    if (!segmentRange(x1, x2, from, to)) {
+        return result;
+    }
+
+    for (from += m_leafCount, to += m_leafCount; from < to; from >>= 1, to >>= 1) {
+        if (from & 1) {
+            result = std::max(result, m_maxBottomTree[from++]);
+        }
+        if (to & 1) {
+            result = std::max(result, m_maxBottomTree[--to]);
+        }
+    }
+
+    return result;
+}
+
+double SkylineLine::Envelope::minTop(double x1, double x2) const
+{
+    double result = DBL_MAX;
+
+    size_t from = 0;
+    size_t to = 0;
+    if (!segmentRange(x1, x2, from, to)) {
+        return result;
+    }
+
+    for (from += m_leafCount, to += m_leafCount; from < to; from >>= 1, to >>= 1) {
+        if (from & 1) {
+            result = std::min(result, m_minTopTree[from++]);
+        }
+        if (to & 1) {
+            result = std::min(result, m_minTopTree[--to]);
+        }
+    }
+
+    return result;
+}
+
+//-------------------------------------------------------------------
+//   updateEnvelope
+//    Elements added after the envelope was built are checked one by
+//    one by the queries, so adding to a skyline doesn't rebuild it;
+//    the envelope is only rebuilt once enough elements piled up.
+//-------------------------------------------------------------------
+
+void SkylineLine::updateEnvelope() const
+{
+    const std::vector<ShapeElement>& elements = m_shape.elements();
+    size_t pendingCount = elements.size() - std::min(m_envelope.indexedCount(), elements.size());
+
+    if (!m_envelope.isValid() || m_envelope.indexedCount() > elements.size()
+        || pendingCount > std::max(size_t(16), m_envelope.indexedCount() / 4)) {
+        m_envelope.build(elements);
+    }
+}
+
+bool SkylineLine::useEnvelope() const
+{
+    // For small skylines, the plain scan is cheaper than maintaining the index
+    static constexpr size_t MIN_ELEMENTS_FOR_ENVELOPE = 16;
+
+    if (m_shape.size() < MIN_ELEMENTS_FOR_ENVELOPE) {
+        return false;
+    }
+
+    updateEnvelope();
+    return true;
+}
+
+double SkylineLine::maxBottomOverlapping(const RectF& r, double minHorizontalClearance) const
+{
+    double x1 = r.left() - minHorizontalClearance;
+    double x2 = r.right() + minHorizontalClearance;
+    size_t firstPending = 0;
+    double result = -DBL_MAX;
+
+    if (x1 < x2) {
+        result = m_envelope.maxBottom(x1, x2);
+        firstPending = m_envelope.indexedCount();
+    }
+
+    const std::vector<ShapeElement>& elements = m_shape.elements();
+    for (size_t i = firstPending; i < elements.size(); ++i) {
+        const ShapeElement& el = elements[i];
+        if (el.height() > 0.0 && mu::engraving::intersects(el.left(), el.right(), r.left(), r.right(), minHorizontalClearance)) {
+            result = std::max(result, el.bottom());
+        }
+    }
+
+    return result;
+}
+
+double SkylineLine::minTopOverlapping(const RectF& r, double minHorizontalClearance) const
+{
+    double x1 = r.left() - minHorizontalClearance;
+    double x2 = r.right() + minHorizontalClearance;
+    size_t firstPending = 0;
+    double result = DBL_MAX;
+
+    if (x1 < x2) {
+        result = m_envelope.minTop(x1, x2);
+        firstPending = m_envelope.indexedCount();
+    }
+
+    const std::vector<ShapeElement>& elements = m_shape.elements();
+    for (size_t i = firstPending; i < elements.size(); ++i) {
+        const ShapeElement& el = elements[i];
+        if (el.height() > 0.0 && mu::engraving::intersects(el.left(), el.right(), r.left(), r.right(), minHorizontalClearance)) {
+            result = std::min(result, el.top());
+        }
+    }
+
+    return result;
 }
 
 //-------------------------------------------------------------------
@@ -202,27 +421,83 @@ double Skyline::minDistance(const Skyline& s, double minHorizontalClearance) con
 
 double SkylineLine::minDistance(const SkylineLine& sl, double minHorizontalClearance) const
 {
-    return m_shape.minVerticalDistance(sl.m_shape, minHorizontalClearance);
+    return minDistanceToShapeBelow(sl.m_shape, minHorizontalClearance);
 }
 
 double SkylineLine::minDistanceToShapeAbove(const Shape& shapeAbove, double minHorizontalClearance) const
 {
-    return shapeAbove.minVerticalDistance(m_shape, minHorizontalClearance);
+    if (shapeAbove.empty() || m_shape.empty() || !useEnvelope()) {
+        return shapeAbove.minVerticalDistance(m_shape, minHorizontalClearance);
+    }
+
+    double dist = -DBL_MAX;
+    for (const ShapeElement& r1 : shapeAbove.elements()) {
+        if (!countsForDistance(r1)) {
+            continue;
+        }
+        double top = minTopOverlapping(r1, minHorizontalClearance);
+        if (top != DBL_MAX) {
+            dist = std::max(dist, r1.bottom() - top);
+        }
+    }
+    return dist;
 }
 
 double SkylineLine::minDistanceToShapeBelow(const Shape& shapeBelow, double minHorizontalClearance) const
 {
-    return m_shape.minVerticalDistance(shapeBelow, minHorizontalClearance);
+    if (shapeBelow.empty() || m_shape.empty() || !useEnvelope()) {
+        return m_shape.minVerticalDistance(shapeBelow, minHorizontalClearance);
+    }
+
+    double dist = -DBL_MAX;
+    for (const ShapeElement& r2 : shapeBelow.elements()) {
+        if (!countsForDistance(r2)) {
+            continue;
+        }
+        double bottom = maxBottomOverlapping(r2, minHorizontalClearance);
+        if (bottom != -DBL_MAX) {
+            dist = std::max(dist, bottom - r2.top());
+        }
+    }
+    return dist;
 }
 
 double SkylineLine::verticalClearanceAbove(const Shape& shapeAbove) const
 {
-    return shapeAbove.verticalClearance(m_shape);
+    if (shapeAbove.empty() || m_shape.empty() || !useEnvelope()) {
+        return shapeAbove.verticalClearance(m_shape);
+    }
+
+    double dist = DBL_MAX;
+    for (const ShapeElement& r1 : shapeAbove.elements()) {
+        if (!countsForDistance(r1)) {
+            continue;
+        }
+        double top = minTopOverlapping(r1, 0.0);
+        if (top != DBL_MAX) {
+            dist = std::min(dist, top - r1.bottom());
+        }
+    }
+    return dist;
 }
 
 double SkylineLine::verticalClaranceBelow(const Shape& shapeBelow) const
 {
-    return m_shape.verticalClearance(shapeBelow);
+    if (shapeBelow.empty() || m_shape.empty() || !useEnvelope()) {
+        return m_shape.verticalClearance(shapeBelow);
+    }
+
+    double dist = DBL_MAX;
+    for (const ShapeElement& r2 : shapeBelow.elements()) {
+        if (!countsForDistance(r2)) {
+            continue;
+        }
+        double bottom = maxBottomOverlapping(r2, 0.0);
+        if (bottom != -DBL_MAX) {
+            dist = std::min(dist, r2.top() - bottom);
+        }
+    }
+    return dist;
 }
 
 void Skyline::paint(Painter& painter, double lineWidth) const // DEBUG only
@@ -268,6 +543,7 @@ bool SkylineLine::valid() const
 SkylineLine& SkylineLine::translateY(double y)
 {
     m_shape.translateY(y);
+    m_envelope.invalidate();
     return *this;
 }
 
@@ -52,7 +52,11 @@ public:
     void add(const Shape& s);
 
     template<typename Predicate>
-    inline bool remove_if(Predicate p) { return m_shape.remove_if(p); }
+    inline bool remove_if(Predicate p)
+    {
+        m_envelope.invalidate();
+        return m_shape.remove_if(p);
+    }
     SkylineLine getFilteredCopy(std::function<bool(const ShapeElement&)> filterOut) const;
 
     void clear();
@@ -74,15 +78,59 @@ public:
     bool isNorth() const { return m_isNorth; }
 
     const std::vector<ShapeElement>& elements() const { return m_shape.elements(); }
-    std::vector<ShapeElement>& elements() { return m_shape.elements(); }
+    std::vector<ShapeElement>& elements()
+    {
+        m_envelope.invalidate();
+        return m_shape.elements();
+    }
 
 private:
     double staffLinesTopAtX(double x) const;
     double staffLinesBottomAtX(double x) const;
 
+    bool useEnvelope() const;
+    double maxBottomOverlapping(const RectF& r, double minHorizontalClearance) const;
+    double minTopOverlapping(const RectF& r, double minHorizontalClearance) const;
+
+    //---------------------------------------------------------
+    //   Envelope
+    //    x-sorted index over the elements of the skyline: the
+    //    highest bottom and the lowest top of every interval
+    //    between two consecutive element edges, kept in a
+    //    segment tree for O(log n) range queries.
+    //---------------------------------------------------------
+
+    class Envelope
+    {
+    public:
+        void build(const std::vector<ShapeElement>& elements);
+        void invalidate() { m_isValid = false; }
+        bool isValid() const { return m_isValid; }
+
+        // number of elements (from the start of the shape) that are covered by the index
+        size_t indexedCount() const { return m_indexedCount; }
+
+        // over the open interval (x1, x2); x1 must be less than x2
+        double maxBottom(double x1, double x2) const;
+        double minTop(double x1, double x2) const;
+
+    private:
+        bool segmentRange(double x1, double x2, size_t& from, size_t& to) const;
+
+        std::vector<double> m_edges;
+        std::vector<double> m_maxBottomTree;
+        std::vector<double> m_minTopTree;
+        size_t m_leafCount = 0;
+        size_t m_indexedCount = 0;
+        bool m_isValid = false;
+    };
+
+    void updateEnvelope() const;
+
 private:
     const bool m_isNorth;
     Shape m_shape;
+    mutable Envelope m_envelope;
 
     struct StaffLineEdge {
         double top = 0.0;
@@ -21,6 +21,7 @@
  */
 #include "engravingconfiguration.h"
 
+#include <algorithm>
 #include <cstdlib>
 
 #ifndef NO_QT_SUPPORT
@@ -51,6 +52,8 @@ static const Settings::Key UNLINKED_COLOR("engraving", "engraving/colors/unlinke
 
 static const Settings::Key DYNAMICS_APPLY_TO_ALL_VOICES("engraving", "score/dynamicsApplyToAllVoices");
 
+static const Settings::Key UNDO_HISTORY_LIMIT_MEGABYTES("engraving", "engraving/undo/historyLimitMegabytes");
+
 struct VoiceColor {
     Settings::Key key;
     Color color;
@@ -118,6 +121,16 @@ void EngravingConfiguration::init()
     settings()->valueChanged(UNLINKED_COLOR).onReceive(nullptr, [this](const Val& val) {
         m_unlinkedColorChanged.send(Color::fromQColor(val.toQColor()));
     });
+
+    //! NOTE 0 - unlimited. Above the limit, the oldest undo steps are merged into one, see UndoStack::compactHistory.
+    //! Off by default: the merging only frees the repeated property changes
+    settings()->setDefaultValue(UNDO_HISTORY_LIMIT_MEGABYTES, Val(0));
+    settings()->setDescription(UNDO_HISTORY_LIMIT_MEGABYTES, muse::trc("engraving", "Undo history limit (MB), the oldest undo steps are merged into one above it"));
+    settings()->setCanBeManuallyEdited(UNDO_HISTORY_LIMIT_MEGABYTES, true, Val(0), Val(64 * 1024));
+    settings()->valueChanged(UNDO_HISTORY_LIMIT_MEGABYTES).onReceive(nullptr, [](const Val& val) {
+        MScore::undoHistoryLimitBytes = static_cast<size_t>(std::max(val.toInt(), 0)) * 1024 * 1024;
+    });
+    MScore::undoHistoryLimitBytes = static_cast<size_t>(std::max(settings()->value(UNDO_HISTORY_LIMIT_MEGABYTES).toInt(), 0)) * 1024 * 1024;
 }
 
 muse::io::path_t EngravingConfiguration::appDataPath() const
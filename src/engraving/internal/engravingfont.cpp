@@ -134,6 +134,11 @@ void EngravingFont::ensureLoad()
     loadStylisticAlternates(metadataJson.value("glyphsWithAlternates").toObject());
     loadEngravingDefaults(metadataJson.value("engravingDefaults").toObject());
 
+    //! NOTE Built here, after the anchors and the composed glyphs are loaded, so the font is read-only during the layout
+    for (Sym& sym : m_symbols) {
+        constructShapeWithCutouts(sym);
+    }
+
     m_loaded = true;
 }
 
@@ -610,33 +615,43 @@ Shape EngravingFont::shape(const SymIdList& s, const SizeF& mag) const
     return sh;
 }
 
-Shape EngravingFont::shapeWithCutouts(SymId id, double mag)
+Shape EngravingFont::shapeWithCutouts(SymId id, double mag) const
 {
     return shapeWithCutouts(id, SizeF(mag, mag));
 }
 
-Shape EngravingFont::shapeWithCutouts(SymId id, const SizeF& mag)
+Shape EngravingFont::shapeWithCutouts(SymId id, const SizeF& mag) const
 {
-    Shape& shape = sym(id).shapeWithCutouts;
+    if (useFallbackFont(id)) {
+        return engravingFonts()->fallbackFont()->shapeWithCutouts(id, mag);
+    }
+
+    const Shape& shape = sym(id).shapeWithCutouts;
     if (shape.empty()) {
-        constructShapeWithCutouts(shape, id);
+        //! NOTE Not built, the metadata failed to load, so there are no cutouts
+        return Shape(bbox(id, mag));
     }
 
     return shape.scaled(mag);
 }
 
-void EngravingFont::constructShapeWithCutouts(Shape& shape, SymId id)
+void EngravingFont::constructShapeWithCutouts(Sym& sym)
 {
-    RectF boundingBox = bbox(id, 1.0);
+    const RectF& boundingBox = sym.bbox;
     double bottom = boundingBox.bottom();
     double top = boundingBox.top();
     double left = boundingBox.left();
     double right = boundingBox.right();
 
-    PointF cutOutNW = smuflAnchor(id, SmuflAnchorId::cutOutNW, 1.0);
-    PointF cutOutNE = smuflAnchor(id, SmuflAnchorId::cutOutNE, 1.0);
-    PointF cutOutSW = smuflAnchor(id, SmuflAnchorId::cutOutSW, 1.0);
-    PointF cutOutSE = smuflAnchor(id, SmuflAnchorId::cutOutSE, 1.0);
+    auto anchor = [&sym](SmuflAnchorId anchorId) {
+        auto it = sym.smuflAnchors.find(anchorId);
+        return it != sym.smuflAnchors.cend() ? it->second : PointF();
+    };
+
+    PointF cutOutNW = anchor(SmuflAnchorId::cutOutNW);
+    PointF cutOutNE = anchor(SmuflAnchorId::cutOutNE);
+    PointF cutOutSW = anchor(SmuflAnchorId::cutOutSW);
+    PointF cutOutSE = anchor(SmuflAnchorId::cutOutSE);
 
     bool nwNull = cutOutNW.isNull();
     bool neNull = cutOutNE.isNull();
@@ -644,7 +659,7 @@ void EngravingFont::constructShapeWithCutouts(Shape& shape, SymId id)
     bool seNull = cutOutSE.isNull();
 
     if (nwNull && neNull && swNull && seNull) {
-        shape = Shape(bbox(id, 1.0));
+        sym.shapeWithCutouts = Shape(boundingBox);
         return;
     }
 
@@ -696,7 +711,7 @@ void EngravingFont::constructShapeWithCutouts(Shape& shape, SymId id)
         rects.emplace_back(RectF(PointF(leftInset, bottom), PointF(rightInset, top)).normalized());
     }
 
-    shape = Shape(rects);
+    sym.shapeWithCutouts = Shape(rects);
 }
 
 // =============================================
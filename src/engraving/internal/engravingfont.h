@@ -76,8 +76,8 @@ public:
     RectF bbox(const SymIdList& s, const SizeF& mag) const override;
     Shape shape(const SymIdList& s, double mag) const override;
     Shape shape(const SymIdList& s, const SizeF& mag) const override;
-    Shape shapeWithCutouts(SymId id, double mag) override;
-    Shape shapeWithCutouts(SymId id, const SizeF& mag) override;
+    Shape shapeWithCutouts(SymId id, double mag) const override;
+    Shape shapeWithCutouts(SymId id, const SizeF& mag) const override;
 
     double width(SymId id, double mag) const override;
     double width(const SymIdList&, double mag) const override;
@@ -125,7 +125,7 @@ private:
     void loadEngravingDefaults(const muse::JsonObject& engravingDefaultsObject);
     void computeMetrics(Sym& sym, const Smufl::Code& code);
 
-    void constructShapeWithCutouts(Shape& shape, SymId id);
+    void constructShapeWithCutouts(Sym& sym);
 
     Sym& sym(SymId id);
     const Sym& sym(SymId id) const;
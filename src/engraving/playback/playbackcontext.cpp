@@ -176,15 +176,33 @@ PlaybackParamList PlaybackContext::playbackParams(const track_idx_t trackIdx, co
     return result;
 }
 
+//! NOTE The keys of the map are sorted ticks, so they are converted to times at once
+template<typename TickMap>
+static void tickKeysToSecs(const Score* score, const TickMap& map, std::vector<int>& ticks, std::vector<double>& secs)
+{
+    ticks.clear();
+    for (const auto& pair : map) {
+        ticks.push_back(pair.first);
+    }
+
+    secs.resize(ticks.size());
+    score->repeatList().utick2utime(ticks.data(), secs.data(), ticks.size());
+}
+
 PlaybackParamLayers PlaybackContext::playbackParamLayers(const Score* score) const
 {
     PlaybackParamLayers result;
+    std::vector<int> ticks;
+    std::vector<double> secs;
 
-    auto addParams = [score, &result](const ParamsByTrack& paramsByTrack) {
+    auto addParams = [score, &result, &ticks, &secs](const ParamsByTrack& paramsByTrack) {
         for (const auto& params : paramsByTrack) {
             PlaybackParamMap& paramMap = result[static_cast<layer_idx_t>(params.first)];
+            tickKeysToSecs(score, params.second, ticks, secs);
+
+            size_t i = 0;
             for (const auto& pair : params.second) {
-                PlaybackParamList& list = paramMap[timestampFromTicks(score, pair.first)];
+                PlaybackParamList& list = paramMap[timestampFromSecs(secs[i++])];
                 list.insert(list.end(), pair.second.begin(), pair.second.end());
             }
         }
@@ -199,11 +217,16 @@ PlaybackParamLayers PlaybackContext::playbackParamLayers(const Score* score) con
 DynamicLevelLayers PlaybackContext::dynamicLevelLayers(const Score* score) const
 {
     DynamicLevelLayers result;
+    std::vector<int> ticks;
+    std::vector<double> secs;
 
     for (const auto& dynamics : m_dynamicsByTrack) {
+        tickKeysToSecs(score, dynamics.second, ticks, secs);
+
         DynamicLevelMap dynamicLevelMap;
+        size_t i = 0;
         for (const auto& dynamic : dynamics.second) {
-            dynamicLevelMap.emplace(timestampFromTicks(score, dynamic.first), dynamic.second.level);
+            dynamicLevelMap.emplace(timestampFromSecs(secs[i++]), dynamic.second.level);
         }
 
         result.emplace(static_cast<layer_idx_t>(dynamics.first), std::move(dynamicLevelMap));
@@ -124,7 +124,8 @@ void PlaybackModel::reload()
     update(tickFrom, tickTo, trackFrom, trackTo);
 
     for (auto& pair : m_playbackDataMap) {
-        pair.second.mainStream.send(pair.second.originEvents, pair.second.dynamics, pair.second.params);
+        pair.second.mainStream.send(PlaybackEventsChanges::makeFullUpdate(pair.second.originEvents), pair.second.dynamics,
+                                    pair.second.params);
     }
 
     m_dataChanged.notify();
@@ -378,8 +379,7 @@ void PlaybackModel::processSegment(const int tickPositionOffset, const Segment*
         }
 
         if (chordSymbol->play()) {
-            m_renderer.renderChordSymbol(chordSymbol, tickPositionOffset, profile,
-                                         m_playbackDataMap[trackId].originEvents);
+            m_renderer.renderChordSymbol(chordSymbol, tickPositionOffset, profile, eventsToRender(trackId, trackChanges));
         }
 
         collectChangesTracks(trackId, trackChanges);
@@ -428,7 +428,7 @@ void PlaybackModel::processSegment(const int tickPositionOffset, const Segment*
         }
 
         const PlaybackContextPtr ctx = playbackCtx(trackId);
-        m_renderer.render(item, tickPositionOffset, std::move(profile), ctx, m_playbackDataMap[trackId].originEvents);
+        m_renderer.render(item, tickPositionOffset, std::move(profile), ctx, eventsToRender(trackId, trackChanges));
 
         collectChangesTracks(trackId, trackChanges);
     }
@@ -513,7 +513,7 @@ void PlaybackModel::updateEvents(const int tickFrom, const int tickTo, const tra
             }
 
             m_renderer.renderMetronome(m_score, measureStartTick, measureEndTick, tickPositionOffset,
-                                       metronomeProfile, m_playbackDataMap[METRONOME_TRACK_ID].originEvents);
+                                       metronomeProfile, eventsToRender(METRONOME_TRACK_ID, trackChanges));
             collectChangesTracks(METRONOME_TRACK_ID, trackChanges);
         }
     }
@@ -729,25 +729,45 @@ void PlaybackModel::collectChangesTracks(const InstrumentTrackId& trackId, Chang
     result->insert(trackId);
 }
 
+PlaybackEventsMap& PlaybackModel::eventsToRender(const InstrumentTrackId& trackId, const ChangedTrackIdSet* trackChanges)
+{
+    PlaybackData& trackData = m_playbackDataMap[trackId];
+
+    //! NOTE While the changes are collected, only the new events are rendered, apart from the others,
+    //! so that just them are sent to the sequencers
+    if (trackChanges) {
+        return m_pendingChanges[trackId].insertedEvents;
+    }
+
+    return trackData.originEvents;
+}
+
 void PlaybackModel::notifyAboutChanges(const InstrumentTrackIdSet& oldTracks, const InstrumentTrackIdSet& changedTracks)
 {
-    for (const InstrumentTrackId& trackId : changedTracks) {
-        auto search = m_playbackDataMap.find(trackId);
+    bool hasChanges = !changedTracks.empty();
+
+    for (const auto& pair : m_pendingChanges) {
+        auto search = m_playbackDataMap.find(pair.first);
 
         if (search == m_playbackDataMap.cend()) {
             continue;
         }
 
-        search->second.mainStream.send(search->second.originEvents, search->second.dynamics, search->second.params);
+        // the removed ranges are already erased, so this appends the new events
+        pair.second.applyTo(search->second.originEvents);
+        search->second.mainStream.send(pair.second, search->second.dynamics, search->second.params);
+        hasChanges = true;
     }
 
+    m_pendingChanges.clear();
+
     for (auto it = m_playbackDataMap.cbegin(); it != m_playbackDataMap.cend(); ++it) {
         if (!muse::contains(oldTracks, it->first)) {
             m_trackAdded.send(it->first);
         }
     }
 
-    if (!changedTracks.empty()) {
+    if (hasChanges) {
         m_dataChanged.notify();
     }
 }
@@ -766,9 +786,11 @@ void PlaybackModel::removeTrackEvents(const InstrumentTrackId& trackId, const mu
     }
 
     PlaybackData& trackPlaybackData = search->second;
+    PlaybackEventsChanges& changes = m_pendingChanges[trackId];
 
     if (timestampFrom == -1 && timestampTo == -1) {
         search->second.originEvents.clear();
+        changes.fullUpdate = true;
         return;
     }
 
@@ -778,8 +800,10 @@ void PlaybackModel::removeTrackEvents(const InstrumentTrackId& trackId, const mu
         //!Note Some events might be started RIGHT before the "official" start of the track
         //!     Need to make sure that we don't miss those events
         lowerBound = trackPlaybackData.originEvents.begin();
+        changes.removedRanges.push_back({ std::numeric_limits<timestamp_t>::min(), timestampTo });
     } else {
         lowerBound = trackPlaybackData.originEvents.lower_bound(timestampFrom);
+        changes.removedRanges.push_back({ timestampFrom, timestampTo });
     }
 
     auto upperBound = trackPlaybackData.originEvents.upper_bound(timestampTo);
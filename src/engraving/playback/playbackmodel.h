@@ -127,6 +127,7 @@ private:
     void clearExpiredContexts(const track_idx_t trackFrom, const track_idx_t trackTo);
     void clearExpiredEvents(const int tickFrom, const int tickTo, const track_idx_t trackFrom, const track_idx_t trackTo);
     void collectChangesTracks(const InstrumentTrackId& trackId, ChangedTrackIdSet* result);
+    muse::mpe::PlaybackEventsMap& eventsToRender(const InstrumentTrackId& trackId, const ChangedTrackIdSet* trackChanges);
     void notifyAboutChanges(const InstrumentTrackIdSet& oldTracks, const InstrumentTrackIdSet& changedTracks);
 
     void removeEventsFromRange(const track_idx_t trackFrom, const track_idx_t trackTo, const muse::mpe::timestamp_t timestampFrom = -1,
@@ -154,6 +155,7 @@ private:
 
     std::unordered_map<InstrumentTrackId, PlaybackContextPtr> m_playbackCtxMap;
     std::unordered_map<InstrumentTrackId, muse::mpe::PlaybackData> m_playbackDataMap;
+    std::unordered_map<InstrumentTrackId, muse::mpe::PlaybackEventsChanges> m_pendingChanges;
 
     muse::async::Notification m_dataChanged;
     muse::async::Channel<InstrumentTrackId> m_trackAdded;
@@ -36,9 +36,14 @@
 #include "types/constants.h"
 
 namespace mu::engraving {
+inline muse::mpe::timestamp_t timestampFromSecs(const double secs)
+{
+    return secs * 1000000;
+}
+
 inline muse::mpe::timestamp_t timestampFromTicks(const Score* score, const int tick)
 {
-    return score->repeatList().utick2utime(tick) * 1000000;
+    return timestampFromSecs(score->repeatList().utick2utime(tick));
 }
 
 inline int timestampToTick(const Score* score, const muse::mpe::timestamp_t timestamp)
@@ -112,6 +112,10 @@ public:
         int trimMarginPixelSize = -1;
         int deviceDpi = -1;
 
+        //! NOTE Replay what the items drew the last time (see DisplayList), instead of drawing them again.
+        //! The painter then gets the drawing commands only, without the objects (see Painter::beginObject)
+        bool useDisplayLists = true;
+
         std::function<void(muse::draw::Painter* painter, const Page* page, const RectF& pageRect)> onPaintPageSheet;
         std::function<void()> onNewPage;
     };
@@ -22,6 +22,8 @@
 #ifndef MU_ENGRAVING_LAYOUTOPTIONS_H
 #define MU_ENGRAVING_LAYOUTOPTIONS_H
 
+#include <cstddef>
+
 namespace mu::engraving {
 //---------------------------------------------------------
 //   LayoutMode
@@ -45,6 +47,16 @@ struct LayoutOptions
     bool isMode(LayoutMode m) const { return mode == m; }
     bool isLinearMode() const { return mode == LayoutMode::LINE || mode == LayoutMode::HORIZONTAL_FIXED; }
 };
+
+//! NOTE What the last layout of the score did: the systems and pages
+//! that were not relaid are kept from the previous layout
+struct LayoutStatistics
+{
+    size_t relaidSystems = 0;
+    size_t reusedSystems = 0;
+    size_t relaidPages = 0;
+    size_t reusedPages = 0;
+};
 }
 
 #endif // MU_ENGRAVING_LAYOUTOPTIONS_H
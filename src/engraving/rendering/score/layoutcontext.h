@@ -24,6 +24,7 @@
 
 #include <vector>
 #include <set>
+#include <unordered_map>
 
 #include "../../types/fraction.h"
 #include "../../types/types.h"
@@ -236,6 +237,10 @@ public:
 
     bool rangeDone() const { return m_rangeDone; }
 
+    size_t relaidSystemCount() const { return m_relaidSystemCount; }
+    size_t relaidPageCount() const { return m_relaidPageCount; }
+    const std::unordered_map<const System*, std::vector<double> >& oldStaffLayouts() const { return m_oldStaffLayouts; }
+
     double totalBracketsWidth() const { return m_totalBracketsWidth; }
 
     // Mutable
@@ -273,6 +278,10 @@ public:
 
     void setRangeDone(bool val) { m_rangeDone = val; }
 
+    void incRelaidSystemCount() { ++m_relaidSystemCount; }
+    void incRelaidPageCount() { ++m_relaidPageCount; }
+    std::unordered_map<const System*, std::vector<double> >& oldStaffLayouts() { return m_oldStaffLayouts; }
+
     void setTotalBracketsWidth(double val) { m_totalBracketsWidth = val; }
 
 private:
@@ -304,6 +313,13 @@ private:
 
     bool m_rangeDone = false;
 
+    size_t m_relaidSystemCount = 0;
+    size_t m_relaidPageCount = 0;
+
+    //! NOTE The staff positions of the reusable systems before layout,
+    //! to find the systems which page layout didn't change
+    std::unordered_map<const System*, std::vector<double> > m_oldStaffLayouts;
+
     // cache
     double m_totalBracketsWidth = -1.0;
 };
@@ -109,6 +109,7 @@ void PageLayout::getNextPage(LayoutContext& ctx)
     }
     state.setPageIdx(state.pageIdx() + 1);
     state.page()->setPos(x, y);
+    state.incRelaidPageCount();
 }
 
 //---------------------------------------------------------
@@ -284,6 +285,10 @@ void PageLayout::collectPage(LayoutContext& ctx)
 
     Fraction stick2 = Fraction(-1, 1);
     for (System* s : page->systems()) {
+        if (!isSystemChanged(ctx, s)) {
+            continue;
+        }
+
         for (MeasureBase* mb : s->measures()) {
             if (!mb->isMeasure()) {
                 continue;
@@ -397,6 +402,51 @@ void PageLayout::collectPage(LayoutContext& ctx)
     page->invalidateBspTree();
 }
 
+//---------------------------------------------------------
+//   staffLayout
+//---------------------------------------------------------
+
+std::vector<double> PageLayout::staffLayout(const System* system)
+{
+    std::vector<double> layout;
+    layout.reserve(system->staves().size() * 3);
+    for (const SysStaff* staff : system->staves()) {
+        layout.push_back(staff->show() ? 1.0 : 0.0);
+        layout.push_back(staff->y());
+        layout.push_back(staff->bbox().height());
+    }
+    return layout;
+}
+
+//---------------------------------------------------------
+//   isSystemChanged
+//    Whether the cross-staff items, tuplets, note spanners and barlines
+//    of the system need to be laid out again after page layout.
+//    That is the case for the relaid systems and for their neighbours,
+//    which share ties and the first and last measures with them,
+//    and for the systems whose staves were moved by page layout.
+//---------------------------------------------------------
+
+bool PageLayout::isSystemChanged(const LayoutContext& ctx, const System* system)
+{
+    if (!system->firstMeasure()) {
+        return true;
+    }
+
+    const Fraction stick = system->firstMeasure()->tick();
+    const Fraction etick = system->endTick();
+    if (etick >= ctx.state().startTick() && stick <= ctx.state().tick()) {
+        return true;
+    }
+
+    auto it = ctx.state().oldStaffLayouts().find(system);
+    if (it == ctx.state().oldStaffLayouts().end()) {
+        return true;
+    }
+
+    return it->second != staffLayout(system);
+}
+
 void PageLayout::layoutCrossStaffElements(LayoutContext& ctx, Page* page)
 {
     for (System* system : page->systems()) {
@@ -37,7 +37,11 @@ public:
     static void getNextPage(LayoutContext& ctx);
     static void collectPage(LayoutContext& ctx);
 
+    static std::vector<double> staffLayout(const System* system);
+
 private:
+    static bool isSystemChanged(const LayoutContext& ctx, const System* system);
+
     static void layoutPage(LayoutContext& ctx, Page* page, double restHeight, double footerPadding);
     static void checkDivider(LayoutContext& ctx, bool left, System* s, double yOffset, bool remove = false);
     static void distributeStaves(LayoutContext& ctx, Page* page, double footerPadding);
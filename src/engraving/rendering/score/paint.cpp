@@ -21,10 +21,15 @@
  */
 #include "paint.h"
 
+#include "hashutils.h"
+
 #include "draw/painter.h"
+#include "draw/bufferedpaintprovider.h"
+#include "draw/utils/drawdatapaint.h"
 #include "dom/score.h"
 #include "dom/page.h"
 #include "dom/engravingitem.h"
+#include "dom/note.h"
 
 #include "tdraw.h"
 #include "debugpaint.h"
@@ -71,6 +76,11 @@ void Paint::paintScore(Painter* painter, Score* score, const IScoreRenderer::Pai
     score->setPrinting(opt.isPrinting);
     mu::engraving::MScore::pdfPrinting = opt.isPrinting;
 
+    //! NOTE The recordings of the items go to the painter without the objects,
+    //! which the extended provider and the buffered ones are interested in
+    const bool useDisplayLists = opt.useDisplayLists && !Painter::extended;
+    const size_t displayListContext = useDisplayLists ? Paint::displayListContext(score) : 0;
+
     // Setup page counts
     int fromPage = opt.fromPage >= 0 ? opt.fromPage : 0;
     int toPage = (opt.toPage >= 0 && opt.toPage < int(pages.size())) ? opt.toPage : (int(pages.size()) - 1);
@@ -145,7 +155,12 @@ void Paint::paintScore(Painter* painter, Score* score, const IScoreRenderer::Pai
             }
 
             std::vector<EngravingItem*> elements = page->items(drawRect.translated(-pagePos));
-            paintItems(*painter, elements);
+            if (useDisplayLists) {
+                page->displayList().setContext(displayListContext);
+                paintItems(*painter, elements, page->displayList());
+            } else {
+                paintItems(*painter, elements);
+            }
             //DebugPaint::paintPageTree(*painter, page);
 
             if (disableClipping) {
@@ -221,7 +236,6 @@ void Paint::paintItem(Painter& painter, const EngravingItem* item)
     if (item->ldata()->isSkipDraw()) {
         return;
     }
-    item->itemDiscovered = false;
     PointF itemPosition(item->pagePos());
 
     painter.translate(itemPosition);
@@ -244,3 +258,133 @@ void Paint::paintItems(Painter& painter, const std::vector<EngravingItem*>& item
         paintItem(painter, item);
     }
 }
+
+void Paint::paintItems(Painter& painter, const std::vector<EngravingItem*>& items, DisplayList& displayList)
+{
+    TRACEFUNC;
+    std::vector<EngravingItem*> sortedItems(items.begin(), items.end());
+
+    std::sort(sortedItems.begin(), sortedItems.end(), mu::engraving::elementLessThan);
+
+    for (const EngravingItem* item : sortedItems) {
+        if (!item->isInteractionAvailable()) {
+            continue;
+        }
+
+        paintItem(painter, item, displayList);
+    }
+}
+
+void Paint::paintItem(Painter& painter, const EngravingItem* item, DisplayList& displayList)
+{
+    TRACEFUNC;
+    if (item->ldata()->isSkipDraw()) {
+        return;
+    }
+
+    if (!isRecordable(painter, item)) {
+        paintItem(painter, item);
+        return;
+    }
+
+    const size_t signature = displayListSignature(item);
+    DrawDataPtr data = displayList.find(item, signature);
+    if (!data) {
+        data = record(item);
+        displayList.insert(item, signature, data);
+    }
+
+    PointF itemPosition(item->pagePos());
+
+    painter.translate(itemPosition);
+    DrawDataPaint::replay(&painter, data);
+    painter.translate(-itemPosition);
+}
+
+bool Paint::isRecordable(const Painter& painter, const EngravingItem* item)
+{
+    //! NOTE These items draw depending on the scale of the painter
+    switch (item->type()) {
+    case ElementType::IMAGE:
+    case ElementType::LASSO:
+        return false;
+    default:
+        break;
+    }
+
+#ifndef Q_OS_MACOS
+    //! NOTE See TextBase::drawTextWorkaround
+    if (item->isTextBase() && !MScore::pdfPrinting && painter.worldTransform().m11() < 1.0) {
+        return false;
+    }
+#else
+    UNUSED(painter);
+#endif
+
+    return true;
+}
+
+DrawDataPtr Paint::record(const EngravingItem* item)
+{
+    TRACEFUNC;
+    std::shared_ptr<BufferedPaintProvider> provider = std::make_shared<BufferedPaintProvider>();
+    {
+        Painter painter(provider, "displaylist");
+        painter.setAntialiasing(true);
+        TDraw::drawItem(item, &painter);
+    }
+
+    return provider->drawData();
+}
+
+static size_t colorHash(const Color& color)
+{
+    return (static_cast<size_t>(color.red()) << 24) | (static_cast<size_t>(color.green()) << 16)
+           | (static_cast<size_t>(color.blue()) << 8) | static_cast<size_t>(color.alpha());
+}
+
+size_t Paint::displayListContext(const Score* score)
+{
+    size_t context = 0;
+
+    muse::hashCombine(context, std::hash<double>()(MScore::pixelRatio));
+    muse::hashCombine(context, (score->printing() ? 1 : 0)
+                               | (MScore::pdfPrinting ? 2 : 0)
+                               | (MScore::svgPrinting ? 4 : 0)
+                               | (MScore::warnPitchRange ? 8 : 0)
+                               | (score->isShowInvisible() ? 16 : 0)
+                               | (score->showUnprintable() ? 32 : 0)
+                               | (score->showFrames() ? 64 : 0)
+                               | (score->showPageborders() ? 128 : 0)
+                               | (score->showSoundFlags() ? 256 : 0)
+                               | (score->markIrregularMeasures() ? 512 : 0)
+                               | (score->configuration()->scoreInversionEnabled() ? 1024 : 0));
+
+    muse::hashCombine(context, colorHash(score->configuration()->defaultColor()));
+    muse::hashCombine(context, colorHash(score->configuration()->invisibleColor()));
+    muse::hashCombine(context, colorHash(score->configuration()->formattingColor()));
+    muse::hashCombine(context, colorHash(score->configuration()->unlinkedColor()));
+    for (voice_idx_t voice = 0; voice <= VOICES; ++voice) {
+        muse::hashCombine(context, colorHash(score->configuration()->voiceColor(voice)));
+    }
+
+    return context;
+}
+
+size_t Paint::displayListSignature(const EngravingItem* item)
+{
+    size_t signature = 0;
+
+    //! NOTE The layout data is taken for writing each time the item is laid out
+    const EngravingItem::LayoutData* ldata = item->ldata();
+    muse::hashCombine(signature, static_cast<size_t>(ldata->id()));
+    muse::hashCombine(signature, static_cast<size_t>(ldata->revision()));
+
+    muse::hashCombine(signature, colorHash(item->color()));
+    muse::hashCombine(signature, (item->selected() ? 1 : 0)
+                                 | (item->dropTarget() ? 2 : 0)
+                                 | (item->visible() ? 4 : 0)
+                                 | ((item->isNote() && toNote(item)->mark()) ? 8 : 0));
+
+    return signature;
+}
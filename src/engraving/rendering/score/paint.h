@@ -25,9 +25,11 @@
 #include <vector>
 
 #include "draw/painter.h"
+#include "draw/types/drawdata.h"
 #include "../iscorerenderer.h"
 
 namespace mu::engraving {
+class DisplayList;
 class EngravingItem;
 class Page;
 class Score;
@@ -46,6 +48,14 @@ public:
     static SizeF pageSizeInch(const Score* score, const IScoreRenderer::PaintOptions& opt);
 
 private:
+    static void paintItems(muse::draw::Painter& painter, const std::vector<EngravingItem*>& items, DisplayList& displayList);
+    static void paintItem(muse::draw::Painter& painter, const EngravingItem* item, DisplayList& displayList);
+
+    static bool isRecordable(const muse::draw::Painter& painter, const EngravingItem* item);
+    static muse::draw::DrawDataPtr record(const EngravingItem* item);
+
+    static size_t displayListContext(const Score* score);
+    static size_t displayListSignature(const EngravingItem* item);
 };
 }
 
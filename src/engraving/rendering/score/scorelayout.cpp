@@ -21,6 +21,8 @@
  */
 #include "scorelayout.h"
 
+#include <algorithm>
+
 #include "dom/score.h"
 #include "dom/masterscore.h"
 #include "dom/system.h"
@@ -95,5 +97,12 @@ void ScoreLayout::layoutRange(Score* score, const Fraction& st, const Fraction&
         break;
     }
 
+    LayoutStatistics stats;
+    stats.relaidSystems = std::min(ctx.state().relaidSystemCount(), score->systems().size());
+    stats.reusedSystems = score->systems().size() - stats.relaidSystems;
+    stats.relaidPages = std::min(ctx.state().relaidPageCount(), score->pages().size());
+    stats.reusedPages = score->pages().size() - stats.relaidPages;
+    score->setLayoutStatistics(stats);
+
     //LOGDA() << DumpLayoutData::dump(score);
 }
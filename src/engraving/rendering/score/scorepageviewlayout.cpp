@@ -84,6 +84,9 @@ void ScorePageViewLayout::initLayoutContext(const Score* score, LayoutContext& c
         state.setStartTick(system->measures().front()->tick());
         state.setCurSystem(system);
         state.setSystemList(muse::mid(score->systems(), systemIndex));
+        for (const System* s : state.systemList()) {
+            state.oldStaffLayouts()[s] = PageLayout::staffLayout(s);
+        }
 
         // set current page
         state.setPage(system->page());
@@ -82,6 +82,9 @@ void ScoreVerticalViewLayout::layoutVerticalView(Score* score, LayoutContext& ct
         }
         ctx.mutState().setCurSystem(system);
         ctx.mutState().setSystemList(muse::mid(score->systems(), systemIndex));
+        for (const System* s : ctx.state().systemList()) {
+            ctx.mutState().oldStaffLayouts()[s] = PageLayout::staffLayout(s);
+        }
 
         if (systemIndex == 0) {
             ctx.mutState().setNextMeasure(ctx.conf().isShowVBox() ? score->first() : score->firstMeasure());
@@ -112,6 +112,7 @@ System* SystemLayout::collectSystem(LayoutContext& ctx)
     }
 
     System* system = getNextSystem(ctx);
+    ctx.mutState().incRelaidSystemCount();
 
     LAYOUT_CALL() << LAYOUT_ITEM_INFO(system);
 
@@ -23,6 +23,7 @@
 
 #include <memory>
 
+#include "global/concurrency/taskscheduler.h"
 #include "global/io/buffer.h"
 #include "global/types/retval.h"
 
@@ -33,6 +34,8 @@
 #include "../dom/excerpt.h"
 #include "../dom/imageStore.h"
 
+#include "../style/defaultstyle.h"
+
 #include "compat/compatutils.h"
 #include "compat/readstyle.h"
 
@@ -71,6 +74,56 @@ static RetVal<IReaderPtr> makeReader(int version, bool ignoreVersionError)
     return RetVal<IReaderPtr>::make_ok(RWRegister::reader(version));
 }
 
+struct ExcerptFile {
+    MStyle style;
+    ByteArray data;
+    std::shared_ptr<const XmlStreamReader::Recording> tokens;
+};
+
+//! NOTE Unzipping the excerpt files, reading their styles and tokenizing their XML doesn't touch
+//! the master score, so it is done concurrently. The part scores are built afterwards from the tokens,
+//! on one thread and in file order: building generates EIDs from the master score and links
+//! the elements to the master score's ones, so it must stay sequential for the result to be the same as before
+static std::vector<ExcerptFile> readExcerptFiles(const MasterScore* masterScore, const MscReader& mscReader,
+                                                 const std::vector<String>& excerptFileNames)
+{
+    TRACEFUNC;
+
+    // See ReadStyleHook::setupDefaultStyle(Score*)
+    const int defaultsVersion = masterScore->style().defaultStyleVersion();
+    const MStyle& defaultStyle = DefaultStyle::resolveStyleDefaults(defaultsVersion);
+
+    std::vector<ExcerptFile> files(excerptFileNames.size());
+
+    auto readFile = [&](size_t index) {
+        const String& excerptFileName = excerptFileNames.at(index);
+        ExcerptFile& file = files.at(index);
+
+        file.style = defaultStyle;
+        file.style.setDefaultStyleVersion(defaultsVersion);
+
+        ByteArray excerptStyleData = mscReader.readExcerptStyleFile(excerptFileName);
+        Buffer excerptStyleBuf(&excerptStyleData);
+        excerptStyleBuf.open(IODevice::ReadOnly);
+        file.style.read(&excerptStyleBuf);
+
+        file.data = mscReader.readExcerptFile(excerptFileName);
+
+        XmlStreamReader tokenizer(file.data);
+        tokenizer.startRecording();
+        file.tokens = tokenizer.takeRecording();
+
+        // the recording owns the decoded text, the data is only needed to report the errors of a malformed file
+        if (file.tokens) {
+            file.data = ByteArray();
+        }
+    };
+
+    TaskScheduler::shared().parallelFor(files.size(), readFile);
+
+    return files;
+}
+
 Ret MscLoader::loadMscz(MasterScore* masterScore, const MscReader& mscReader, SettingsCompat& settingsCompat,
                         bool ignoreVersionError, rw::ReadInOutData* inOut)
 {
@@ -156,23 +209,28 @@ Ret MscLoader::loadMscz(MasterScore* masterScore, const MscReader& mscReader, Se
     // Read excerpts
     if (ret && masterScore->mscVersion() >= 400) {
         std::vector<String> excerptFileNames = mscReader.excerptFileNames();
-        for (const String& excerptFileName : excerptFileNames) {
-            Score* partScore = masterScore->createScore();
+        std::vector<ExcerptFile> excerptFiles = readExcerptFiles(masterScore, mscReader, excerptFileNames);
+
+        for (size_t i = 0; i < excerptFileNames.size(); ++i) {
+            const String& excerptFileName = excerptFileNames.at(i);
+            ExcerptFile& excerptFile = excerptFiles.at(i);
 
-            compat::ReadStyleHook::setupDefaultStyle(partScore);
+            Score* partScore = masterScore->createScore();
+            partScore->setStyle(excerptFile.style);
 
             Excerpt* ex = new Excerpt(masterScore);
             ex->setExcerptScore(partScore);
             ex->setFileName(excerptFileName);
 
-            ByteArray excerptStyleData = mscReader.readExcerptStyleFile(excerptFileName);
-            Buffer excerptStyleBuf(&excerptStyleData);
-            excerptStyleBuf.open(IODevice::ReadOnly);
-            partScore->style().read(&excerptStyleBuf);
+            // the data and the tokens aren't needed after reading
+            ByteArray excerptData = std::move(excerptFile.data);
 
-            ByteArray excerptData = mscReader.readExcerptFile(excerptFileName);
-
-            XmlReader xml(excerptData);
+            XmlReader xml;
+            if (excerptFile.tokens) {
+                xml.replay(std::move(excerptFile.tokens));
+            } else {
+                xml.setData(excerptData);
+            }
             xml.setDocName(excerptFileName);
 
             ReadInOutData partReadInData;
@@ -184,7 +242,9 @@ Ret MscLoader::loadMscz(MasterScore* masterScore, const MscReader& mscReader, Se
                 break;
             }
 
+            partScore->spannerMap().beginBulkInsert();
             Err err = reader.val->readScore(partScore, xml, &partReadInData);
+            partScore->spannerMap().endBulkInsert();
             ret =  make_ret(err);
             if (!ret) {
                 break;
@@ -258,7 +318,9 @@ Ret MscLoader::readMasterScore(MasterScore* score, XmlReader& e, bool ignoreVers
                 score->checkChordList();
             }
 
+            score->spannerMap().beginBulkInsert();
             Err err = reader.val->readScore(score, e, out);
+            score->spannerMap().endBulkInsert();
 
             score->setExcerptsChanged(false);
 
@@ -1281,8 +1281,6 @@ const TextStyle* textStyle(TextStyleType idx)
     return nullptr;
 }
 
-static std::vector<TextStyleType> _allTextStyles;
-
 static const std::vector<TextStyleType> _primaryTextStyles = {
     TextStyleType::TITLE,
     TextStyleType::SUBTITLE,
@@ -1334,13 +1332,16 @@ static const std::vector<TextStyleType> _primaryTextStyles = {
 
 const std::vector<TextStyleType>& allTextStyles()
 {
-    if (_allTextStyles.empty()) {
-        _allTextStyles.reserve(int(TextStyleType::TEXT_TYPES));
+    //! NOTE Initialized once, thread-safe, read-only afterwards
+    static const std::vector<TextStyleType> styles = []() {
+        std::vector<TextStyleType> result;
+        result.reserve(int(TextStyleType::TEXT_TYPES));
         for (int t = int(TextStyleType::DEFAULT) + 1; t < int(TextStyleType::TEXT_TYPES); ++t) {
-            _allTextStyles.push_back(TextStyleType(t));
+            result.push_back(TextStyleType(t));
         }
-    }
-    return _allTextStyles;
+        return result;
+    }();
+    return styles;
 }
 
 //---------------------------------------------------------
@@ -1352,14 +1353,13 @@ const std::vector<TextStyleType>& primaryTextStyles()
     return _primaryTextStyles;
 }
 
-static std::vector<TextStyleType> _editableTextStyles;
-
 const std::vector<TextStyleType>& editableTextStyles()
 {
-    if (_editableTextStyles.empty()) {
-        _editableTextStyles = allTextStyles();
-        muse::remove(_editableTextStyles, TextStyleType::DYNAMICS);
-    }
-    return _editableTextStyles;
+    static const std::vector<TextStyleType> styles = []() {
+        std::vector<TextStyleType> result = allTextStyles();
+        muse::remove(result, TextStyleType::DYNAMICS);
+        return result;
+    }();
+    return styles;
 }
 }
@@ -22,6 +22,9 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <chrono>
+
 #include "dom/bsp.h"
 #include "dom/page.h"
 
@@ -86,3 +89,160 @@ TEST_F(Engraving_BspTreeTests, NearestNeighbor)
         EXPECT_EQ(nn, singleNote);
     }
 }
+
+static std::vector<RectF> queryRects(const RectF& pageRect)
+{
+    std::vector<RectF> rects;
+
+    const int steps = 12;
+    const double w = pageRect.width() / steps;
+    const double h = pageRect.height() / steps;
+
+    for (int i = 0; i < steps; ++i) {
+        for (int j = 0; j < steps; ++j) {
+            rects.emplace_back(pageRect.left() + i * w, pageRect.top() + j * h, w, h);
+            rects.emplace_back(pageRect.left() + i * w, pageRect.top() + j * h, 3 * w, 2 * h);
+        }
+    }
+
+    rects.push_back(pageRect);
+
+    return rects;
+}
+
+/**
+ * @brief Engraving_BspTreeTests_ItemsInRect
+ * @details Check that BspTree::items(RectF) finds exactly the items whose bounding boxes intersect the rect,
+ *          also after items have been removed from the tree
+ */
+TEST_F(Engraving_BspTreeTests, ItemsInRect)
+{
+    Score* score = ScoreRW::readScore(BSPTREE_DATA_DIR + u"nearest_neighbor.mscx");
+    EXPECT_TRUE(score);
+
+    Page* page = score->pages().at(0);
+    EXPECT_TRUE(page);
+
+    // [GIVEN] A BspTree containing all the elements of the page
+    std::vector<EngravingItem*> elements = page->elements();
+    EXPECT_FALSE(elements.empty());
+
+    BspTree bsp;
+    bsp.build(page->pageBoundingRect(), elements);
+
+    auto checkItems = [&bsp](const std::vector<EngravingItem*>& expectedElements, const RectF& rect) {
+        std::set<EngravingItem*> expected;
+        for (EngravingItem* e : expectedElements) {
+            if (e->pageBoundingRect().intersects(rect)) {
+                expected.insert(e);
+            }
+        }
+
+        std::vector<EngravingItem*> found = bsp.items(rect);
+        std::set<EngravingItem*> actual(found.begin(), found.end());
+
+        // [THEN] No duplicates, and the same items as a full scan
+        EXPECT_EQ(found.size(), actual.size());
+        EXPECT_EQ(actual, expected);
+    };
+
+    // [WHEN] Querying rects all over the page
+    for (const RectF& rect : queryRects(page->pageBoundingRect())) {
+        checkItems(elements, rect);
+    }
+
+    // [WHEN] Removing every other element and querying again
+    std::vector<EngravingItem*> remaining;
+    for (size_t i = 0; i < elements.size(); ++i) {
+        if (i % 2) {
+            bsp.remove(elements[i]);
+        } else {
+            remaining.push_back(elements[i]);
+        }
+    }
+
+    for (const RectF& rect : queryRects(page->pageBoundingRect())) {
+        checkItems(remaining, rect);
+    }
+}
+
+/**
+ * @brief Engraving_BspTreeTests_ItemsInRectAfterMove
+ * @details Check that BspTree::items(RectF) doesn't return an item which was moved out of the rect
+ *          since it was inserted, and finds it again once the tree is rebuilt
+ */
+TEST_F(Engraving_BspTreeTests, ItemsInRectAfterMove)
+{
+    Score* score = ScoreRW::readScore(BSPTREE_DATA_DIR + u"nearest_neighbor.mscx");
+    EXPECT_TRUE(score);
+
+    Page* page = score->pages().at(0);
+    EXPECT_TRUE(page);
+
+    // [GIVEN] A BspTree containing all the elements of the page, and a note found in its own rect
+    std::vector<EngravingItem*> elements = page->elements();
+    auto noteIt = std::find_if(elements.begin(), elements.end(), [](const EngravingItem* e) { return e->isNote(); });
+    ASSERT_TRUE(noteIt != elements.end());
+    EngravingItem* note = *noteIt;
+
+    BspTree bsp;
+    bsp.build(page->pageBoundingRect(), elements);
+
+    const RectF oldRect = note->pageBoundingRect();
+    std::vector<EngravingItem*> found = bsp.items(oldRect);
+    EXPECT_NE(std::find(found.begin(), found.end(), note), found.end());
+
+    // [WHEN] The note is moved away, without rebuilding the tree
+    note->mutldata()->move(PointF(0.0, 2 * oldRect.height() + 1.0));
+    ASSERT_FALSE(note->pageBoundingRect().intersects(oldRect));
+
+    // [THEN] It isn't found at its old place anymore
+    found = bsp.items(oldRect);
+    EXPECT_EQ(std::find(found.begin(), found.end(), note), found.end());
+
+    // [WHEN] The tree is rebuilt
+    bsp.build(page->pageBoundingRect(), elements);
+
+    // [THEN] It is found at its new place
+    found = bsp.items(note->pageBoundingRect());
+    EXPECT_NE(std::find(found.begin(), found.end(), note), found.end());
+}
+
+/**
+ * @brief Engraving_BspTreeTests_DISABLED_ItemsInRectBenchmark
+ * @details Measures the rebuild and rect query time of BspTree; run with --gtest_also_run_disabled_tests
+ */
+TEST_F(Engraving_BspTreeTests, DISABLED_ItemsInRectBenchmark)
+{
+    Score* score = ScoreRW::readScore(BSPTREE_DATA_DIR + u"nearest_neighbor.mscx");
+    EXPECT_TRUE(score);
+
+    Page* page = score->pages().at(0);
+    EXPECT_TRUE(page);
+
+    std::vector<EngravingItem*> elements = page->elements();
+    std::vector<RectF> rects = queryRects(page->pageBoundingRect());
+
+    BspTree bsp;
+
+    const int iterations = 1000;
+    size_t foundCount = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        bsp.build(page->pageBoundingRect(), elements);
+    }
+    auto built = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) {
+        for (const RectF& rect : rects) {
+            foundCount += bsp.items(rect).size();
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    using us = std::chrono::microseconds;
+    std::cout << "elements: " << elements.size()
+              << ", build: " << std::chrono::duration_cast<us>(built - start).count() / iterations << " us"
+              << ", " << rects.size() << " queries: " << std::chrono::duration_cast<us>(end - built).count() / iterations << " us"
+              << " (found " << foundCount / iterations << ")" << std::endl;
+}
@@ -0,0 +1,142 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <QImage>
+
+#include "draw/painter.h"
+
+#include "dom/note.h"
+#include "dom/page.h"
+#include "dom/score.h"
+
+#include "rendering/score/paint.h"
+
+#include "utils/scorerw.h"
+
+using namespace mu;
+using namespace mu::engraving;
+using namespace muse::draw;
+
+static const String DISPLAYLIST_DATA_DIR(u"displaylist_data/");
+
+class Engraving_DisplayListTests : public ::testing::Test
+{
+public:
+    static QImage paintFirstPage(Score* score, bool useDisplayLists)
+    {
+        constexpr int DEVICE_DPI = 72;
+
+        const SizeF pageSize = rendering::score::Paint::pageSizeInch(score);
+        QImage image(std::lrint(pageSize.width() * DEVICE_DPI), std::lrint(pageSize.height() * DEVICE_DPI),
+                     QImage::Format_ARGB32_Premultiplied);
+        image.fill(Qt::white);
+
+        {
+            Painter painter(&image, "displaylist");
+
+            rendering::IScoreRenderer::PaintOptions opt;
+            opt.fromPage = 0;
+            opt.toPage = 0;
+            opt.deviceDpi = DEVICE_DPI;
+            opt.printPageBackground = false;
+            opt.useDisplayLists = useDisplayLists;
+
+            rendering::score::Paint::paintScore(&painter, score, opt);
+        }
+
+        return image;
+    }
+};
+
+TEST_F(Engraving_DisplayListTests, Replay)
+{
+    //! GIVEN A laid out score
+    MasterScore* score = ScoreRW::readScore(DISPLAYLIST_DATA_DIR + u"displaylist-1.mscx");
+    ASSERT_TRUE(score);
+
+    Page* page = score->pages().at(0);
+    const QImage expected = paintFirstPage(score, false);
+
+    //! DO Paint it with the display lists
+    QImage image = paintFirstPage(score, true);
+
+    //! CHECK All the items are recorded, the result is the same as drawing them
+    EXPECT_GT(page->displayList().size(), 0);
+    EXPECT_EQ(page->displayList().stats().hits, 0);
+    EXPECT_EQ(image, expected);
+
+    //! DO Paint it again
+    page->displayList().resetStats();
+    image = paintFirstPage(score, true);
+
+    //! CHECK Nothing is recorded again
+    EXPECT_EQ(page->displayList().stats().misses, 0);
+    EXPECT_GT(page->displayList().stats().hits, 0);
+    EXPECT_EQ(image, expected);
+
+    delete score;
+}
+
+TEST_F(Engraving_DisplayListTests, Edit)
+{
+    //! GIVEN A score painted with the display lists
+    MasterScore* score = ScoreRW::readScore(DISPLAYLIST_DATA_DIR + u"displaylist-1.mscx");
+    ASSERT_TRUE(score);
+
+    Page* page = score->pages().at(0);
+    paintFirstPage(score, true);
+
+    Note* note = nullptr;
+    for (EngravingItem* item : page->elements()) {
+        if (item->isNote()) {
+            note = toNote(item);
+            break;
+        }
+    }
+    ASSERT_TRUE(note);
+
+    //! DO Select a note
+    score->select(note);
+    page->displayList().resetStats();
+    QImage image = paintFirstPage(score, true);
+
+    //! CHECK Only the note is recorded again
+    EXPECT_EQ(page->displayList().stats().misses, 1);
+    EXPECT_EQ(image, paintFirstPage(score, false));
+
+    //! DO Change the color of the note
+    score->startCmd();
+    note->undoChangeProperty(Pid::COLOR, PropertyValue::fromValue(Color::RED));
+    score->endCmd();
+
+    page = score->pages().at(0);
+    page->displayList().resetStats();
+    image = paintFirstPage(score, true);
+
+    //! CHECK The laid out items are recorded again, the result is the same as drawing them
+    EXPECT_GT(page->displayList().stats().misses, 0);
+    EXPECT_EQ(image, paintFirstPage(score, false));
+
+    delete score;
+}
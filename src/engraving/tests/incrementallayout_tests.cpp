@@ -0,0 +1,82 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "dom/chordrest.h"
+#include "dom/masterscore.h"
+#include "dom/measure.h"
+#include "dom/page.h"
+#include "dom/segment.h"
+#include "dom/system.h"
+
+#include "utils/scorerw.h"
+
+using namespace mu;
+using namespace mu::engraving;
+
+static const String INCREMENTALLAYOUT_DATA_DIR(u"all_elements_data/");
+
+class Engraving_IncrementalLayoutTests : public ::testing::Test
+{
+};
+
+TEST_F(Engraving_IncrementalLayoutTests, ReuseSystems)
+{
+    MasterScore* score = ScoreRW::readScore(INCREMENTALLAYOUT_DATA_DIR + u"moonlight.mscx");
+    ASSERT_TRUE(score);
+
+    // [GIVEN] A fully laid out score of several pages
+    score->doLayout();
+
+    const size_t systemCount = score->systems().size();
+    const size_t pageCount = score->npages();
+    ASSERT_GT(pageCount, 2);
+
+    LayoutStatistics stats = score->layoutStatistics();
+    EXPECT_EQ(stats.relaidSystems, systemCount);
+    EXPECT_EQ(stats.reusedSystems, 0);
+    EXPECT_EQ(stats.relaidPages, pageCount);
+
+    // [WHEN] A chord on the second page is made small
+    Measure* measure = score->pages().at(1)->systems().front()->firstMeasure();
+    ASSERT_TRUE(measure);
+
+    ChordRest* chordRest = measure->first(SegmentType::ChordRest)->cr(0);
+    ASSERT_TRUE(chordRest);
+
+    score->startCmd();
+    chordRest->undoChangeProperty(Pid::SMALL, !chordRest->isSmall());
+    score->endCmd();
+
+    // [THEN] Only the systems around the edit are relaid, the following ones are reused
+    stats = score->layoutStatistics();
+    EXPECT_EQ(score->systems().size(), systemCount);
+    EXPECT_EQ(score->npages(), pageCount);
+    EXPECT_GT(stats.relaidSystems, 0);
+    EXPECT_GT(stats.reusedSystems, 0);
+    EXPECT_EQ(stats.relaidSystems + stats.reusedSystems, systemCount);
+    EXPECT_GT(stats.reusedPages, 0);
+    EXPECT_EQ(stats.relaidPages + stats.reusedPages, pageCount);
+
+    delete score;
+}
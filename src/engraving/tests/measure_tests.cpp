@@ -42,6 +42,42 @@ static const String MEASURE_DATA_DIR("measure_data/");
 
 class Engraving_MeasureTests : public ::testing::Test
 {
+public:
+    //! NOTE Compare the indexed tick lookups with walking the measure list
+    static void checkTickLookups(const Score* score)
+    {
+        for (MeasureBase* mb = score->first(); mb; mb = mb->next()) {
+            if (!mb->isMeasure()) {
+                continue;
+            }
+            Measure* m = toMeasure(mb);
+            for (const Fraction& tick : { m->tick(), m->tick() + m->ticks() * Fraction(1, 3) }) {
+                if (tick.isZero()) {
+                    continue;
+                }
+                EXPECT_EQ(score->tick2measure(tick), m);
+                EXPECT_EQ(score->tick2measureBase(tick), m);
+            }
+            for (Segment* s = m->first(); s; s = s->next()) {
+                Segment* firstAtTick = nullptr;
+                Segment* lastAtTick = nullptr;
+                for (Segment* ss = score->tick2measure(s->tick())->first(); ss; ss = ss->next()) {
+                    if (ss->tick() == s->tick()) {
+                        firstAtTick = firstAtTick ? firstAtTick : ss;
+                        lastAtTick = ss;
+                    }
+                }
+                EXPECT_EQ(score->tick2segment(s->tick(), true), firstAtTick);
+                EXPECT_EQ(score->tick2segment(s->tick(), false), lastAtTick);
+                EXPECT_EQ(m->findSegmentR(s->segmentType(), s->rtick())->segmentType(), s->segmentType());
+            }
+        }
+
+        Measure* last = score->lastMeasure();
+        EXPECT_EQ(score->tick2measure(last->endTick()), last);
+        EXPECT_EQ(score->tick2measure(last->endTick() + Fraction(1, 4)), nullptr);
+        EXPECT_EQ(score->tick2measureBase(last->endTick()), nullptr);
+    }
 };
 
 TEST_F(Engraving_MeasureTests, DISABLED_insertMeasureMiddle) //TODO: verify program change, 72 is wrong surely?
@@ -606,3 +642,65 @@ TEST_F(Engraving_MeasureTests, measureSplit) {
 
     EXPECT_TRUE(ScoreComp::saveCompareScore(score, u"measureSplit.mscx", MEASURE_DATA_DIR + u"measureSplit-ref.mscx"));
 }
+
+TEST_F(Engraving_MeasureTests, tickLookupsAfterEdits)
+{
+    MasterScore* score = ScoreRW::readScore(MEASURE_DATA_DIR + u"measure-insert_bf_clef.mscx");
+    EXPECT_TRUE(score);
+    checkTickLookups(score);
+
+    // [WHEN] A measure is inserted in the middle
+    Measure* m = score->firstMeasure()->nextMeasure()->nextMeasure();
+    score->startCmd();
+    score->insertMeasure(m);
+    score->endCmd();
+
+    // [THEN] The lookups find the new measure and the shifted ones
+    checkTickLookups(score);
+
+    // [WHEN] The length of a measure changes
+    m = score->firstMeasure()->nextMeasure();
+    score->startCmd();
+    m->adjustToLen(Fraction(6, 4));
+    score->endCmd();
+    checkTickLookups(score);
+
+    // [WHEN] Measures are deleted, and then restored
+    m = score->firstMeasure()->nextMeasure();
+    score->startCmd();
+    score->deleteMeasures(m, m->nextMeasure());
+    score->endCmd();
+    checkTickLookups(score);
+
+    score->undoRedo(true, 0);
+    checkTickLookups(score);
+
+    delete score;
+}
+
+TEST_F(Engraving_MeasureTests, tick2measureMM)
+{
+    MasterScore* score = ScoreRW::readScore(MEASURE_DATA_DIR + u"mmrest.mscx");
+    EXPECT_TRUE(score);
+
+    score->startCmd();
+    score->undoChangeStyleVal(Sid::createMultiMeasureRests, true);
+    score->setLayoutAll();
+    score->endCmd();
+
+    // [THEN] Every tick maps to the same measure as walking the multimeasure rest list
+    bool hasMMRest = false;
+    for (Measure* mm = score->firstMeasureMM(); mm; mm = mm->nextMeasureMM()) {
+        hasMMRest = hasMMRest || mm->isMMRest();
+        for (const Fraction& tick : { mm->tick(), mm->tick() + mm->ticks() * Fraction(1, 2) }) {
+            EXPECT_EQ(score->tick2measureMM(tick), mm);
+        }
+    }
+    EXPECT_TRUE(hasMMRest);
+
+    Measure* last = score->lastMeasureMM();
+    EXPECT_EQ(score->tick2measureMM(last->endTick()), last);
+    EXPECT_EQ(score->tick2measureMM(last->endTick() + Fraction(1, 4)), nullptr);
+
+    delete score;
+}
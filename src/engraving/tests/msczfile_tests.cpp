@@ -88,3 +88,59 @@ TEST_F(Engraving_MsczFileTests, MsczFile_WriteRead)
         EXPECT_EQ(imageData, originImageData);
     }
 }
+
+TEST_F(Engraving_MsczFileTests, MsczFile_WriteSnapshot)
+{
+    //! CASE Collecting the datas to a snapshot and writing it later
+
+    //! GIVEN A snapshot of some datas
+    const ByteArray originScoreData("score");
+    const ByteArray originImageData("image");
+
+    MscWriter::Snapshot snapshot;
+    {
+        MscWriter::Params params;
+        params.filePath = "simple1.mscz";
+        params.mode = MscIoMode::Zip;
+        params.snapshot = &snapshot;
+
+        MscWriter writer(params);
+        writer.open();
+
+        writer.writeScoreFile(originScoreData);
+        writer.addImageFile(u"image1.png", originImageData);
+    }
+
+    //! CHECK The datas and the meta are collected
+    ASSERT_EQ(snapshot.files.size(), 3);
+    EXPECT_EQ(snapshot.files.at(0).first, u"simple1.mscx");
+    EXPECT_EQ(snapshot.files.at(2).first, u"META-INF/container.xml");
+
+    //! DO Write the snapshot
+    ByteArray msczData;
+    {
+        Buffer buf(&msczData);
+        MscWriter::Params params;
+        params.device = &buf;
+        params.filePath = "simple1.mscz";
+        params.mode = MscIoMode::Zip;
+
+        MscWriter writer(params);
+        EXPECT_TRUE(writer.writeSnapshot(snapshot));
+    }
+
+    //! CHECK Read and compare with origin
+    {
+        Buffer buf(&msczData);
+        MscReader::Params params;
+        params.device = &buf;
+        params.filePath = "simple1.mscz";
+        params.mode = MscIoMode::Zip;
+
+        MscReader reader(params);
+        reader.open();
+
+        EXPECT_EQ(reader.readScoreFile(), originScoreData);
+        EXPECT_EQ(reader.readImageFile(u"image1.png"), originImageData);
+    }
+}
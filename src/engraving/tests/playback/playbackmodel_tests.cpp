@@ -836,8 +836,8 @@ TEST_F(Engraving_PlaybackModelTests, SimpleRepeat_Changes_Notification)
     // [GIVEN] The articulation profiles repository will be returning profiles for StringsArticulation family
     ON_CALL(*m_repositoryMock, defaultProfile(_)).WillByDefault(Return(m_defaultProfile));
 
-    // [GIVEN] Expected amount of changed events
-    int expectedChangedEventsCount = 24;
+    // [GIVEN] Expected amount of re-rendered events: 8 notes from 480 up to 3840, then 5 notes of the repeat
+    int expectedChangedEventsCount = 13;
 
     // [GIVEN] The playback model requested to be loaded
     PlaybackModel model(modularity::globalCtx());
@@ -846,10 +846,15 @@ TEST_F(Engraving_PlaybackModelTests, SimpleRepeat_Changes_Notification)
 
     PlaybackData result = model.resolveTrackPlaybackData(part->id(), part->instrumentId());
 
-    // [THEN] Updated events map will match our expectations
-    result.mainStream.onReceive(this, [expectedChangedEventsCount](const PlaybackEventsMap& updatedEvents, const DynamicLevelLayers&,
-                                                                   const PlaybackParamLayers&) {
-        EXPECT_EQ(updatedEvents.size(), expectedChangedEventsCount);
+    // [THEN] Only the changed range of each repeat is sent
+    bool changesReceived = false;
+    result.mainStream.onReceive(this, [expectedChangedEventsCount, &changesReceived](const PlaybackEventsChanges& changes,
+                                                                                     const DynamicLevelLayers&,
+                                                                                     const PlaybackParamLayers&) {
+        EXPECT_FALSE(changes.fullUpdate);
+        EXPECT_EQ(changes.removedRanges.size(), 2);
+        EXPECT_EQ(changes.insertedEvents.size(), expectedChangedEventsCount);
+        changesReceived = true;
     });
 
     // [WHEN] Notation has been changed
@@ -861,6 +866,10 @@ TEST_F(Engraving_PlaybackModelTests, SimpleRepeat_Changes_Notification)
     range.changedTypes = { ElementType::NOTE };
 
     score->changesChannel().send(range);
+
+    // [THEN] The model still contains all the events
+    EXPECT_TRUE(changesReceived);
+    EXPECT_EQ(model.resolveTrackPlaybackData(part->id(), part->instrumentId()).originEvents.size(), 24);
 }
 
 /**
@@ -415,3 +415,33 @@ TEST_F(Engraving_RepeatTests, repeat68) {
     // Entire score skipped by volta: gh#14685
     repeat("repeat68.mscx", u"");
 }
+
+TEST_F(Engraving_RepeatTests, utick2utimeBatch) {
+    // Jump at volta end with end repeat
+    MasterScore* score = ScoreRW::readScore(REPEAT_DATA_DIR + u"repeat65.mscx");
+    ASSERT_TRUE(score);
+
+    score->setExpandRepeats(true);
+    const RepeatList& repeatList = score->repeatList();
+    ASSERT_FALSE(repeatList.empty());
+
+    // [WHEN] We convert sorted and unsorted uticks at once, over all the repeat segments
+    const int endUtick = repeatList.back()->utick + repeatList.back()->len();
+    std::vector<int> uticks;
+    for (int utick = -Constants::DIVISION; utick <= endUtick + Constants::DIVISION; utick += 240) {
+        uticks.push_back(utick);
+    }
+    for (int utick = endUtick; utick >= 0; utick -= 720) {
+        uticks.push_back(utick);
+    }
+
+    std::vector<double> times(uticks.size());
+    repeatList.utick2utime(uticks.data(), times.data(), uticks.size());
+
+    // [THEN] The results are the same as the ones of the single conversion
+    for (size_t i = 0; i < uticks.size(); ++i) {
+        EXPECT_EQ(times.at(i), repeatList.utick2utime(uticks.at(i))) << uticks.at(i);
+    }
+
+    delete score;
+}
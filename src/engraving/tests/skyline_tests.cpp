@@ -0,0 +1,85 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "infrastructure/skyline.h"
+
+using namespace mu;
+using namespace mu::engraving;
+
+class Engraving_SkylineTests : public ::testing::Test
+{
+};
+
+//---------------------------------------------------------
+//   IndexedQueriesMatchShapeScan
+///   The skyline answers distance queries through its x-sorted
+///   envelope; the results must match a plain scan over all
+///   pairs of shape elements, also while elements keep being
+///   added to an already queried skyline.
+//---------------------------------------------------------
+
+TEST_F(Engraving_SkylineTests, IndexedQueriesMatchShapeScan)
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> coord(0.0, 100.0);
+
+    // Integer x-coordinates, so that elements often share edges
+    auto randomRect = [&]() {
+        double x = std::round(coord(rng));
+        double width = std::round(coord(rng) / 5.0);
+        double height = rng() % 7 == 0 ? 0.0 : coord(rng) / 4.0;
+        return RectF(x, coord(rng), width, height);
+    };
+
+    for (int iteration = 0; iteration < 500; ++iteration) {
+        SkylineLine skylineLine(iteration % 2 == 0);
+        Shape plainShape;
+
+        Shape otherShape;
+        size_t otherCount = rng() % 40;
+        for (size_t i = 0; i < otherCount; ++i) {
+            otherShape.add(ShapeElement(randomRect(), nullptr));
+        }
+
+        size_t count = rng() % 80;
+        for (size_t i = 0; i < count; ++i) {
+            ShapeElement element(randomRect(), nullptr);
+            skylineLine.add(element);
+            plainShape.add(element);
+
+            if (rng() % 8 != 0) {
+                continue;
+            }
+
+            double clearance = (rng() % 3) * 0.5;
+
+            EXPECT_EQ(skylineLine.minDistanceToShapeBelow(otherShape, clearance), plainShape.minVerticalDistance(otherShape, clearance));
+            EXPECT_EQ(skylineLine.minDistanceToShapeAbove(otherShape, clearance), otherShape.minVerticalDistance(plainShape, clearance));
+            EXPECT_EQ(skylineLine.verticalClaranceBelow(otherShape), plainShape.verticalClearance(otherShape));
+            EXPECT_EQ(skylineLine.verticalClearanceAbove(otherShape), otherShape.verticalClearance(plainShape));
+        }
+    }
+}
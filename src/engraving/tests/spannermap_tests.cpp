@@ -0,0 +1,228 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <set>
+
+#include "dom/masterscore.h"
+#include "dom/spanner.h"
+#include "dom/spannermap.h"
+
+#include "utils/scorerw.h"
+
+using namespace mu;
+using namespace mu::engraving;
+
+static const String SPANNERMAP_DATA_DIR(u"all_elements_data/");
+
+class Engraving_SpannerMapTests : public ::testing::Test
+{
+public:
+    static std::multiset<Spanner*> toSet(const SpannerMap::IntervalList& intervals)
+    {
+        std::multiset<Spanner*> result;
+        for (const auto& interval : intervals) {
+            result.insert(interval.value);
+        }
+        return result;
+    }
+
+    static std::multiset<Spanner*> bruteForceOverlapping(const std::vector<Spanner*>& spanners, int start, int stop)
+    {
+        std::multiset<Spanner*> result;
+        for (Spanner* s : spanners) {
+            if (s->tick2().ticks() >= start && s->tick().ticks() <= stop) {
+                result.insert(s);
+            }
+        }
+        return result;
+    }
+
+    static std::multiset<Spanner*> bruteForceContained(const std::vector<Spanner*>& spanners, int start, int stop)
+    {
+        std::multiset<Spanner*> result;
+        for (Spanner* s : spanners) {
+            if (s->tick().ticks() >= start && s->tick2().ticks() <= stop) {
+                result.insert(s);
+            }
+        }
+        return result;
+    }
+
+    static std::multiset<Spanner*> visitedOverlapping(const SpannerMap& map, int start, int stop)
+    {
+        std::multiset<Spanner*> result;
+        map.visitOverlapping(start, stop, [&result](const auto& interval) {
+            result.insert(interval.value);
+        });
+        return result;
+    }
+
+    static std::multiset<Spanner*> visitedContained(const SpannerMap& map, int start, int stop)
+    {
+        std::multiset<Spanner*> result;
+        map.visitContained(start, stop, [&result](const auto& interval) {
+            result.insert(interval.value);
+        });
+        return result;
+    }
+
+    //! NOTE The visitors are checked first, as the find methods fold the pending changes into the tree
+    static void checkQueries(const SpannerMap& map, const std::vector<Spanner*>& spanners, int lastTick)
+    {
+        const int step = std::max(1, lastTick / 40);
+        for (int start = 0; start <= lastTick; start += step) {
+            for (int stop = start; stop <= lastTick + step; stop += 3 * step) {
+                EXPECT_EQ(visitedOverlapping(map, start, stop), bruteForceOverlapping(spanners, start, stop));
+                EXPECT_EQ(visitedContained(map, start, stop), bruteForceContained(spanners, start, stop));
+            }
+        }
+
+        for (int start = 0; start <= lastTick; start += step) {
+            for (int stop = start; stop <= lastTick + step; stop += 3 * step) {
+                EXPECT_EQ(toSet(map.findOverlapping(start, stop)), bruteForceOverlapping(spanners, start, stop));
+                EXPECT_EQ(toSet(map.findContained(start, stop)), bruteForceContained(spanners, start, stop));
+            }
+        }
+    }
+};
+
+/**
+ * @brief Engraving_SpannerMapTests_IncrementalUpdates
+ * @details Check that queries stay correct while spanners are removed and added
+ *          without rebuilding the lookup tree from scratch
+ */
+TEST_F(Engraving_SpannerMapTests, IncrementalUpdates)
+{
+    MasterScore* score = ScoreRW::readScore(SPANNERMAP_DATA_DIR + u"moonlight.mscx");
+    ASSERT_TRUE(score);
+
+    // [GIVEN] A map filled with the spanners of the score
+    std::vector<Spanner*> spanners;
+    SpannerMap map;
+    map.beginBulkInsert();
+    for (const auto& pair : score->spannerMap().map()) {
+        spanners.push_back(pair.second);
+        map.addSpanner(pair.second);
+    }
+    map.endBulkInsert();
+
+    ASSERT_FALSE(spanners.empty());
+
+    const int lastTick = score->endTick().ticks();
+    checkQueries(map, spanners, lastTick);
+
+    // [WHEN] Some spanners are removed
+    std::vector<Spanner*> current;
+    std::vector<Spanner*> removed;
+    for (size_t i = 0; i < spanners.size(); ++i) {
+        if (i % 3 == 0) {
+            EXPECT_TRUE(map.removeSpanner(spanners[i]));
+            removed.push_back(spanners[i]);
+        } else {
+            current.push_back(spanners[i]);
+        }
+    }
+
+    // [THEN] They are not found anymore
+    checkQueries(map, current, lastTick);
+
+    // [WHEN] Some of them are added back and others removed again
+    for (size_t i = 0; i < removed.size(); i += 2) {
+        map.addSpanner(removed[i]);
+        current.push_back(removed[i]);
+    }
+
+    for (size_t i = 0; i < removed.size(); i += 4) {
+        EXPECT_TRUE(map.removeSpanner(removed[i]));
+        current.erase(std::find(current.begin(), current.end(), removed[i]));
+    }
+
+    // [THEN] The queries reflect every change
+    checkQueries(map, current, lastTick);
+
+    // [WHEN] The lookup tree is rebuilt
+    map.update();
+
+    // [THEN] The results are the same
+    checkQueries(map, current, lastTick);
+
+    delete score;
+}
+
+/**
+ * @brief Engraving_SpannerMapTests_OrderDoesNotDependOnEdits
+ * @details Check that after edits the queries return the spanners in the same order
+ *          as a map built at once from the same spanners
+ */
+TEST_F(Engraving_SpannerMapTests, OrderDoesNotDependOnEdits)
+{
+    MasterScore* score = ScoreRW::readScore(SPANNERMAP_DATA_DIR + u"moonlight.mscx");
+    ASSERT_TRUE(score);
+
+    // [GIVEN] A map filled with the spanners of the score
+    std::vector<Spanner*> spanners;
+    SpannerMap map;
+    map.beginBulkInsert();
+    for (const auto& pair : score->spannerMap().map()) {
+        spanners.push_back(pair.second);
+        map.addSpanner(pair.second);
+    }
+    map.endBulkInsert();
+
+    ASSERT_FALSE(spanners.empty());
+
+    const int lastTick = score->endTick().ticks();
+    const int step = std::max(1, lastTick / 40);
+
+    // [WHEN] Some spanners are removed and added back, between queries, so that the changes are pending
+    for (size_t i = 0; i < spanners.size(); i += 3) {
+        EXPECT_TRUE(map.removeSpanner(spanners[i]));
+        map.visitOverlapping(0, lastTick, [](const auto&) {});
+    }
+    for (size_t i = 0; i < spanners.size(); i += 3) {
+        map.addSpanner(spanners[i]);
+        map.visitOverlapping(0, lastTick, [](const auto&) {});
+    }
+
+    // [WHEN] Another map is built at once from the spanners, in the order of the edited map
+    SpannerMap freshMap;
+    freshMap.beginBulkInsert();
+    for (const auto& pair : map.map()) {
+        freshMap.addSpanner(pair.second);
+    }
+    freshMap.endBulkInsert();
+
+    // [THEN] Both maps return the spanners in the same order
+    for (int start = 0; start <= lastTick; start += step) {
+        const SpannerMap::IntervalList expected = freshMap.findOverlapping(start, start + 4 * step);
+        const SpannerMap::IntervalList& found = map.findOverlapping(start, start + 4 * step);
+
+        ASSERT_EQ(found.size(), expected.size());
+        for (size_t i = 0; i < found.size(); ++i) {
+            EXPECT_EQ(found[i].value, expected[i].value);
+        }
+    }
+
+    delete score;
+}
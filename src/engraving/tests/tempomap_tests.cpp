@@ -256,3 +256,84 @@ TEST_F(Engraving_TempoMapTests, GRADUAL_TEMPO_CHANGE_DOESNT_OVERWRITE_OTHER_TEMP
         EXPECT_TRUE(muse::RealIsEqual(muse::RealRound(tempoMap->at(pair.first).tempo.val, 2), muse::RealRound(pair.second.val, 2)));
     }
 }
+
+/**
+ * @brief TempoMapTests_TICK_TIME_CONVERSION
+ * @details Check the conversions between ticks and seconds around tempo changes and pauses,
+ *          and that the batch conversion gives the same results as the single one
+ */
+TEST_F(Engraving_TempoMapTests, TICK_TIME_CONVERSION)
+{
+    // [GIVEN] 120 BPM, 180 BPM from the 2-nd quarter of the 3-rd beat, a pause of 1.5 sec at the 5-th beat, 60 BPM from the 7-th beat
+    TempoMap tempoMap;
+    tempoMap.setTempo(0, BeatsPerSecond(2.0));
+    tempoMap.setTempo(2 * Constants::DIVISION, BeatsPerSecond(3.0));
+    tempoMap.setPause(4 * Constants::DIVISION, 1.5);
+    tempoMap.setTempo(6 * Constants::DIVISION, BeatsPerSecond(1.0));
+
+    // [THEN] The ticks are converted to the expected seconds
+    EXPECT_DOUBLE_EQ(tempoMap.tick2time(Constants::DIVISION), 0.5);
+    EXPECT_DOUBLE_EQ(tempoMap.tick2time(2 * Constants::DIVISION), 1.0);
+    EXPECT_DOUBLE_EQ(tempoMap.tick2time(4 * Constants::DIVISION), 1.0 + 2.0 / 3.0 + 1.5);
+    EXPECT_DOUBLE_EQ(tempoMap.tick2time(6 * Constants::DIVISION), 1.0 + 4.0 / 3.0 + 1.5);
+    EXPECT_DOUBLE_EQ(tempoMap.tick2time(7 * Constants::DIVISION), 1.0 + 4.0 / 3.0 + 1.5 + 1.0);
+
+    // [THEN] The seconds are converted back to the ticks, a time in the pause gives the tick of the pause
+    for (int tick = 0; tick < 8 * Constants::DIVISION; tick += Constants::DIVISION / 4) {
+        EXPECT_EQ(tempoMap.time2tick(tempoMap.tick2time(tick)), tick);
+    }
+    EXPECT_EQ(tempoMap.time2tick(1.0 + 2.0 / 3.0 + 0.5), 4 * Constants::DIVISION);
+
+    // [WHEN] We convert sorted and unsorted ticks at once, also before the first tempo and after the last one
+    std::vector<int> ticks;
+    for (int tick = -Constants::DIVISION; tick < 10 * Constants::DIVISION; tick += 120) {
+        ticks.push_back(tick);
+    }
+    for (int tick = 10 * Constants::DIVISION; tick > -Constants::DIVISION; tick -= 360) {
+        ticks.push_back(tick);
+    }
+
+    std::vector<double> times(ticks.size());
+    tempoMap.tick2time(ticks.data(), times.data(), ticks.size());
+
+    // [THEN] The results are the same as the ones of the single conversion
+    for (size_t i = 0; i < ticks.size(); ++i) {
+        EXPECT_EQ(times.at(i), tempoMap.tick2time(ticks.at(i))) << ticks.at(i);
+    }
+}
+
+/**
+ * @brief TempoMapTests_INCREMENTAL_UPDATE
+ * @details Check that the map changed step by step, in any order, is the same as the one made at once
+ */
+TEST_F(Engraving_TempoMapTests, INCREMENTAL_UPDATE)
+{
+    // [GIVEN] A tempo map made in the order of the ticks
+    TempoMap expectedTempoMap;
+    for (int i = 0; i < 16; ++i) {
+        expectedTempoMap.setTempo(i * Constants::DIVISION, BeatsPerSecond(1.0 + i * 0.25));
+    }
+    expectedTempoMap.setPause(5 * Constants::DIVISION, 0.5);
+
+    // [WHEN] We make the same map in the reversed order, with a pause and a tempo which are removed afterwards
+    TempoMap tempoMap;
+    tempoMap.setPause(9 * Constants::DIVISION + 1, 2.0);
+    tempoMap.setTempo(7 * Constants::DIVISION + 1, BeatsPerSecond(4.0));
+    for (int i = 15; i >= 0; --i) {
+        tempoMap.setTempo(i * Constants::DIVISION, BeatsPerSecond(1.0 + i * 0.25));
+    }
+    tempoMap.setPause(5 * Constants::DIVISION, 0.5);
+    tempoMap.delTempo(7 * Constants::DIVISION + 1);
+    tempoMap.clearRange(9 * Constants::DIVISION + 1, 9 * Constants::DIVISION + 2);
+    tempoMap.setTempo(15 * Constants::DIVISION, BeatsPerSecond(1.0 + 15 * 0.25));
+
+    // [THEN] The events and the conversions are the same
+    const std::map<int, TEvent>& events = tempoMap;
+    const std::map<int, TEvent>& expectedEvents = expectedTempoMap;
+    EXPECT_EQ(events, expectedEvents);
+
+    for (int tick = 0; tick < 17 * Constants::DIVISION; tick += 60) {
+        EXPECT_EQ(tempoMap.tick2time(tick), expectedTempoMap.tick2time(tick)) << tick;
+        EXPECT_EQ(tempoMap.tempo(tick), expectedTempoMap.tempo(tick)) << tick;
+    }
+}
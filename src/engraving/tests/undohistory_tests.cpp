@@ -0,0 +1,257 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "dom/chord.h"
+#include "dom/chordrest.h"
+#include "dom/masterscore.h"
+#include "dom/measure.h"
+#include "dom/mscore.h"
+#include "dom/note.h"
+#include "dom/segment.h"
+#include "dom/undo.h"
+
+#include "utils/scorerw.h"
+
+using namespace mu;
+using namespace mu::engraving;
+
+static const String UNDOHISTORY_DATA_DIR(u"undohistory_data/");
+
+class Engraving_UndoHistoryTests : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_limitBytes = MScore::undoHistoryLimitBytes;
+    }
+
+    void TearDown() override
+    {
+        MScore::undoHistoryLimitBytes = m_limitBytes;
+    }
+
+    static EngravingItem* firstChordRest(MasterScore* score)
+    {
+        return score->firstMeasure()->first(SegmentType::ChordRest)->element(0);
+    }
+
+    static void changeColor(MasterScore* score, const Color& color)
+    {
+        score->startCmd();
+        firstChordRest(score)->undoChangeProperty(Pid::COLOR, color);
+        score->endCmd();
+    }
+
+    static Color stepColor(size_t step)
+    {
+        return Color(static_cast<int>(step + 1), 0, 0);
+    }
+
+    static size_t noteCount(MasterScore* score)
+    {
+        size_t count = 0;
+        for (Segment* s = score->firstSegment(SegmentType::ChordRest); s; s = s->next1(SegmentType::ChordRest)) {
+            EngravingItem* e = s->element(0);
+            if (e && e->isChord()) {
+                count += toChord(e)->notes().size();
+            }
+        }
+        return count;
+    }
+
+private:
+    size_t m_limitBytes = 0;
+};
+
+TEST_F(Engraving_UndoHistoryTests, SizeAccounting)
+{
+    MasterScore* score = ScoreRW::readScore(UNDOHISTORY_DATA_DIR + u"undohistory-1.mscx");
+    ASSERT_TRUE(score);
+
+    UndoStack* undoStack = score->undoStack();
+    MScore::undoHistoryLimitBytes = 0;
+
+    //! DO Change a property
+    changeColor(score, Color::RED);
+    const size_t propertyBytes = undoStack->last()->cachedSizeBytes();
+
+    //! DO Remove all the notes
+    score->startCmd();
+    score->cmdSelectAll();
+    score->cmdDeleteSelection();
+    score->endCmd();
+    const size_t removeBytes = undoStack->last()->cachedSizeBytes();
+
+    //! CHECK The sizes of the command classes, of the values and of the removed elements are accounted for
+    EXPECT_GT(propertyBytes, sizeof(UndoMacro) + sizeof(ChangeProperty));
+    EXPECT_GE(removeBytes, 8 * (sizeof(RemoveElement) + sizeof(Chord) + sizeof(Note)));
+
+    UndoStack::HistoryStats stats = undoStack->historyStats();
+    EXPECT_EQ(stats.macroCount, 2);
+    EXPECT_EQ(stats.bytes, propertyBytes + removeBytes);
+    EXPECT_EQ(stats.compactedMacroCount, 0);
+
+    //! DO Undo both
+    undoStack->undo(nullptr);
+    undoStack->undo(nullptr);
+
+    //! CHECK The history is kept for redo
+    EXPECT_FALSE(undoStack->canUndo());
+    EXPECT_EQ(undoStack->historyBytes(), propertyBytes + removeBytes);
+
+    delete score;
+}
+
+TEST_F(Engraving_UndoHistoryTests, CompactionMergesOldestSteps)
+{
+    MasterScore* score = ScoreRW::readScore(UNDOHISTORY_DATA_DIR + u"undohistory-1.mscx");
+    ASSERT_TRUE(score);
+
+    UndoStack* undoStack = score->undoStack();
+    const Color originalColor = firstChordRest(score)->color();
+
+    //! GIVEN A limit that is smaller than any macro
+    MScore::undoHistoryLimitBytes = 1;
+
+    //! DO Change a property three more times than the steps which are never compacted
+    const size_t stepCount = UndoStack::UNCOMPACTED_MACRO_COUNT + 3;
+    for (size_t step = 0; step < stepCount; ++step) {
+        changeColor(score, stepColor(step));
+    }
+
+    //! CHECK The three oldest steps are merged into one, and their changes of the same property into one
+    UndoStack::HistoryStats stats = undoStack->historyStats();
+    EXPECT_EQ(stats.macroCount, UndoStack::UNCOMPACTED_MACRO_COUNT + 1);
+    EXPECT_EQ(stats.compactedMacroCount, 2);
+    EXPECT_GT(stats.compactedCommandCount, 0);
+    EXPECT_EQ(undoStack->getCurIdx(), UndoStack::UNCOMPACTED_MACRO_COUNT + 1);
+
+    //! DO Undo the steps which are not compacted
+    for (size_t i = 0; i < UndoStack::UNCOMPACTED_MACRO_COUNT; ++i) {
+        undoStack->undo(nullptr);
+    }
+
+    //! CHECK They are undone one by one
+    EXPECT_EQ(firstChordRest(score)->color(), stepColor(2));
+    EXPECT_TRUE(undoStack->canUndo());
+
+    //! DO Undo the compacted step
+    undoStack->undo(nullptr);
+
+    //! CHECK The three oldest changes are undone together
+    EXPECT_EQ(firstChordRest(score)->color(), originalColor);
+    EXPECT_FALSE(undoStack->canUndo());
+
+    //! DO Redo the compacted step, then all the others
+    undoStack->redo(nullptr);
+    EXPECT_EQ(firstChordRest(score)->color(), stepColor(2));
+    while (undoStack->canRedo()) {
+        undoStack->redo(nullptr);
+    }
+
+    //! CHECK The last change is back
+    EXPECT_EQ(firstChordRest(score)->color(), stepColor(stepCount - 1));
+
+    delete score;
+}
+
+TEST_F(Engraving_UndoHistoryTests, CompactionKeepsStepsWhichFreeNothing)
+{
+    MasterScore* score = ScoreRW::readScore(UNDOHISTORY_DATA_DIR + u"undohistory-1.mscx");
+    ASSERT_TRUE(score);
+
+    UndoStack* undoStack = score->undoStack();
+    const size_t originalNoteCount = noteCount(score);
+    ASSERT_GT(originalNoteCount, 0);
+
+    //! GIVEN A limit that is smaller than any macro
+    MScore::undoHistoryLimitBytes = 1;
+
+    //! DO Remove all the notes, then make more changes than the steps which are never compacted
+    score->startCmd();
+    score->cmdSelectAll();
+    score->cmdDeleteSelection();
+    score->endCmd();
+    EXPECT_EQ(noteCount(score), 0);
+
+    const size_t stepCount = UndoStack::UNCOMPACTED_MACRO_COUNT + 2;
+    for (size_t step = 0; step < stepCount; ++step) {
+        changeColor(score, stepColor(step));
+    }
+
+    //! CHECK The removal is not merged with the next step, as it would not free anything
+    UndoStack::HistoryStats stats = undoStack->historyStats();
+    EXPECT_EQ(stats.compactedMacroCount, 0);
+    EXPECT_EQ(stats.macroCount, stepCount + 1);
+
+    //! DO Undo the changes
+    for (size_t i = 0; i < stepCount; ++i) {
+        undoStack->undo(nullptr);
+    }
+
+    //! CHECK The notes are still removed
+    EXPECT_EQ(noteCount(score), 0);
+
+    //! DO Undo the removal
+    undoStack->undo(nullptr);
+
+    //! CHECK The removed notes are back
+    EXPECT_EQ(noteCount(score), originalNoteCount);
+    EXPECT_FALSE(undoStack->canUndo());
+
+    delete score;
+}
+
+TEST_F(Engraving_UndoHistoryTests, CompactionWaitsForUnlock)
+{
+    MasterScore* score = ScoreRW::readScore(UNDOHISTORY_DATA_DIR + u"undohistory-1.mscx");
+    ASSERT_TRUE(score);
+
+    UndoStack* undoStack = score->undoStack();
+    MScore::undoHistoryLimitBytes = 1;
+
+    //! GIVEN Someone holds an index of the undo stack
+    const size_t startIdx = undoStack->getCurIdx();
+    undoStack->lockCompaction();
+
+    //! DO Make more changes than the steps which are never compacted
+    const size_t stepCount = UndoStack::UNCOMPACTED_MACRO_COUNT + 3;
+    for (size_t step = 0; step < stepCount; ++step) {
+        changeColor(score, stepColor(step));
+    }
+
+    //! CHECK Nothing is compacted, the index is still valid
+    EXPECT_EQ(undoStack->historyStats().compactedMacroCount, 0);
+    EXPECT_EQ(undoStack->getCurIdx(), startIdx + stepCount);
+
+    //! DO Unlock and make one more change
+    undoStack->unlockCompaction();
+    changeColor(score, Color::BLUE);
+
+    //! CHECK The oldest steps are compacted now
+    EXPECT_EQ(undoStack->historyStats().compactedMacroCount, 3);
+    EXPECT_EQ(undoStack->historyStats().macroCount, UndoStack::UNCOMPACTED_MACRO_COUNT + 1);
+
+    delete score;
+}
@@ -23,8 +23,10 @@
 #ifndef MUSE_AUDIO_ABSTRACTEVENTSEQUENCER_H
 #define MUSE_AUDIO_ABSTRACTEVENTSEQUENCER_H
 
+#include <algorithm>
 #include <map>
 #include <set>
+#include <vector>
 
 #include "global/async/asyncable.h"
 #include "mpe/events.h"
@@ -41,8 +43,54 @@ public:
     using EventSequence = std::set<EventType>;
     using EventSequenceMap = std::map<msecs_t, EventSequence>;
 
-    typedef typename EventSequenceMap::const_iterator SequenceIterator;
-    typedef typename EventSequence::const_iterator EventIterator;
+    struct TimedEvent {
+        msecs_t timestamp = 0;
+        EventType event;
+
+        //! NOTE The timestamp of the playback events this event is rendered from
+        mpe::timestamp_t origin = 0;
+    };
+
+    using TimedEventList = std::vector<TimedEvent>;
+
+    //! NOTE The events of one audio buffer, grouped by timestamp.
+    //! The events point into the sequencer and stay valid until its events are updated
+    struct EventBlock {
+        struct Sequence {
+            msecs_t timestamp = 0;
+            size_t firstEvent = 0;
+            size_t eventCount = 0;
+        };
+
+        std::vector<Sequence> sequences;
+        std::vector<const EventType*> events;
+
+        void clear()
+        {
+            sequences.clear();
+            events.clear();
+        }
+
+        void beginSequence(const msecs_t timestamp)
+        {
+            sequences.push_back(Sequence { timestamp, events.size(), 0 });
+        }
+
+        void append(const msecs_t timestamp, const EventType* event)
+        {
+            if (sequences.empty() || sequences.back().timestamp != timestamp) {
+                beginSequence(timestamp);
+            }
+
+            events.push_back(event);
+            ++sequences.back().eventCount;
+        }
+
+        const EventType& event(const Sequence& sequence, size_t idx) const
+        {
+            return *events[sequence.firstEvent + idx];
+        }
+    };
 
     virtual ~AbstractEventSequencer()
     {
@@ -56,12 +104,18 @@ public:
 
         m_playbackData = data;
 
-        m_playbackData.mainStream.onReceive(this, [this](const mpe::PlaybackEventsMap& events,
+        m_playbackData.mainStream.onReceive(this, [this](const mpe::PlaybackEventsChanges& changes,
                                                          const mpe::DynamicLevelLayers& dynamics,
                                                          const mpe::PlaybackParamLayers& params) {
-            m_playbackData.originEvents = events;
+            changes.applyTo(m_playbackData.originEvents);
             m_playbackData.dynamics = dynamics;
             m_playbackData.params = params;
+
+            //! NOTE A change of some ranges is spliced into the current events, unless they are rebuilt anyway
+            if (!changes.fullUpdate && !m_shouldUpdateMainStreamEvents && applyMainStreamChanges(changes, dynamics, params)) {
+                return;
+            }
+
             m_shouldUpdateMainStreamEvents = true;
 
             if (m_isActive) {
@@ -112,7 +166,7 @@ public:
         ONLY_AUDIO_WORKER_THREAD;
 
         m_playbackPosition = newPlaybackPosition;
-        resetAllIterators();
+        resetAllCursors();
     }
 
     msecs_t playbackPosition() const
@@ -151,31 +205,31 @@ public:
         return mpe::dynamicLevelFromType(muse::mpe::DynamicType::Natural);
     }
 
-    EventSequenceMap movePlaybackForward(const msecs_t nextMsecs)
+    //! NOTE Collects the events of the next nextMsecs into the given block.
+    //! The block is cleared, but keeps its capacity, so that the audio thread does not allocate
+    //! once the block has grown to the biggest number of events per buffer
+    void movePlaybackForward(const msecs_t nextMsecs, EventBlock& result)
     {
         ONLY_AUDIO_WORKER_THREAD;
 
-        EventSequenceMap result;
+        result.clear();
 
         if (!m_isActive) {
-            result.emplace(0, EventSequence());
+            result.beginSequence(0);
             handleOffStream(result, nextMsecs);
-            return result;
+            return;
         }
 
         // Empty sequence means to continue the previous sequence
-        result.emplace(m_playbackPosition, EventSequence());
+        result.beginSequence(m_playbackPosition);
 
-        if (m_currentMainSequenceIt == m_mainStreamEvents.cend()) {
-            return result;
+        if (m_mainStreamCursor >= m_mainStreamEvents.size()) {
+            return;
         }
 
         m_playbackPosition += nextMsecs;
 
         handleMainStream(result);
-        handleDynamicChanges(result);
-
-        return result;
     }
 
 protected:
@@ -183,83 +237,180 @@ protected:
     virtual void updateMainStreamEvents(const mpe::PlaybackEventsMap& events, const mpe::DynamicLevelLayers& dynamics,
                                         const mpe::PlaybackParamLayers& params) = 0;
 
-    void resetAllIterators()
+    //! NOTE Splices the changed ranges into the current main stream events, returns false if not supported
+    virtual bool applyMainStreamChanges(const mpe::PlaybackEventsChanges&, const mpe::DynamicLevelLayers&, const mpe::PlaybackParamLayers&)
     {
-        updateMainSequenceIterator();
-        updateOffSequenceIterator();
-        updateDynamicChangesIterator();
+        return false;
     }
 
-    void updateMainSequenceIterator()
+    //! NOTE Converts the playback events of one timestamp into the sequencer events
+    virtual void appendPlaybackEvents(EventSequenceMap&, const mpe::PlaybackEventList&) {}
+
+    void setMainStreamEvents(const mpe::PlaybackEventsMap& events)
     {
-        m_currentMainSequenceIt = m_mainStreamEvents.lower_bound(m_playbackPosition);
+        m_mainStreamEvents.clear();
+        appendMainStreamEvents(events);
+        std::sort(m_mainStreamEvents.begin(), m_mainStreamEvents.end(), isEarlier);
+        updateMainStreamCursor();
     }
 
-    void updateOffSequenceIterator()
+    //! NOTE Drops the events rendered from the removed ranges, then merges the inserted ones in,
+    //! without rebuilding the untouched events
+    void spliceMainStreamEvents(const mpe::PlaybackEventsChanges& changes)
     {
-        m_currentOffSequenceIt = m_offStreamEvents.cbegin();
+        if (changes.fullUpdate) {
+            setMainStreamEvents(changes.insertedEvents);
+            return;
+        }
+
+        auto removedBegin = std::remove_if(m_mainStreamEvents.begin(), m_mainStreamEvents.end(), [&changes](const TimedEvent& event) {
+            return changes.isRemoved(event.origin);
+        });
+
+        m_mainStreamEvents.erase(removedBegin, m_mainStreamEvents.end());
+
+        const size_t keptCount = m_mainStreamEvents.size();
+        appendMainStreamEvents(changes.insertedEvents);
+
+        auto insertedBegin = m_mainStreamEvents.begin() + keptCount;
+        std::sort(insertedBegin, m_mainStreamEvents.end(), isEarlier);
+        std::inplace_merge(m_mainStreamEvents.begin(), insertedBegin, m_mainStreamEvents.end(), isEarlier);
+
+        updateMainStreamCursor();
     }
 
-    void updateDynamicChangesIterator()
+    void setDynamicEvents(const EventSequenceMap& events)
     {
-        m_currentDynamicsIt = m_dynamicEvents.lower_bound(m_playbackPosition);
+        flatten(events, m_dynamicEvents);
+        updateDynamicEventsCursor();
     }
 
-    void handleOffStream(EventSequenceMap& result, const msecs_t nextMsecs)
+    void setOffStreamEvents(const EventSequenceMap& events)
     {
-        if (m_offStreamEvents.empty() || m_currentOffSequenceIt == m_offStreamEvents.cend()) {
-            return;
-        }
+        flatten(events, m_offStreamEvents);
+        m_offStreamCursor = 0;
+        m_offStreamShift = 0;
+    }
 
-        if (m_currentOffSequenceIt->first <= nextMsecs) {
-            while (m_currentOffSequenceIt != m_offStreamEvents.end()
-                   && m_currentOffSequenceIt->first <= nextMsecs) {
-                result.insert_or_assign(m_currentOffSequenceIt->first, std::move(m_currentOffSequenceIt->second));
-                m_currentOffSequenceIt = m_offStreamEvents.erase(m_currentOffSequenceIt);
-            }
-        } else {
-            auto node = m_offStreamEvents.extract(m_currentOffSequenceIt);
-            node.key() -= nextMsecs;
-            m_offStreamEvents.insert(std::move(node));
-            updateOffSequenceIterator();
-        }
+    //! NOTE The off stream is played regardless of the position, its played events are not repeated
+    void resetAllCursors()
+    {
+        updateMainStreamCursor();
+        updateDynamicEventsCursor();
     }
 
-    void handleMainStream(EventSequenceMap& result)
+    void updateMainStreamCursor()
     {
-        while (m_currentMainSequenceIt != m_mainStreamEvents.end()
-               && m_currentMainSequenceIt->first <= m_playbackPosition) {
-            EventSequence& sequence = result[m_currentMainSequenceIt->first];
-            sequence.insert(m_currentMainSequenceIt->second.cbegin(),
-                            m_currentMainSequenceIt->second.cend());
-            m_currentMainSequenceIt = std::next(m_currentMainSequenceIt);
-        }
+        m_mainStreamCursor = lowerBound(m_mainStreamEvents, m_playbackPosition);
+    }
+
+    void updateDynamicEventsCursor()
+    {
+        m_dynamicEventsCursor = lowerBound(m_dynamicEvents, m_playbackPosition);
     }
 
-    void handleDynamicChanges(EventSequenceMap& result)
+    void handleOffStream(EventBlock& result, const msecs_t nextMsecs)
     {
-        if (m_dynamicEvents.empty()) {
+        if (m_offStreamCursor >= m_offStreamEvents.size()) {
             return;
         }
 
-        while (m_currentDynamicsIt != m_dynamicEvents.end()
-               && m_currentDynamicsIt->first <= m_playbackPosition) {
-            EventSequence& sequence = result[m_currentDynamicsIt->first];
-            sequence.insert(m_currentDynamicsIt->second.cbegin(),
-                            m_currentDynamicsIt->second.cend());
-            m_currentDynamicsIt = std::next(m_currentDynamicsIt);
+        //! NOTE Only the first pending sequence is shifted towards the current block
+        const TimedEvent& first = m_offStreamEvents[m_offStreamCursor];
+        const msecs_t firstTimestamp = first.timestamp - m_offStreamShift;
+
+        if (firstTimestamp > nextMsecs) {
+            m_offStreamShift += nextMsecs;
+            return;
+        }
+
+        const msecs_t originTimestamp = first.timestamp;
+        while (m_offStreamCursor < m_offStreamEvents.size() && m_offStreamEvents[m_offStreamCursor].timestamp == originTimestamp) {
+            result.append(firstTimestamp, &m_offStreamEvents[m_offStreamCursor].event);
+            ++m_offStreamCursor;
+        }
+
+        m_offStreamShift = 0;
+
+        while (m_offStreamCursor < m_offStreamEvents.size() && m_offStreamEvents[m_offStreamCursor].timestamp <= nextMsecs) {
+            const TimedEvent& event = m_offStreamEvents[m_offStreamCursor];
+            result.append(event.timestamp, &event.event);
+            ++m_offStreamCursor;
+        }
+    }
+
+    void handleMainStream(EventBlock& result)
+    {
+        static const std::less<EventType> isLess;
+
+        const TimedEvent* lastMain = nullptr;
+
+        const size_t mainCount = m_mainStreamEvents.size();
+        const size_t dynamicCount = m_dynamicEvents.size();
+
+        //! NOTE Merges both lists by timestamp, the events of the same timestamp are ordered like in EventSequence
+        while (true) {
+            const TimedEvent* main = m_mainStreamCursor < mainCount ? &m_mainStreamEvents[m_mainStreamCursor] : nullptr;
+            const TimedEvent* dynamic = m_dynamicEventsCursor < dynamicCount ? &m_dynamicEvents[m_dynamicEventsCursor] : nullptr;
+
+            if (main && main->timestamp > m_playbackPosition) {
+                main = nullptr;
+            }
+
+            if (dynamic && dynamic->timestamp > m_playbackPosition) {
+                dynamic = nullptr;
+            }
+
+            if (!main && !dynamic) {
+                break;
+            }
+
+            if (main && dynamic && main->timestamp == dynamic->timestamp) {
+                if (isLess(dynamic->event, main->event)) {
+                    main = nullptr;
+                } else if (!isLess(main->event, dynamic->event)) {
+                    // the same event in both lists
+                    ++m_dynamicEventsCursor;
+                    dynamic = nullptr;
+                } else {
+                    dynamic = nullptr;
+                }
+            } else if (main && dynamic) {
+                if (main->timestamp < dynamic->timestamp) {
+                    dynamic = nullptr;
+                } else {
+                    main = nullptr;
+                }
+            }
+
+            if (main) {
+                // the same event may be rendered from several playback events
+                const bool isDuplicate = lastMain && lastMain->timestamp == main->timestamp
+                                         && !isLess(lastMain->event, main->event) && !isLess(main->event, lastMain->event);
+                if (!isDuplicate) {
+                    result.append(main->timestamp, &main->event);
+                }
+
+                lastMain = main;
+                ++m_mainStreamCursor;
+            } else {
+                result.append(dynamic->timestamp, &dynamic->event);
+                ++m_dynamicEventsCursor;
+            }
         }
     }
 
     mutable msecs_t m_playbackPosition = 0;
 
-    SequenceIterator m_currentMainSequenceIt;
-    SequenceIterator m_currentOffSequenceIt;
-    SequenceIterator m_currentDynamicsIt;
+    size_t m_mainStreamCursor = 0;
+    size_t m_offStreamCursor = 0;
+    size_t m_dynamicEventsCursor = 0;
+    msecs_t m_offStreamShift = 0;
 
-    EventSequenceMap m_mainStreamEvents;
-    EventSequenceMap m_offStreamEvents;
-    EventSequenceMap m_dynamicEvents;
+    //! NOTE Sorted by timestamp, the events of the same timestamp are ordered like in EventSequence
+    TimedEventList m_mainStreamEvents;
+    TimedEventList m_offStreamEvents;
+    TimedEventList m_dynamicEvents;
 
     mpe::PlaybackData m_playbackData;
 
@@ -268,6 +419,59 @@ protected:
     OnFlushedCallback m_onOffStreamFlushed;
     OnFlushedCallback m_onMainStreamFlushed;
 
+private:
+    static void flatten(const EventSequenceMap& sequences, TimedEventList& destination)
+    {
+        destination.clear();
+
+        size_t count = 0;
+        for (const auto& pair : sequences) {
+            count += pair.second.size();
+        }
+
+        destination.reserve(count);
+
+        for (const auto& pair : sequences) {
+            for (const EventType& event : pair.second) {
+                destination.push_back(TimedEvent { pair.first, event, 0 });
+            }
+        }
+    }
+
+    void appendMainStreamEvents(const mpe::PlaybackEventsMap& events)
+    {
+        EventSequenceMap sequences;
+
+        for (const auto& pair : events) {
+            sequences.clear();
+            appendPlaybackEvents(sequences, pair.second);
+
+            for (const auto& sequence : sequences) {
+                for (const EventType& event : sequence.second) {
+                    m_mainStreamEvents.push_back(TimedEvent { sequence.first, event, pair.first });
+                }
+            }
+        }
+    }
+
+    static bool isEarlier(const TimedEvent& first, const TimedEvent& second)
+    {
+        if (first.timestamp != second.timestamp) {
+            return first.timestamp < second.timestamp;
+        }
+
+        return std::less<EventType>()(first.event, second.event);
+    }
+
+    static size_t lowerBound(const TimedEventList& events, const msecs_t position)
+    {
+        auto it = std::lower_bound(events.cbegin(), events.cend(), position, [](const TimedEvent& event, const msecs_t value) {
+            return event.timestamp < value;
+        });
+
+        return static_cast<size_t>(std::distance(events.cbegin(), it));
+    }
+
 private:
     bool m_shouldUpdateMainStreamEvents = false;
 };
@@ -70,6 +70,13 @@ public:
     virtual size_t encode(samples_t samplesPerChannel, const float* input) = 0;
     virtual size_t flush() = 0;
 
+    //! NOTE Whether encode() may be called several times with consecutive parts of the stream,
+    //! producing the same output as a single call with the whole stream
+    virtual bool isStreamingSupported() const
+    {
+        return false;
+    }
+
     Progress progress()
     {
         return m_progress;
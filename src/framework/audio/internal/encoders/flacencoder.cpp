@@ -31,6 +31,8 @@
 using namespace muse::audio;
 using namespace muse::audio::encode;
 
+static constexpr uint32_t FRAME_SIZE = 1024;
+
 struct FlacHandler : public FLAC::Encoder::File
 {
     using ProgressCallBack = std::function<void (int64_t /*current*/, int64_t /*total*/)>;
@@ -102,34 +104,44 @@ size_t FlacEncoder::encode(samples_t samplesPerChannel, const float* input)
         return 0;
     }
 
-    size_t result = 0;
     size_t totalSamplesNumber = samplesPerChannel * m_format.audioChannelsNumber;
-    uint32_t frameSize = 1024;
-    size_t stepSize = frameSize * m_format.audioChannelsNumber;
 
-    std::vector<FLAC__int32> buff(samplesPerChannel * sizeof(float));
+    std::vector<FLAC__int32> buff(totalSamplesNumber);
 
     for (size_t i = 0; i < buff.size(); ++i) {
         buff[i] = static_cast<FLAC__int32>(dsp::convertFloatSamples<FLAC__int16>(input[i]));
     }
 
-    std::vector<FLAC__int32> intermBuff(stepSize);
+    if (!m_flac->process_interleaved(buff.data(), samplesPerChannel)) {
+        return 0;
+    }
 
-    for (size_t i = 0; i < totalSamplesNumber; i += stepSize) {
-        std::copy(buff.data() + i, buff.data() + i + stepSize, intermBuff.data());
+    m_encodedSamplesPerChannel += samplesPerChannel;
 
-        if (m_flac->process_interleaved(intermBuff.data(), frameSize)) {
-            result += stepSize;
-        } else {
-            break;
-        }
-    }
+    return totalSamplesNumber;
+}
+
+bool FlacEncoder::isStreamingSupported() const
+{
+    //!Note libFLAC buffers the input up to a whole block internally, so the encoded stream doesn't depend on how the input is split
 
-    return result;
+    return true;
 }
 
 size_t FlacEncoder::flush()
 {
+    IF_ASSERT_FAILED(m_flac) {
+        return 0;
+    }
+
+    //!Note The end of the stream is padded with silence up to a whole FRAME_SIZE
+    samples_t remainder = m_encodedSamplesPerChannel % FRAME_SIZE;
+    if (remainder != 0) {
+        samples_t paddingSamplesPerChannel = FRAME_SIZE - remainder;
+        std::vector<FLAC__int32> silence(paddingSamplesPerChannel * m_format.audioChannelsNumber, 0);
+        m_flac->process_interleaved(silence.data(), paddingSamplesPerChannel);
+    }
+
     m_flac->finish();
     return 0;
 }
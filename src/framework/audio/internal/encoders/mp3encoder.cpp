@@ -102,6 +102,13 @@ size_t Mp3Encoder::encode(samples_t samplesPerChannel, const float* input)
     return result;
 }
 
+bool Mp3Encoder::isStreamingSupported() const
+{
+    //!Note LAME buffers the input internally, so the encoded stream doesn't depend on how the input is split
+
+    return true;
+}
+
 size_t Mp3Encoder::flush()
 {
     int encodedBytes = lame_encode_flush(m_handler->flags,
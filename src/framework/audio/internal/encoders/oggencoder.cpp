@@ -22,6 +22,8 @@
 
 #include "oggencoder.h"
 
+#include <vector>
+
 #ifdef SYSTEM_OPUSENC
 #include <opus/opusenc.h>
 #else
@@ -36,14 +38,26 @@ using namespace muse::audio::encode;
 size_t OggEncoder::encode(samples_t samplesPerChannel, const float* input)
 {
     m_progress.progressChanged.send(0, 100, "");
-    int code = ope_encoder_write_float(m_opusEncoder, input, samplesPerChannel + m_format.sampleRate * 2);
+    int code = ope_encoder_write_float(m_opusEncoder, input, samplesPerChannel);
     m_progress.progressChanged.send(100, 100, "");
 
     return code == OPE_OK ? samplesPerChannel : 0;
 }
 
+bool OggEncoder::isStreamingSupported() const
+{
+    //!Note libopusenc buffers the input internally, so the encoded stream doesn't depend on how the input is split
+
+    return true;
+}
+
 size_t OggEncoder::flush()
 {
+    //!Note The encoder isn't drained, the end of the stream is pushed out of its buffers by 2 seconds of silence
+    const samples_t silenceSamplesPerChannel = m_format.sampleRate * 2;
+    std::vector<float> silence(silenceSamplesPerChannel * m_format.audioChannelsNumber, 0.f);
+    ope_encoder_write_float(m_opusEncoder, silence.data(), silenceSamplesPerChannel);
+
     return ope_encoder_flush_header(m_opusEncoder);
 }
 
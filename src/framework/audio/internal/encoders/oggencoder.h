@@ -34,6 +34,8 @@ public:
     size_t encode(samples_t samplesPerChannel, const float* input) override;
     size_t flush() override;
 
+    bool isStreamingSupported() const override;
+
 protected:
     size_t requiredOutputBufferSize(samples_t) const override;
     bool openDestination(const io::path_t& path) override;
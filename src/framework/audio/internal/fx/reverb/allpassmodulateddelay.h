@@ -78,6 +78,37 @@ public:
         return res;
     }
 
+    /// Largest n for which readBlock() followed by writeBlockAndAdvance() gives the same result
+    /// as n calls of readSample() / writeSampleAndAdvance(), i.e. no sample read in the block
+    /// is written in the same block. Depends on the current modulation offset.
+    int maxBlockSize() const
+    {
+        return -(m_readOffset + 1);
+    }
+
+    /// Reads n consecutive samples with the current modulation offset.
+    /// Needs to be followed by writeBlockAndAdvance() with the same n.
+    void readBlock(float* target, int n)
+    {
+        assert(n <= maxBlockSize());
+        float y1 = m_y1;
+        for (int i = 0; i < n; ++i) {
+            auto res = m_buffer.read(m_readOffset + i);
+            auto x1 = m_buffer.read(m_readOffset + i + 1);
+
+            res += m_modFraction * (x1 - y1);
+            y1 = res;
+            target[i] = res;
+        }
+        m_y1 = y1;
+    }
+
+    void writeBlockAndAdvance(const float* source, int n)
+    {
+        m_buffer.writeBlock(0, n, source);
+        m_buffer.advance(n);
+    }
+
     float processSample(float sample)
     {
         writeSampleAndAdvance(sample);
@@ -22,6 +22,7 @@
 
 #include "reverbprocessor.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <complex>
@@ -218,6 +219,7 @@ struct ReverbProcessor::impl
 
     SamplesFloat ivnd_in_buffer;
     SamplesFloat delay_out_buffer;
+    SamplesFloat feedback_buffer;
     SamplesFloat er_buffer;
     SamplesFloat work_buffer;
     SamplesFloat late_buffer;
@@ -364,6 +366,16 @@ void ReverbProcessor::process(float* buffer, unsigned int sampleCount)
     }
 }
 
+bool ReverbProcessor::blockProcessingEnabled() const
+{
+    return m_blockProcessingEnabled;
+}
+
+void ReverbProcessor::setBlockProcessingEnabled(bool enabled)
+{
+    m_blockProcessingEnabled = enabled;
+}
+
 void ReverbProcessor::getParameterInfo(int32_t index, ParameterInfo& info)
 {
     assert(index < NumParams);
@@ -563,6 +575,7 @@ bool ReverbProcessor::setFormat(audioch_t audioChannelsCount, double sampleRate,
     d->ivnd_er[1].configure(63, sampleRate, maximumBlockSize);
     d->ivnd_in_buffer.setSize(max_num_delays, maximumBlockSize);
     d->delay_out_buffer.setSize(max_num_delays, maximumBlockSize);
+    d->feedback_buffer.setSize(max_num_delays, maximumBlockSize);
 
     for (int i = 0; i < 2; ++i) {
         d->er_fir[i].setFormat(maximumBlockSize, int(0.15 * sampleRate));
@@ -636,6 +649,123 @@ void ReverbProcessor::reset()
     d->er_gain_smooth.setToTarget();
 }
 
+template<int num_lines>
+void ReverbProcessor::_updateModulation()
+{
+    int modType = int(getParameter(Params::ModType));
+    switch (modType) {
+    case 0: // phase distributed sine waves
+        d->modDelay[0].setModOffset(d->sinLfo.getNextMainValue());
+        for (int i = 1; i < num_lines; ++i) {
+            d->modDelay[i].setModOffset(d->sinLfo.getTapValue(i));
+        }
+        break;
+    case 1: {
+        auto offset = d->sinLfo.getNextMainValue();
+        for (int i = 0; i < num_lines; ++i) {
+            d->modDelay[i].setModOffset(offset);
+        }
+        break;
+    }
+    }
+}
+
+template<int num_lines>
+void ReverbProcessor::_processFeedbackSample(const float** delayInPtr, float** delayOutPtr, int32_t index)
+{
+    // delay line outputs / decay filters
+    float mat_in[num_lines];
+    for (int i = 0; i < num_lines; i += 4) {
+        int j = i >> 2;
+        simd::float_x4 s = { d->modDelay[i].readSample(), d->modDelay[i + 1].readSample(),
+                             d->modDelay[i + 2].readSample(), d->modDelay[i + 3].readSample() };
+
+        s = d->ag_filter_x4[j].processSample(s);
+        s = IirBiquadFilter::processSampleDF2(s, d->damping_cf1_x4[j], d->damping_state1_x4[j]);
+        s = IirBiquadFilter::processSampleDF2(s, d->damping_cf2_x4[j], d->damping_state2_x4[j]);
+
+        mat_in[i] = delayOutPtr[i][index] = s[0];
+        mat_in[i + 1] = delayOutPtr[i + 1][index] = s[1];
+        mat_in[i + 2] = delayOutPtr[i + 2][index] = s[2];
+        mat_in[i + 3] = delayOutPtr[i + 3][index] = s[3];
+    }
+    // Applying the Matrix
+    float mat_res[num_lines];
+    reverb_matrices::Hadamard<num_lines>(mat_in, mat_res);
+
+    // feeding matrix results and input buffers to the delay lines
+    for (int i = 0; i < num_lines; ++i) {
+        d->modDelay[i].writeSampleAndAdvance(mat_res[i] + delayInPtr[i][index]);
+    }
+}
+
+template<int num_lines>
+void ReverbProcessor::_processFeedbackBlock(const float** delayInPtr, float** delayOutPtr, int32_t offset, int32_t numSamples)
+{
+    // Same computation as _processFeedbackSample() for numSamples consecutive samples.
+    // This is possible because the delays are longer than the block, so nothing written
+    // to a delay line within the block is read back within the block.
+    auto feedback_ptr = d->feedback_buffer.getPtrs();
+
+    // delay line outputs
+    for (int i = 0; i < num_lines; ++i) {
+        d->modDelay[i].readBlock(delayOutPtr[i] + offset, numSamples);
+    }
+
+    // decay filters, these are recursive in time so they run across 4 lines at a time
+    for (int i = 0; i < num_lines; i += 4) {
+        int j = i >> 2;
+        float* out[] = { delayOutPtr[i] + offset, delayOutPtr[i + 1] + offset,
+                         delayOutPtr[i + 2] + offset, delayOutPtr[i + 3] + offset };
+        for (int n = 0; n < numSamples; ++n) {
+            simd::float_x4 s = { out[0][n], out[1][n], out[2][n], out[3][n] };
+
+            s = d->ag_filter_x4[j].processSample(s);
+            s = IirBiquadFilter::processSampleDF2(s, d->damping_cf1_x4[j], d->damping_state1_x4[j]);
+            s = IirBiquadFilter::processSampleDF2(s, d->damping_cf2_x4[j], d->damping_state2_x4[j]);
+
+            out[0][n] = s[0];
+            out[1][n] = s[1];
+            out[2][n] = s[2];
+            out[3][n] = s[3];
+        }
+    }
+
+    // Applying the Matrix to 4 samples at a time and adding the input buffers
+    int n = 0;
+    for (; n + 4 <= numSamples; n += 4) {
+        simd::float_x4 mat_in[num_lines];
+        for (int i = 0; i < num_lines; ++i) {
+            mat_in[i] = simd::load_unaligned(delayOutPtr[i] + offset + n);
+        }
+
+        simd::float_x4 mat_res[num_lines];
+        reverb_matrices::Hadamard<num_lines>(mat_in, mat_res);
+
+        for (int i = 0; i < num_lines; ++i) {
+            simd::store_unaligned(feedback_ptr[i] + n, mat_res[i] + simd::load_unaligned(delayInPtr[i] + offset + n));
+        }
+    }
+    for (; n < numSamples; ++n) {
+        float mat_in[num_lines];
+        for (int i = 0; i < num_lines; ++i) {
+            mat_in[i] = delayOutPtr[i][offset + n];
+        }
+
+        float mat_res[num_lines];
+        reverb_matrices::Hadamard<num_lines>(mat_in, mat_res);
+
+        for (int i = 0; i < num_lines; ++i) {
+            feedback_ptr[i][n] = mat_res[i] + delayInPtr[i][offset + n];
+        }
+    }
+
+    // feeding the results to the delay lines
+    for (int i = 0; i < num_lines; ++i) {
+        d->modDelay[i].writeBlockAndAdvance(feedback_ptr[i], numSamples);
+    }
+}
+
 template<int num_lines>
 void ReverbProcessor::_processLines(float** signalPtr, int32_t numSamples)
 {
@@ -695,52 +825,29 @@ void ReverbProcessor::_processLines(float** signalPtr, int32_t numSamples)
         auto delay_out_ptr = d->delay_out_buffer.getPtrs();
 
         // feedback loop
-        for (int cnt = 0; cnt < numSamples; ++cnt) {
+        int cnt = 0;
+        while (cnt < numSamples) {
             // update delay modulation offsets
             if (d->modCounter++ >= d->modStep) {
                 d->modCounter = 0;
-
-                int modType = int(getParameter(Params::ModType));
-                switch (modType) {
-                case 0: // phase distributed sine waves
-                    d->modDelay[0].setModOffset(d->sinLfo.getNextMainValue());
-                    for (int i = 1; i < num_lines; ++i) {
-                        d->modDelay[i].setModOffset(d->sinLfo.getTapValue(i));
-                    }
-                    break;
-                case 1: {
-                    auto offset = d->sinLfo.getNextMainValue();
-                    for (int i = 0; i < num_lines; ++i) {
-                        d->modDelay[i].setModOffset(offset);
-                    }
-                    break;
-                }
-                }
+                _updateModulation<num_lines>();
             }
 
-            // delay line outputs / decay filters
-            float mat_in[num_lines];
-            for (int i = 0; i < num_lines; i += 4) {
-                int j = i >> 2;
-                simd::float_x4 s = { d->modDelay[i].readSample(), d->modDelay[i + 1].readSample(),
-                                     d->modDelay[i + 2].readSample(), d->modDelay[i + 3].readSample() };
-
-                s = d->ag_filter_x4[j].processSample(s);
-                s = IirBiquadFilter::processSampleDF2(s, d->damping_cf1_x4[j], d->damping_state1_x4[j]);
-                s = IirBiquadFilter::processSampleDF2(s, d->damping_cf2_x4[j], d->damping_state2_x4[j]);
-
-                mat_in[i] = delay_out_ptr[i][cnt] = s[0];
-                mat_in[i + 1] = delay_out_ptr[i + 1][cnt] = s[1];
-                mat_in[i + 2] = delay_out_ptr[i + 2][cnt] = s[2];
-                mat_in[i + 3] = delay_out_ptr[i + 3][cnt] = s[3];
+            // the modulation offsets stay constant until the next update
+            int len = std::min(numSamples - cnt, 1 + std::max(0, d->modStep - d->modCounter));
+
+            bool blockwise = m_blockProcessingEnabled;
+            for (int i = 0; i < num_lines && blockwise; ++i) {
+                blockwise = d->modDelay[i].maxBlockSize() >= len;
             }
-            // Applying the Matrix
-            float mat_res[num_lines];
-            reverb_matrices::Hadamard<num_lines>(mat_in, mat_res);
 
-            // feeding matrix results and input buffers to the delay lines
-            for (int i = 0; i < num_lines; ++i) {
-                d->modDelay[i].writeSampleAndAdvance(mat_res[i] + delay_in_ptr[i][cnt]);
+            if (blockwise) {
+                d->modCounter += len - 1;
+                _processFeedbackBlock<num_lines>(delay_in_ptr, delay_out_ptr, cnt, len);
+                cnt += len;
+            } else {
+                _processFeedbackSample<num_lines>(delay_in_ptr, delay_out_ptr, cnt);
+                ++cnt;
             }
         } // end of feedback loop
 
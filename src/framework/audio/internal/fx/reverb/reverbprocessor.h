@@ -47,6 +47,12 @@ public:
 
     void process(float* buffer, unsigned int sampleCount) override;
 
+    //! NOTE The feedback loop is processed in vectorized sub-blocks by default, falling back to
+    //! sample-by-sample processing when the delays are too short for that. Disabling it forces the
+    //! sample-by-sample path, which serves as reference for testing.
+    bool blockProcessingEnabled() const;
+    void setBlockProcessingEnabled(bool enabled);
+
 private:
     enum Params
     {
@@ -126,6 +132,12 @@ private:
     // Specific effect data
     template<int num_lines>
     void _processLines(float** signalPtr, int32_t numSamples);
+    template<int num_lines>
+    void _updateModulation();
+    template<int num_lines>
+    void _processFeedbackSample(const float** delayInPtr, float** delayOutPtr, int32_t index);
+    template<int num_lines>
+    void _processFeedbackBlock(const float** delayInPtr, float** delayOutPtr, int32_t offset, int32_t numSamples);
     static constexpr int max_num_delays = 24;
 
     void calculateTailParams();
@@ -139,6 +151,7 @@ private:
     float m_erToLateGain = 0.f;
 
     int m_delays = 16;
+    bool m_blockProcessingEnabled = true;
 
     AudioFxParams m_params;
     async::Channel<audio::AudioFxParams> m_paramsChanged;
@@ -139,6 +139,28 @@ __finl float_x4 __vecc operator*(float_x4 a, float_x4 b)
 {
     return vmulq_f32(a.s, b.s);
 }
+
+__finl float_x4 __vecc operator+(float_x4 a)
+{
+    return a;
+}
+
+__finl float_x4 __vecc operator-(float_x4 a)
+{
+    return vnegq_f32(a.s);
+}
+
+/// loads 4 consecutive floats, src needs no special alignment
+__finl float_x4 load_unaligned(const float* src)
+{
+    return vld1q_f32(src);
+}
+
+/// stores 4 consecutive floats, dst needs no special alignment
+__finl void __vecc store_unaligned(float* dst, float_x4 a)
+{
+    vst1q_f32(dst, a.s);
+}
 } // namespace muse::audio::fx
 
 #endif // MUSE_AUDIO_SIMDTYPES_NEON_H
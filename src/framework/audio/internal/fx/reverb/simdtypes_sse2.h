@@ -134,6 +134,28 @@ __finl float_x4 __vecc operator*(float_x4 a, float_x4 b)
 {
     return _mm_mul_ps(a.s, b.s);
 }
+
+__finl float_x4 __vecc operator+(float_x4 a)
+{
+    return a;
+}
+
+__finl float_x4 __vecc operator-(float_x4 a)
+{
+    return _mm_xor_ps(a.s, _mm_set1_ps(-0.f));
+}
+
+/// loads 4 consecutive floats, src needs no special alignment
+__finl float_x4 load_unaligned(const float* src)
+{
+    return _mm_loadu_ps(src);
+}
+
+/// stores 4 consecutive floats, dst needs no special alignment
+__finl void __vecc store_unaligned(float* dst, float_x4 a)
+{
+    _mm_storeu_ps(dst, a.s);
+}
 } // namespace muse::audio::fx
 
 #endif // MUSE_AUDIO_SIMDTYPES_SSE2_H
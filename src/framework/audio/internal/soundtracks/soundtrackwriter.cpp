@@ -22,6 +22,9 @@
 
 #include "soundtrackwriter.h"
 
+#include <chrono>
+#include <thread>
+
 #include "global/defer.h"
 
 #include "internal/worker/audioengine.h"
@@ -41,6 +44,14 @@ using namespace muse::audio::soundtrack;
 static constexpr int PREPARE_STEP = 0;
 static constexpr int ENCODE_STEP = 1;
 
+//! NOTE In the offline pipeline the encoder thread wakes up once this many render steps are ready
+static constexpr size_t ENCODE_CHUNK_RENDER_STEPS = 64;
+
+static double secondsSince(const std::chrono::steady_clock::time_point& start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
 static encode::AbstractAudioEncoderPtr createEncoder(const SoundTrackType type)
 {
     switch (type) {
@@ -67,6 +78,9 @@ SoundTrackWriter::SoundTrackWriter(const io::path_t& destination, const SoundTra
     samples_t totalSamplesNumber = (totalDuration / 1000000.f) * sizeof(float) * format.sampleRate;
     m_inputBuffer.resize(totalSamplesNumber);
     m_intermBuffer.resize(format.samplesPerChannel * format.audioChannelsNumber);
+
+    //! NOTE The step of the realtime driver is kept: the synthesizers advance their playback in msecs
+    //! rounded per rendered block (ex. FluidSynth::process), so another step would change the output
     m_renderStep = format.samplesPerChannel;
 
     m_encoderPtr = createEncoder(format.type);
@@ -76,9 +90,13 @@ SoundTrackWriter::SoundTrackWriter(const io::path_t& destination, const SoundTra
     }
 
     m_encoderPtr->init(destination, format, totalSamplesNumber);
-    m_encoderPtr->progress().progressChanged.onReceive(this, [this](int64_t current, int64_t total, std::string) {
-        sendStepProgress(ENCODE_STEP, current, total);
-    });
+
+    //! NOTE Streaming encoders run alongside the rendering, so the rendering progress is reported instead
+    if (!m_encoderPtr->isStreamingSupported()) {
+        m_encoderPtr->progress().progressChanged.onReceive(this, [this](int64_t current, int64_t total, std::string) {
+            sendStepProgress(ENCODE_STEP, current, total);
+        });
+    }
 }
 
 SoundTrackWriter::~SoundTrackWriter()
@@ -112,12 +130,28 @@ Ret SoundTrackWriter::write()
         m_isAborted = false;
     };
 
-    Ret ret = generateAudioData();
-    if (!ret) {
-        return ret;
-    }
+    const auto startTime = std::chrono::steady_clock::now();
+    m_renderStats = RenderStats();
 
-    size_t bytes = m_encoderPtr->encode(m_inputBuffer.size() / sizeof(float), m_inputBuffer.data());
+    size_t bytes = 0;
+
+    if (m_encoderPtr->isStreamingSupported()) {
+        Ret ret = generateAndEncodeAudioData();
+        if (!ret) {
+            return ret;
+        }
+
+        bytes = m_encodedBytes;
+    } else {
+        Ret ret = generateAudioData();
+        if (!ret) {
+            return ret;
+        }
+
+        m_renderStats.renderSeconds = secondsSince(startTime);
+
+        bytes = m_encoderPtr->encode(m_inputBuffer.size() / sizeof(float), m_inputBuffer.data());
+    }
 
     if (m_isAborted) {
         return make_ret(Ret::Code::Cancel);
@@ -127,6 +161,14 @@ Ret SoundTrackWriter::write()
         return make_ret(Err::ErrorEncode);
     }
 
+    m_renderStats.totalSeconds = secondsSince(startTime);
+    m_renderStats.audioSeconds = static_cast<double>(m_inputBuffer.size() / sizeof(float)) / m_encoderPtr->format().sampleRate;
+
+    LOGI() << "exported " << m_renderStats.audioSeconds << " s of audio"
+           << ", render: " << m_renderStats.renderSeconds << " s"
+           << ", total: " << m_renderStats.totalSeconds << " s"
+           << ", realtime factor: " << m_renderStats.realtimeFactor();
+
     return muse::make_ok();
 }
 
@@ -140,13 +182,86 @@ Progress SoundTrackWriter::progress()
     return m_progress;
 }
 
+const SoundTrackWriter::RenderStats& SoundTrackWriter::renderStats() const
+{
+    return m_renderStats;
+}
+
+//! NOTE The encoder consumes only (m_inputBuffer.size() / sizeof(float)) samples per channel (see write()),
+//! so there is no need to render the rest of the buffer
+size_t SoundTrackWriter::samplesToRender() const
+{
+    const size_t samplesPerChannel = m_inputBuffer.size() / sizeof(float);
+    return std::min(m_inputBuffer.size(), samplesPerChannel * m_encoderPtr->format().audioChannelsNumber);
+}
+
 Ret SoundTrackWriter::generateAudioData()
 {
     TRACEFUNC;
 
-    const size_t inputBufferMaxOffset = m_inputBuffer.size();
+    const size_t inputBufferMaxOffset = samplesToRender();
+    size_t inputBufferOffset = 0;
+
+    sendStepProgress(PREPARE_STEP, inputBufferOffset, inputBufferMaxOffset);
+
+    while (inputBufferOffset < inputBufferMaxOffset && !m_isAborted) {
+        m_source->process(m_intermBuffer.data(), m_renderStep);
+
+        size_t samplesToCopy = std::min(m_intermBuffer.size(), inputBufferMaxOffset - inputBufferOffset);
+
+        std::copy(m_intermBuffer.begin(),
+                  m_intermBuffer.begin() + samplesToCopy,
+                  m_inputBuffer.begin() + inputBufferOffset);
+
+        inputBufferOffset += samplesToCopy;
+        sendStepProgress(PREPARE_STEP, inputBufferOffset, inputBufferMaxOffset);
+    }
+
+    if (m_isAborted) {
+        return make_ret(Ret::Code::Cancel);
+    }
+
+    if (inputBufferOffset == 0) {
+        LOGI() << "No audio to export";
+        return make_ret(Err::NoAudioToExport);
+    }
+
+    return muse::make_ok();
+}
+
+Ret SoundTrackWriter::generateAndEncodeAudioData()
+{
+    TRACEFUNC;
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    const size_t inputBufferMaxOffset = samplesToRender();
     size_t inputBufferOffset = 0;
 
+    {
+        std::lock_guard<std::mutex> lock(m_renderedMutex);
+        m_renderedSamples = 0;
+        m_isRenderFinished = false;
+        m_encodedBytes = 0;
+    }
+
+    std::thread encoderThread([this]() {
+        encodeRenderedData();
+    });
+
+    DEFER {
+        {
+            std::lock_guard<std::mutex> lock(m_renderedMutex);
+            m_isRenderFinished = true;
+        }
+
+        m_renderedChanged.notify_one();
+
+        if (encoderThread.joinable()) {
+            encoderThread.join();
+        }
+    };
+
     sendStepProgress(PREPARE_STEP, inputBufferOffset, inputBufferMaxOffset);
 
     while (inputBufferOffset < inputBufferMaxOffset && !m_isAborted) {
@@ -159,9 +274,18 @@ Ret SoundTrackWriter::generateAudioData()
                   m_inputBuffer.begin() + inputBufferOffset);
 
         inputBufferOffset += samplesToCopy;
+
+        {
+            std::lock_guard<std::mutex> lock(m_renderedMutex);
+            m_renderedSamples = inputBufferOffset;
+        }
+
+        m_renderedChanged.notify_one();
         sendStepProgress(PREPARE_STEP, inputBufferOffset, inputBufferMaxOffset);
     }
 
+    m_renderStats.renderSeconds = secondsSince(startTime);
+
     if (m_isAborted) {
         return make_ret(Ret::Code::Cancel);
     }
@@ -171,9 +295,55 @@ Ret SoundTrackWriter::generateAudioData()
         return make_ret(Err::NoAudioToExport);
     }
 
+    {
+        std::lock_guard<std::mutex> lock(m_renderedMutex);
+        m_isRenderFinished = true;
+    }
+
+    m_renderedChanged.notify_one();
+    encoderThread.join();
+
+    sendStepProgress(ENCODE_STEP, 1, 1);
+
     return muse::make_ok();
 }
 
+void SoundTrackWriter::encodeRenderedData()
+{
+    const audioch_t audioChannelsNumber = m_encoderPtr->format().audioChannelsNumber;
+    const size_t chunkSize = m_intermBuffer.size() * ENCODE_CHUNK_RENDER_STEPS;
+    size_t encodedSamples = 0;
+
+    while (true) {
+        size_t renderedSamples = 0;
+        bool isRenderFinished = false;
+
+        {
+            std::unique_lock<std::mutex> lock(m_renderedMutex);
+            m_renderedChanged.wait(lock, [this, encodedSamples, chunkSize]() {
+                return m_isRenderFinished || m_renderedSamples - encodedSamples >= chunkSize;
+            });
+
+            renderedSamples = m_renderedSamples;
+            isRenderFinished = m_isRenderFinished;
+        }
+
+        if (m_isAborted) {
+            return;
+        }
+
+        const samples_t samplesPerChannel = (renderedSamples - encodedSamples) / audioChannelsNumber;
+        if (samplesPerChannel > 0) {
+            m_encodedBytes += m_encoderPtr->encode(samplesPerChannel, m_inputBuffer.data() + encodedSamples);
+            encodedSamples += samplesPerChannel * audioChannelsNumber;
+        }
+
+        if (isRenderFinished) {
+            return;
+        }
+    }
+}
+
 void SoundTrackWriter::sendStepProgress(int step, int64_t current, int64_t total)
 {
     int stepRange = step == PREPARE_STEP ? 80 : 20;
@@ -23,6 +23,9 @@
 #ifndef MUSE_AUDIO_SOUNDTRACKWRITER_H
 #define MUSE_AUDIO_SOUNDTRACKWRITER_H
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <vector>
 
 #include "global/async/asyncable.h"
@@ -48,8 +51,21 @@ public:
 
     Progress progress();
 
+    struct RenderStats {
+        double audioSeconds = 0.0;      // duration of the exported audio
+        double renderSeconds = 0.0;     // wall time spent rendering
+        double totalSeconds = 0.0;      // wall time spent rendering and encoding
+
+        double realtimeFactor() const { return totalSeconds > 0.0 ? audioSeconds / totalSeconds : 0.0; }
+    };
+
+    const RenderStats& renderStats() const;
+
 private:
+    size_t samplesToRender() const;
     Ret generateAudioData();
+    Ret generateAndEncodeAudioData();
+    void encodeRenderedData();
 
     void sendStepProgress(int step, int64_t current, int64_t total);
 
@@ -63,6 +79,15 @@ private:
 
     Progress m_progress;
     std::atomic<bool> m_isAborted = false;
+
+    // Offline pipeline: the audio thread renders into m_inputBuffer, while the encoder thread consumes the rendered part
+    std::mutex m_renderedMutex;
+    std::condition_variable m_renderedChanged;
+    size_t m_renderedSamples = 0;
+    bool m_isRenderFinished = false;
+    size_t m_encodedBytes = 0;
+
+    RenderStats m_renderStats;
 };
 }
 
@@ -64,8 +64,9 @@ void FluidSequencer::updateOffStreamEvents(const mpe::PlaybackEventsMap& events,
         m_onOffStreamFlushed();
     }
 
-    updatePlaybackEvents(m_offStreamEvents, events);
-    updateOffSequenceIterator();
+    EventSequenceMap offStreamEvents;
+    updatePlaybackEvents(offStreamEvents, events);
+    setOffStreamEvents(offStreamEvents);
 }
 
 void FluidSequencer::updateMainStreamEvents(const mpe::PlaybackEventsMap& events, const mpe::DynamicLevelLayers& dynamics,
@@ -78,15 +79,29 @@ void FluidSequencer::updateMainStreamEvents(const mpe::PlaybackEventsMap& events
         m_onMainStreamFlushed();
     }
 
-    updatePlaybackEvents(m_mainStreamEvents, events);
-    updateMainSequenceIterator();
+    setMainStreamEvents(events);
 
     if (m_useDynamicEvents) {
-        updateDynamicEvents(m_dynamicEvents, dynamics);
-        updateDynamicChangesIterator();
+        EventSequenceMap dynamicEvents;
+        updateDynamicEvents(dynamicEvents, dynamics);
+        setDynamicEvents(dynamicEvents);
     }
 }
 
+bool FluidSequencer::applyMainStreamChanges(const mpe::PlaybackEventsChanges& changes, const mpe::DynamicLevelLayers& dynamics,
+                                            const mpe::PlaybackParamLayers&)
+{
+    spliceMainStreamEvents(changes);
+
+    if (m_useDynamicEvents) {
+        EventSequenceMap dynamicEvents;
+        updateDynamicEvents(dynamicEvents, dynamics);
+        setDynamicEvents(dynamicEvents);
+    }
+
+    return true;
+}
+
 muse::async::Channel<channel_t, Program> FluidSequencer::channelAdded() const
 {
     return m_channels.channelAdded;
@@ -100,39 +115,44 @@ const ChannelMap& FluidSequencer::channels() const
 void FluidSequencer::updatePlaybackEvents(EventSequenceMap& destination, const mpe::PlaybackEventsMap& changes)
 {
     for (const auto& pair : changes) {
-        for (const mpe::PlaybackEvent& event : pair.second) {
-            if (!std::holds_alternative<mpe::NoteEvent>(event)) {
-                continue;
-            }
+        appendPlaybackEvents(destination, pair.second);
+    }
+}
 
-            const mpe::NoteEvent& noteEvent = std::get<mpe::NoteEvent>(event);
+void FluidSequencer::appendPlaybackEvents(EventSequenceMap& destination, const mpe::PlaybackEventList& events)
+{
+    for (const mpe::PlaybackEvent& event : events) {
+        if (!std::holds_alternative<mpe::NoteEvent>(event)) {
+            continue;
+        }
 
-            timestamp_t timestampFrom = noteEvent.arrangementCtx().actualTimestamp;
-            timestamp_t timestampTo = timestampFrom + noteEvent.arrangementCtx().actualDuration;
+        const mpe::NoteEvent& noteEvent = std::get<mpe::NoteEvent>(event);
 
-            channel_t channelIdx = channel(noteEvent);
-            note_idx_t noteIdx = noteIndex(noteEvent.pitchCtx().nominalPitchLevel);
-            velocity_t velocity = noteVelocity(noteEvent);
-            tuning_t tuning = noteTuning(noteEvent, noteIdx);
+        timestamp_t timestampFrom = noteEvent.arrangementCtx().actualTimestamp;
+        timestamp_t timestampTo = timestampFrom + noteEvent.arrangementCtx().actualDuration;
 
-            midi::Event noteOn(Event::Opcode::NoteOn, Event::MessageType::ChannelVoice20);
-            noteOn.setChannel(channelIdx);
-            noteOn.setNote(noteIdx);
-            noteOn.setVelocity(velocity);
-            noteOn.setPitchNote(noteIdx, tuning);
+        channel_t channelIdx = channel(noteEvent);
+        note_idx_t noteIdx = noteIndex(noteEvent.pitchCtx().nominalPitchLevel);
+        velocity_t velocity = noteVelocity(noteEvent);
+        tuning_t tuning = noteTuning(noteEvent, noteIdx);
 
-            destination[timestampFrom].emplace(std::move(noteOn));
+        midi::Event noteOn(Event::Opcode::NoteOn, Event::MessageType::ChannelVoice20);
+        noteOn.setChannel(channelIdx);
+        noteOn.setNote(noteIdx);
+        noteOn.setVelocity(velocity);
+        noteOn.setPitchNote(noteIdx, tuning);
 
-            midi::Event noteOff(Event::Opcode::NoteOff, Event::MessageType::ChannelVoice20);
-            noteOff.setChannel(channelIdx);
-            noteOff.setNote(noteIdx);
-            noteOff.setPitchNote(noteIdx, tuning);
+        destination[timestampFrom].emplace(std::move(noteOn));
 
-            destination[timestampTo].emplace(std::move(noteOff));
+        midi::Event noteOff(Event::Opcode::NoteOff, Event::MessageType::ChannelVoice20);
+        noteOff.setChannel(channelIdx);
+        noteOff.setNote(noteIdx);
+        noteOff.setPitchNote(noteIdx, tuning);
 
-            appendControlSwitch(destination, noteEvent, PEDAL_CC_SUPPORTED_TYPES, midi::SUSTAIN_PEDAL_CONTROLLER);
-            appendPitchBend(destination, noteEvent, BEND_SUPPORTED_TYPES, channelIdx);
-        }
+        destination[timestampTo].emplace(std::move(noteOff));
+
+        appendControlSwitch(destination, noteEvent, PEDAL_CC_SUPPORTED_TYPES, midi::SUSTAIN_PEDAL_CONTROLLER);
+        appendPitchBend(destination, noteEvent, BEND_SUPPORTED_TYPES, channelIdx);
     }
 }
 
@@ -357,15 +357,16 @@ samples_t FluidSynth::process(float* buffer, samples_t samplesPerChannel)
     }
 
     const msecs_t nextMsecs = samplesToMsecs(samplesPerChannel, m_sampleRate);
-    const FluidSequencer::EventSequenceMap sequences = m_sequencer.movePlaybackForward(nextMsecs);
+    m_sequencer.movePlaybackForward(nextMsecs, m_eventBlock);
     samples_t sampleOffset = 0;
 
-    for (auto it = sequences.cbegin(); it != sequences.cend(); ++it) {
+    const auto& sequences = m_eventBlock.sequences;
+
+    for (size_t i = 0; i < sequences.size(); ++i) {
         samples_t durationInSamples = samplesPerChannel - sampleOffset;
 
-        auto nextIt = std::next(it);
-        if (nextIt != sequences.cend()) {
-            msecs_t duration = nextIt->first - it->first;
+        if (i + 1 < sequences.size()) {
+            msecs_t duration = sequences[i + 1].timestamp - sequences[i].timestamp;
             durationInSamples = microSecsToSamples(duration, m_sampleRate);
         }
 
@@ -373,7 +374,7 @@ samples_t FluidSynth::process(float* buffer, samples_t samplesPerChannel)
             break;
         }
 
-        if (!processSequence(it->second, durationInSamples, buffer + sampleOffset * FLUID_AUDIO_CHANNELS_COUNT)) {
+        if (!processSequence(sequences[i], durationInSamples, buffer + sampleOffset * FLUID_AUDIO_CHANNELS_COUNT)) {
             return 0;
         }
 
@@ -383,14 +384,14 @@ samples_t FluidSynth::process(float* buffer, samples_t samplesPerChannel)
     return samplesPerChannel;
 }
 
-bool FluidSynth::processSequence(const FluidSequencer::EventSequence& sequence, const samples_t samples, float* buffer)
+bool FluidSynth::processSequence(const FluidSequencer::EventBlock::Sequence& sequence, const samples_t samples, float* buffer)
 {
-    if (!sequence.empty()) {
+    if (sequence.eventCount > 0) {
         m_tuning.reset();
     }
 
-    for (const FluidSequencer::EventType& event : sequence) {
-        handleEvent(std::get<midi::Event>(event));
+    for (size_t i = 0; i < sequence.eventCount; ++i) {
+        handleEvent(std::get<midi::Event>(m_eventBlock.event(sequence, i)));
     }
 
     fluid_synth_tune_notes(m_fluid->synth, 0, 0, m_tuning.size(), m_tuning.keys.data(), m_tuning.pitches.data(), true);
@@ -102,7 +102,7 @@ private:
 
     void allNotesOff();
 
-    bool processSequence(const FluidSequencer::EventSequence& sequence, const samples_t samples, float* buffer);
+    bool processSequence(const FluidSequencer::EventBlock::Sequence& sequence, const samples_t samples, float* buffer);
     bool handleEvent(const midi::Event& event);
 
     void toggleExpressionController();
@@ -116,6 +116,7 @@ private:
     async::Channel<unsigned int> m_streamsCountChanged;
 
     FluidSequencer m_sequencer;
+    FluidSequencer::EventBlock m_eventBlock;
     std::set<io::path_t> m_sfontPaths;
     std::optional<midi::Program> m_preset;
 
@@ -0,0 +1,536 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2021 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "sfcachedloader.h"
+
+#include <QtGlobal>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <sfloader/fluid_defsfont.h>
+
+using namespace muse::audio::synth;
+
+namespace {
+//! NOTE Read-only view of a whole sound-font file.
+//!      The file is memory-mapped, so the pages are shared between all synth instances
+//!      and only those actually touched by fluid (hydra chunks, samples of selected presets) become resident
+class MappedSoundFontFile
+{
+public:
+    MappedSoundFontFile(const MappedSoundFontFile&) = delete;
+    MappedSoundFontFile& operator=(const MappedSoundFontFile&) = delete;
+
+    static std::unique_ptr<MappedSoundFontFile> open(const char* filename)
+    {
+        std::unique_ptr<MappedSoundFontFile> file(new MappedSoundFontFile());
+        if (file->map(filename) || file->readAll(filename)) {
+            return file;
+        }
+
+        return nullptr;
+    }
+
+    ~MappedSoundFontFile()
+    {
+#ifdef Q_OS_WIN
+        if (m_mapped) {
+            UnmapViewOfFile(m_data);
+        }
+#else
+        if (m_mapped) {
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+        }
+#endif
+    }
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    MappedSoundFontFile() = default;
+
+    bool map(const char* filename)
+    {
+#ifdef Q_OS_WIN
+        int len = MultiByteToWideChar(CP_UTF8, 0, filename, -1, nullptr, 0);
+        if (len <= 0) {
+            return false;
+        }
+
+        std::wstring wfilename(static_cast<size_t>(len), L'\0');
+        MultiByteToWideChar(CP_UTF8, 0, filename, -1, wfilename.data(), len);
+
+        HANDLE file = CreateFileW(wfilename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+            CloseHandle(file);
+            return false;
+        }
+
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        CloseHandle(file);
+        if (!mapping) {
+            return false;
+        }
+
+        void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping); // the view keeps the mapping alive
+        if (!view) {
+            return false;
+        }
+
+        m_data = static_cast<const uint8_t*>(view);
+        m_size = static_cast<size_t>(fileSize.QuadPart);
+        m_mapped = true;
+        return true;
+#else
+        int fd = ::open(filename, O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+            ::close(fd);
+            return false;
+        }
+
+        void* addr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd); // the mapping keeps the file alive
+        if (addr == MAP_FAILED) {
+            return false;
+        }
+
+        m_data = static_cast<const uint8_t*>(addr);
+        m_size = static_cast<size_t>(st.st_size);
+        m_mapped = true;
+        return true;
+#endif
+    }
+
+    //! NOTE Fallback for platforms or file systems without mmap support
+    bool readAll(const char* filename)
+    {
+        std::FILE* stream = std::fopen(filename, "rb");
+        if (!stream) {
+            return false;
+        }
+
+        std::vector<uint8_t> buffer;
+        if (std::fseek(stream, 0, SEEK_END) == 0) {
+            long size = std::ftell(stream);
+            if (size > 0 && std::fseek(stream, 0, SEEK_SET) == 0) {
+                buffer.resize(static_cast<size_t>(size));
+                if (std::fread(buffer.data(), buffer.size(), 1, stream) != 1) {
+                    buffer.clear();
+                }
+            }
+        }
+
+        std::fclose(stream);
+
+        if (buffer.empty()) {
+            return false;
+        }
+
+        m_buffer = std::move(buffer);
+        m_data = m_buffer.data();
+        m_size = m_buffer.size();
+        return true;
+    }
+
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_mapped = false;
+    std::vector<uint8_t> m_buffer;
+};
+
+//! NOTE Every fluid "file handle" is an independent cursor over the shared mapped file,
+//!      so several synth instances can read the same sound-font concurrently
+struct SoundFontStream
+{
+    const MappedSoundFontFile* file = nullptr;
+    size_t pos = 0;
+};
+
+using PresetNotifyFunc = int (*)(fluid_preset_t*, int, int);
+
+//! NOTE A preset of a loaded sound-font, and its link in the list of the presets
+//!      whose samples must be loaded
+struct PresetLoadRequest
+{
+    fluid_preset_t* preset = nullptr;
+    PresetNotifyFunc defaultNotify = nullptr;
+    std::atomic<bool> requested = false;
+    PresetLoadRequest* next = nullptr;
+};
+
+//! NOTE A loaded sound-font, as seen from the synth instances.
+//!      It isn't modified once published, so it's read from any thread without locking
+struct LoadedSoundFont
+{
+    explicit LoadedSoundFont(size_t presetCount)
+        : presets(presetCount) {}
+
+    std::string filename;
+    const MappedSoundFontFile* file = nullptr;
+    const fluid_sfont_t* soundFont = nullptr;
+    std::vector<PresetLoadRequest> presets; // sorted by preset
+    const LoadedSoundFont* next = nullptr;
+};
+
+struct SoundFontData
+{
+    fluid_sfont_t* soundFontPtr = nullptr;
+    std::unique_ptr<MappedSoundFontFile> file;
+    std::unique_ptr<LoadedSoundFont> loaded;
+};
+
+struct SoundFontCache : public std::map<std::string, SoundFontData> {
+    static SoundFontCache* instance()
+    {
+        static SoundFontCache s;
+        return &s;
+    }
+
+    //! NOTE Guards the cache while a sound-font is loaded. Not used by the synth instances afterwards
+    std::recursive_mutex mutex;
+
+private:
+    SoundFontCache() = default;
+    ~SoundFontCache()
+    {
+        for (const auto& pair : *this) {
+            if (!pair.second.soundFontPtr) {
+                continue;
+            }
+
+            fluid_defsfont_t* defsFont = static_cast<fluid_defsfont_t*>(fluid_sfont_get_data(pair.second.soundFontPtr));
+
+            if (delete_fluid_defsfont(defsFont) != FLUID_OK) {
+                continue;
+            }
+
+            delete_fluid_sfont(pair.second.soundFontPtr);
+        }
+    }
+};
+
+//! NOTE The loaded sound-fonts, most recent first. Only appended to, under the cache mutex
+std::atomic<const LoadedSoundFont*> s_loadedSoundFonts = nullptr;
+
+//! NOTE The presets selected for the first time, whose samples are not loaded yet
+std::atomic<PresetLoadRequest*> s_presetLoadRequests = nullptr;
+std::atomic<bool> s_loadingPresets = false;
+}
+
+static void* openSoundFont(const char* filename)
+{
+    SoundFontCache* cache = SoundFontCache::instance();
+    std::lock_guard lock(cache->mutex);
+
+    SoundFontData& sfData = (*cache)[filename];
+    if (!sfData.file) {
+        sfData.file = MappedSoundFontFile::open(filename);
+    }
+
+    if (!sfData.file) {
+        return nullptr;
+    }
+
+    SoundFontStream* stream = new SoundFontStream();
+    stream->file = sfData.file.get();
+
+    return stream;
+}
+
+static void* openLoadedSoundFont(const char* filename)
+{
+    //!Note Used by fluid to read the samples of the selected presets, which may happen on the audio thread,
+    //!     so the file is looked up among the loaded sound-fonts, without locking the cache
+    for (const LoadedSoundFont* soundFont = s_loadedSoundFonts.load(std::memory_order_acquire); soundFont; soundFont = soundFont->next) {
+        if (soundFont->filename == filename) {
+            SoundFontStream* stream = new SoundFontStream();
+            stream->file = soundFont->file;
+
+            return stream;
+        }
+    }
+
+    return nullptr;
+}
+
+static int readSoundFont(void* buf, fluid_long_long_t count, void* handle)
+{
+    SoundFontStream* stream = static_cast<SoundFontStream*>(handle);
+    if (count < 0 || static_cast<size_t>(count) > stream->file->size() - stream->pos) {
+        return FLUID_FAILED;
+    }
+
+    std::memcpy(buf, stream->file->data() + stream->pos, static_cast<size_t>(count));
+    stream->pos += static_cast<size_t>(count);
+
+    return FLUID_OK;
+}
+
+static int seekSoundFont(void* handle, fluid_long_long_t offset, int origin)
+{
+    SoundFontStream* stream = static_cast<SoundFontStream*>(handle);
+
+    fluid_long_long_t base = 0;
+    if (origin == SEEK_CUR) {
+        base = static_cast<fluid_long_long_t>(stream->pos);
+    } else if (origin == SEEK_END) {
+        base = static_cast<fluid_long_long_t>(stream->file->size());
+    } else if (origin != SEEK_SET) {
+        return FLUID_FAILED;
+    }
+
+    fluid_long_long_t newPos = base + offset;
+    if (newPos < 0 || newPos > static_cast<fluid_long_long_t>(stream->file->size())) {
+        return FLUID_FAILED;
+    }
+
+    stream->pos = static_cast<size_t>(newPos);
+
+    return FLUID_OK;
+}
+
+static int closeSoundFont(void* handle)
+{
+    //!Note Only the cursor is released here,
+    //!     the mapped file itself stays in SoundFontCache to be shared with other Fluid instances
+    delete static_cast<SoundFontStream*>(handle);
+
+    return FLUID_OK;
+}
+
+static fluid_long_long_t tellSoundFont(void* handle)
+{
+    return static_cast<fluid_long_long_t>(static_cast<SoundFontStream*>(handle)->pos);
+}
+
+static int deleteSoundFont(fluid_sfont_t* /*sfont*/)
+{
+    //!Note Prevent removal of sound-fonts by Fluid instances,
+    //!     instead the actual removal of cached sound-fonts will happen in SoundFontCache.
+    //!     However, we still need to provide "some" callback for Fluid's API
+
+    return FLUID_OK;
+}
+
+static fluid_file_callbacks_t FILE_CALLBACKS {
+    openSoundFont,
+    readSoundFont,
+    seekSoundFont,
+    closeSoundFont,
+    tellSoundFont
+};
+
+static fluid_file_callbacks_t LOADED_FILE_CALLBACKS {
+    openLoadedSoundFont,
+    readSoundFont,
+    seekSoundFont,
+    closeSoundFont,
+    tellSoundFont
+};
+
+static PresetLoadRequest* findPresetLoadRequest(const fluid_preset_t* preset)
+{
+    for (const LoadedSoundFont* soundFont = s_loadedSoundFonts.load(std::memory_order_acquire); soundFont; soundFont = soundFont->next) {
+        if (soundFont->soundFont != preset->sfont) {
+            continue;
+        }
+
+        auto it = std::lower_bound(soundFont->presets.begin(), soundFont->presets.end(), preset,
+                                   [](const PresetLoadRequest& request, const fluid_preset_t* p) {
+            return std::less<const fluid_preset_t*>()(request.preset, p);
+        });
+
+        if (it != soundFont->presets.end() && it->preset == preset) {
+            return const_cast<PresetLoadRequest*>(&(*it));
+        }
+
+        return nullptr;
+    }
+
+    return nullptr;
+}
+
+static void loadRequestedPresets()
+{
+    //!Note The instance that gets here first loads the samples requested by all of them,
+    //!     the others don't wait: their notes of the requested presets don't sound until it's done.
+    //!     Only one thread at a time changes the shared sound-fonts
+    while (!s_loadingPresets.exchange(true, std::memory_order_acquire)) {
+        PresetLoadRequest* request = s_presetLoadRequests.exchange(nullptr, std::memory_order_acquire);
+        while (request) {
+            PresetLoadRequest* next = request->next;
+            request->defaultNotify(request->preset, FLUID_PRESET_SELECTED, -1);
+            request = next;
+        }
+
+        s_loadingPresets.store(false, std::memory_order_release);
+
+        // a request may have been added after the list was taken, but before the loading flag was cleared
+        if (!s_presetLoadRequests.load(std::memory_order_acquire)) {
+            break;
+        }
+    }
+}
+
+static int notifyPreset(fluid_preset_t* preset, int reason, int /*chan*/)
+{
+    //!Note With dynamic sample loading, the sample data of a preset is decoded when the preset
+    //!     gets selected for the first time. It's called on the audio thread by program changes
+    //!     and shared by all Fluid instances, so the samples are kept until the sound-font is unloaded
+    //!     and the selections are handed over without locking
+    if (reason != FLUID_PRESET_SELECTED && reason != FLUID_PRESET_PIN) {
+        return FLUID_OK;
+    }
+
+    PresetLoadRequest* request = findPresetLoadRequest(preset);
+    if (!request) {
+        return FLUID_FAILED;
+    }
+
+    if (!request->requested.exchange(true, std::memory_order_acq_rel)) {
+        PresetLoadRequest* head = s_presetLoadRequests.load(std::memory_order_relaxed);
+        do {
+            request->next = head;
+        } while (!s_presetLoadRequests.compare_exchange_weak(head, request, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    loadRequestedPresets();
+
+    return FLUID_OK;
+}
+
+static std::unique_ptr<LoadedSoundFont> setupPresetNotify(fluid_defsfont_t* defsfont, const char* filename,
+                                                          const MappedSoundFontFile* file)
+{
+    std::vector<fluid_preset_t*> presets;
+    PresetNotifyFunc defaultNotify = nullptr;
+
+    for (fluid_list_t* list = defsfont->preset; list; list = fluid_list_next(list)) {
+        fluid_preset_t* preset = static_cast<fluid_preset_t*>(fluid_list_get(list));
+        if (!preset->notify) {
+            continue;
+        }
+
+        defaultNotify = preset->notify;
+        presets.push_back(preset);
+    }
+
+    std::sort(presets.begin(), presets.end(), std::less<fluid_preset_t*>());
+
+    auto loaded = std::make_unique<LoadedSoundFont>(presets.size());
+    loaded->filename = filename;
+    loaded->file = file;
+    loaded->soundFont = defsfont->sfont;
+
+    for (size_t i = 0; i < presets.size(); ++i) {
+        loaded->presets[i].preset = presets[i];
+        loaded->presets[i].defaultNotify = defaultNotify;
+    }
+
+    // published before the presets can be selected
+    loaded->next = s_loadedSoundFonts.load(std::memory_order_relaxed);
+    s_loadedSoundFonts.store(loaded.get(), std::memory_order_release);
+
+    for (fluid_preset_t* preset : presets) {
+        preset->notify = notifyPreset;
+    }
+
+    defsfont->fcbs = &LOADED_FILE_CALLBACKS;
+
+    return loaded;
+}
+
+fluid_sfont_t* muse::audio::synth::loadSoundFont(fluid_sfloader_t* loader, const char* filename)
+{
+    SoundFontCache* cache = SoundFontCache::instance();
+    std::lock_guard lock(cache->mutex);
+
+    auto search = cache->find(filename);
+    if (search != cache->cend() && search->second.soundFontPtr) {
+        return search->second.soundFontPtr;
+    }
+
+    fluid_defsfont_t* defsfont = nullptr;
+    fluid_sfont_t* result = nullptr;
+
+    defsfont = new_fluid_defsfont(static_cast<fluid_settings_t*>(fluid_sfloader_get_data(loader)));
+
+    if (!defsfont) {
+        return nullptr;
+    }
+
+    result = new_fluid_sfont(fluid_defsfont_sfont_get_name,
+                             fluid_defsfont_sfont_get_preset,
+                             fluid_defsfont_sfont_iteration_start,
+                             fluid_defsfont_sfont_iteration_next,
+                             deleteSoundFont);
+
+    if (!result) {
+        return result;
+    }
+
+    fluid_sfont_set_data(result, defsfont);
+    defsfont->sfont = result;
+    defsfont->fcbs = &FILE_CALLBACKS;
+
+    if (fluid_defsfont_load(defsfont, &FILE_CALLBACKS, filename) == FLUID_FAILED) {
+        fluid_defsfont_sfont_delete(result);
+        return nullptr;
+    }
+
+    SoundFontData& sfData = (*cache)[filename];
+    sfData.soundFontPtr = result;
+    sfData.loaded = setupPresetNotify(defsfont, filename, sfData.file.get());
+
+    return result;
+}
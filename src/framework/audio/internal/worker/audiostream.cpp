@@ -20,6 +20,9 @@
  * along with this program.  If not, see <https://www.gnu.org/licenses/>.
  */
 #include "audiostream.h"
+
+#include <algorithm>
+
 #include "log.h"
 
 #define DR_WAV_IMPLEMENTATION
@@ -44,8 +47,16 @@
 
 using namespace muse::audio;
 
+//! NOTE The offline conversion is done once, so the best quality is used.
+//! The real time one runs in the audio thread, so the cost and the latency are kept lower
+static constexpr SampleRateConvertor::Quality OFFLINE_QUALITY = SampleRateConvertor::Quality::High;
+static constexpr SampleRateConvertor::Quality REALTIME_QUALITY = SampleRateConvertor::Quality::Medium;
+
+//! input frames converted at once in real time
+static constexpr size_t REALTIME_BLOCK_FRAMES = 512;
+
 AudioStream::AudioStream()
-    : m_src(m_data, 0, 1, 1)
+    : m_src(1, 1, 1, REALTIME_QUALITY)
 {
 }
 
@@ -55,6 +66,7 @@ bool AudioStream::loadFile(const io::path_t& path)
     if (loaded) {
         m_src.setChannelCount(m_channels);
         m_src.setSampleRateIn(m_sampleRate);
+        m_srcSeekNeeded = true;
     }
     return loaded;
 }
@@ -62,9 +74,12 @@ bool AudioStream::loadFile(const io::path_t& path)
 void AudioStream::convertSampleRate(unsigned int sampleRate)
 {
     if (sampleRate != m_sampleRate) {
-        auto src = new SampleRateConvertor(m_data, m_channels, m_sampleRate, sampleRate);
-        m_data = src->convert();
+        SampleRateConvertor src(m_data, m_channels, m_sampleRate, sampleRate, OFFLINE_QUALITY);
+        m_data = src.convert();
         m_sampleRate = sampleRate;
+
+        m_src.setSampleRateIn(m_sampleRate);
+        m_srcSeekNeeded = true;
     }
 }
 
@@ -81,9 +96,12 @@ unsigned int AudioStream::sampleRate() const
 unsigned int AudioStream::copySamplesToBuffer(float* buffer, unsigned int fromSample, unsigned int sampleCount, unsigned int sampleRate)
 {
     if (m_sampleRate != sampleRate) {
-        m_src.setSampleRateOut(sampleRate);
+        if (m_src.sampleRateOut() != sampleRate) {
+            m_src.setSampleRateOut(sampleRate);
+            m_srcSeekNeeded = true;
+        }
 
-        return m_src.convert(buffer, fromSample, sampleCount);
+        return convertSamplesToBuffer(buffer, fromSample, sampleCount);
     }
 
     auto from = fromSample * m_channels;
@@ -105,6 +123,61 @@ unsigned int AudioStream::copySamplesToBuffer(float* buffer, unsigned int fromSa
     return count / m_channels;
 }
 
+unsigned int AudioStream::convertSamplesToBuffer(float* buffer, unsigned int fromSample, unsigned int sampleCount)
+{
+    //! NOTE The convertor keeps its state between the calls, so the consecutive blocks are converted
+    //! without recomputing the overlapping windows. A new position (or a new sample rate) needs a seek
+    if (m_srcSeekNeeded || fromSample != m_srcOutputFrame) {
+        m_srcSeekNeeded = false;
+        m_srcInputFrame = m_src.seek(fromSample);
+        m_srcOutputFrame = fromSample;
+        m_srcOutput.clear();
+        m_srcOutputPos = 0;
+    }
+
+    const size_t totalInputFrames = m_data.size() / m_channels;
+    const size_t totalOutputFrames = m_src.outputFrameCount(totalInputFrames);
+
+    unsigned int copied = 0;
+
+    while (copied < sampleCount && m_srcOutputFrame < totalOutputFrames) {
+        if (m_srcOutputPos == m_srcOutput.size()) {
+            //! NOTE The source is followed by silence, so the last output frames get the rest of their windows
+            const size_t blockFrames = REALTIME_BLOCK_FRAMES;
+            const size_t dataFrames = m_srcInputFrame < totalInputFrames ? std::min(blockFrames, totalInputFrames - m_srcInputFrame) : 0;
+
+            const float* input = nullptr;
+            if (dataFrames == blockFrames) {
+                input = m_data.data() + m_srcInputFrame * m_channels;
+            } else {
+                m_srcInput.assign(blockFrames * m_channels, 0.f);
+                if (dataFrames > 0) {
+                    std::copy_n(m_data.begin() + m_srcInputFrame * m_channels, dataFrames * m_channels, m_srcInput.begin());
+                }
+                input = m_srcInput.data();
+            }
+
+            m_srcOutput.resize(m_src.maxOutputFrames(blockFrames) * m_channels);
+            const size_t outputFrames = m_src.process(input, blockFrames, m_srcOutput.data());
+            m_srcOutput.resize(outputFrames * m_channels);
+            m_srcOutputPos = 0;
+            m_srcInputFrame += blockFrames;
+            continue;
+        }
+
+        const size_t availableFrames = (m_srcOutput.size() - m_srcOutputPos) / m_channels;
+        const size_t frames = std::min({ availableFrames, static_cast<size_t>(sampleCount - copied), totalOutputFrames - m_srcOutputFrame });
+
+        std::copy_n(m_srcOutput.begin() + m_srcOutputPos, frames * m_channels, buffer + copied * m_channels);
+
+        m_srcOutputPos += frames * m_channels;
+        m_srcOutputFrame += frames;
+        copied += static_cast<unsigned int>(frames);
+    }
+
+    return copied;
+}
+
 bool AudioStream::loadWAV(io::path_t path)
 {
     drwav wav;
@@ -54,10 +54,20 @@ private:
     bool loadMP3(io::path_t path);
     bool loadOGG(io::path_t path);
 
+    unsigned int convertSamplesToBuffer(float* buffer, unsigned int fromSample, unsigned int sampleCount);
+
     unsigned int m_channels = 1;
     unsigned int m_sampleRate = 1;
     std::vector<float> m_data = {};
+
+    //! real time conversion state: the next output and input frames, and the converted frames not copied yet
     SampleRateConvertor m_src;
+    bool m_srcSeekNeeded = true;
+    size_t m_srcOutputFrame = 0;
+    size_t m_srcInputFrame = 0;
+    std::vector<float> m_srcInput;
+    std::vector<float> m_srcOutput;
+    size_t m_srcOutputPos = 0;
 };
 }
 
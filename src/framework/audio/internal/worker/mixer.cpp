@@ -99,6 +99,7 @@ RetVal<MixerChannelPtr> Mixer::addChannel(const TrackId trackId, ITrackAudioInpu
     });
 
     m_trackChannels.emplace(trackId, channel);
+    updateTrackBuffers();
 
     result.val = m_trackChannels[trackId];
     result.ret = make_ret(Ret::Code::Ok);
@@ -140,6 +141,8 @@ Ret Mixer::removeChannel(const TrackId trackId)
         }
 
         m_trackChannels.erase(trackId);
+        updateTrackBuffers();
+
         return make_ret(Ret::Code::Ok);
     }
 
@@ -155,6 +158,8 @@ void Mixer::setAudioChannelsCount(const audioch_t count)
     ONLY_AUDIO_WORKER_THREAD;
 
     m_audioChannelsCount = count;
+
+    resizeTrackBuffers(configuration()->samplesToPreallocate() * count);
 }
 
 void Mixer::setSampleRate(unsigned int sampleRate)
@@ -169,6 +174,8 @@ void Mixer::setSampleRate(unsigned int sampleRate)
         channel.second->setSampleRate(sampleRate);
     }
 
+    resizeTrackBuffers(configuration()->samplesToPreallocate() * m_audioChannelsCount);
+
     for (AuxChannelInfo& aux : m_auxChannelInfoList) {
         aux.channel->setSampleRate(sampleRate);
     }
@@ -201,18 +208,17 @@ samples_t Mixer::process(float* outBuffer, samples_t samplesPerChannel)
         return 0;
     }
 
-    TracksData tracksData;
-    processTrackChannels(outBufferSize, samplesPerChannel, tracksData);
+    processTrackChannels(outBufferSize, samplesPerChannel);
 
     prepareAuxBuffers(outBufferSize);
 
     samples_t masterChannelSampleCount = 0;
 
-    for (auto& pair : tracksData) {
-        const std::vector<float>& trackBuffer = pair.second;
+    for (const TrackBuffer* track : m_tracksToProcess) {
+        const float* trackBuffer = track->data.data();
 
         bool outBufferIsSilent = false;
-        mixOutputFromChannel(outBuffer, trackBuffer.data(), samplesPerChannel, outBufferIsSilent);
+        mixOutputFromChannel(outBuffer, trackBuffer, samplesPerChannel, outBufferIsSilent);
         masterChannelSampleCount = std::max(samplesPerChannel, masterChannelSampleCount);
 
         if (!outBufferIsSilent) {
@@ -221,8 +227,8 @@ samples_t Mixer::process(float* outBuffer, samples_t samplesPerChannel)
             continue;
         }
 
-        const AuxSendsParams& auxSends = m_trackChannels.at(pair.first)->outputParams().auxSends;
-        writeTrackToAuxBuffers(trackBuffer.data(), auxSends, samplesPerChannel);
+        const AuxSendsParams& auxSends = track->channel->outputParams().auxSends;
+        writeTrackToAuxBuffers(trackBuffer, auxSends, samplesPerChannel);
     }
 
     if (m_masterParams.muted || masterChannelSampleCount == 0 || m_isSilence) {
@@ -242,60 +248,84 @@ samples_t Mixer::process(float* outBuffer, samples_t samplesPerChannel)
     return masterChannelSampleCount;
 }
 
-void Mixer::processTrackChannels(size_t outBufferSize, size_t samplesPerChannel, TracksData& outTracksData)
+void Mixer::updateTrackBuffers()
 {
-    auto processChannel = [outBufferSize, samplesPerChannel](MixerChannelPtr channel) -> std::vector<float> {
-        thread_local std::vector<float> buffer(outBufferSize, 0.f);
-        thread_local std::vector<float> silent_buffer(outBufferSize, 0.f);
+    std::vector<TrackBuffer> buffers;
+    buffers.reserve(m_trackChannels.size());
 
-        if (buffer.size() < outBufferSize) {
-            buffer.resize(outBufferSize, 0.f);
-            silent_buffer.resize(outBufferSize, 0.f);
-        }
+    for (const auto& pair : m_trackChannels) {
+        TrackBuffer buffer;
+        buffer.channel = pair.second;
 
-        buffer = silent_buffer;
+        //! NOTE: Reuse the already allocated memory of the existing channels
+        auto it = std::find_if(m_trackBuffers.begin(), m_trackBuffers.end(), [&pair](const TrackBuffer& b) {
+            return b.channel == pair.second;
+        });
 
-        if (channel) {
-            channel->process(buffer.data(), samplesPerChannel);
+        if (it != m_trackBuffers.end()) {
+            buffer.data = std::move(it->data);
         }
 
-        return buffer;
-    };
+        buffer.data.resize(m_trackBufferSize, 0.f);
+        buffers.push_back(std::move(buffer));
+    }
 
-    bool filterTracks = m_isIdle && !m_tracksToProcessWhenIdle.empty();
+    m_trackBuffers = std::move(buffers);
 
-    if (useMultithreading()) {
-        std::map<TrackId, std::future<std::vector<float> > > futures;
+    m_tracksToProcess.clear();
+    m_tracksToProcess.reserve(m_trackBuffers.size());
+}
 
-        for (const auto& pair : m_trackChannels) {
-            if (filterTracks && !muse::contains(m_tracksToProcessWhenIdle, pair.second->trackId())) {
-                continue;
-            }
+void Mixer::resizeTrackBuffers(size_t bufferSize)
+{
+    if (bufferSize <= m_trackBufferSize) {
+        return;
+    }
 
-            if (pair.second->muted()) {
-                pair.second->notifyNoAudioSignal();
-                continue;
-            }
+    m_trackBufferSize = bufferSize;
+
+    for (TrackBuffer& buffer : m_trackBuffers) {
+        buffer.data.resize(bufferSize, 0.f);
+    }
+}
 
-            std::future<std::vector<float> > future = m_taskScheduler->submit(processChannel, pair.second);
-            futures.emplace(pair.first, std::move(future));
+void Mixer::processTrackChannels(size_t outBufferSize, size_t samplesPerChannel)
+{
+    //! NOTE: Only happens if the driver asks for a bigger block than the preallocated one
+    if (m_trackBufferSize < outBufferSize) {
+        resizeTrackBuffers(outBufferSize);
+    }
+
+    bool filterTracks = m_isIdle && !m_tracksToProcessWhenIdle.empty();
+
+    m_tracksToProcess.clear();
+
+    for (TrackBuffer& track : m_trackBuffers) {
+        if (filterTracks && !muse::contains(m_tracksToProcessWhenIdle, track.channel->trackId())) {
+            continue;
         }
 
-        for (auto& pair : futures) {
-            outTracksData.emplace(pair.first, pair.second.get());
+        if (track.channel->muted()) {
+            track.channel->notifyNoAudioSignal();
+            continue;
         }
-    } else {
-        for (const auto& pair : m_trackChannels) {
-            if (filterTracks && !muse::contains(m_tracksToProcessWhenIdle, pair.second->trackId())) {
-                continue;
-            }
 
-            if (pair.second->muted()) {
-                pair.second->notifyNoAudioSignal();
-                continue;
-            }
+        m_tracksToProcess.push_back(&track);
+    }
+
+    auto processChannel = [this, outBufferSize, samplesPerChannel](size_t index) {
+        TrackBuffer* track = m_tracksToProcess[index];
+        float* buffer = track->data.data();
 
-            outTracksData.emplace(pair.first, processChannel(pair.second));
+        std::fill(buffer, buffer + outBufferSize, 0.f);
+        track->channel->process(buffer, samplesPerChannel);
+    };
+
+    if (useMultithreading()) {
+        m_taskScheduler->parallelFor(m_tracksToProcess.size(), processChannel);
+    } else {
+        for (size_t i = 0; i < m_tracksToProcess.size(); ++i) {
+            processChannel(i);
         }
     }
 }
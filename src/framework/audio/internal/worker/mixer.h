@@ -79,9 +79,15 @@ public:
     void setIsActive(bool arg) override;
 
 private:
-    using TracksData = std::map<TrackId, std::vector<float> >;
+    struct TrackBuffer {
+        MixerChannelPtr channel;
+        std::vector<float> data;
+    };
 
-    void processTrackChannels(size_t outBufferSize, size_t samplesPerChannel, TracksData& outTracksData);
+    void updateTrackBuffers();
+    void resizeTrackBuffers(size_t bufferSize);
+
+    void processTrackChannels(size_t outBufferSize, size_t samplesPerChannel);
     void mixOutputFromChannel(float* outBuffer, const float* inBuffer, unsigned int samplesCount, bool& outBufferIsSilent);
     void prepareAuxBuffers(size_t outBufferSize);
     void writeTrackToAuxBuffers(const float* trackBuffer, const AuxSendsParams& auxSends, samples_t samplesPerChannel);
@@ -106,6 +112,12 @@ private:
     std::map<TrackId, MixerChannelPtr> m_trackChannels = {};
     std::unordered_set<TrackId> m_tracksToProcessWhenIdle;
 
+    //! NOTE: One preallocated buffer per track channel (in the same order as m_trackChannels),
+    //! so that processing a block doesn't need any heap allocation
+    std::vector<TrackBuffer> m_trackBuffers;
+    std::vector<TrackBuffer*> m_tracksToProcess;
+    size_t m_trackBufferSize = 0;
+
     struct AuxChannelInfo {
         MixerChannelPtr channel;
         std::vector<float> buffer;
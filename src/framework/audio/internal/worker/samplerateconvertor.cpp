@@ -21,192 +21,271 @@
  */
 #include "samplerateconvertor.h"
 
+#include <algorithm>
 #include <cmath>
+#include <numeric>
 
 #include "log.h"
 
 using namespace muse::audio;
 
+//! NOTE The partial sums are independent, so the compiler vectorizes the loop (SSE/AVX/NEON)
+//! without having to reorder floating point additions. The number of taps is always a multiple of 8
+static inline float dotProduct(const float* coefs, const float* samples, unsigned int count)
+{
+    float sum[8] = { 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f, 0.f };
+
+    for (unsigned int i = 0; i < count; i += 8) {
+        for (unsigned int k = 0; k < 8; ++k) {
+            sum[k] += coefs[i + k] * samples[i + k];
+        }
+    }
+
+    return ((sum[0] + sum[4]) + (sum[1] + sum[5])) + ((sum[2] + sum[6]) + (sum[3] + sum[7]));
+}
+
+//! modified Bessel function of the first kind of order zero
+static double zeroBessel(double x)
+{
+    const double halfXSquared = x * x / 4.0;
+
+    double sum = 1.0;
+    double term = 1.0;
+
+    for (int k = 1; term > sum * 1e-12; ++k) {
+        term *= halfXSquared / (static_cast<double>(k) * k);
+        sum += term;
+    }
+
+    return sum;
+}
+
+static double sinc(double value)
+{
+    if (value == 0.0) {
+        return 1.0;
+    }
+
+    return std::sin(M_PI * value) / (M_PI * value);
+}
+
 SampleRateConvertor::SampleRateConvertor(const std::vector<float>& data,
                                          unsigned int channelsCount,
                                          unsigned int sampleRateIn,
-                                         unsigned int sampleRateOut)
-    : m_data(data), m_fir(), m_channelsCount(channelsCount), m_sampleRateIn(sampleRateIn), m_sampleRateOut(sampleRateOut)
+                                         unsigned int sampleRateOut,
+                                         Quality quality)
+    : m_data(&data), m_channelsCount(channelsCount), m_sampleRateIn(sampleRateIn), m_sampleRateOut(sampleRateOut),
+    m_quality(quality)
 {
-    m_fir.resize(FIR_LENGTH, 0);
-    m_y.resize(FIR_LENGTH, 0);
-    initWindow();
+    initFilterBank();
+}
+
+SampleRateConvertor::SampleRateConvertor(unsigned int channelsCount, unsigned int sampleRateIn, unsigned int sampleRateOut,
+                                         Quality quality)
+    : m_channelsCount(channelsCount), m_sampleRateIn(sampleRateIn), m_sampleRateOut(sampleRateOut), m_quality(quality)
+{
+    initFilterBank();
 }
 
 std::vector<float> SampleRateConvertor::convert()
 {
     std::vector<float> out;
-    auto resultSamples = m_data.size() * m_sampleRateOut / (m_channelsCount * m_sampleRateIn);
+    IF_ASSERT_FAILED(m_data && m_channelsCount > 0) {
+        return out;
+    }
+
+    const size_t frames = m_data->size() / m_channelsCount;
+    const size_t resultSamples = m_data->size() * m_sampleRateOut / (m_channelsCount * m_sampleRateIn);
 
     out.resize(resultSamples * m_channelsCount);
-    for (unsigned sample = 0; sample < resultSamples; ++sample) {
-        for (unsigned int channel = 0; channel < m_channelsCount; ++channel) {
-            out[sample * m_channelsCount + channel] = y(sample, channel);
+
+    //! NOTE Deinterleaved and zero padded copy of every channel, so that each window is contiguous
+    const size_t padding = m_taps;
+    std::vector<float> channelData(frames + 2 * padding);
+
+    for (unsigned int channel = 0; channel < m_channelsCount; ++channel) {
+        std::fill(channelData.begin(), channelData.end(), 0.f);
+        for (size_t frame = 0; frame < frames; ++frame) {
+            channelData[padding + frame] = (*m_data)[frame * m_channelsCount + channel];
+        }
+
+        for (size_t sample = 0; sample < resultSamples; ++sample) {
+            const uint64_t position = sample * m_M;
+            const size_t windowStart = padding + position / m_L + 1 - m_taps / 2;
+
+            out[sample * m_channelsCount + channel] = dotProduct(phase(position % m_L), channelData.data() + windowStart, m_taps);
         }
     }
 
     return out;
 }
 
-unsigned int SampleRateConvertor::convert(float* buffer, unsigned int from, unsigned int count)
+size_t SampleRateConvertor::process(const float* input, size_t inputFrames, float* output)
 {
-    unsigned int sample = from;
-    unsigned int converted = 0;
+    if (m_sampleRateIn == m_sampleRateOut) {
+        std::copy(input, input + inputFrames * m_channelsCount, output);
+        return inputFrames;
+    }
+
+    const size_t history = m_taps - 1;
+    const size_t bufferSize = history + inputFrames;
+
+    for (unsigned int channel = 0; channel < m_channelsCount; ++channel) {
+        std::vector<float>& buffer = m_channelBuffers[channel];
+        buffer.resize(bufferSize);
+
+        for (size_t frame = 0; frame < inputFrames; ++frame) {
+            buffer[history + frame] = input[frame * m_channelsCount + channel];
+        }
+    }
+
+    size_t outputFrames = 0;
+
+    while (m_windowStart + m_taps <= bufferSize) {
+        const float* coefs = phase(m_phaseAccumulator);
 
-    for (converted = 0; converted < count; ++converted, ++sample) {
         for (unsigned int channel = 0; channel < m_channelsCount; ++channel) {
-            if (!availableSamples(sample)) {
-                return converted;
-            }
-            buffer[converted * m_channelsCount + channel] = y(sample, channel);
+            output[outputFrames * m_channelsCount + channel] = dotProduct(coefs, m_channelBuffers[channel].data() + m_windowStart, m_taps);
         }
+
+        ++outputFrames;
+
+        m_phaseAccumulator += m_M;
+        m_windowStart += m_phaseAccumulator / m_L;
+        m_phaseAccumulator %= m_L;
+    }
+
+    for (std::vector<float>& buffer : m_channelBuffers) {
+        std::copy(buffer.end() - history, buffer.end(), buffer.begin());
+        buffer.resize(history);
     }
-    return converted;
+
+    m_windowStart -= inputFrames;
+
+    return outputFrames;
 }
 
-float SampleRateConvertor::y(unsigned int sample, unsigned int channel) const
+size_t SampleRateConvertor::maxOutputFrames(size_t inputFrames) const
 {
-    switch (m_method) {
-    case SINC:
-        return ySinc(sample, channel);
-    case FIR:
-        return yFIR(sample, channel);
-    }
-    return 0.f;
+    return (inputFrames * m_L + m_M - 1) / m_M + 1;
 }
 
-void SampleRateConvertor::setChannelCount(unsigned int count)
+size_t SampleRateConvertor::latencyFrames() const
 {
-    m_channelsCount = count;
+    return m_sampleRateIn == m_sampleRateOut ? 0 : m_taps / 2;
 }
 
-void SampleRateConvertor::setSampleRateIn(unsigned int sampleRate)
+size_t SampleRateConvertor::outputFrameCount(size_t inputFrames) const
 {
-    if (m_sampleRateIn != sampleRate) {
-        m_sampleRateIn = sampleRate;
-        initWindow();
-    }
+    return inputFrames * m_sampleRateOut / m_sampleRateIn;
 }
 
-void SampleRateConvertor::setSampleRateOut(unsigned int sampleRate)
+void SampleRateConvertor::reset()
 {
-    if (m_sampleRateOut != sampleRate) {
-        m_sampleRateOut = sampleRate;
-        initWindow();
-    }
+    //! NOTE The first window is centered on the first input sample, preceded by silence
+    m_channelBuffers.assign(m_channelsCount, std::vector<float>(m_taps - 1, 0.f));
+    m_windowStart = m_taps / 2;
+    m_phaseAccumulator = 0;
 }
 
-float SampleRateConvertor::ySinc(unsigned int sample, unsigned int channel) const
+size_t SampleRateConvertor::seek(uint64_t outputFrame)
 {
-    double currentOutputSampleTime = sample / static_cast<double>(m_sampleRateOut);
-    auto zeroInputSample = std::floor(currentOutputSampleTime * m_sampleRateIn);
+    const uint64_t position = outputFrame * m_M;
+    const int64_t windowStart = static_cast<int64_t>(position / m_L) + 1 - static_cast<int64_t>(m_taps / 2);
 
-    float out = 0.f;
-    for (unsigned int i = 0; i < USE_SAMPLES; ++i) {
-        int currentSample = zeroInputSample + i - USE_SAMPLES / 2;
-        double currentInputSampleTime = currentSample / static_cast<double>(m_sampleRateIn);
+    //! NOTE The window of the first output frame starts with the first input frame passed,
+    //! or with silence at the beginning of the source, as in convert()
+    const size_t history = m_taps - 1;
+    m_channelBuffers.assign(m_channelsCount, std::vector<float>(history, 0.f));
+    m_windowStart = windowStart >= 0 ? history : history + windowStart;
+    m_phaseAccumulator = position % m_L;
 
-        if (currentSample < 0 || currentSample * m_channelsCount + channel >= m_data.size()) {
-            continue;
-        }
-        out += m_data.at(currentSample * m_channelsCount + channel) * sinc(currentOutputSampleTime - currentInputSampleTime);
+    if (m_sampleRateIn == m_sampleRateOut) {
+        return outputFrame;
     }
-    return out;
+
+    return static_cast<size_t>(std::max<int64_t>(windowStart, 0));
 }
 
-float SampleRateConvertor::yFIR(unsigned int sample, unsigned int channel) const
+void SampleRateConvertor::setChannelCount(unsigned int count)
 {
-    auto x = [this, &channel](int m) -> float {
-        int pos = m * m_M / m_L * m_channelsCount + channel;
-        if (pos >= 0 && pos < static_cast<int>(m_data.size())) {
-            return m_data.at(pos);
-        }
-        return 0.f;
-    };
-
-    float y = 0.f;
-    for (unsigned int i = 0; i < FIR_LENGTH; ++i) {
-        int t = sample - static_cast<int>(i);
-        y += x(t) * m_fir[i];
+    if (m_channelsCount != count) {
+        m_channelsCount = count;
+        reset();
     }
-    return y;
 }
 
-bool SampleRateConvertor::availableSamples(unsigned int sample) const
+void SampleRateConvertor::setSampleRateIn(unsigned int sampleRate)
 {
-    float currentOutputSampleTime = sample / static_cast<float>(m_sampleRateOut);
-    auto firstInputSample = std::floor(currentOutputSampleTime * m_sampleRateIn) - USE_SAMPLES / 2;
-
-    // first sample for conversion points out of the input buffer
-    if (firstInputSample * m_channelsCount >= m_data.size()) {
-        return false;
+    if (m_sampleRateIn != sampleRate) {
+        m_sampleRateIn = sampleRate;
+        initFilterBank();
     }
-    return true;
 }
 
-inline double zeroBessel(double x)
+void SampleRateConvertor::setSampleRateOut(unsigned int sampleRate)
 {
-    //return std::cyl_bessel_i(0, x);
-
-    double s = 1, y = 1;
-    int m = 1;
-
-    while (y > std::numeric_limits<float>::min()) {
-        m += 2;
-        y *= x * x / (4 * m * m);
-        s += s * y;
+    if (m_sampleRateOut != sampleRate) {
+        m_sampleRateOut = sampleRate;
+        initFilterBank();
     }
-
-    return s;
 }
 
-void SampleRateConvertor::initWindow()
+void SampleRateConvertor::initFilterBank()
 {
-    int max = std::max(m_sampleRateIn, m_sampleRateOut), min = std::min(m_sampleRateIn, m_sampleRateOut);
-    int maxCommonDivider = 1;
-    while (max % min != 0) {
-        maxCommonDivider = max % min;
-        max = min;
-        min = maxCommonDivider;
-    }
-    m_M = m_sampleRateIn / maxCommonDivider;
-    m_L = m_sampleRateOut / maxCommonDivider;
-    double fStop = std::min(m_sampleRateIn, m_sampleRateOut) / 2,
-           fIntermediateSampleRate = m_sampleRateIn * m_M,
-           attenuation = 96 /*dB*/;
-    int M = FIR_LENGTH;
-    int Np = (M - 1) / 2;
-
-    double alpha = 0.1102 * (attenuation - 8.7);
-    double A[FIR_LENGTH];
-
-    A[0] = 2 * fStop / fIntermediateSampleRate;
-    for (int j = 1; j <= Np; j++) {
-        A[j]  = std::sin(2 * j * M_PI * fStop / fIntermediateSampleRate) / j * M_PI;
+    double attenuation = 80.0; /*dB*/
+    switch (m_quality) {
+    case Quality::Low:
+        m_taps = 16;
+        attenuation = 60.0;
+        break;
+    case Quality::Medium:
+        m_taps = 32;
+        attenuation = 80.0;
+        break;
+    case Quality::High:
+        m_taps = 64;
+        attenuation = 96.0;
+        break;
     }
 
-    for (int j = 0; j <= Np; j++) {
-        m_fir[Np + j]  = A[j];
-        m_fir[Np + j] *= zeroBessel(alpha * std::sqrt(1 - (j * j / (Np * Np))));
-        m_fir[Np + j] /= zeroBessel(alpha);
-    }
+    const uint64_t divider = std::max(1u, std::gcd(m_sampleRateIn, m_sampleRateOut));
+    m_M = std::max(1u, m_sampleRateIn) / divider;
+    m_L = std::max(1u, m_sampleRateOut) / divider;
+    m_phasesCount = static_cast<unsigned int>(std::min<uint64_t>(m_L, MAX_PHASES_COUNT));
 
-    for (int j = 0; j < Np; j++) {
-        m_fir[j] = m_fir[M - 1 - j];
-    }
-}
+    // Kaiser window design: the transition band width follows from the filter length and attenuation,
+    // the cutoff (in cycles per input sample) is placed so that the stopband starts at the lower Nyquist frequency
+    const double beta = 0.1102 * (attenuation - 8.7);
+    const double transitionWidth = (attenuation - 7.95) / (14.36 * m_taps);
+    const double nyquist = 0.5 * std::min(1.0, static_cast<double>(m_L) / m_M);
+    const double cutoff = std::max(nyquist - transitionWidth / 2, nyquist / 2);
+    const double halfLength = m_taps / 2.0;
+    const double windowNorm = zeroBessel(beta);
 
-double SampleRateConvertor::sinc(double value) const
-{
-    if (value == 0) {
-        return 1.f;
+    m_filterBank.assign(static_cast<size_t>(m_phasesCount + 1) * m_taps, 0.f);
+
+    for (unsigned int phaseIdx = 0; phaseIdx <= m_phasesCount; ++phaseIdx) {
+        const double fraction = phaseIdx / static_cast<double>(m_phasesCount);
+        float* coefs = m_filterBank.data() + static_cast<size_t>(phaseIdx) * m_taps;
+
+        double sum = 0.0;
+        for (unsigned int i = 0; i < m_taps; ++i) {
+            // distance between the output sample and the input sample, in input samples
+            const double t = fraction + halfLength - 1 - i;
+            const double u = t / halfLength;
+            const double window = std::abs(u) < 1.0 ? zeroBessel(beta * std::sqrt(1.0 - u * u)) / windowNorm : 0.0;
+            const double value = 2.0 * cutoff * sinc(2.0 * cutoff * t) * window;
+
+            coefs[i] = static_cast<float>(value);
+            sum += value;
+        }
+
+        // unity gain for every phase
+        for (unsigned int i = 0; i < m_taps; ++i) {
+            coefs[i] = static_cast<float>(coefs[i] / sum);
+        }
     }
-    double sincArg = M_PI * value * m_sampleRateIn;
-    double gain = std::min(1.0, m_sampleRateOut / static_cast<double>(m_sampleRateIn));
-    return gain * std::sin(sincArg) / sincArg;
+
+    reset();
 }
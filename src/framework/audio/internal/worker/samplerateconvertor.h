@@ -22,58 +22,88 @@
 #ifndef MUSE_AUDIO_SAMPLERATECONVERTOR_H
 #define MUSE_AUDIO_SAMPLERATECONVERTOR_H
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
-#include <deque>
 
 namespace muse::audio {
+//! Polyphase windowed-sinc sample rate convertor.
+//! The filter bank is precomputed for every phase of the ratio sampleRateOut / sampleRateIn,
+//! so each output sample is a single dot product of the bank row with the input window
 class SampleRateConvertor
 {
 public:
-    enum Method {
-        SINC, FIR
+    //! defines the number of filter taps per output sample: quality vs latency and cost
+    enum class Quality {
+        Low,        // 16 taps, ~60 dB stopband
+        Medium,     // 32 taps, ~80 dB stopband
+        High        // 64 taps, ~96 dB stopband
     };
+
     explicit SampleRateConvertor(const std::vector<float>& data, unsigned int channelsCount, unsigned int sampleRateIn,
-                                 unsigned int sampleRateOut);
+                                 unsigned int sampleRateOut, Quality quality = Quality::Medium);
+
+    //! streaming convertor without source data, use process()
+    SampleRateConvertor(unsigned int channelsCount, unsigned int sampleRateIn, unsigned int sampleRateOut,
+                        Quality quality = Quality::Medium);
 
     //! offline convert full data set
     std::vector<float> convert();
 
-    //! online convert
-    unsigned int convert(float* buffer, unsigned int from, unsigned int count);
+    //! streaming convert of interleaved blocks, the filter state is kept between calls.
+    //! All input frames are consumed, output must have room for maxOutputFrames(inputFrames) frames.
+    //! Output frame n is the same as the one of convert(); it needs the input up to latencyFrames() frames
+    //! after the matching input frame, so the last output frames come when more input (or silence) is passed
+    size_t process(const float* input, size_t inputFrames, float* output);
+
+    size_t maxOutputFrames(size_t inputFrames) const;
+    size_t latencyFrames() const;
+
+    //! number of output frames of the conversion of inputFrames, as convert() gives
+    size_t outputFrameCount(size_t inputFrames) const;
+
+    //! clear the streaming state, the next input is the first frame of the source
+    void reset();
+
+    //! clear the streaming state to produce the output from outputFrame on,
+    //! return the frame of the source from which the input must be passed to process()
+    size_t seek(uint64_t outputFrame);
 
     void setChannelCount(unsigned int count);
     void setSampleRateIn(unsigned int sampleRate);
     void setSampleRateOut(unsigned int sampleRate);
+    unsigned int sampleRateOut() const { return m_sampleRateOut; }
 
 private:
+    //! calculate the polyphase filter bank
+    void initFilterBank();
 
-    //! return value of sinc function (LPF) with consideration of used sampleRates
-    double sinc(double value) const;
-
-    //! output sample value
-    float y(unsigned int sample, unsigned int channel) const;
-    float ySinc(unsigned int sample, unsigned int channel) const;
-    float yFIR(unsigned int sample, unsigned int channel) const;
+    //! the row of the bank nearest to the position between two input samples;
+    //! the bank has an extra row for the position of the next input sample
+    const float* phase(uint64_t phaseAccumulator) const
+    {
+        return m_filterBank.data() + ((phaseAccumulator * m_phasesCount + m_L / 2) / m_L) * m_taps;
+    }
 
-    //! return true if there are samples in input buffer for conversion
-    bool availableSamples(unsigned int sample) const;
+    //! upper limit of the bank size for ratios of big co-prime rates, the nearest phase is used then
+    const static unsigned int MAX_PHASES_COUNT = 1024;
 
-    //! calculate window function values
-    void initWindow();
+    const std::vector<float>* m_data = nullptr;
 
-    const static unsigned int USE_SAMPLES = 16; //!< this value defines the quality and complexity of SRC.
-    const std::vector<float>& m_data;
+    unsigned int m_taps = 32;
+    unsigned int m_phasesCount = 1;
+    uint64_t m_M = 1, m_L = 1;      //!< out / in = L / M
+    std::vector<float> m_filterBank; //!< m_phasesCount + 1 rows of m_taps coefficients
 
-    //! values of window function for USE_SAMPLES
-    const static unsigned int FIR_LENGTH = 33;
-    unsigned int m_M = 1, m_L = 1;
-    std::vector<float> m_fir;
-    mutable std::deque<float> m_y;
+    // streaming state
+    std::vector<std::vector<float> > m_channelBuffers; //!< per channel: m_taps - 1 history samples + current block
+    uint64_t m_windowStart = 0;
+    uint64_t m_phaseAccumulator = 0;
 
-    unsigned int m_channelsCount;
-    unsigned int m_sampleRateIn;
-    unsigned int m_sampleRateOut;
-    Method m_method = FIR;
+    unsigned int m_channelsCount = 1;
+    unsigned int m_sampleRateIn = 1;
+    unsigned int m_sampleRateOut = 1;
+    Quality m_quality = Quality::Medium;
 };
 }
 
@@ -0,0 +1,281 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <map>
+#include <new>
+
+#include "audio/internal/abstracteventsequencer.h"
+#include "audio/internal/audiosanitizer.h"
+
+using namespace muse;
+using namespace muse::audio;
+
+//! NOTE Counts the allocations of the whole test binary, only the difference around a call is checked
+static std::atomic<size_t> s_allocationCount = 0;
+
+void* operator new(size_t size)
+{
+    ++s_allocationCount;
+
+    if (void* ptr = std::malloc(size == 0 ? 1 : size)) {
+        return ptr;
+    }
+
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+class Audio_AbstractEventSequencerTests : public ::testing::Test
+{
+public:
+    class TestSequencer : public AbstractEventSequencer<int>
+    {
+    public:
+        void setEvents(const mpe::PlaybackEventsMap& mainStream, const EventSequenceMap& dynamics)
+        {
+            setMainStreamEvents(mainStream);
+            setDynamicEvents(dynamics);
+        }
+
+        void applyChanges(const mpe::PlaybackEventsChanges& changes)
+        {
+            spliceMainStreamEvents(changes);
+        }
+
+        void setOffStream(const EventSequenceMap& offStream)
+        {
+            setOffStreamEvents(offStream);
+        }
+
+    private:
+        //! NOTE Each rest is played as its duration, at its actual timestamp
+        void appendPlaybackEvents(EventSequenceMap& destination, const mpe::PlaybackEventList& events) override
+        {
+            for (const mpe::PlaybackEvent& event : events) {
+                const mpe::ArrangementContext& ctx = std::get<mpe::RestEvent>(event).arrangementCtx();
+                destination[ctx.actualTimestamp].insert(static_cast<int>(ctx.nominalDuration));
+            }
+        }
+
+        void updateOffStreamEvents(const mpe::PlaybackEventsMap&, const mpe::PlaybackParamList&) override {}
+        void updateMainStreamEvents(const mpe::PlaybackEventsMap&, const mpe::DynamicLevelLayers&, const mpe::PlaybackParamLayers&) override {}
+    };
+
+    void SetUp() override
+    {
+        AudioSanitizer::setupWorkerThread();
+    }
+
+    static mpe::PlaybackEventsMap makeEvents(const std::map<msecs_t, std::vector<int> >& values)
+    {
+        mpe::PlaybackEventsMap result;
+        for (const auto& pair : values) {
+            for (int value : pair.second) {
+                result[pair.first].emplace_back(mpe::RestEvent(pair.first, value, 0));
+            }
+        }
+
+        return result;
+    }
+
+    static std::vector<std::pair<msecs_t, std::vector<int> > > toList(const TestSequencer::EventBlock& block)
+    {
+        std::vector<std::pair<msecs_t, std::vector<int> > > result;
+        for (const TestSequencer::EventBlock::Sequence& sequence : block.sequences) {
+            std::vector<int> events;
+            for (size_t i = 0; i < sequence.eventCount; ++i) {
+                events.push_back(std::get<int>(block.event(sequence, i)));
+            }
+            result.emplace_back(sequence.timestamp, std::move(events));
+        }
+
+        return result;
+    }
+};
+
+/**
+ * @brief Audio_AbstractEventSequencerTests_MainStream
+ * @details The main stream events and the dynamic changes are merged by timestamp
+ *          and grouped into the sequences of the block
+ */
+TEST_F(Audio_AbstractEventSequencerTests, MainStream)
+{
+    // [GIVEN] A sequencer with a few events and dynamic changes
+    TestSequencer sequencer;
+    sequencer.setEvents(makeEvents({ { 0, { 1, 2 } }, { 100, { 3 } }, { 250, { 4 } } }), { { 0, { 10 } }, { 150, { 11 } } });
+    sequencer.setActive(true);
+
+    // [WHEN] Move the playback by 200 msecs
+    TestSequencer::EventBlock block;
+    sequencer.movePlaybackForward(200, block);
+
+    // [THEN] The block starts with the current position and contains all the events up to the new position
+    using List = std::vector<std::pair<msecs_t, std::vector<int> > >;
+    EXPECT_EQ(toList(block), List({ { 0, { 1, 2, 10 } }, { 100, { 3 } }, { 150, { 11 } } }));
+
+    // [WHEN] Move on
+    sequencer.movePlaybackForward(200, block);
+
+    // [THEN] The block starts with an empty sequence, which continues the previous one
+    EXPECT_EQ(toList(block), List({ { 200, {} }, { 250, { 4 } } }));
+
+    // [WHEN] Seek back
+    sequencer.setPlaybackPosition(100);
+    sequencer.movePlaybackForward(100, block);
+
+    // [THEN] The events are played again from the new position
+    EXPECT_EQ(toList(block), List({ { 100, { 3 } }, { 150, { 11 } } }));
+}
+
+/**
+ * @brief Audio_AbstractEventSequencerTests_SpliceChanges
+ * @details The changed ranges are spliced into the main stream: all the events rendered from the removed
+ *          playback events are dropped, even if they are played later, and the inserted ones are merged in
+ */
+TEST_F(Audio_AbstractEventSequencerTests, SpliceChanges)
+{
+    // [GIVEN] A sequencer with a few events, the one at 100 is played at 250 (ex. a note off)
+    mpe::PlaybackEventsMap events = makeEvents({ { 0, { 1 } }, { 200, { 3 } } });
+    events[100].emplace_back(mpe::RestEvent(250, 2, 0));
+
+    // [GIVEN] An event at 50 which is played the same as the one at 0
+    events[50].emplace_back(mpe::RestEvent(0, 1, 0));
+
+    TestSequencer sequencer;
+    sequencer.setEvents(events, {});
+    sequencer.setActive(true);
+
+    // [WHEN] Replace the events at 100 by two others
+    mpe::PlaybackEventsChanges changes;
+    changes.removedRanges.push_back({ 100, 100 });
+    changes.insertedEvents = makeEvents({ { 100, { 5 } }, { 150, { 6 } } });
+    sequencer.applyChanges(changes);
+
+    // [THEN] The event played at 250 is gone, the new ones are played in order, and the same event is played once
+    using List = std::vector<std::pair<msecs_t, std::vector<int> > >;
+    TestSequencer::EventBlock block;
+    sequencer.movePlaybackForward(300, block);
+    EXPECT_EQ(toList(block), List({ { 0, { 1 } }, { 100, { 5 } }, { 150, { 6 } }, { 200, { 3 } } }));
+
+    // [WHEN] Remove one of the events played the same
+    changes = mpe::PlaybackEventsChanges();
+    changes.removedRanges.push_back({ 0, 0 });
+    sequencer.applyChanges(changes);
+    sequencer.setPlaybackPosition(0);
+    sequencer.movePlaybackForward(100, block);
+
+    // [THEN] The other one is still played
+    EXPECT_EQ(toList(block), List({ { 0, { 1 } }, { 100, { 5 } } }));
+
+    // [WHEN] Replace all the events
+    sequencer.applyChanges(mpe::PlaybackEventsChanges::makeFullUpdate(makeEvents({ { 0, { 7 } } })));
+    sequencer.setPlaybackPosition(0);
+    sequencer.movePlaybackForward(300, block);
+
+    // [THEN] Only the new events are played
+    EXPECT_EQ(toList(block), List({ { 0, { 7 } } }));
+}
+
+/**
+ * @brief Audio_AbstractEventSequencerTests_OffStream
+ * @details The off stream events are played from the start of the block while the sequencer is not active
+ */
+TEST_F(Audio_AbstractEventSequencerTests, OffStream)
+{
+    // [GIVEN] An inactive sequencer with a note on and a note off
+    TestSequencer sequencer;
+    sequencer.setOffStream({ { 0, { 1 } }, { 25, { 2 } } });
+
+    using List = std::vector<std::pair<msecs_t, std::vector<int> > >;
+    TestSequencer::EventBlock block;
+
+    // [WHEN] Move the playback by blocks of 10 msecs
+    // [THEN] The note on is played at once and the note off 25 msecs later
+    sequencer.movePlaybackForward(10, block);
+    EXPECT_EQ(toList(block), List({ { 0, { 1 } } }));
+
+    sequencer.movePlaybackForward(10, block);
+    EXPECT_EQ(toList(block), List({ { 0, {} } }));
+
+    sequencer.movePlaybackForward(10, block);
+    EXPECT_EQ(toList(block), List({ { 0, {} } }));
+
+    sequencer.movePlaybackForward(10, block);
+    EXPECT_EQ(toList(block), List({ { 0, {} }, { 5, { 2 } } }));
+
+    // [THEN] The played events are not repeated
+    sequencer.movePlaybackForward(10, block);
+    EXPECT_EQ(toList(block), List({ { 0, {} } }));
+}
+
+/**
+ * @brief Audio_AbstractEventSequencerTests_NoAllocationsPerBlock
+ * @details Once the caller's block has grown, moving the playback forward does not allocate
+ */
+TEST_F(Audio_AbstractEventSequencerTests, NoAllocationsPerBlock)
+{
+    // [GIVEN] A sequencer with an event every msec and a dynamic change every 10 msecs
+    std::map<msecs_t, std::vector<int> > mainStream;
+    TestSequencer::EventSequenceMap dynamics;
+    for (int i = 0; i < 10000; ++i) {
+        mainStream[i * 1000] = { i, i + 50000 };
+        if (i % 10 == 0) {
+            dynamics[i * 1000].insert(i + 100000);
+        }
+    }
+
+    TestSequencer sequencer;
+    sequencer.setEvents(makeEvents(mainStream), dynamics);
+    sequencer.setActive(true);
+
+    // [GIVEN] A block which has already been used once
+    constexpr msecs_t BLOCK_DURATION = 10667; // 512 samples at 48 kHz
+    TestSequencer::EventBlock block;
+    sequencer.movePlaybackForward(BLOCK_DURATION, block);
+
+    // [WHEN] Play the rest of the events block by block
+    size_t maxAllocations = 0;
+    size_t eventCount = block.events.size();
+    for (int i = 0; i < 1000; ++i) {
+        const size_t before = s_allocationCount;
+        sequencer.movePlaybackForward(BLOCK_DURATION, block);
+        maxAllocations = std::max(maxAllocations, s_allocationCount - before);
+        eventCount += block.events.size();
+    }
+
+    // [THEN] All the events are played, without any allocation in the callbacks
+    EXPECT_EQ(eventCount, 21000);
+    EXPECT_EQ(maxAllocations, 0);
+}
@@ -0,0 +1,140 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "audio/internal/fx/reverb/reverbprocessor.h"
+
+using namespace muse;
+using namespace muse::audio;
+using namespace muse::audio::fx;
+
+class Audio_ReverbProcessorTests : public ::testing::Test
+{
+public:
+    static constexpr audioch_t CHANNELS = 2;
+
+    static std::vector<float> makeInput(size_t frames)
+    {
+        std::vector<float> input(frames * CHANNELS, 0.f);
+
+        // short noise bursts separated by silence, so both the attack and the tail are covered
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<float> dist(-1.f, 1.f);
+        for (size_t frame = 0; frame < frames; ++frame) {
+            if ((frame / 4000) % 3 == 0) {
+                for (audioch_t ch = 0; ch < CHANNELS; ++ch) {
+                    input[frame * CHANNELS + ch] = 0.5f * dist(gen);
+                }
+            }
+        }
+
+        return input;
+    }
+
+    static std::vector<float> render(ReverbProcessor& reverb, const std::vector<float>& input, samples_t blockSize)
+    {
+        std::vector<float> output = input;
+        size_t frames = output.size() / CHANNELS;
+
+        for (size_t frame = 0; frame + blockSize <= frames; frame += blockSize) {
+            reverb.process(output.data() + frame * CHANNELS, blockSize);
+        }
+
+        return output;
+    }
+};
+
+/**
+ * @brief Audio_ReverbProcessorTests_BlockProcessingMatchesReference
+ * @details The vectorized block feedback loop must produce the same output as the
+ *          sample-by-sample reference, also for buffer sizes that are not a multiple of the modulation step
+ */
+TEST_F(Audio_ReverbProcessorTests, BlockProcessingMatchesReference)
+{
+    // [GIVEN] Two reverbs with default params, one of them processing sample by sample
+    AudioFxParams params;
+    params.active = true;
+
+    ReverbProcessor blockReverb(params, CHANNELS);
+    ReverbProcessor referenceReverb(params, CHANNELS);
+    referenceReverb.setBlockProcessingEnabled(false);
+
+    EXPECT_TRUE(blockReverb.blockProcessingEnabled());
+    EXPECT_FALSE(referenceReverb.blockProcessingEnabled());
+
+    // [GIVEN] Some input signal
+    std::vector<float> input = makeInput(48000);
+
+    for (samples_t blockSize : { 512, 100, 7 }) {
+        // [WHEN] Rendering it with the given buffer size
+        std::vector<float> blockOutput = render(blockReverb, input, blockSize);
+        std::vector<float> referenceOutput = render(referenceReverb, input, blockSize);
+
+        // [THEN] The outputs are the same, apart from rounding
+        ASSERT_EQ(blockOutput.size(), referenceOutput.size());
+
+        float maxDiff = 0.f;
+        float maxLevel = 0.f;
+        for (size_t i = 0; i < blockOutput.size(); ++i) {
+            maxDiff = std::max(maxDiff, std::abs(blockOutput[i] - referenceOutput[i]));
+            maxLevel = std::max(maxLevel, std::abs(referenceOutput[i]));
+        }
+
+        EXPECT_GT(maxLevel, 0.f) << "block size: " << blockSize;
+        EXPECT_LE(maxDiff, 1e-5f) << "block size: " << blockSize;
+    }
+}
+
+/**
+ * @brief Audio_ReverbProcessorTests_DISABLED_Benchmark
+ * @details Compares the speed of the block and the sample-by-sample feedback loop.
+ *          Run explicitly with --gtest_also_run_disabled_tests
+ */
+TEST_F(Audio_ReverbProcessorTests, DISABLED_Benchmark)
+{
+    AudioFxParams params;
+    params.active = true;
+
+    std::vector<float> input = makeInput(44100 * 20);
+
+    auto measure = [&](bool blockProcessing) {
+        ReverbProcessor reverb(params, CHANNELS);
+        reverb.setBlockProcessingEnabled(blockProcessing);
+
+        auto start = std::chrono::steady_clock::now();
+        render(reverb, input, 512);
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    double referenceSecs = measure(false);
+    double blockSecs = measure(true);
+
+    std::cout << "reverb, 20s of audio: sample-by-sample " << referenceSecs << "s, block " << blockSecs << "s, speedup "
+              << referenceSecs / blockSecs << "x" << std::endl;
+}
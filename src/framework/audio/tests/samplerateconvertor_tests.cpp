@@ -0,0 +1,201 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "audio/internal/worker/samplerateconvertor.h"
+
+using namespace muse;
+using namespace muse::audio;
+
+class Audio_SampleRateConvertorTests : public ::testing::Test
+{
+public:
+    static constexpr unsigned int CHANNELS = 2;
+
+    static std::vector<float> makeSine(size_t frames, unsigned int sampleRate, double frequency)
+    {
+        std::vector<float> data(frames * CHANNELS);
+        for (size_t frame = 0; frame < frames; ++frame) {
+            const double value = 0.5 * std::sin(2.0 * M_PI * frequency * frame / sampleRate);
+            data[frame * CHANNELS] = static_cast<float>(value);
+            data[frame * CHANNELS + 1] = static_cast<float>(-value);
+        }
+        return data;
+    }
+
+    //! signal to noise ratio of the frames [from, to), in dB
+    static double snr(const std::vector<float>& reference, const std::vector<float>& signal, size_t from, size_t to)
+    {
+        double signalPower = 0.0;
+        double noisePower = 0.0;
+        for (size_t i = from * CHANNELS; i < to * CHANNELS; ++i) {
+            signalPower += reference[i] * reference[i];
+            noisePower += (reference[i] - signal[i]) * (reference[i] - signal[i]);
+        }
+        return 10.0 * std::log10(signalPower / noisePower);
+    }
+
+    static std::vector<float> processInBlocks(SampleRateConvertor& src, const std::vector<float>& input, size_t fromFrame,
+                                              size_t blockFrames)
+    {
+        std::vector<float> output;
+        std::vector<float> block;
+
+        const size_t frames = input.size() / CHANNELS;
+        for (size_t frame = fromFrame; frame < frames + src.latencyFrames(); frame += blockFrames) {
+            // the source is followed by silence, so the last windows are complete
+            block.assign(blockFrames * CHANNELS, 0.f);
+            for (size_t i = 0; i < blockFrames && frame + i < frames; ++i) {
+                block[i * CHANNELS] = input[(frame + i) * CHANNELS];
+                block[i * CHANNELS + 1] = input[(frame + i) * CHANNELS + 1];
+            }
+
+            std::vector<float> out(src.maxOutputFrames(blockFrames) * CHANNELS);
+            size_t outFrames = src.process(block.data(), blockFrames, out.data());
+            EXPECT_LE(outFrames, src.maxOutputFrames(blockFrames));
+
+            output.insert(output.end(), out.begin(), out.begin() + outFrames * CHANNELS);
+        }
+
+        return output;
+    }
+
+    static const std::vector<SampleRateConvertor::Quality>& qualities()
+    {
+        static const std::vector<SampleRateConvertor::Quality> q = {
+            SampleRateConvertor::Quality::Low,
+            SampleRateConvertor::Quality::Medium,
+            SampleRateConvertor::Quality::High
+        };
+        return q;
+    }
+};
+
+/**
+ * @brief Audio_SampleRateConvertorTests_SineRoundTrip
+ * @details A sine converted from 44.1 kHz to 48 kHz and back must match the original,
+ *          better for a higher quality
+ */
+TEST_F(Audio_SampleRateConvertorTests, SineRoundTrip)
+{
+    // [GIVEN] One second of a 1 kHz sine at 44.1 kHz
+    const size_t frames = 44100;
+    const std::vector<float> original = makeSine(frames, 44100, 1000.0);
+
+    const std::vector<double> minSnr = { 58.0, 78.0, 95.0 };
+
+    for (size_t q = 0; q < qualities().size(); ++q) {
+        // [WHEN] Convert it to 48 kHz and back
+        SampleRateConvertor up(original, CHANNELS, 44100, 48000, qualities()[q]);
+        const std::vector<float> upsampled = up.convert();
+
+        SampleRateConvertor down(upsampled, CHANNELS, 48000, 44100, qualities()[q]);
+        const std::vector<float> roundTrip = down.convert();
+
+        // [THEN] The length is kept
+        ASSERT_EQ(upsampled.size(), 48000 * CHANNELS);
+        ASSERT_EQ(roundTrip.size(), original.size());
+
+        // [THEN] The signal is kept, apart from the edges where the windows contain silence
+        const size_t edge = 64;
+        EXPECT_GT(snr(original, roundTrip, edge, frames - edge), minSnr[q]) << "quality: " << q;
+    }
+}
+
+/**
+ * @brief Audio_SampleRateConvertorTests_RatioAndLatency
+ * @details For every quality, the streaming convertor produces the output frames as soon as
+ *          their windows are complete, i.e. latencyFrames() input frames later, and the number
+ *          of output frames follows the ratio of the sample rates
+ */
+TEST_F(Audio_SampleRateConvertorTests, RatioAndLatency)
+{
+    const std::vector<size_t> taps = { 16, 32, 64 };
+
+    for (size_t q = 0; q < qualities().size(); ++q) {
+        // [GIVEN] 44.1 kHz to 48 kHz: L / M = 160 / 147
+        SampleRateConvertor src(CHANNELS, 44100, 48000, qualities()[q]);
+
+        // [THEN] The latency is the half of the filter
+        EXPECT_EQ(src.latencyFrames(), taps[q] / 2);
+        EXPECT_EQ(src.outputFrameCount(44100), 48000);
+
+        // [WHEN] Pass a block of input
+        const size_t inputFrames = 4410;
+        const std::vector<float> input = makeSine(inputFrames, 44100, 1000.0);
+        std::vector<float> output(src.maxOutputFrames(inputFrames) * CHANNELS);
+        const size_t outputFrames = src.process(input.data(), inputFrames, output.data());
+
+        // [THEN] The output frames up to the input frame inputFrames - latency are produced
+        const size_t expected = ((inputFrames - src.latencyFrames()) * 160 + 146) / 147;
+        EXPECT_EQ(outputFrames, expected) << "quality: " << q;
+    }
+
+    // [GIVEN] The same sample rates
+    SampleRateConvertor src(CHANNELS, 48000, 48000);
+
+    // [THEN] The input is copied without latency
+    const std::vector<float> input = makeSine(100, 48000, 1000.0);
+    std::vector<float> output(src.maxOutputFrames(100) * CHANNELS);
+    EXPECT_EQ(src.latencyFrames(), 0);
+    EXPECT_EQ(src.process(input.data(), 100, output.data()), 100);
+    EXPECT_TRUE(std::equal(input.begin(), input.end(), output.begin()));
+}
+
+/**
+ * @brief Audio_SampleRateConvertorTests_StreamingMatchesOffline
+ * @details process() in blocks of any size, also after a seek, gives the same frames as convert()
+ */
+TEST_F(Audio_SampleRateConvertorTests, StreamingMatchesOffline)
+{
+    // [GIVEN] A sine at 48 kHz and its offline conversion to 44.1 kHz
+    const size_t frames = 9600;
+    const std::vector<float> input = makeSine(frames, 48000, 440.0);
+
+    SampleRateConvertor offline(input, CHANNELS, 48000, 44100);
+    const std::vector<float> expected = offline.convert();
+
+    // [WHEN] Convert it in blocks that are not a multiple of the ratio
+    SampleRateConvertor src(CHANNELS, 48000, 44100);
+    std::vector<float> streamed = processInBlocks(src, input, 0, 333);
+
+    // [THEN] The frames are the same
+    ASSERT_GE(streamed.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_FLOAT_EQ(streamed[i], expected[i]) << "sample: " << i;
+    }
+
+    // [WHEN] Seek to an output frame and convert from there
+    const size_t outputFrame = 4321;
+    const size_t inputFrame = src.seek(outputFrame);
+    streamed = processInBlocks(src, input, inputFrame, 256);
+
+    // [THEN] The frames are the same as the offline ones from that frame
+    ASSERT_GE(streamed.size(), expected.size() - outputFrame * CHANNELS);
+    for (size_t i = outputFrame * CHANNELS; i < expected.size(); ++i) {
+        ASSERT_FLOAT_EQ(streamed[i - outputFrame * CHANNELS], expected[i]) << "sample: " << i;
+    }
+}
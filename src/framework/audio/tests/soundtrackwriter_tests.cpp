@@ -0,0 +1,239 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "global/modularity/ioc.h"
+
+#include "audio/internal/soundtracks/soundtrackwriter.h"
+
+using namespace muse;
+using namespace muse::audio;
+using namespace muse::audio::soundtrack;
+
+namespace {
+class FakeAudioEngine : public IAudioEngine
+{
+public:
+    sample_rate_t sampleRate() const override { return 44100; }
+
+    void setSampleRate(const sample_rate_t) override {}
+    void setReadBufferSize(const uint16_t) override {}
+    void setAudioChannelsCount(const audioch_t) override {}
+
+    RenderMode mode() const override { return m_mode; }
+    void setMode(const RenderMode newMode) override { m_mode = newMode; }
+    async::Notification modeChanged() const override { return async::Notification(); }
+
+    MixerPtr mixer() const override { return nullptr; }
+
+private:
+    RenderMode m_mode = RenderMode::IdleMode;
+};
+
+//! NOTE A sine, counting the frames it renders
+class SineSource : public IAudioSource
+{
+public:
+    bool isActive() const override { return m_isActive; }
+    void setIsActive(bool arg) override { m_isActive = arg; }
+
+    void setSampleRate(unsigned int sampleRate) override { m_sampleRate = sampleRate; }
+
+    unsigned int audioChannelsCount() const override { return CHANNELS; }
+    async::Channel<unsigned int> audioChannelsCountChanged() const override { return async::Channel<unsigned int>(); }
+
+    samples_t process(float* buffer, samples_t samplesPerChannel) override
+    {
+        for (samples_t i = 0; i < samplesPerChannel; ++i) {
+            const float value = 0.5f * static_cast<float>(std::sin(2.0 * M_PI * 440.0 * (renderedFrames + i) / m_sampleRate));
+            for (audioch_t ch = 0; ch < CHANNELS; ++ch) {
+                buffer[i * CHANNELS + ch] = value;
+            }
+        }
+
+        renderedFrames += samplesPerChannel;
+        return samplesPerChannel;
+    }
+
+    static constexpr audioch_t CHANNELS = 2;
+
+    size_t renderedFrames = 0;
+
+private:
+    bool m_isActive = false;
+    unsigned int m_sampleRate = 44100;
+};
+}
+
+class Audio_SoundTrackWriterTests : public ::testing::Test
+{
+public:
+    static constexpr sample_rate_t SAMPLE_RATE = 44100;
+    static constexpr samples_t RENDER_STEP = 512;
+
+    void SetUp() override
+    {
+        m_engine = std::make_shared<FakeAudioEngine>();
+        modularity::globalIoc()->unregister<IAudioEngine>("utests");
+        modularity::globalIoc()->registerExport<IAudioEngine>("utests", m_engine);
+    }
+
+    void TearDown() override
+    {
+        modularity::globalIoc()->unregister<IAudioEngine>("utests");
+    }
+
+    static SoundTrackFormat format(SoundTrackType type)
+    {
+        SoundTrackFormat format;
+        format.type = type;
+        format.sampleRate = SAMPLE_RATE;
+        format.samplesPerChannel = RENDER_STEP;
+        format.audioChannelsNumber = SineSource::CHANNELS;
+        format.bitRate = 128;
+        return format;
+    }
+
+    //! NOTE Writes the given duration of the sine, returns the frames rendered by the source
+    static size_t write(const io::path_t& path, SoundTrackType type, msecs_t duration)
+    {
+        auto source = std::make_shared<SineSource>();
+
+        {
+            SoundTrackWriter writer(path, format(type), duration, source, nullptr);
+            EXPECT_TRUE(writer.write());
+        }
+
+        return source->renderedFrames;
+    }
+
+    static std::vector<uint8_t> readFile(const io::path_t& path)
+    {
+        std::ifstream stream(path.toStdString(), std::ios_base::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    //! NOTE The number of the MPEG-1 Layer III frames with audio, i.e. without the Xing/Info frame written by LAME
+    static size_t mp3AudioFrameCount(const std::vector<uint8_t>& data)
+    {
+        static const int BITRATES[] = { 0, 32, 40, 48, 56, 64, 80, 96, 112, 128, 160, 192, 224, 256, 320, 0 };
+        static const int SAMPLE_RATES[] = { 44100, 48000, 32000, 0 };
+
+        size_t frames = 0;
+        size_t pos = 0;
+        while (pos + 4 <= data.size()) {
+            const uint8_t* header = data.data() + pos;
+            if (header[0] != 0xFF || (header[1] & 0xFE) != 0xFA) {
+                ADD_FAILURE() << "no frame header at: " << pos;
+                return frames;
+            }
+
+            const int bitRate = BITRATES[header[2] >> 4];
+            const int sampleRate = SAMPLE_RATES[(header[2] >> 2) & 0x03];
+            const int padding = (header[2] >> 1) & 0x01;
+            const size_t frameSize = 144 * bitRate * 1000 / sampleRate + padding;
+            if (frameSize == 0) {
+                ADD_FAILURE() << "invalid frame header at: " << pos;
+                return frames;
+            }
+
+            // the side information of a stereo frame is 32 bytes long
+            const bool isTagFrame = pos + 40 <= data.size()
+                                    && (std::memcmp(header + 36, "Xing", 4) == 0 || std::memcmp(header + 36, "Info", 4) == 0);
+            if (!isTagFrame) {
+                ++frames;
+            }
+
+            pos += frameSize;
+        }
+
+        return frames;
+    }
+
+private:
+    std::shared_ptr<FakeAudioEngine> m_engine;
+};
+
+/**
+ * @brief Audio_SoundTrackWriterTests_WavLengthMatchesRenderedLength
+ * @details An encoder without streaming support gets the whole duration, and only that is rendered
+ */
+TEST_F(Audio_SoundTrackWriterTests, WavLengthMatchesRenderedLength)
+{
+    // [GIVEN] Two seconds of a sine
+    const io::path_t path = "soundtrackwriter_tests.wav";
+    const size_t frames = 2 * SAMPLE_RATE;
+
+    // [WHEN] Export it to WAV
+    const size_t renderedFrames = write(path, SoundTrackType::WAV, 2000000);
+
+    // [THEN] The file contains the duration
+    const std::vector<uint8_t> data = readFile(path);
+    std::remove(path.c_str());
+
+    const size_t headerSize = 46;
+    ASSERT_GE(data.size(), headerSize);
+
+    uint32_t dataSize = 0;
+    std::memcpy(&dataSize, data.data() + headerSize - sizeof(dataSize), sizeof(dataSize));
+    EXPECT_EQ(dataSize, frames * SineSource::CHANNELS * sizeof(float));
+    EXPECT_EQ(data.size(), headerSize + dataSize);
+
+    // [THEN] Only the encoded frames are rendered, up to the end of the last render step
+    EXPECT_GE(renderedFrames, frames);
+    EXPECT_LT(renderedFrames, frames + RENDER_STEP);
+}
+
+/**
+ * @brief Audio_SoundTrackWriterTests_Mp3LengthMatchesRenderedLength
+ * @details A streaming encoder is fed while rendering, it must get the whole duration, and only that is rendered
+ */
+TEST_F(Audio_SoundTrackWriterTests, Mp3LengthMatchesRenderedLength)
+{
+    // [GIVEN] Two seconds of a sine
+    const io::path_t path = "soundtrackwriter_tests.mp3";
+    const size_t frames = 2 * SAMPLE_RATE;
+
+    // [WHEN] Export it to MP3
+    const size_t renderedFrames = write(path, SoundTrackType::MP3, 2000000);
+
+    // [THEN] The file contains the duration, with the delay (at least half of an MP3 frame)
+    //        and the padding of the encoder, which are less than three MP3 frames
+    const std::vector<uint8_t> data = readFile(path);
+    std::remove(path.c_str());
+
+    const size_t MP3_FRAME = 1152;
+    const size_t mp3Frames = mp3AudioFrameCount(data);
+    EXPECT_GE(mp3Frames * MP3_FRAME, frames + MP3_FRAME / 2);
+    EXPECT_LT(mp3Frames * MP3_FRAME, frames + 3 * MP3_FRAME);
+
+    // [THEN] Only the encoded frames are rendered, up to the end of the last render step
+    EXPECT_GE(renderedFrames, frames);
+    EXPECT_LT(renderedFrames, frames + RENDER_STEP);
+}
@@ -32,6 +32,7 @@
 #include "internal/diagnosticsactions.h"
 #include "internal/diagnosticsactionscontroller.h"
 #include "internal/diagnosticspathsregister.h"
+#include "internal/diagnosticsmetricsregister.h"
 #include "internal/savediagnosticfilesscenario.h"
 
 #include "internal/crashhandler/crashhandler.h"
@@ -76,6 +77,7 @@ void DiagnosticsModule::registerExports()
     m_actionsController = std::make_shared<DiagnosticsActionsController>(iocContext());
 
     ioc()->registerExport<IDiagnosticsPathsRegister>(moduleName(), new DiagnosticsPathsRegister());
+    ioc()->registerExport<IDiagnosticsMetricsRegister>(moduleName(), new DiagnosticsMetricsRegister());
     ioc()->registerExport<IDiagnosticsConfiguration>(moduleName(), m_configuration);
     ioc()->registerExport<ISaveDiagnosticFilesScenario>(moduleName(), new SaveDiagnosticFilesScenario(iocContext()));
 }
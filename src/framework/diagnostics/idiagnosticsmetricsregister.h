@@ -0,0 +1,54 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MUSE_DIAGNOSTICS_IDIAGNOSTICSMETRICSREGISTER_H
+#define MUSE_DIAGNOSTICS_IDIAGNOSTICSMETRICSREGISTER_H
+
+#include <string>
+#include <vector>
+
+#include "modularity/imoduleinterface.h"
+
+namespace muse::diagnostics {
+//! NOTE Measurements that the modules publish to be seen in the diagnostics (ex. the time of an operation)
+class IDiagnosticsMetricsRegister : MODULE_EXPORT_INTERFACE
+{
+    INTERFACE_ID(IDiagnosticsMetricsRegister)
+public:
+    virtual ~IDiagnosticsMetricsRegister() = default;
+
+    struct Item
+    {
+        std::string name;
+        std::string unit;
+        double last = 0.0;
+        double max = 0.0;
+        double sum = 0.0;
+        size_t count = 0;
+    };
+
+    virtual void reg(const std::string& name, double value, const std::string& unit) = 0;
+    virtual std::vector<Item> items() const = 0;
+    virtual void clear() = 0;
+};
+}
+
+#endif // MUSE_DIAGNOSTICS_IDIAGNOSTICSMETRICSREGISTER_H
@@ -0,0 +1,59 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "diagnosticsmetricsregister.h"
+
+#include <algorithm>
+
+using namespace muse::diagnostics;
+
+void DiagnosticsMetricsRegister::reg(const std::string& name, double value, const std::string& unit)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = std::find_if(m_items.begin(), m_items.end(), [&name](const Item& item) {
+        return item.name == name;
+    });
+
+    if (it == m_items.end()) {
+        Item item;
+        item.name = name;
+        item.unit = unit;
+        it = m_items.insert(m_items.end(), std::move(item));
+    }
+
+    it->last = value;
+    it->max = it->count == 0 ? value : std::max(it->max, value);
+    it->sum += value;
+    it->count += 1;
+}
+
+std::vector<IDiagnosticsMetricsRegister::Item> DiagnosticsMetricsRegister::items() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_items;
+}
+
+void DiagnosticsMetricsRegister::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_items.clear();
+}
@@ -29,7 +29,7 @@ using namespace muse::diagnostics;
 using namespace muse::profiler;
 
 ProfilerViewModel::ProfilerViewModel(QObject* parent)
-    : QAbstractListModel(parent)
+    : QAbstractListModel(parent), Injectable(muse::iocCtxForQmlObject(this))
 {
 }
 
@@ -90,6 +90,22 @@ void ProfilerViewModel::reload()
         m_allList.append(item);
     }
 
+    //! NOTE The metrics are published by the modules, also when the profiler is disabled
+    group = "Metrics";
+    for (const IDiagnosticsMetricsRegister::Item& metric : metricsRegister()->items()) {
+        Item item;
+        item.group = group;
+        item.data = QString("%1: last: %2 %5, max: %3 %5, avg: %4 %5, count: %6")
+                    .arg(QString::fromStdString(metric.name))
+                    .arg(metric.last, 0, 'f', 1)
+                    .arg(metric.max, 0, 'f', 1)
+                    .arg(metric.sum / metric.count, 0, 'f', 1)
+                    .arg(QString::fromStdString(metric.unit))
+                    .arg(metric.count);
+
+        m_allList.append(item);
+    }
+
     find(m_searchText);
 }
 
@@ -116,6 +132,7 @@ void ProfilerViewModel::find(const QString& str)
 void ProfilerViewModel::clear()
 {
     PROFILER_CLEAR;
+    metricsRegister()->clear();
     reload();
 }
 
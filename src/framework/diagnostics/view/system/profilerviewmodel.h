@@ -24,10 +24,16 @@
 
 #include <QAbstractListModel>
 
+#include "modularity/ioc.h"
+#include "idiagnosticsmetricsregister.h"
+
 namespace muse::diagnostics {
-class ProfilerViewModel : public QAbstractListModel
+class ProfilerViewModel : public QAbstractListModel, public Injectable
 {
     Q_OBJECT
+
+    Inject<IDiagnosticsMetricsRegister> metricsRegister = { this };
+
 public:
     explicit ProfilerViewModel(QObject* parent = 0);
 
@@ -42,6 +42,12 @@ static const double DEFAULT_PIXEL_SIZE = 100.0;
 static const double SYMBOLS_PIXEL_SIZE = 200.0;
 static const double LOADED_PIXEL_SIZE = 200.0;
 
+static constexpr size_t SHAPED_TEXT_CACHE_CAPACITY = 10000;
+
+//! NOTE SMuFL symbols are in the Private Use Area
+static constexpr char32_t SMUFL_FIRST_CODE = 0xE000;
+static constexpr char32_t SMUFL_LAST_CODE = 0xF8FF;
+
 static inline RectF fromFBBox(const FBBox& bb, double scale)
 {
     return RectF(from_f26d6(bb.left()) * scale, from_f26d6(bb.top()) * scale,
@@ -59,6 +65,28 @@ static const IFontFace* findSubtitutionFont(char32_t ch, const std::vector<IFont
     return founded;
 }
 
+size_t FontsEngine::RequireFaceKeyHash::operator()(const RequireFaceKey& k) const
+{
+    //! NOTE The family comparison is case insensitive, so is the hash
+    const String& family = k.faceKey.dataKey.family().id();
+    size_t h = 0;
+    for (size_t i = 0; i < family.size(); ++i) {
+        h = h * 31 + Char::toLower(family.at(i).unicode());
+    }
+
+    h = h * 31 + static_cast<size_t>(k.faceKey.type);
+    h = h * 31 + static_cast<size_t>(k.faceKey.pixelSize);
+    h = h * 31 + (k.faceKey.dataKey.bold() ? 1 : 0);
+    h = h * 31 + (k.faceKey.dataKey.italic() ? 1 : 0);
+    h = h * 31 + (k.isSymbolMode ? 1 : 0);
+    return h;
+}
+
+size_t FontsEngine::ShapedTextKeyHash::operator()(const ShapedTextKey& k) const
+{
+    return std::hash<std::u32string_view> {}(k.text) ^ (std::hash<const IFontFace*> {}(k.face) << 1);
+}
+
 bool FontsEngine::RequireFace::isSymbolMode() const
 {
     return face ? face->isSymbolMode() : false;
@@ -75,8 +103,8 @@ double FontsEngine::RequireFace::pixelScale() const
 
 FontsEngine::~FontsEngine()
 {
-    for (RequireFace* f : m_requiredFaces) {
-        delete f;
+    for (auto& p : m_requiredFaces) {
+        delete p.second;
     }
 
     for (IFontFace* f : m_loadedFaces) {
@@ -181,7 +209,7 @@ double FontsEngine::horizontalAdvance(const Font& f, const std::u32string& text)
         return 0.0;
     }
 
-    std::vector<GlyphPos> glyphs = rf->face->glyphs(&text[0], (int)text.size());
+    const std::vector<GlyphPos>& glyphs = shapedGlyphs(rf->face, &text[0], (int)text.size());
     f26dot6_t advance = 0;
     for (const GlyphPos& g : glyphs) {
         advance += g.x_advance;
@@ -234,7 +262,7 @@ RectF FontsEngine::boundingRect(const Font& f, const std::u32string& text) const
                 continue;
             }
 
-            std::vector<GlyphPos> glyphs = fontFace->glyphs(ffBlock.text, ffBlock.lenght);
+            const std::vector<GlyphPos>& glyphs = shapedGlyphs(fontFace, ffBlock.text, ffBlock.lenght);
 
             for (const GlyphPos& g : glyphs) {
                 FBBox bbox = rf->face->glyphBbox(g.idx);
@@ -298,7 +326,7 @@ RectF FontsEngine::tightBoundingRect(const Font& f, const std::u32string& text)
                 continue;
             }
 
-            std::vector<GlyphPos> glyphs = fontFace->glyphs(ffBlock.text, ffBlock.lenght);
+            const std::vector<GlyphPos>& glyphs = shapedGlyphs(fontFace, ffBlock.text, ffBlock.lenght);
 
             for (const GlyphPos& g : glyphs) {
                 FBBox bbox = rf->face->glyphBbox(g.idx);
@@ -338,9 +366,7 @@ RectF FontsEngine::symBBox(const Font& f, char32_t ucs4) const
         return RectF();
     }
 
-    glyph_idx_t glyphIdx = rf->face->glyphIndex(ucs4);
-    FBBox bb = rf->face->glyphBbox(glyphIdx);
-    return fromFBBox(bb, rf->pixelScale());
+    return fromFBBox(symbolMetrics(rf, ucs4).bbox, rf->pixelScale());
 }
 
 double FontsEngine::symAdvance(const Font& f, char32_t ucs4) const
@@ -350,9 +376,38 @@ double FontsEngine::symAdvance(const Font& f, char32_t ucs4) const
         return 0.0;
     }
 
-    glyph_idx_t glyphIdx = rf->face->glyphIndex(ucs4);
-    f26dot6_t advance = rf->face->glyphAdvance(glyphIdx);
-    return from_f26d6(advance) * rf->pixelScale();
+    return from_f26d6(symbolMetrics(rf, ucs4).advance) * rf->pixelScale();
+}
+
+FontsEngine::SymbolMetrics FontsEngine::symbolMetrics(RequireFace* rf, char32_t ucs4) const
+{
+    auto metrics = [rf](char32_t ucs4) {
+        glyph_idx_t glyphIdx = rf->face->glyphIndex(ucs4);
+
+        SymbolMetrics sm;
+        sm.bbox = rf->face->glyphBbox(glyphIdx);
+        sm.advance = rf->face->glyphAdvance(glyphIdx);
+        sm.valid = true;
+        return sm;
+    };
+
+    if (ucs4 < SMUFL_FIRST_CODE || ucs4 > SMUFL_LAST_CODE) {
+        return metrics(ucs4);
+    }
+
+    if (rf->symbolMetrics.empty()) {
+        rf->symbolMetrics.resize(SMUFL_LAST_CODE - SMUFL_FIRST_CODE + 1);
+    }
+
+    SymbolMetrics& sm = rf->symbolMetrics[ucs4 - SMUFL_FIRST_CODE];
+    if (sm.valid) {
+        ++m_cacheStats.symbolMetricsHits;
+        return sm;
+    }
+
+    ++m_cacheStats.symbolMetricsMisses;
+    sm = metrics(ucs4);
+    return sm;
 }
 
 #ifndef MUSE_MODULE_DRAW_USE_QTTEXTDRAW
@@ -423,6 +478,42 @@ static void generateSdf(GlyphImage& out, glyph_idx_t glyphIdx, const IFontFace*
 
 #endif
 
+const std::vector<GlyphPos>& FontsEngine::shapedGlyphs(const IFontFace* face, const char32_t* text, int length) const
+{
+    auto it = m_shapedTextsIndex.find(ShapedTextKey { face, std::u32string_view(text, length) });
+    if (it != m_shapedTextsIndex.end()) {
+        ++m_cacheStats.shapedTextHits;
+        m_shapedTexts.splice(m_shapedTexts.begin(), m_shapedTexts, it->second);
+        return it->second->glyphs;
+    }
+
+    ++m_cacheStats.shapedTextMisses;
+
+    if (m_shapedTexts.size() >= SHAPED_TEXT_CACHE_CAPACITY) {
+        const ShapedText& last = m_shapedTexts.back();
+        m_shapedTextsIndex.erase(ShapedTextKey { last.face, last.text });
+        m_shapedTexts.pop_back();
+    }
+
+    ShapedText& shaped = m_shapedTexts.emplace_front();
+    shaped.face = face;
+    shaped.text = std::u32string(text, length);
+    shaped.glyphs = face->glyphs(text, length);
+    m_shapedTextsIndex.emplace(ShapedTextKey { face, shaped.text }, m_shapedTexts.begin());
+
+    return shaped.glyphs;
+}
+
+FontsCacheStats FontsEngine::cacheStats() const
+{
+    return m_cacheStats;
+}
+
+void FontsEngine::resetCacheStats()
+{
+    m_cacheStats = FontsCacheStats();
+}
+
 std::vector<GlyphImage> FontsEngine::render(const Font& f, const std::u32string& text) const
 {
     //! NOTE for rendering, all fonts, including symbols fonts, are processed as text
@@ -460,7 +551,7 @@ std::vector<GlyphImage> FontsEngine::render(const Font& f, const std::u32string&
                 continue;
             }
 
-            std::vector<GlyphPos> glyphs = fontFace->glyphs(ffBlock.text, ffBlock.lenght);
+            const std::vector<GlyphPos>& glyphs = shapedGlyphs(fontFace, ffBlock.text, ffBlock.lenght);
 
             for (const GlyphPos& g : glyphs) {
                 if (NOT_RENDER_GLYPHS.find(g.idx) == NOT_RENDER_GLYPHS.end()) {
@@ -531,10 +622,10 @@ FontsEngine::RequireFace* FontsEngine::fontFace(const Font& f, bool isSymbolMode
     }
 
     //! NOTE We are looking for the require font we need among the previously loaded ones
-    for (RequireFace* face : m_requiredFaces) {
-        if (face->requireKey == requireKey && face->isSymbolMode() == isSymbolMode) {
-            return face;
-        }
+    RequireFaceKey key { requireKey, isSymbolMode };
+    auto it = m_requiredFaces.find(key);
+    if (it != m_requiredFaces.end()) {
+        return it->second;
     }
 
     //! If we didn't find it, we create a new require font
@@ -604,7 +695,7 @@ FontsEngine::RequireFace* FontsEngine::fontFace(const Font& f, bool isSymbolMode
         newFont->subtitutionFaces.push_back(subtitutionFace);
     }
 
-    m_requiredFaces.push_back(newFont);
+    m_requiredFaces.emplace(key, newFont);
 
     return newFont;
 }
@@ -22,17 +22,20 @@
 #pragma once
 
 #include <vector>
+#include <list>
+#include <string_view>
+#include <unordered_map>
 #include <functional>
 
 #include "ifontsengine.h"
 
 #include "global/modularity/ioc.h"
 #include "ifontsdatabase.h"
+#include "ifontface.h"
 
 //#include "fontrendercache.h"
 
 namespace muse::draw {
-class IFontFace;
 class FontsEngine : public IFontsEngine, public Injectable
 {
     Inject<IFontsDatabase> fontsDatabase = { this };
@@ -67,6 +70,10 @@ public:
     // For draw
     std::vector<GlyphImage> render(const Font& f, const std::u32string& text) const override;
 
+    // Profiling
+    FontsCacheStats cacheStats() const override;
+    void resetCacheStats() override;
+
     // For dev
     using FontFaceFactory = std::function<IFontFace* (const io::path_t&)>;
     void setFontFaceFactory(const FontFaceFactory& f);
@@ -78,25 +85,76 @@ private:
         int lenght = 0;
     };
 
+    struct SymbolMetrics {
+        FBBox bbox;
+        f26dot6_t advance = 0;
+        bool valid = false;
+    };
+
     struct RequireFace {
         IFontFace* face = nullptr;   // real loaded face
         std::vector<IFontFace*> subtitutionFaces;
         FaceKey requireKey;          // require face
 
+        //! NOTE Metrics of the SMuFL symbols (Private Use Area), indexed by code point
+        std::vector<SymbolMetrics> symbolMetrics;
+
         bool isSymbolMode() const;
         double pixelScale() const;
     };
 
+    struct RequireFaceKey {
+        FaceKey faceKey;
+        bool isSymbolMode = false;
+
+        inline bool operator==(const RequireFaceKey& o) const
+        {
+            return isSymbolMode == o.isSymbolMode && faceKey == o.faceKey;
+        }
+    };
+
+    struct RequireFaceKeyHash {
+        size_t operator()(const RequireFaceKey& k) const;
+    };
+
+    //! NOTE The text is a view into the cached entry, so lookups don't need to copy the text
+    struct ShapedTextKey {
+        const IFontFace* face = nullptr;
+        std::u32string_view text;
+
+        inline bool operator==(const ShapedTextKey& o) const { return face == o.face && text == o.text; }
+    };
+
+    struct ShapedTextKeyHash {
+        size_t operator()(const ShapedTextKey& k) const;
+    };
+
+    struct ShapedText {
+        const IFontFace* face = nullptr;
+        std::u32string text;
+        std::vector<GlyphPos> glyphs;
+    };
+
     IFontFace* createFontFace(const io::path_t& path) const;
     RequireFace* fontFace(const Font& f, bool isSymbolMode = false) const;
 
+    //! NOTE The returned glyphs are valid until the next call
+    const std::vector<GlyphPos>& shapedGlyphs(const IFontFace* face, const char32_t* text, int length) const;
+    SymbolMetrics symbolMetrics(RequireFace* rf, char32_t ucs4) const;
+
     std::vector<TextBlock> splitTextByLines(const std::u32string& text) const;
     std::vector<TextBlock> splitTextByFontFaces(const RequireFace* rf, const TextBlock& text) const;
 
     FontFaceFactory m_fontFaceFactory;
 
     mutable std::vector<IFontFace*> m_loadedFaces;
-    mutable std::vector<RequireFace*> m_requiredFaces;
+    mutable std::unordered_map<RequireFaceKey, RequireFace*, RequireFaceKeyHash> m_requiredFaces;
+
+    //! NOTE LRU cache of shaped text runs, the most recently used at the front
+    mutable std::list<ShapedText> m_shapedTexts;
+    mutable std::unordered_map<ShapedTextKey, std::list<ShapedText>::iterator, ShapedTextKeyHash> m_shapedTextsIndex;
+
+    mutable FontsCacheStats m_cacheStats;
 
     //mutable FontRenderCache m_renderCache;
 };
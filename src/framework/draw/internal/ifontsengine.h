@@ -57,5 +57,9 @@ public:
 
     // Draw
     virtual std::vector<GlyphImage> render(const Font& f, const std::u32string& text) const = 0;
+
+    // Profiling
+    virtual FontsCacheStats cacheStats() const = 0;
+    virtual void resetCacheStats() = 0;
 };
 }
@@ -0,0 +1,299 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+
+#include "draw/internal/fontsengine.h"
+
+using namespace muse;
+using namespace muse::draw;
+
+namespace muse::draw {
+//! NOTE Counts the calls of the fonts engine, to see what it takes from its caches
+struct FontsCalls {
+    int actualFont = 0;
+    int glyphs = 0;
+    int glyphBbox = 0;
+};
+
+class FontsDatabaseStub : public IFontsDatabase
+{
+public:
+    FontsDatabaseStub(FontsCalls* calls)
+        : m_calls(calls) {}
+
+    void setDefaultFont(Font::Type, const FontDataKey&) override {}
+    void insertSubstitution(const String&, const String&) override {}
+    int addFont(const FontDataKey&, const io::path_t&) override { return 0; }
+
+    FontDataKey actualFont(const FontDataKey& requireKey, Font::Type) const override
+    {
+        ++m_calls->actualFont;
+        return requireKey;
+    }
+
+    std::vector<FontDataKey> substitutionFonts(Font::Type) const override { return {}; }
+    FontData fontData(const FontDataKey&, Font::Type) const override { return FontData(); }
+    io::path_t fontPath(const FontDataKey& requireKey, Font::Type) const override { return String(u"/fonts/") + requireKey.family().id(); }
+
+    void addAdditionalFonts(const io::path_t&) override {}
+
+private:
+    FontsCalls* m_calls = nullptr;
+};
+
+class FontFaceStub : public IFontFace
+{
+public:
+    FontFaceStub(FontsCalls* calls)
+        : m_calls(calls) {}
+
+    bool load(const FaceKey& key, const io::path_t&, bool isSymbolMode) override
+    {
+        m_key = key;
+        m_isSymbolMode = isSymbolMode;
+        return true;
+    }
+
+    const FaceKey& key() const override { return m_key; }
+    bool isSymbolMode() const override { return m_isSymbolMode; }
+
+    f26dot6_t leading() const override { return 0; }
+    f26dot6_t ascent() const override { return 64; }
+    f26dot6_t descent() const override { return 0; }
+    f26dot6_t xHeight() const override { return 32; }
+    f26dot6_t capHeight() const override { return 64; }
+
+    std::vector<GlyphPos> glyphs(const char32_t* text, int text_length) const override
+    {
+        ++m_calls->glyphs;
+
+        std::vector<GlyphPos> result;
+        for (int i = 0; i < text_length; ++i) {
+            result.push_back(GlyphPos { static_cast<glyph_idx_t>(text[i]), 64 });
+        }
+        return result;
+    }
+
+    glyph_idx_t glyphIndex(char32_t ucs4) const override { return static_cast<glyph_idx_t>(ucs4); }
+    glyph_idx_t glyphIndex(const std::string&) const override { return 0; }
+    char32_t findCharCode(glyph_idx_t idx) const override { return static_cast<char32_t>(idx); }
+
+    FBBox glyphBbox(glyph_idx_t) const override
+    {
+        ++m_calls->glyphBbox;
+        return FBBox(0, -64, 64, 64);
+    }
+
+    f26dot6_t glyphAdvance(glyph_idx_t) const override { return 64; }
+
+#ifndef MUSE_MODULE_DRAW_USE_QTTEXTDRAW
+    const msdfgen::Shape& glyphShape(glyph_idx_t) const override { return m_shape; }
+#endif
+
+private:
+    FontsCalls* m_calls = nullptr;
+    FaceKey m_key;
+    bool m_isSymbolMode = false;
+#ifndef MUSE_MODULE_DRAW_USE_QTTEXTDRAW
+    msdfgen::Shape m_shape;
+#endif
+};
+}
+
+class Draw_FontsEngineTests : public ::testing::Test
+{
+public:
+    //! NOTE Must match the capacity of the shaped text cache in fontsengine.cpp
+    static constexpr size_t SHAPED_TEXT_CACHE_CAPACITY = 10000;
+
+    void SetUp() override
+    {
+        m_calls = FontsCalls();
+
+        m_fontsDatabase = std::make_shared<FontsDatabaseStub>(&m_calls);
+        modularity::globalIoc()->unregister<IFontsDatabase>("utests");
+        modularity::globalIoc()->registerExport<IFontsDatabase>("utests", m_fontsDatabase);
+
+        m_engine = std::make_unique<FontsEngine>(modularity::ContextPtr());
+        m_engine->setFontFaceFactory([this](const io::path_t&) {
+            return new FontFaceStub(&m_calls);
+        });
+    }
+
+    void TearDown() override
+    {
+        m_engine.reset();
+        modularity::globalIoc()->unregister<IFontsDatabase>("utests");
+    }
+
+    static Font font(const String& family, int pixelSize = 20)
+    {
+        Font f(family, Font::Type::Text);
+        f.setPixelSize(pixelSize);
+        return f;
+    }
+
+    static std::u32string text(size_t n)
+    {
+        return U"text " + std::u32string(1, U'a' + static_cast<char32_t>(n % 26)) + std::u32string(n / 26 + 1, U'x');
+    }
+
+    FontsCalls m_calls;
+    std::shared_ptr<FontsDatabaseStub> m_fontsDatabase;
+    std::unique_ptr<FontsEngine> m_engine;
+};
+
+TEST_F(Draw_FontsEngineTests, ShapedText_HitsAndMisses)
+{
+    Font f = font(u"Edwin");
+
+    //! DO Measure the same text twice
+    double advance1 = m_engine->horizontalAdvance(f, U"abc");
+    double advance2 = m_engine->horizontalAdvance(f, U"abc");
+
+    //! CHECK The text is shaped once, the second time it comes from the cache
+    EXPECT_DOUBLE_EQ(advance1, advance2);
+    EXPECT_EQ(m_calls.glyphs, 1);
+
+    FontsCacheStats stats = m_engine->cacheStats();
+    EXPECT_EQ(stats.shapedTextMisses, 1);
+    EXPECT_EQ(stats.shapedTextHits, 1);
+
+    //! DO Measure another text
+    m_engine->horizontalAdvance(f, U"abd");
+
+    //! CHECK
+    stats = m_engine->cacheStats();
+    EXPECT_EQ(stats.shapedTextMisses, 2);
+    EXPECT_EQ(stats.shapedTextHits, 1);
+
+    //! DO Reset the counters
+    m_engine->resetCacheStats();
+
+    //! CHECK The counters are reset, the cache is kept
+    stats = m_engine->cacheStats();
+    EXPECT_EQ(stats.shapedTextMisses, 0);
+    EXPECT_EQ(stats.shapedTextHits, 0);
+
+    m_engine->horizontalAdvance(f, U"abc");
+    EXPECT_EQ(m_engine->cacheStats().shapedTextHits, 1);
+    EXPECT_EQ(m_calls.glyphs, 2);
+}
+
+TEST_F(Draw_FontsEngineTests, ShapedText_EvictsLeastRecentlyUsed)
+{
+    Font f = font(u"Edwin");
+
+    //! GIVEN The cache is full
+    for (size_t i = 0; i < SHAPED_TEXT_CACHE_CAPACITY; ++i) {
+        m_engine->horizontalAdvance(f, text(i));
+    }
+    EXPECT_EQ(m_engine->cacheStats().shapedTextMisses, SHAPED_TEXT_CACHE_CAPACITY);
+
+    //! DO Use the oldest text again, so the second one becomes the least recently used
+    m_engine->horizontalAdvance(f, text(0));
+    EXPECT_EQ(m_engine->cacheStats().shapedTextHits, 1);
+
+    //! DO Add one more text
+    m_engine->horizontalAdvance(f, text(SHAPED_TEXT_CACHE_CAPACITY));
+
+    //! CHECK The recently used text is kept
+    m_engine->resetCacheStats();
+    m_engine->horizontalAdvance(f, text(0));
+    EXPECT_EQ(m_engine->cacheStats().shapedTextHits, 1);
+    EXPECT_EQ(m_engine->cacheStats().shapedTextMisses, 0);
+
+    //! CHECK The least recently used text is evicted, the next one is kept
+    m_engine->resetCacheStats();
+    m_engine->horizontalAdvance(f, text(2));
+    m_engine->horizontalAdvance(f, text(1));
+    EXPECT_EQ(m_engine->cacheStats().shapedTextHits, 1);
+    EXPECT_EQ(m_engine->cacheStats().shapedTextMisses, 1);
+}
+
+TEST_F(Draw_FontsEngineTests, RequireFace_FamilyIsCaseInsensitive)
+{
+    //! DO Use the same family, spelled differently
+    m_engine->lineSpacing(font(u"Edwin"));
+    m_engine->lineSpacing(font(u"EDWIN"));
+    m_engine->lineSpacing(font(u"edwin"));
+
+    //! CHECK The same require face is found by the hash and the comparison
+    EXPECT_EQ(m_calls.actualFont, 1);
+
+    //! DO The same family with another size
+    m_engine->lineSpacing(font(u"edwin", 30));
+
+    //! CHECK It is another require face
+    EXPECT_EQ(m_calls.actualFont, 2);
+}
+
+TEST_F(Draw_FontsEngineTests, RequireFace_SymbolModeIsPartOfTheKey)
+{
+    //! DO Use a font as text, then as symbols
+    m_engine->lineSpacing(font(u"Leland"));
+    m_engine->symBBox(font(u"Leland"), 0xE050);
+
+    //! CHECK Symbol mode gets its own require face
+    EXPECT_EQ(m_calls.actualFont, 2);
+
+    //! DO Use it as symbols again, whatever the size and the case of the family
+    m_engine->symBBox(font(u"LELAND", 40), 0xE050);
+    m_engine->symAdvance(font(u"leland"), 0xE050);
+
+    //! CHECK The symbol mode face is found again
+    EXPECT_EQ(m_calls.actualFont, 2);
+}
+
+TEST_F(Draw_FontsEngineTests, SymbolMetrics_HitsAndMisses)
+{
+    Font f = font(u"Leland");
+
+    //! DO Get the metrics of a SMuFL symbol twice
+    RectF bbox1 = m_engine->symBBox(f, 0xE050);
+    RectF bbox2 = m_engine->symBBox(f, 0xE050);
+
+    //! CHECK The glyph is measured once
+    EXPECT_EQ(bbox1, bbox2);
+    EXPECT_EQ(m_calls.glyphBbox, 1);
+
+    FontsCacheStats stats = m_engine->cacheStats();
+    EXPECT_EQ(stats.symbolMetricsMisses, 1);
+    EXPECT_EQ(stats.symbolMetricsHits, 1);
+
+    //! DO The advance of the same symbol comes from the same entry
+    m_engine->symAdvance(f, 0xE050);
+    EXPECT_EQ(m_engine->cacheStats().symbolMetricsHits, 2);
+
+    //! DO Characters outside of the Private Use Area are not cached
+    m_engine->symBBox(f, U'a');
+    m_engine->symBBox(f, U'a');
+
+    //! CHECK
+    stats = m_engine->cacheStats();
+    EXPECT_EQ(stats.symbolMetricsMisses, 1);
+    EXPECT_EQ(stats.symbolMetricsHits, 2);
+    EXPECT_EQ(m_calls.glyphBbox, 3);
+}
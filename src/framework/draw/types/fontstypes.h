@@ -143,6 +143,14 @@ struct GlyphImage {
     bool isNull() const { return rect.isNull(); }
 };
 
+//! NOTE Hit/miss counters of the fonts engine caches, for profiling
+struct FontsCacheStats {
+    size_t shapedTextHits = 0;
+    size_t shapedTextMisses = 0;
+    size_t symbolMetricsHits = 0;
+    size_t symbolMetricsMisses = 0;
+};
+
 struct FontParams {
     std::string name;
     Font::Type type = Font::Type::Undefined;
@@ -32,6 +32,10 @@ public:
     DrawDataPaint() = default;
 
     static void paint(Painter* painter, const DrawDataPtr& data, const Color& overlay = Color());
+
+    //! NOTE Draws the data in the current coordinates of the painter,
+    //! the transforms of the data are applied on top of them
+    static void replay(Painter* painter, const DrawDataPtr& data);
 };
 }
 
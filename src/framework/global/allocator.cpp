@@ -22,24 +22,103 @@
 #include "allocator.h"
 
 #include <algorithm>
+#include <cstddef>
 #include <cstdlib>
 #include <iostream>
+#include <new>
 #include <set>
 #include <sstream>
 
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
 #include "stringutils.h"
 #include "log.h"
 
 using namespace muse;
 
+static constexpr size_t BLOCK_HEADER_SIZE = sizeof(std::max_align_t);
+
 int ObjectAllocator::s_used = 0;
-size_t ObjectAllocator::DEFAULT_BLOCK_SIZE(1024 * 256); // 256 kB
+size_t ObjectAllocator::DEFAULT_BLOCK_SIZE(1024 * 256 - BLOCK_HEADER_SIZE); // 256 kB with the block header
 
 static inline size_t align(size_t n)
 {
     return (n + sizeof(intptr_t) - 1) & ~(sizeof(intptr_t) - 1);
 }
 
+static size_t nextPowerOfTwo(size_t n)
+{
+    size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+//! NOTE Allocates a block of the given size, aligned to it
+static void* allocateAligned(size_t size)
+{
+#ifdef _WIN32
+    return _aligned_malloc(size, size);
+#else
+    void* ptr = nullptr;
+    return posix_memalign(&ptr, size, size) == 0 ? ptr : nullptr;
+#endif
+}
+
+static void freeAligned(void* ptr)
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+// ============================================
+// AllocatorArena
+// ============================================
+thread_local AllocatorArena* AllocatorArena::s_current = nullptr;
+
+AllocatorArena::AllocatorArena(const std::string& name)
+    : m_name(name)
+{
+}
+
+AllocatorArena::~AllocatorArena()
+{
+    //! NOTE A scope must not outlive its arena, otherwise the objects created
+    //! on this thread afterwards would be allocated from the released blocks
+    IF_ASSERT_FAILED(s_current != this) {
+        s_current = nullptr;
+    }
+
+    AllocatorsRegister::instance()->releaseArena(this);
+}
+
+const std::string& AllocatorArena::name() const
+{
+    return m_name;
+}
+
+AllocatorArena* AllocatorArena::current()
+{
+    return s_current;
+}
+
+AllocatorArena::Scope::Scope(AllocatorArena* arena)
+    : m_prev(s_current)
+{
+    s_current = arena;
+}
+
+AllocatorArena::Scope::~Scope()
+{
+    s_current = m_prev;
+}
+
 // ============================================
 // ObjectAllocator
 // ============================================
@@ -78,6 +157,32 @@ const char* ObjectAllocator::name() const
     return m_name;
 }
 
+ObjectAllocator::Pool& ObjectAllocator::currentPool()
+{
+    const AllocatorArena* arena = AllocatorArena::current();
+    if (!arena) {
+        return m_pool;
+    }
+
+    if (arena != m_lastArena) {
+        m_lastArena = arena;
+        m_lastArenaPool = &m_arenaPools[arena];
+    }
+
+    return *m_lastArenaPool;
+}
+
+ObjectAllocator::BlockHeader* ObjectAllocator::blockHeader(const void* chunk) const
+{
+    uintptr_t address = reinterpret_cast<uintptr_t>(chunk);
+    return reinterpret_cast<BlockHeader*>(address & ~(uintptr_t(m_blockAlign) - 1));
+}
+
+ObjectAllocator::Pool& ObjectAllocator::ownerPool(void* chunk)
+{
+    return *blockHeader(chunk)->owner;
+}
+
 void* ObjectAllocator::alloc(size_t size)
 {
     size = align(size);
@@ -88,89 +193,210 @@ void* ObjectAllocator::alloc(size_t size)
 
     assert(m_chunkSize == size);
 
-    if (!m_free) {
-        Block b = allocateBlock(m_chunkSize);
-        m_blocks.push_back(b);
-        m_free = b.begin;
+    Pool& pool = currentPool();
+
+    if (!pool.free) {
+        Block b = allocateBlock(m_chunkSize, pool);
+        pool.blocks.push_back(b);
+        pool.totalChunks += b.chunkCount;
+        pool.freeChunks += b.chunkCount;
+        pool.free = b.begin;
     }
 
     // The return value is the current position of
     // the allocation pointer:
-    Chunk* freeChunk = m_free;
+    Chunk* freeChunk = pool.free;
 
     // Advance (bump) the allocation pointer to the next chunk.
     //
-    // When no chunks left, the `m_free` will be set to `nullptr`, and
+    // When no chunks left, the `pool.free` will be set to `nullptr`, and
     // this will cause allocation of a new block on the next request:
-    m_free = m_free->next;
+    pool.free = pool.free->next;
+    pool.freeChunks--;
 
     m_statistic.totalAllocatedCount++;
 
+    uint64_t usedChunks = m_statistic.totalAllocatedCount - m_statistic.totalFreeCount;
+    m_statistic.peakUsedChunks = std::max(m_statistic.peakUsedChunks, usedChunks);
+
     return freeChunk;
 }
 
 void ObjectAllocator::free(void* chunk)
 {
+    if (m_cleaningUp) {
+        m_freedOnCleanup.insert(reinterpret_cast<const Chunk*>(chunk));
+    }
+
+    Pool& pool = ownerPool(chunk);
+
     // The freed chunk's next pointer points to the
     // current allocation pointer:
-    reinterpret_cast<Chunk*>(chunk)->next = m_free;
+    reinterpret_cast<Chunk*>(chunk)->next = pool.free;
 
     // And the allocation pointer is now set
     // to the returned (free) chunk:
-    m_free = reinterpret_cast<Chunk*>(chunk);
+    pool.free = reinterpret_cast<Chunk*>(chunk);
+    pool.freeChunks++;
 
     m_statistic.totalFreeCount++;
 }
 
 void ObjectAllocator::cleanup()
 {
-    if (m_blocks.empty()) {
-        return;
+    std::vector<Pool*> pools;
+    pools.push_back(&m_pool);
+    for (auto& p : m_arenaPools) {
+        pools.push_back(&p.second);
     }
 
-    std::set<Chunk*> freeChunks;
-    {
-        Chunk* free = m_free;
-        while (free) {
+    std::set<const Chunk*> freeChunks;
+    std::vector<Chunk*> liveChunks;
+    for (const Pool* pool : pools) {
+        for (const Chunk* free = pool->free; free; free = free->next) {
             freeChunks.insert(free);
-            free = free->next;
         }
+
+        for (const Block& b : pool->blocks) {
+            for (size_t i = 0; i < b.chunkCount; ++i) {
+                Chunk* chunk = reinterpret_cast<Chunk*>(reinterpret_cast<uint8_t*>(b.begin) + i * b.chunkSize);
+                if (freeChunks.find(chunk) == freeChunks.cend()) {
+                    liveChunks.push_back(chunk);
+                }
+            }
+        }
+    }
+
+    // the destructors may delete other live objects, e.g. a chord deletes its grace chords,
+    // these are freed the usual way and must not be destroyed again
+    m_cleaningUp = true;
+    for (Chunk* chunk : liveChunks) {
+        if (m_freedOnCleanup.find(chunk) != m_freedOnCleanup.cend()) {
+            continue;
+        }
+
+        m_dtor(reinterpret_cast<void*>(chunk));
+        m_statistic.totalFreeCount++;
+    }
+    m_cleaningUp = false;
+    m_freedOnCleanup.clear();
+
+    for (Pool* pool : pools) {
+        relinkPool(*pool);
+    }
+}
+
+//! NOTE Makes all the chunks of the pool free
+void ObjectAllocator::relinkPool(Pool& pool)
+{
+    if (pool.blocks.empty()) {
+        return;
     }
 
-    for (size_t bi = 0; bi < m_blocks.size(); ++bi) {
-        const Block& b = m_blocks.at(bi);
+    for (size_t bi = 0; bi < pool.blocks.size(); ++bi) {
+        const Block& b = pool.blocks.at(bi);
         Chunk* chunk = b.begin;
         for (size_t i = 0; i < b.chunkCount - 1; ++i) {
-            // if not free chunk, then destroy object
-            if (freeChunks.find(chunk) == freeChunks.cend()) {
-                m_dtor(reinterpret_cast<void*>(chunk));
-            }
-
             chunk->next = reinterpret_cast<Chunk*>(reinterpret_cast<uint8_t*>(chunk) + b.chunkSize);
             chunk = chunk->next;
         }
 
-        if (freeChunks.find(chunk) == freeChunks.cend()) {
-            m_dtor(reinterpret_cast<void*>(chunk));
+        if (bi < (pool.blocks.size() - 1)) {
+            chunk->next = pool.blocks.at(bi + 1).begin;
+        } else {
+            chunk->next = nullptr;
         }
+    }
 
-        if (bi < (m_blocks.size() - 1)) {
-            chunk->next = m_blocks.at(bi + 1).begin;
+    pool.free = pool.blocks.front().begin;
+    pool.freeChunks = pool.totalChunks;
+}
+
+void ObjectAllocator::releaseArena(const AllocatorArena* arena)
+{
+    auto it = m_arenaPools.find(arena);
+    if (it == m_arenaPools.end()) {
+        return;
+    }
+
+    Pool& pool = it->second;
+
+    auto blockOf = [this](const Chunk* chunk) {
+        return reinterpret_cast<const Chunk*>(reinterpret_cast<const uint8_t*>(blockHeader(chunk)) + BLOCK_HEADER_SIZE);
+    };
+
+    // count free chunks per block
+    std::map<const Chunk*, size_t> freeCountByBlock;
+    for (const Chunk* free = pool.free; free; free = free->next) {
+        freeCountByBlock[blockOf(free)]++;
+    }
+
+    // blocks without live objects are released, the others are handed over to the shared pool
+    std::set<const Chunk*> keptBlocks;
+    size_t leakedChunks = 0;
+    for (const Block& b : pool.blocks) {
+        size_t freeCount = freeCountByBlock[b.begin];
+        if (freeCount < b.chunkCount) {
+            keptBlocks.insert(b.begin);
+            leakedChunks += b.chunkCount - freeCount;
+        }
+    }
+
+    if (!keptBlocks.empty()) {
+        Chunk* free = pool.free;
+        while (free) {
+            Chunk* next = free->next;
+            if (keptBlocks.find(blockOf(free)) != keptBlocks.cend()) {
+                free->next = m_pool.free;
+                m_pool.free = free;
+                m_pool.freeChunks++;
+            }
+            free = next;
+        }
+
+        LOGW() << m_name << ": " << leakedChunks << " objects still alive on release of arena " << arena->name();
+    }
+
+    for (const Block& b : pool.blocks) {
+        if (keptBlocks.find(b.begin) != keptBlocks.cend()) {
+            m_pool.blocks.push_back(b);
+            m_pool.totalChunks += b.chunkCount;
+            blockHeader(b.begin)->owner = &m_pool;
         } else {
-            chunk->next = nullptr;
+            freeBlock(b);
         }
     }
 
-    m_free = m_blocks.front().begin;
+    m_arenaPools.erase(it);
+    if (m_lastArena == arena) {
+        m_lastArena = nullptr;
+        m_lastArenaPool = nullptr;
+    }
+}
+
+void ObjectAllocator::resetPeak()
+{
+    m_statistic.peakUsedChunks = m_statistic.totalAllocatedCount - m_statistic.totalFreeCount;
 }
 
-ObjectAllocator::Block ObjectAllocator::allocateBlock(size_t chunkSize) const
+ObjectAllocator::Block ObjectAllocator::allocateBlock(size_t chunkSize, Pool& owner)
 {
     size_t blockSize = std::max(DEFAULT_BLOCK_SIZE, chunkSize);
+
+    // all the blocks of the allocator have the same alignment, it's chosen with the first one
+    if (!m_blockAlign) {
+        m_blockAlign = nextPowerOfTwo(BLOCK_HEADER_SIZE + blockSize);
+    }
+    blockSize = std::min(blockSize, m_blockAlign - BLOCK_HEADER_SIZE);
+
     size_t chunkCount = blockSize / chunkSize;
 
+    static_assert(sizeof(BlockHeader) <= BLOCK_HEADER_SIZE);
+    uint8_t* memory = reinterpret_cast<uint8_t*>(allocateAligned(m_blockAlign));
+    new (memory) BlockHeader { &owner };
+
     Block b;
-    b.begin = reinterpret_cast<Chunk*>(malloc(blockSize));
+    b.begin = reinterpret_cast<Chunk*>(memory + BLOCK_HEADER_SIZE);
     b.chunkCount = chunkCount;
     b.chunkSize = chunkSize;
 
@@ -189,6 +415,11 @@ ObjectAllocator::Block ObjectAllocator::allocateBlock(size_t chunkSize) const
     return b;
 }
 
+void ObjectAllocator::freeBlock(const Block& b)
+{
+    freeAligned(blockHeader(b.begin));
+}
+
 void* ObjectAllocator::not_supported(const char* info)
 {
     LOGE() << m_name << ": " << info << " not supported";
@@ -202,18 +433,18 @@ ObjectAllocator::Info ObjectAllocator::stateInfo() const
     info.module = m_module;
     info.name = m_name;
     info.chunkSize = m_chunkSize;
-    info.blockCount = m_blocks.size();
+    info.arenaCount = m_arenaPools.size();
     info.totalAllocatedCount = m_statistic.totalAllocatedCount;
     info.totalFreeCount = m_statistic.totalFreeCount;
-
-    for (const Block& b : m_blocks) {
-        info.totalChunks += b.chunkCount;
-    }
-
-    Chunk* free = m_free;
-    while (free) {
-        ++info.freeChunks;
-        free = free->next;
+    info.peakUsedChunks = m_statistic.peakUsedChunks;
+
+    info.blockCount = m_pool.blocks.size();
+    info.totalChunks = m_pool.totalChunks;
+    info.freeChunks = m_pool.freeChunks;
+    for (const auto& p : m_arenaPools) {
+        info.blockCount += p.second.blocks.size();
+        info.totalChunks += p.second.totalChunks;
+        info.freeChunks += p.second.freeChunks;
     }
 
     return info;
@@ -224,21 +455,63 @@ ObjectAllocator::Info ObjectAllocator::stateInfo() const
 // ============================================
 void AllocatorsRegister::reg(ObjectAllocator* a)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_allocators.push_back(a);
 }
 
 void AllocatorsRegister::unreg(ObjectAllocator* a)
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
     m_allocators.remove(a);
 }
 
-void AllocatorsRegister::cleanupAll(const std::string& module)
+//! NOTE The allocators are called without the lock, a destructor may be the first use of another class
+std::vector<ObjectAllocator*> AllocatorsRegister::allocators(const std::string& module) const
 {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<ObjectAllocator*> result;
     for (ObjectAllocator* a : m_allocators) {
-        if (a->module() == module) {
-            a->cleanup();
+        if (module.empty() || a->module() == module) {
+            result.push_back(a);
         }
     }
+    return result;
+}
+
+void AllocatorsRegister::cleanupAll(const std::string& module)
+{
+    for (ObjectAllocator* a : allocators(module)) {
+        a->cleanup();
+    }
+}
+
+void AllocatorsRegister::releaseArena(const AllocatorArena* arena)
+{
+    for (ObjectAllocator* a : allocators()) {
+        a->releaseArena(arena);
+    }
+}
+
+std::vector<ObjectAllocator::Info> AllocatorsRegister::stateInfo(const std::string& module) const
+{
+    std::vector<ObjectAllocator::Info> infos;
+    for (const ObjectAllocator* a : allocators(module)) {
+        infos.push_back(a->stateInfo());
+    }
+
+    std::stable_sort(infos.begin(), infos.end(), [](const ObjectAllocator::Info& i1, const ObjectAllocator::Info& i2) {
+        return i1.liveBytes() > i2.liveBytes();
+    });
+
+    return infos;
+}
+
+void AllocatorsRegister::resetPeaks()
+{
+    for (ObjectAllocator* a : allocators()) {
+        a->resetPeak();
+    }
 }
 
 #define FORMAT(str, width) muse::strings::leftJustified(str, width)
@@ -247,33 +520,40 @@ void AllocatorsRegister::cleanupAll(const std::string& module)
 
 void AllocatorsRegister::printStatistic(const std::string& title)
 {
+    std::vector<ObjectAllocator::Info> infos = stateInfo();
+
     std::stringstream stream;
     stream << "\n\n";
     stream << title << "\n";
-    stream << "allocators: " << m_allocators.size() << '\n';
-    stream << TITLE("Object") << TITLE("Total alloc") << TITLE("Total free") << TITLE("Used (leak?)") << TITLE("Object size") << "\n";
+    stream << "allocators: " << infos.size() << '\n';
+    stream << TITLE("Object") << TITLE("Total alloc") << TITLE("Total free") << TITLE("Used (leak?)") << TITLE("Object size")
+           << TITLE("Live bytes") << TITLE("Peak bytes") << "\n";
 
     uint64_t totalBytes = 0;
     uint64_t totalAllocatedCount = 0;
     uint64_t totalFreeCount = 0;
     uint64_t totalUsedCount = 0;
-    for (ObjectAllocator* a : m_allocators) {
-        ObjectAllocator::Info info = a->stateInfo();
+    uint64_t totalLiveBytes = 0;
+    for (const ObjectAllocator::Info& info : infos) {
         stream << FORMAT(info.name, 20)
                << VALUE(info.totalAllocatedCount)
                << VALUE(info.totalFreeCount)
                << VALUE(info.usedChunks())
                << VALUE(info.chunkSize)
+               << VALUE(info.liveBytes())
+               << VALUE(info.peakBytes())
                << "\n";
 
         totalAllocatedCount += info.totalAllocatedCount;
         totalFreeCount += info.totalFreeCount;
         totalUsedCount += info.usedChunks();
         totalBytes += info.allocatedBytes();
+        totalLiveBytes += info.liveBytes();
     }
 
-    stream << "--------------------------------------------------------------------------------------------\n";
-    stream << FORMAT("Total", 20) << VALUE(totalAllocatedCount) << VALUE(totalFreeCount) << VALUE(totalUsedCount) << "\n";
+    stream << "--------------------------------------------------------------------------------------------------------------------------------------------\n";
+    stream << FORMAT("Total", 20) << VALUE(totalAllocatedCount) << VALUE(totalFreeCount) << VALUE(totalUsedCount) << TITLE("")
+           << VALUE(totalLiveBytes) << "\n";
     stream << "Total allocated: " << totalBytes << " bytes\n";
 
     LOGD() << stream.str() << '\n';
@@ -281,15 +561,17 @@ void AllocatorsRegister::printStatistic(const std::string& title)
 
 void AllocatorsRegister::printState(const std::string& title)
 {
+    std::vector<ObjectAllocator*> allocs = allocators();
+
     std::stringstream stream;
     stream << "\n\n";
     stream << title << "\n";
-    stream << "allocators: " << m_allocators.size() << '\n';
+    stream << "allocators: " << allocs.size() << '\n';
     stream << TITLE("Object") << TITLE("blockCount") << TITLE("totalChunks") << TITLE("freeChunks") << TITLE("chunkSize")
            << TITLE("allocatedBytes") << "\n";
 
     uint64_t totalBytes = 0;
-    for (ObjectAllocator* a : m_allocators) {
+    for (ObjectAllocator* a : allocs) {
         ObjectAllocator::Info info = a->stateInfo();
         stream << FORMAT(info.name, 20)
                << VALUE(info.blockCount)
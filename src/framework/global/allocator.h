@@ -25,6 +25,9 @@
 #include <cstdint>
 #include <vector>
 #include <list>
+#include <map>
+#include <mutex>
+#include <set>
 #include <string>
 
 namespace muse {
@@ -59,6 +62,49 @@ public: \
     } \
 private:
 
+//! NOTE While an arena is current on a thread, the objects created on that thread are allocated
+//! from blocks owned by that arena. An arena is made current by a Scope, held by an operation of
+//! its owner (on the stack, or from the start to the end of an edit command), scopes must be
+//! destroyed in the reverse order; objects created outside of any scope come from the shared blocks.
+//! When the arena is destroyed, its blocks are returned to the system. Blocks that still
+//! contain live objects (e.g. objects of another score allocated meanwhile) are handed over
+//! to the shared blocks of the allocator instead, so nothing is freed under a live object.
+class AllocatorArena
+{
+public:
+    AllocatorArena(const std::string& name);
+    ~AllocatorArena();
+
+    AllocatorArena(const AllocatorArena&) = delete;
+    AllocatorArena& operator=(const AllocatorArena&) = delete;
+
+    const std::string& name() const;
+
+    static AllocatorArena* current();
+
+    //! NOTE Makes the arena current on this thread, the previous one is restored on destruction
+    class Scope
+    {
+    public:
+        explicit Scope(AllocatorArena* arena);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        AllocatorArena* m_prev = nullptr;
+    };
+
+private:
+    std::string m_name;
+
+    static thread_local AllocatorArena* s_current;
+};
+
+//! NOTE The allocators are not thread-safe, like the objects using them,
+//! which are created and destroyed on the main thread
+
 class ObjectAllocator
 {
 public:
@@ -75,6 +121,9 @@ public:
 
     void* alloc(size_t size);
     void free(void* ptr);
+
+    //! NOTE Destroys all the live objects, in memory order. The objects deleted by the destructors
+    //! meanwhile are not destroyed again, but an object must not delete one that was destroyed before it
     void cleanup();
 
     template<class T>
@@ -94,16 +143,23 @@ public:
         size_t blockCount = 0;
         size_t totalChunks = 0;
         size_t freeChunks = 0;
+        size_t arenaCount = 0;
 
         uint64_t totalAllocatedCount = 0;
         uint64_t totalFreeCount = 0;
+        uint64_t peakUsedChunks = 0;
 
         uint64_t usedChunks() const { return totalChunks - freeChunks; }
         uint64_t allocatedBytes() const { return totalChunks * chunkSize; }
+        uint64_t liveBytes() const { return usedChunks() * chunkSize; }
+        uint64_t peakBytes() const { return peakUsedChunks * chunkSize; }
     };
 
     Info stateInfo() const;
 
+    void resetPeak();
+    void releaseArena(const AllocatorArena* arena);
+
     static bool enabled() { return s_used; }
     static void used();
     static void unused();
@@ -128,19 +184,46 @@ private:
         size_t chunkSize = 0;
     };
 
-    Block allocateBlock(size_t chunkSize) const;
+    struct Pool {
+        Chunk* free = nullptr;
+        std::vector<Block> blocks;
+        size_t totalChunks = 0;
+        size_t freeChunks = 0;
+    };
+
+    //! NOTE The blocks are aligned to m_blockAlign and begin with a header holding their owner pool,
+    //! so the pool of a chunk is found from its address
+    struct BlockHeader {
+        Pool* owner = nullptr;
+    };
+
+    Block allocateBlock(size_t chunkSize, Pool& owner);
+    void freeBlock(const Block& b);
+    BlockHeader* blockHeader(const void* chunk) const;
+    Pool& currentPool();
+    Pool& ownerPool(void* chunk);
+    void relinkPool(Pool& pool);
 
     const char* m_module = nullptr;
     const char* m_name = nullptr;
     size_t m_chunkSize = 0;
     destroyer_t m_dtor = nullptr;
-    Chunk* m_free = nullptr;
-    std::vector<Block> m_blocks;
+
+    Pool m_pool; // shared, used when no arena is current
+    std::map<const AllocatorArena*, Pool> m_arenaPools;
+    size_t m_blockAlign = 0; // set with the first block
+    const AllocatorArena* m_lastArena = nullptr;
+    Pool* m_lastArenaPool = nullptr;
+
+    //! NOTE The destructors called by cleanup may delete other objects of this allocator
+    bool m_cleaningUp = false;
+    std::set<const Chunk*> m_freedOnCleanup;
 
     struct Statistic
     {
         uint64_t totalAllocatedCount = 0;
         uint64_t totalFreeCount = 0;
+        uint64_t peakUsedChunks = 0;
     };
 
     Statistic m_statistic;
@@ -160,12 +243,20 @@ public:
     void unreg(ObjectAllocator* a);
 
     void cleanupAll(const std::string& module);
+    void releaseArena(const AllocatorArena* arena);
+
+    //! NOTE Per class state, sorted by live bytes (largest first). Empty module means all modules
+    std::vector<ObjectAllocator::Info> stateInfo(const std::string& module = std::string()) const;
+    void resetPeaks();
 
     void printStatistic(const std::string& title);
     void printState(const std::string& title);
 
 private:
+    std::vector<ObjectAllocator*> allocators(const std::string& module = std::string()) const;
+
     std::list<ObjectAllocator*> m_allocators;
+    mutable std::mutex m_mutex; // the allocators register on the first use of their class, from any thread
 };
 }
 
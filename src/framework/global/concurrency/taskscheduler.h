@@ -56,6 +56,14 @@ public:
         terminateThreads();
     }
 
+    //! NOTE The scheduler for the background work of the modules (ex. compressing the project files),
+    //! so that they don't start their own threads. Not for the realtime work
+    static TaskScheduler& shared()
+    {
+        static TaskScheduler scheduler;
+        return scheduler;
+    }
+
     thread_pool_size_t threadPoolSize() const
     {
         return m_threadPoolSize;
@@ -119,6 +127,49 @@ public:
         return promise->get_future();
     }
 
+    //! NOTE: Fork-join: invokes func(index) for every index in [0, count) on the pool threads
+    //! and on the calling thread, and returns once all of them are done.
+    //! Unlike submit(), this does not allocate, so it can be used on a realtime thread.
+    //! Only one parallelFor can be in progress at a time; concurrent calls are serialized.
+    template<typename FuncT>
+    void parallelFor(size_t count, FuncT&& func)
+    {
+        if (count == 0) {
+            return;
+        }
+
+        if (count == 1) {
+            func(size_t(0));
+            return;
+        }
+
+        using FuncType = std::remove_reference_t<FuncT>;
+
+        const std::lock_guard batchLock(m_batchMutex);
+
+        {
+            const std::lock_guard lock(m_mutex);
+            m_batch.context = const_cast<void*>(static_cast<const void*>(std::addressof(func)));
+            m_batch.invoke = [](void* context, size_t index) {
+                (*static_cast<FuncType*>(context))(index);
+            };
+            m_batch.count = count;
+            m_batch.nextIndex = 0;
+            m_batch.activeWorkers = 0;
+            m_batch.isActive = true;
+        }
+
+        m_newTaskAvailableCv.notify_all();
+
+        runBatchItems(m_batch.context, m_batch.invoke, count);
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_batchFinishedCv.wait(lock, [this] { return m_batch.activeWorkers == 0; });
+        m_batch.isActive = false;
+        m_batch.context = nullptr;
+        m_batch.invoke = nullptr;
+    }
+
     void waitForAllTasksComplete()
     {
         m_isWaitingForAllTasksDone = true;
@@ -164,16 +215,48 @@ private:
         return desiredThreadCount;
     }
 
+    using BatchInvoke = void (*)(void* context, size_t index);
+
+    void runBatchItems(void* context, BatchInvoke invoke, size_t count)
+    {
+        for (size_t index = m_batch.nextIndex.fetch_add(1); index < count; index = m_batch.nextIndex.fetch_add(1)) {
+            invoke(context, index);
+        }
+    }
+
+    bool hasPendingBatchItems() const
+    {
+        return m_batch.isActive && m_batch.nextIndex < m_batch.count;
+    }
+
     void th_workerLoop()
     {
         while (m_isActive) {
             std::unique_lock<std::mutex> lock(m_mutex);
-            m_newTaskAvailableCv.wait(lock, [this] { return !m_taskQueue.empty() || !m_isActive; });
+            m_newTaskAvailableCv.wait(lock, [this] { return !m_taskQueue.empty() || hasPendingBatchItems() || !m_isActive; });
 
             if (!m_isActive) {
                 return;
             }
 
+            if (hasPendingBatchItems()) {
+                void* context = m_batch.context;
+                BatchInvoke invoke = m_batch.invoke;
+                size_t count = m_batch.count;
+                m_batch.activeWorkers++;
+
+                lock.unlock();
+
+                runBatchItems(context, invoke, count);
+
+                lock.lock();
+                if (--m_batch.activeWorkers == 0) {
+                    m_batchFinishedCv.notify_one();
+                }
+
+                continue;
+            }
+
             std::function<void()> task = m_taskQueue.front();
             m_taskQueue.pop();
 
@@ -195,6 +278,19 @@ private:
     std::condition_variable m_taskFinishedCv;
     std::queue<std::function<void()> > m_taskQueue;
 
+    struct Batch {
+        void* context = nullptr;
+        BatchInvoke invoke = nullptr;
+        size_t count = 0;
+        std::atomic<size_t> nextIndex = 0;
+        size_t activeWorkers = 0;
+        bool isActive = false;
+    };
+
+    std::mutex m_batchMutex;
+    std::condition_variable m_batchFinishedCv;
+    Batch m_batch;
+
     thread_pool_size_t m_threadPoolSize = 0;
     std::unique_ptr<std::thread[]> m_threadPool = nullptr;
 };
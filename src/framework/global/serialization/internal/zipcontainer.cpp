@@ -23,6 +23,8 @@
 
 #include <ctime>
 #include <cstring>
+#include <mutex>
+#include <vector>
 #include <zlib.h>
 
 #include "global/io/dir.h"
@@ -149,37 +151,44 @@ static int inflate(Bytef* dest, ulong* destLen, const Bytef* source, ulong sourc
     return err;
 }
 
-static int deflate(Bytef* dest, ulong* destLen, const Bytef* source, ulong sourceLen)
+//! NOTE Deflates the source in chunks of the output, so that the compressed data
+//! doesn't need a buffer of the worst case size, each chunk is passed to the sink
+template<typename Sink>
+static int deflateChunked(const Bytef* source, size_t sourceLen, int level, Sink&& sink)
 {
+    static constexpr size_t CHUNK_SIZE = 64 * 1024;
+
     z_stream stream;
-    int err;
+    std::memset(&stream, 0, sizeof(z_stream));
+
+    int err = deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    if (err != Z_OK) {
+        return err;
+    }
+
+    std::vector<Bytef> chunk(CHUNK_SIZE);
 
     stream.next_in = const_cast<Bytef*>(source);
     stream.avail_in = (uInt)sourceLen;
-    stream.next_out = dest;
-    stream.avail_out = (uInt) * destLen;
-    if ((uLong)stream.avail_out != *destLen) {
-        return Z_BUF_ERROR;
-    }
 
-    stream.zalloc = (alloc_func)0;
-    stream.zfree = (free_func)0;
-    stream.opaque = (voidpf)0;
+    do {
+        stream.next_out = chunk.data();
+        stream.avail_out = (uInt)chunk.size();
 
-    err = deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
-    if (err != Z_OK) {
-        return err;
-    }
+        err = deflate(&stream, Z_FINISH);
+        if (err != Z_OK && err != Z_STREAM_END) {
+            deflateEnd(&stream);
+            return err;
+        }
 
-    err = deflate(&stream, Z_FINISH);
-    if (err != Z_STREAM_END) {
-        deflateEnd(&stream);
-        return err == Z_OK ? Z_BUF_ERROR : err;
-    }
-    *destLen = stream.total_out;
+        size_t len = chunk.size() - stream.avail_out;
+        if (len > 0 && !sink(chunk.data(), len)) {
+            deflateEnd(&stream);
+            return Z_ERRNO;
+        }
+    } while (err != Z_STREAM_END);
 
-    err = deflateEnd(&stream);
-    return err;
+    return deflateEnd(&stream);
 }
 
 namespace WindowsFileAttributes {
@@ -372,6 +381,10 @@ LocalFileHeader CentralFileHeader::toLocalHeader() const
 struct ZipContainer::Impl {
     IODevice* device = nullptr;
 
+    //! NOTE Guards the device position and the file tree,
+    //! so that several files can be read (and inflated) concurrently
+    std::mutex readMutex;
+
     bool dirtyFileTree = true;
     std::vector<FileHeader> fileHeaders;
     ByteArray comment;
@@ -379,12 +392,20 @@ struct ZipContainer::Impl {
     ZipContainer::Status status = ZipContainer::NoError;
 
     ZipContainer::CompressionPolicy compressionPolicy = ZipContainer::AlwaysCompress;
+    int compressionLevel = Z_DEFAULT_COMPRESSION;
 
     enum EntryType {
         Directory, File, Symlink
     };
 
+    bool isDeflated(size_t size) const;
+    FileHeader makeFileHeader(EntryType type, const std::string& fileName, bool deflated, uint crc, size_t size) const;
+
+    bool prepareDevice();
     void addEntry(EntryType type, const std::string& fileName, const ByteArray& contents);
+    void addEntry(FileHeader& header, const ByteArray& data);
+    void finishEntry(const FileHeader& header, bool ok);
+    bool writeLocalHeader(const FileHeader& header);
     bool writeToDevice(const uint8_t* data, size_t len);
     bool writeToDevice(const ByteArray& data);
 
@@ -559,30 +580,29 @@ ZipContainer::FileInfo ZipContainer::Impl::fillFileInfo(size_t index) const
     return fileInfo;
 }
 
-void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, const ByteArray& contents)
+bool ZipContainer::Impl::isDeflated(size_t size) const
 {
-    if (!(device->isOpen() || device->open(IODevice::WriteOnly))) {
-        status = ZipContainer::FileOpenError;
-        return;
+    switch (compressionPolicy) {
+    case ZipContainer::AlwaysCompress:
+        return true;
+    case ZipContainer::NeverCompress:
+        return false;
+    case ZipContainer::AutoCompress:
+        // don't compress small files
+        return size >= 64;
     }
-    device->seek(start_of_directory);
 
-    // don't compress small files
-    ZipContainer::CompressionPolicy compression = compressionPolicy;
-    if (compressionPolicy == ZipContainer::AutoCompress) {
-        if (contents.size() < 64) {
-            compression = ZipContainer::NeverCompress;
-        } else {
-            compression = ZipContainer::AlwaysCompress;
-        }
-    }
+    return true;
+}
 
+FileHeader ZipContainer::Impl::makeFileHeader(EntryType type, const std::string& fileName, bool deflated, uint crc, size_t size) const
+{
     FileHeader header;
     std::memset(&header.h, 0, sizeof(CentralFileHeader));
     writeUInt(header.h.signature, 0x02014b50);
 
     writeUShort(header.h.version_needed, ZIP_VERSION);
-    writeUInt(header.h.uncompressed_size, (uint)contents.size());
+    writeUInt(header.h.uncompressed_size, (uint)size);
 
     std::time_t t = std::time(0);   // get time now
     std::tm now;
@@ -592,37 +612,14 @@ void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, c
     localtime_r(&t, &now);
 #endif
     writeMSDosDate(header.h.last_mod_file, now);
-    ByteArray data = contents;
-    if (compression == ZipContainer::AlwaysCompress) {
-        writeUShort(header.h.compression_method, CompressionMethodDeflated);
-
-        ulong len = (ulong)contents.size();
-        // shamelessly copied form zlib
-        len += (len >> 12) + (len >> 14) + 11;
-        int res;
-        do {
-            data.resize(len);
-            res = deflate((uint8_t*)data.data(), &len, (const uint8_t*)contents.constData(), (ulong)contents.size());
 
-            switch (res) {
-            case Z_OK:
-                data.resize(len);
-                break;
-            case Z_MEM_ERROR:
-                LOGW("Zip: Z_MEM_ERROR: Not enough memory to compress file, skipping");
-                data.resize(0);
-                break;
-            case Z_BUF_ERROR:
-                len *= 2;
-                break;
-            }
-        } while (res == Z_BUF_ERROR);
+    if (deflated) {
+        writeUShort(header.h.compression_method, CompressionMethodDeflated);
+    } else {
+        writeUInt(header.h.compressed_size, (uint)size);
     }
-// TODO add a check if data.size() > contents.size().  Then try to store the original and revert the compression method to be uncompressed
-    writeUInt(header.h.compressed_size, (uint)data.size());
-    uint crc_32 = ::crc32(0, 0, 0);
-    crc_32 = ::crc32(crc_32, (const uint8_t*)contents.constData(), (uint)contents.size());
-    writeUInt(header.h.crc_32, crc_32);
+
+    writeUInt(header.h.crc_32, crc);
 
     // if bit 11 is set, the filename and comment fields must be encoded using UTF-8
     ushort general_purpose_bits = Utf8Names; // always use utf-8
@@ -666,15 +663,78 @@ void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, c
     writeUInt(header.h.external_file_attributes, mode << 16);
     writeUInt(header.h.offset_local_header, start_of_directory);
 
-    fileHeaders.push_back(header);
+    return header;
+}
 
-    bool ok = true;
+bool ZipContainer::Impl::prepareDevice()
+{
+    if (!(device->isOpen() || device->open(IODevice::WriteOnly))) {
+        status = ZipContainer::FileOpenError;
+        return false;
+    }
 
-    LocalFileHeader h = header.h.toLocalHeader();
-    ok &= writeToDevice((const uint8_t*)&h, sizeof(LocalFileHeader));
-    ok &= writeToDevice(header.file_name);
+    device->seek(start_of_directory);
+
+    return true;
+}
+
+void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, const ByteArray& contents)
+{
+    if (!prepareDevice()) {
+        return;
+    }
+
+    uint crc_32 = ::crc32(0, 0, 0);
+    crc_32 = ::crc32(crc_32, (const uint8_t*)contents.constData(), (uint)contents.size());
+
+    const bool deflated = isDeflated(contents.size());
+    FileHeader header = makeFileHeader(type, fileName, deflated, crc_32, contents.size());
+
+    if (!deflated) {
+        addEntry(header, contents);
+        return;
+    }
+
+    //! NOTE The compressed data is written to the device as it is produced,
+    //! the local header is written again when its size is known
+    bool ok = writeLocalHeader(header);
+
+    size_t compressedSize = 0;
+    int res = deflateChunked((const uint8_t*)contents.constData(), contents.size(), compressionLevel,
+                             [this, &compressedSize](const uint8_t* data, size_t len) {
+        compressedSize += len;
+        return writeToDevice(data, len);
+    });
+
+    if (res != Z_OK) {
+        LOGW() << "Zip: failed to compress file: " << fileName << ", err: " << res;
+        ok = false;
+    }
+
+    writeUInt(header.h.compressed_size, (uint)compressedSize);
+
+    const size_t endPos = device->pos();
+    ok &= device->seek(start_of_directory);
+    ok &= writeLocalHeader(header);
+    ok &= device->seek(endPos);
+
+    finishEntry(header, ok);
+}
+
+void ZipContainer::Impl::addEntry(FileHeader& header, const ByteArray& data)
+{
+    writeUInt(header.h.compressed_size, (uint)data.size());
+
+    bool ok = writeLocalHeader(header);
     ok &= writeToDevice(data);
 
+    finishEntry(header, ok);
+}
+
+void ZipContainer::Impl::finishEntry(const FileHeader& header, bool ok)
+{
+    fileHeaders.push_back(header);
+
     start_of_directory = (uint)device->pos();
     dirtyFileTree = true;
 
@@ -683,6 +743,16 @@ void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, c
     }
 }
 
+bool ZipContainer::Impl::writeLocalHeader(const FileHeader& header)
+{
+    LocalFileHeader h = header.h.toLocalHeader();
+
+    bool ok = writeToDevice((const uint8_t*)&h, sizeof(LocalFileHeader));
+    ok &= writeToDevice(header.file_name);
+
+    return ok;
+}
+
 bool ZipContainer::Impl::writeToDevice(const uint8_t* data, size_t len)
 {
     return device->write(data, len) == len;
@@ -707,6 +777,7 @@ ZipContainer::~ZipContainer()
 
 std::vector<ZipContainer::FileInfo> ZipContainer::fileInfoList() const
 {
+    const std::lock_guard lock(p->readMutex);
     p->scanFiles();
     std::vector<FileInfo> files;
     const size_t numFileHeaders = p->fileHeaders.size();
@@ -719,12 +790,14 @@ std::vector<ZipContainer::FileInfo> ZipContainer::fileInfoList() const
 
 int ZipContainer::count() const
 {
+    const std::lock_guard lock(p->readMutex);
     p->scanFiles();
     return (int)p->fileHeaders.size();
 }
 
 bool ZipContainer::fileExists(const std::string& fileName) const
 {
+    const std::lock_guard lock(p->readMutex);
     p->scanFiles();
     ByteArray fileNameBa = ByteArray::fromRawData(fileName.c_str(), fileName.size());
     for (size_t i = 0; i < p->fileHeaders.size(); ++i) {
@@ -737,6 +810,7 @@ bool ZipContainer::fileExists(const std::string& fileName) const
 
 ByteArray ZipContainer::fileData(const std::string& fileName) const
 {
+    std::unique_lock lock(p->readMutex);
     p->scanFiles();
 
     ByteArray fileNameBa = ByteArray::fromRawData(fileName.c_str(), fileName.size());
@@ -779,6 +853,8 @@ ByteArray ZipContainer::fileData(const std::string& fileName) const
     }
 
     ByteArray compressed = p->device->read(compressed_size);
+    lock.unlock();
+
     if (compression_method == CompressionMethodStored) {
         // no compression
         compressed.truncate(uncompressed_size);
@@ -834,11 +910,63 @@ ZipContainer::CompressionPolicy ZipContainer::compressionPolicy() const
     return p->compressionPolicy;
 }
 
+void ZipContainer::setCompressionLevel(int level)
+{
+    p->compressionLevel = level;
+}
+
+int ZipContainer::compressionLevel() const
+{
+    return p->compressionLevel;
+}
+
 void ZipContainer::addFile(const std::string& fileName, const ByteArray& data)
 {
     p->addEntry(Impl::File, Dir::fromNativeSeparators(fileName).toStdString(), data);
 }
 
+ZipContainer::CompressedFile ZipContainer::compressFile(const std::string& fileName, const ByteArray& data) const
+{
+    CompressedFile file;
+    file.fileName = Dir::fromNativeSeparators(fileName).toStdString();
+    file.size = data.size();
+
+    uint crc_32 = ::crc32(0, 0, 0);
+    file.crc = ::crc32(crc_32, (const uint8_t*)data.constData(), (uint)data.size());
+
+    if (p->isDeflated(data.size())) {
+        ByteArray compressed;
+        int res = deflateChunked((const uint8_t*)data.constData(), data.size(), p->compressionLevel,
+                                 [&compressed](const uint8_t* chunk, size_t len) {
+            compressed.push_back(chunk, len);
+            return true;
+        });
+
+        //! NOTE If the compression fails, the file is stored
+        if (res == Z_OK) {
+            file.data = compressed;
+            file.isDeflated = true;
+            return file;
+        }
+
+        LOGW() << "Zip: failed to compress file: " << fileName << ", err: " << res;
+    }
+
+    file.data = data;
+
+    return file;
+}
+
+void ZipContainer::addCompressedFile(const CompressedFile& file)
+{
+    if (!p->prepareDevice()) {
+        return;
+    }
+
+    FileHeader header = p->makeFileHeader(Impl::File, file.fileName, file.isDeflated, file.crc, file.size);
+    p->addEntry(header, file.data);
+}
+
 void ZipContainer::addDirectory(const std::string& dirName)
 {
     std::string name(Dir::fromNativeSeparators(dirName).toStdString());
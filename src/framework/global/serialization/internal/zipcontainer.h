@@ -22,6 +22,7 @@
 #ifndef MUSE_GLOBAL_ZIPCONTAINER_H
 #define MUSE_GLOBAL_ZIPCONTAINER_H
 
+#include <cstdint>
 #include <ctime>
 #include <string>
 
@@ -76,7 +77,26 @@ public:
     void setCompressionPolicy(CompressionPolicy policy);
     CompressionPolicy compressionPolicy() const;
 
+    //! NOTE The zlib level, from 1 (best speed) to 9 (best compression), or -1 for the default
+    void setCompressionLevel(int level);
+    int compressionLevel() const;
+
+    //! NOTE The data is compressed while it is written to the device
     void addFile(const std::string& fileName, const ByteArray& data);
+
+    //! NOTE A file compressed in advance, so that several files can be compressed concurrently
+    struct CompressedFile
+    {
+        std::string fileName;
+        ByteArray data;
+        uint32_t crc = 0;
+        size_t size = 0;
+        bool isDeflated = false;
+    };
+
+    //! NOTE Doesn't use the device, so it may be called from several threads
+    CompressedFile compressFile(const std::string& fileName, const ByteArray& data) const;
+    void addCompressedFile(const CompressedFile& file);
     void addDirectory(const std::string& dirName);
 
 private:
@@ -21,26 +21,355 @@
  */
 #include "xmlstreamreader.h"
 
+#include <algorithm>
+#include <cctype>
 #include <cstring>
+#include <memory>
 
 #include "global/types/string.h"
-#ifdef SYSTEM_TINYXML
-#include <tinyxml2.h>
-#else
-#include "thirdparty/tinyxml/tinyxml2.h"
-#endif
 
 #include "log.h"
 
 using namespace muse;
 using namespace muse::io;
-using namespace tinyxml2;
+
+static constexpr size_t READ_CHUNK_SIZE = 64 * 1024;
+static constexpr size_t NOT_FOUND = static_cast<size_t>(-1);
+
+//! NOTE The character classes, the entity and the line end handling follow tinyxml2,
+//! that was used before, so that the documents are read exactly as before
+
+static inline bool isWhiteSpace(char ch)
+{
+    // anything in the high order range of UTF-8 is assumed to not be whitespace
+    return !(ch & 0x80) && std::isspace(static_cast<unsigned char>(ch));
+}
+
+static inline bool isNameStartChar(char c)
+{
+    const unsigned char ch = static_cast<unsigned char>(c);
+    return ch >= 128 || std::isalpha(ch) || ch == ':' || ch == '_';
+}
+
+static inline bool isNameChar(char c)
+{
+    const unsigned char ch = static_cast<unsigned char>(c);
+    return isNameStartChar(c) || std::isdigit(ch) || ch == '.' || ch == '-';
+}
+
+static size_t toUtf8(unsigned long ucs, char* out)
+{
+    if (ucs < 0x80) {
+        out[0] = static_cast<char>(ucs);
+        return 1;
+    }
+
+    size_t len = 0;
+    if (ucs < 0x800) {
+        len = 2;
+    } else if (ucs < 0x10000) {
+        len = 3;
+    } else if (ucs < 0x200000) {
+        len = 4;
+    } else {
+        return 0;
+    }
+
+    static const unsigned char FIRST_BYTE_MARK[5] = { 0x00, 0x00, 0xC0, 0xE0, 0xF0 };
+    for (size_t i = len - 1; i > 0; --i) {
+        out[i] = static_cast<char>(0x80 | (ucs & 0x3F));
+        ucs >>= 6;
+    }
+    out[0] = static_cast<char>(ucs | FIRST_BYTE_MARK[len]);
+
+    return len;
+}
+
+//! NOTE `p` points to "&#"; returns the position after the reference, or nullptr if it isn't a valid one
+static const char* readCharacterRef(const char* p, const char* end, char* out, size_t* outLen)
+{
+    const char* semicolon = static_cast<const char*>(std::memchr(p + 2, ';', end - (p + 2)));
+    if (!semicolon) {
+        return nullptr;
+    }
+
+    unsigned long ucs = 0;
+    const bool hex = p[2] == 'x';
+    for (const char* q = hex ? p + 3 : p + 2; q < semicolon; ++q) {
+        unsigned long digit = 0;
+        if (*q >= '0' && *q <= '9') {
+            digit = *q - '0';
+        } else if (hex && *q >= 'a' && *q <= 'f') {
+            digit = *q - 'a' + 10;
+        } else if (hex && *q >= 'A' && *q <= 'F') {
+            digit = *q - 'A' + 10;
+        } else {
+            return nullptr;
+        }
+
+        // out of range, is dropped
+        ucs = std::min(ucs * (hex ? 16 : 10) + digit, 0x200000ul);
+    }
+
+    *outLen = toUtf8(ucs, out);
+    return semicolon + 1;
+}
+
+//! NOTE Resolves the predefined and the character entities and normalizes the line ends, in place.
+//! The result is never longer than the source; returns its length
+static size_t decodeInPlace(char* str, size_t len, bool processEntities)
+{
+    char* const end = str + len;
+
+    char* first = static_cast<char*>(std::memchr(str, '\r', len));
+    if (processEntities) {
+        char* amp = static_cast<char*>(std::memchr(str, '&', (first ? first : end) - str));
+        if (amp) {
+            first = amp;
+        }
+    }
+
+    if (!first) {
+        return len;
+    }
+
+    struct Entity {
+        const char* pattern;
+        size_t length;
+        char value;
+    };
+
+    static const Entity ENTITIES[] = {
+        { "quot", 4, '\"' },
+        { "amp", 3, '&' },
+        { "apos", 4, '\'' },
+        { "lt", 2, '<' },
+        { "gt", 2, '>' }
+    };
+
+    const char* p = first;
+    char* q = first;
+    while (p < end) {
+        if (*p == '\r') {
+            // CR-LF pair and CR alone become LF
+            p += (p + 1 < end && p[1] == '\n') ? 2 : 1;
+            *q++ = '\n';
+        } else if (*p == '\n') {
+            // LF-CR becomes LF
+            p += (p + 1 < end && p[1] == '\r') ? 2 : 1;
+            *q++ = '\n';
+        } else if (processEntities && *p == '&') {
+            const char* next = nullptr;
+            if (p + 1 < end && p[1] == '#') {
+                char buf[4];
+                size_t bufLen = 0;
+                next = readCharacterRef(p, end, buf, &bufLen);
+                if (next) {
+                    std::memcpy(q, buf, bufLen);
+                    q += bufLen;
+                }
+            } else {
+                for (const Entity& entity : ENTITIES) {
+                    if (p + entity.length + 1 < end && std::strncmp(p + 1, entity.pattern, entity.length) == 0
+                        && p[entity.length + 1] == ';') {
+                        *q++ = entity.value;
+                        next = p + entity.length + 2;
+                        break;
+                    }
+                }
+            }
+
+            if (next) {
+                p = next;
+            } else {
+                // not an entity, keep it as is
+                *q++ = *p++;
+            }
+        } else {
+            *q++ = *p++;
+        }
+    }
+
+    return q - str;
+}
 
 struct XmlStreamReader::Xml {
-    XMLDocument doc;
-    XMLNode* node = nullptr;
-    XMLError err;
+    struct Attr {
+        AsciiStringView name;
+        AsciiStringView value;
+    };
+
+    IODevice* device = nullptr;
+    bool deviceAtEnd = true;
+
+    //! NOTE The blocks are kept until the reader is reset, because the returned views point into them.
+    //! A new block is started only when a token doesn't fit into the rest of the current one
+    std::vector<std::unique_ptr<char[]> > blocks;
+    char* pos = nullptr; // not read data
+    char* end = nullptr; // end of the available data, always `*end == 0`
+
+    //! NOTE The '<' at `pos` has been overwritten by the terminator of the previous text
+    bool ltAtPos = false;
+
+    AsciiStringView name;
+    std::vector<Attr> attributes;
+    AsciiStringView text;
+    std::vector<AsciiStringView> elements;
+    bool isEmptyElement = false;
+    bool hasTokens = false;
+
+    int64_t line = 1;
+    int64_t tokenLine = 1;
+
+    Error err = NoError;
+    String errString;
     String customErr;
+
+    std::shared_ptr<Recording> recording;
+    std::shared_ptr<const Recording> replay;
+    size_t replayPos = 0;
+
+    void reset()
+    {
+        device = nullptr;
+        deviceAtEnd = true;
+        blocks.clear();
+        pos = nullptr;
+        end = nullptr;
+        ltAtPos = false;
+        name = AsciiStringView();
+        attributes.clear();
+        text = AsciiStringView();
+        elements.clear();
+        isEmptyElement = false;
+        hasTokens = false;
+        line = 1;
+        tokenLine = 1;
+        err = NoError;
+        errString.clear();
+        customErr.clear();
+        recording.reset();
+        replay.reset();
+        replayPos = 0;
+    }
+
+    void setBuffer(const char* data, size_t size)
+    {
+        blocks.clear();
+        std::unique_ptr<char[]> block = std::make_unique<char[]>(size + 1);
+        std::memcpy(block.get(), data, size);
+        block[size] = 0;
+
+        pos = block.get();
+        end = pos + size;
+        blocks.push_back(std::move(block));
+    }
+
+    //! NOTE Makes sure that at least `count` bytes from `pos` are available
+    inline bool ensure(size_t count)
+    {
+        return static_cast<size_t>(end - pos) >= count || readMore(count);
+    }
+
+    bool readMore(size_t count)
+    {
+        if (deviceAtEnd) {
+            return false;
+        }
+
+        const size_t tail = end - pos;
+        const size_t capacity = std::max(READ_CHUNK_SIZE, 2 * count);
+        std::unique_ptr<char[]> block = std::make_unique<char[]>(capacity + 1);
+        if (tail) {
+            std::memcpy(block.get(), pos, tail);
+        }
+
+        size_t size = tail;
+        while (size < capacity) {
+            size_t read = device->read(reinterpret_cast<uint8_t*>(block.get() + size), capacity - size);
+            if (read == 0) {
+                deviceAtEnd = true;
+                break;
+            }
+            size += read;
+        }
+        block[size] = 0;
+
+        pos = block.get();
+        end = pos + size;
+        blocks.push_back(std::move(block));
+
+        return size >= count;
+    }
+
+    //! NOTE Returns the offset from `pos`
+    size_t find(size_t from, char ch)
+    {
+        for (;;) {
+            const size_t available = end - pos;
+            if (from < available) {
+                const void* found = std::memchr(pos + from, ch, available - from);
+                if (found) {
+                    return static_cast<const char*>(found) - pos;
+                }
+                from = available;
+            }
+
+            if (!readMore(available + 1)) {
+                return NOT_FOUND;
+            }
+        }
+    }
+
+    size_t find(size_t from, const char* pattern, size_t patternLen)
+    {
+        for (;;) {
+            const size_t idx = find(from, pattern[0]);
+            if (idx == NOT_FOUND || !ensure(idx + patternLen)) {
+                return NOT_FOUND;
+            }
+
+            if (std::memcmp(pos + idx, pattern, patternLen) == 0) {
+                return idx;
+            }
+            from = idx + 1;
+        }
+    }
+
+    //! NOTE Must be called before the consumed data is modified
+    char* consume(size_t count)
+    {
+        char* start = pos;
+        line += std::count(start, start + count, '\n');
+        pos += count;
+        return start;
+    }
+
+    const Attr* attribute(const char* attrName) const
+    {
+        for (const Attr& a : attributes) {
+            if (a.name == attrName) {
+                return &a;
+            }
+        }
+        return nullptr;
+    }
+};
+
+struct XmlStreamReader::Recording {
+    struct Token {
+        const char* value = nullptr; // the name of the elements, the text of the others
+        uint32_t valueLen = 0;
+        uint32_t line = 0;
+        uint32_t firstAttribute = 0;
+        uint32_t attributeCount = 0;
+        TokenType type = TokenType::NoToken;
+    };
+
+    std::vector<std::unique_ptr<char[]> > blocks;
+    std::vector<Token> tokens;
+    std::vector<Xml::Attr> attributes;
+    std::map<String, String> entities;
 };
 
 XmlStreamReader::XmlStreamReader()
@@ -51,8 +380,9 @@ XmlStreamReader::XmlStreamReader()
 XmlStreamReader::XmlStreamReader(IODevice* device)
 {
     m_xml = new Xml();
-    ByteArray data = device->readAll();
-    setData(data);
+    m_xml->device = device;
+    m_xml->deviceAtEnd = false;
+    init();
 }
 
 XmlStreamReader::XmlStreamReader(const ByteArray& data)
@@ -76,41 +406,57 @@ XmlStreamReader::~XmlStreamReader()
     delete m_xml;
 }
 
-void XmlStreamReader::setData(const ByteArray& data_)
+void XmlStreamReader::setData(const ByteArray& data)
+{
+    m_xml->reset();
+    m_xml->setBuffer(data.constChar(), data.size());
+    init();
+}
+
+void XmlStreamReader::init()
 {
-    m_xml->doc.Clear();
-    m_xml->customErr.clear();
     m_token = TokenType::Invalid;
 
-    if (data_.size() < 4) {
-        m_xml->err = XML_ERROR_EMPTY_DOCUMENT;
-        LOGE() << m_xml->doc.ErrorIDToName(m_xml->err);
+    if (!m_xml->ensure(4)) {
+        parseError(NotWellFormedError, u"Empty document");
         return;
     }
 
-    UtfCodec::Encoding enc = UtfCodec::xmlEncoding(data_);
+    // the encoding is detected by the first chunk
+    ByteArray head = ByteArray::fromRawData(m_xml->pos, m_xml->end - m_xml->pos);
+    UtfCodec::Encoding enc = UtfCodec::xmlEncoding(head);
     if (enc == UtfCodec::Encoding::Unknown) {
-        m_xml->err = XML_CAN_NOT_CONVERT_TEXT;
-        LOGE() << "unknown encoding";
+        parseError(NotWellFormedError, u"Unknown encoding");
         return;
     }
 
-    ByteArray data = data_; // no copy, implicit sharing
-    if (enc == UtfCodec::Encoding::UTF_16LE) {
-        String u16 = String::fromUtf16LE(data_);
-        data = u16.toUtf8();
-    } else if (enc == UtfCodec::Encoding::UTF_16BE) {
-        String u16 = String::fromUtf16BE(data_);
-        data = u16.toUtf8();
-    }
+    if (enc == UtfCodec::Encoding::UTF_16LE || enc == UtfCodec::Encoding::UTF_16BE) {
+        ByteArray data(head.constData(), head.size());
+        if (m_xml->device) {
+            data.push_back(m_xml->device->readAll());
+            m_xml->deviceAtEnd = true;
+        }
 
-    m_xml->err = m_xml->doc.Parse(reinterpret_cast<const char*>(data.constData()), data.size());
+        String u16 = enc == UtfCodec::Encoding::UTF_16LE ? String::fromUtf16LE(data) : String::fromUtf16BE(data);
+        ByteArray u8 = u16.toUtf8();
+        m_xml->setBuffer(u8.constChar(), u8.size());
+    }
 
-    if (m_xml->err == XML_SUCCESS) {
-        m_token = TokenType::NoToken;
-    } else {
-        LOGE() << m_xml->doc.ErrorIDToName(m_xml->err);
+    // skip BOM
+    if (m_xml->ensure(3) && std::memcmp(m_xml->pos, "\xEF\xBB\xBF", 3) == 0) {
+        m_xml->pos += 3;
     }
+
+    m_token = TokenType::NoToken;
+}
+
+void XmlStreamReader::parseError(Error error, const String& message)
+{
+    m_xml->err = error;
+    m_xml->errString = message + u" (line " + String::number(m_xml->line) + u")";
+    m_token = TokenType::Invalid;
+
+    LOGE() << m_xml->errString;
 }
 
 bool XmlStreamReader::readNextStartElement()
@@ -130,89 +476,523 @@ bool XmlStreamReader::atEnd() const
     return m_token == TokenType::EndDocument || m_token == TokenType::Invalid;
 }
 
-static XmlStreamReader::TokenType resolveToken(XMLNode* n, bool isStartElement)
+XmlStreamReader::TokenType XmlStreamReader::readNext()
+{
+    if (m_token == TokenType::Invalid) {
+        return m_token;
+    }
+
+    if (m_xml->err != NoError || m_token == EndDocument) {
+        m_token = TokenType::Invalid;
+        return m_token;
+    }
+
+    m_xml->attributes.clear();
+    m_xml->text = AsciiStringView();
+
+    if (m_xml->replay) {
+        replayToken();
+        return m_token;
+    }
+
+    if (m_token == TokenType::StartElement && m_xml->isEmptyElement) {
+        // <name/>
+        m_xml->isEmptyElement = false;
+        m_xml->elements.pop_back();
+        m_token = TokenType::EndElement;
+    } else if (!readToken()) {
+        m_token = TokenType::Invalid;
+    }
+
+    if (m_xml->recording && m_token != TokenType::Invalid) {
+        recordToken();
+    }
+
+    return m_token;
+}
+
+void XmlStreamReader::startRecording()
+{
+    IF_ASSERT_FAILED(m_token == TokenType::NoToken || m_token == TokenType::Invalid) {
+        return;
+    }
+
+    m_xml->recording = std::make_shared<Recording>();
+}
+
+std::shared_ptr<const XmlStreamReader::Recording> XmlStreamReader::takeRecording()
+{
+    if (!m_xml->recording) {
+        return nullptr;
+    }
+
+    while (!atEnd()) {
+        readNext();
+    }
+
+    std::shared_ptr<Recording> recording = std::move(m_xml->recording);
+    m_xml->recording.reset();
+
+    if (m_xml->err != NoError) {
+        return nullptr;
+    }
+
+    // the views of this reader stay valid, the buffer is only moved
+    recording->blocks = std::move(m_xml->blocks);
+    m_xml->blocks.clear();
+    recording->entities = m_entities;
+
+    return recording;
+}
+
+void XmlStreamReader::replay(std::shared_ptr<const Recording> recording)
+{
+    m_xml->reset();
+    m_entities = recording->entities;
+    m_xml->replay = std::move(recording);
+    m_token = TokenType::NoToken;
+}
+
+void XmlStreamReader::recordToken()
+{
+    const Xml* xml = m_xml;
+    Recording* recording = xml->recording.get();
+
+    Recording::Token token;
+    token.type = m_token;
+    token.line = static_cast<uint32_t>(xml->tokenLine);
+
+    const AsciiStringView value = (m_token == TokenType::StartElement || m_token == TokenType::EndElement) ? xml->name : xml->text;
+    token.value = value.ascii();
+    token.valueLen = static_cast<uint32_t>(value.size());
+
+    token.firstAttribute = static_cast<uint32_t>(recording->attributes.size());
+    token.attributeCount = static_cast<uint32_t>(xml->attributes.size());
+    recording->attributes.insert(recording->attributes.end(), xml->attributes.begin(), xml->attributes.end());
+
+    recording->tokens.push_back(token);
+}
+
+void XmlStreamReader::replayToken()
+{
+    Xml* xml = m_xml;
+    const Recording* recording = xml->replay.get();
+
+    if (xml->replayPos >= recording->tokens.size()) {
+        m_token = TokenType::Invalid;
+        return;
+    }
+
+    const Recording::Token& token = recording->tokens[xml->replayPos++];
+    m_token = token.type;
+    xml->line = token.line;
+    xml->tokenLine = token.line;
+
+    const AsciiStringView value(token.value, token.valueLen);
+    if (m_token == TokenType::StartElement || m_token == TokenType::EndElement) {
+        xml->name = value;
+    } else {
+        xml->text = value;
+    }
+
+    const auto firstAttribute = recording->attributes.begin() + token.firstAttribute;
+    xml->attributes.assign(firstAttribute, firstAttribute + token.attributeCount);
+}
+
+bool XmlStreamReader::readToken()
 {
-    if (n->ToElement()) {
-        return isStartElement ? XmlStreamReader::TokenType::StartElement : XmlStreamReader::TokenType::EndElement;
-    } else if (n->ToText()) {
-        return XmlStreamReader::TokenType::Characters;
-    } else if (n->ToComment()) {
-        return XmlStreamReader::TokenType::Comment;
-    } else if (n->ToDeclaration()) {
-        return XmlStreamReader::TokenType::StartDocument;
-    } else if (n->ToDocument()) {
-        return XmlStreamReader::TokenType::EndDocument;
-    } else if (n->ToUnknown()) {
-        return XmlStreamReader::TokenType::DTD;
+    Xml* xml = m_xml;
+
+    if (!xml->ltAtPos) {
+        // whitespace before markup is dropped, before text it's a part of the text
+        size_t i = 0;
+        while (xml->ensure(i + 1) && isWhiteSpace(xml->pos[i])) {
+            ++i;
+        }
+
+        if (!xml->ensure(i + 1)) {
+            xml->consume(i);
+
+            if (!xml->elements.empty()) {
+                parseError(PrematureEndOfDocumentError, u"Premature end of document, element not closed: "
+                           + String::fromAscii(xml->elements.back().ascii()));
+                return false;
+            }
+
+            if (!xml->hasTokens) {
+                parseError(NotWellFormedError, u"Empty document");
+                return false;
+            }
+
+            m_token = TokenType::EndDocument;
+            return true;
+        }
+
+        if (xml->pos[i] != '<') {
+            return readCharacters();
+        }
+
+        xml->consume(i);
     }
-    return XmlStreamReader::TokenType::Unknown;
+
+    xml->ltAtPos = false;
+    xml->tokenLine = xml->line;
+
+    return readMarkup();
 }
 
-static std::pair<XMLNode*, XmlStreamReader::TokenType> resolveNode(XMLNode* currentNode, XmlStreamReader::TokenType currentToken)
+bool XmlStreamReader::readMarkup()
 {
-    if (currentToken == XmlStreamReader::TokenType::StartElement) {
-        XMLNode* child = currentNode->FirstChild();
-        if (child) {
-            return { child, resolveToken(child, true) };
+    Xml* xml = m_xml;
+
+    if (!xml->ensure(2)) {
+        parseError(PrematureEndOfDocumentError, u"Premature end of document");
+        return false;
+    }
+
+    // <?xml ... ?>, <?target ... ?>
+    if (xml->pos[1] == '?') {
+        size_t i = xml->find(2, "?>", 2);
+        if (i == NOT_FOUND) {
+            parseError(PrematureEndOfDocumentError, u"Premature end of document in declaration");
+            return false;
+        }
+
+        xml->consume(i + 2);
+
+        // only the leading declaration is reported, processing instructions inside the document are skipped
+        if (xml->hasTokens) {
+            return readToken();
+        }
+
+        xml->hasTokens = true;
+        m_token = TokenType::StartDocument;
+        return true;
+    }
+
+    if (xml->pos[1] == '!') {
+        // <!-- ... -->
+        if (xml->ensure(4) && std::memcmp(xml->pos + 2, "--", 2) == 0) {
+            size_t i = xml->find(4, "-->", 3);
+            if (i == NOT_FOUND) {
+                parseError(PrematureEndOfDocumentError, u"Premature end of document in comment");
+                return false;
+            }
+
+            char* start = xml->consume(i + 3) + 4;
+            size_t len = decodeInPlace(start, i - 4, false);
+            start[len] = 0;
+
+            xml->text = AsciiStringView(start, len);
+            xml->hasTokens = true;
+            m_token = TokenType::Comment;
+            return true;
         }
 
-        XMLNode* sibling = currentNode->NextSibling();
-        if (!sibling || sibling->ToElement() || sibling->ToText()) {
-            return { currentNode, XmlStreamReader::TokenType::EndElement };
+        // <![CDATA[ ... ]]>
+        if (xml->ensure(9) && std::memcmp(xml->pos + 2, "[CDATA[", 7) == 0) {
+            size_t i = xml->find(9, "]]>", 3);
+            if (i == NOT_FOUND) {
+                parseError(PrematureEndOfDocumentError, u"Premature end of document in CDATA");
+                return false;
+            }
+
+            char* start = xml->consume(i + 3) + 9;
+            size_t len = decodeInPlace(start, i - 9, false);
+            start[len] = 0;
+
+            xml->text = AsciiStringView(start, len);
+            xml->hasTokens = true;
+            m_token = TokenType::Characters;
+            return true;
         }
+
+        // <!DOCTYPE ... [ ... ]>, <!ENTITY ... >
+        // the internal subset of the DOCTYPE may contain comments and further declarations
+        std::vector<std::pair<size_t, size_t> > entityDecls;
+        size_t i = 2;
+        size_t declStart = NOT_FOUND;
+        char quote = 0;
+        bool inSubset = false;
+        for (;; ++i) {
+            if (!xml->ensure(i + 1)) {
+                parseError(PrematureEndOfDocumentError, u"Premature end of document in DTD");
+                return false;
+            }
+
+            const char ch = xml->pos[i];
+            if (quote) {
+                if (ch == quote) {
+                    quote = 0;
+                }
+            } else if (ch == '"' || ch == '\'') {
+                quote = ch;
+            } else if (!inSubset) {
+                if (ch == '[') {
+                    inSubset = true;
+                } else if (ch == '>') {
+                    break;
+                }
+            } else if (ch == ']') {
+                inSubset = false;
+            } else if (ch == '<' && xml->ensure(i + 4) && std::memcmp(xml->pos + i + 1, "!--", 3) == 0) {
+                size_t commentEnd = xml->find(i + 4, "-->", 3);
+                if (commentEnd == NOT_FOUND) {
+                    parseError(PrematureEndOfDocumentError, u"Premature end of document in DTD");
+                    return false;
+                }
+                i = commentEnd + 2;
+            } else if (ch == '<' && xml->ensure(i + 2) && xml->pos[i + 1] == '!') {
+                declStart = i + 2;
+            } else if (ch == '>' && declStart != NOT_FOUND) {
+                entityDecls.emplace_back(declStart, i);
+                declStart = NOT_FOUND;
+            }
+        }
+
+        char* start = xml->consume(i + 1) + 2;
+
+        if (entityDecls.empty()) {
+            entityDecls.emplace_back(2, i);
+        }
+
+        for (const auto& decl : entityDecls) {
+            tryParseEntity(std::string(start + decl.first - 2, decl.second - decl.first).c_str());
+        }
+
+        size_t len = decodeInPlace(start, i - 2, false);
+        start[len] = 0;
+
+        xml->hasTokens = true;
+        m_token = TokenType::DTD;
+        return true;
     }
 
-    XMLNode* sibling = currentNode->NextSibling();
-    if (sibling) {
-        return { sibling, resolveToken(sibling, true) };
+    size_t i = 1;
+    while (xml->ensure(i + 1) && isWhiteSpace(xml->pos[i])) {
+        ++i;
     }
 
-    XMLNode* parent = currentNode->Parent();
-    if (parent) {
-        return { parent, resolveToken(parent, false) };
+    if (xml->ensure(i + 1) && xml->pos[i] == '/') {
+        return readEndElement();
     }
 
-    return { nullptr, XmlStreamReader::TokenType::EndDocument };
+    return readStartElement();
 }
 
-XmlStreamReader::TokenType XmlStreamReader::readNext()
+bool XmlStreamReader::readStartElement()
 {
-    if (m_token == TokenType::Invalid) {
-        return m_token;
+    Xml* xml = m_xml;
+
+    // find the end of the tag, the attribute values may contain '>'
+    size_t tagEnd = 1;
+    char quote = 0;
+    for (;; ++tagEnd) {
+        if (!xml->ensure(tagEnd + 1)) {
+            parseError(PrematureEndOfDocumentError, u"Premature end of document in element");
+            return false;
+        }
+
+        const char ch = xml->pos[tagEnd];
+        if (quote) {
+            if (ch == quote) {
+                quote = 0;
+            }
+        } else if (ch == '"' || ch == '\'') {
+            quote = ch;
+        } else if (ch == '>') {
+            break;
+        }
     }
 
-    if (m_xml->err != XML_SUCCESS || m_token == EndDocument) {
-        m_xml->node = nullptr;
-        m_token = TokenType::Invalid;
-        return m_token;
+    char* p = xml->consume(tagEnd + 1) + 1;
+    char* const end = p + tagEnd - 1; // '>'
+
+    while (p < end && isWhiteSpace(*p)) {
+        ++p;
     }
 
-    if (!m_xml->node) {
-        m_xml->node = m_xml->doc.FirstChild();
-        m_token = m_xml->node->ToDeclaration() ? TokenType::StartDocument : resolveToken(m_xml->node, true);
-        return m_token;
+    if (!isNameStartChar(*p)) {
+        parseError(NotWellFormedError, u"Invalid element name");
+        return false;
     }
 
-    std::pair<XMLNode*, XmlStreamReader::TokenType> p = resolveNode(m_xml->node, m_token);
+    char* nameBegin = p;
+    while (p < end && isNameChar(*p)) {
+        ++p;
+    }
+    char* nameEnd = p;
 
-    m_xml->node = p.first;
-    m_token = p.second;
+    struct RawAttr {
+        char* name;
+        char* nameEnd;
+        char* value;
+        char* valueEnd;
+    };
 
-    if (m_token == XmlStreamReader::TokenType::DTD) {
-        tryParseEntity(m_xml);
+    std::vector<RawAttr> rawAttrs;
+    bool isEmptyElement = false;
+
+    for (;;) {
+        while (p < end && isWhiteSpace(*p)) {
+            ++p;
+        }
+
+        if (p == end) {
+            break;
+        }
+
+        if (*p == '/' && p + 1 == end) {
+            isEmptyElement = true;
+            break;
+        }
+
+        if (!isNameStartChar(*p)) {
+            parseError(NotWellFormedError, u"Invalid attribute in element: " + String::fromAscii(nameBegin, nameEnd - nameBegin));
+            return false;
+        }
+
+        RawAttr attr;
+        attr.name = p;
+        while (p < end && isNameChar(*p)) {
+            ++p;
+        }
+        attr.nameEnd = p;
+
+        while (p < end && isWhiteSpace(*p)) {
+            ++p;
+        }
+
+        if (p == end || *p != '=') {
+            parseError(NotWellFormedError, u"Invalid attribute in element: " + String::fromAscii(nameBegin, nameEnd - nameBegin));
+            return false;
+        }
+        ++p;
+
+        while (p < end && isWhiteSpace(*p)) {
+            ++p;
+        }
+
+        if (p == end || (*p != '"' && *p != '\'')) {
+            parseError(NotWellFormedError, u"Invalid attribute in element: " + String::fromAscii(nameBegin, nameEnd - nameBegin));
+            return false;
+        }
+
+        const char attrQuote = *p++;
+        attr.value = p;
+        attr.valueEnd = static_cast<char*>(std::memchr(p, attrQuote, end - p));
+        if (!attr.valueEnd) {
+            parseError(NotWellFormedError, u"Invalid attribute in element: " + String::fromAscii(nameBegin, nameEnd - nameBegin));
+            return false;
+        }
+        p = attr.valueEnd + 1;
+
+        const size_t attrNameLen = attr.nameEnd - attr.name;
+        for (const RawAttr& other : rawAttrs) {
+            if (static_cast<size_t>(other.nameEnd - other.name) == attrNameLen && std::memcmp(other.name, attr.name, attrNameLen) == 0) {
+                parseError(NotWellFormedError, u"Duplicate attribute in element: " + String::fromAscii(nameBegin, nameEnd - nameBegin));
+                return false;
+            }
+        }
+
+        rawAttrs.push_back(attr);
     }
 
-    return m_token;
+    // terminate the strings in place, after the whole tag is parsed
+    *nameEnd = 0;
+    xml->name = AsciiStringView(nameBegin, nameEnd - nameBegin);
+
+    xml->attributes.reserve(rawAttrs.size());
+    for (const RawAttr& attr : rawAttrs) {
+        *attr.nameEnd = 0;
+        size_t valueLen = decodeInPlace(attr.value, attr.valueEnd - attr.value, true);
+        attr.value[valueLen] = 0;
+
+        xml->attributes.push_back({ AsciiStringView(attr.name, attr.nameEnd - attr.name), AsciiStringView(attr.value, valueLen) });
+    }
+
+    xml->elements.push_back(xml->name);
+    xml->isEmptyElement = isEmptyElement;
+    xml->hasTokens = true;
+    m_token = TokenType::StartElement;
+    return true;
+}
+
+bool XmlStreamReader::readEndElement()
+{
+    Xml* xml = m_xml;
+
+    size_t tagEnd = xml->find(1, '>');
+    if (tagEnd == NOT_FOUND) {
+        parseError(PrematureEndOfDocumentError, u"Premature end of document in element");
+        return false;
+    }
+
+    char* p = xml->consume(tagEnd + 1) + 1;
+    char* const end = p + tagEnd - 1; // '>'
+
+    while (p < end && isWhiteSpace(*p)) {
+        ++p;
+    }
+    ++p; // '/'
+
+    char* nameBegin = p;
+    while (p < end && isNameChar(*p)) {
+        ++p;
+    }
+    const AsciiStringView name(nameBegin, p - nameBegin);
+
+    while (p < end && isWhiteSpace(*p)) {
+        ++p;
+    }
+
+    if (p != end || name.empty()) {
+        parseError(NotWellFormedError, u"Invalid end element");
+        return false;
+    }
+
+    if (xml->elements.empty() || xml->elements.back() != name) {
+        parseError(NotWellFormedError, u"Mismatched element: " + String::fromAscii(nameBegin, name.size()));
+        return false;
+    }
+
+    xml->name = xml->elements.back();
+    xml->elements.pop_back();
+    m_token = TokenType::EndElement;
+    return true;
+}
+
+bool XmlStreamReader::readCharacters()
+{
+    Xml* xml = m_xml;
+
+    size_t i = xml->find(0, '<');
+    if (i == NOT_FOUND) {
+        parseError(PrematureEndOfDocumentError, u"Premature end of document in text");
+        return false;
+    }
+
+    xml->tokenLine = xml->line;
+    char* start = xml->consume(i);
+    size_t len = decodeInPlace(start, i, true);
+
+    // may overwrite the '<' of the next token
+    start[len] = 0;
+    xml->ltAtPos = true;
+
+    xml->text = AsciiStringView(start, len);
+    xml->hasTokens = true;
+    m_token = TokenType::Characters;
+    return true;
 }
 
 #if (defined (_MSCVER) || defined (_MSC_VER))
 #define strdup _strdup // avoid a warning from MSVC on a perfectly valid POSIX function
 #endif
-void XmlStreamReader::tryParseEntity(Xml* xml)
+void XmlStreamReader::tryParseEntity(const char* str)
 {
     static const char* ENTITY = { "ENTITY" };
 
-    const char* str = xml->node->Value();
     if (std::strncmp(str, ENTITY, 6) == 0) {
         // Syntax: '<!ENTITY [%] Name [SYSTEM|PUBLIC] "Value" [additional info] >'
         // the '<!' and '>' stripped away already from str
@@ -237,9 +1017,9 @@ void XmlStreamReader::tryParseEntity(Xml* xml)
 #undef strdup
 #endif
 
-String XmlStreamReader::nodeValue(Xml* xml) const
+String XmlStreamReader::nodeValue() const
 {
-    String str = String::fromUtf8(xml->node->Value());
+    String str = String::fromUtf8(m_xml->text.ascii());
     if (!m_entities.empty()) {
         for (const auto& p : m_entities) {
             str.replace(p.first, p.second);
@@ -289,7 +1069,7 @@ void XmlStreamReader::skipCurrentElement()
 
 AsciiStringView XmlStreamReader::name() const
 {
-    return (m_xml->node && m_xml->node->ToElement()) ? m_xml->node->Value() : AsciiStringView();
+    return (m_token == TokenType::StartElement || m_token == TokenType::EndElement) ? m_xml->name : AsciiStringView();
 }
 
 bool XmlStreamReader::hasAttribute(const char* name) const
@@ -298,24 +1078,12 @@ bool XmlStreamReader::hasAttribute(const char* name) const
         return false;
     }
 
-    XMLElement* e = m_xml->node->ToElement();
-    if (!e) {
-        return false;
-    }
-    return e->FindAttribute(name) != nullptr;
+    return m_xml->attribute(name) != nullptr;
 }
 
 String XmlStreamReader::attribute(const char* name) const
 {
-    if (m_token != TokenType::StartElement) {
-        return String();
-    }
-
-    XMLElement* e = m_xml->node->ToElement();
-    if (!e) {
-        return String();
-    }
-    return String::fromUtf8(e->Attribute(name));
+    return String::fromUtf8(asciiAttribute(name).ascii());
 }
 
 String XmlStreamReader::attribute(const char* name, const String& def) const
@@ -329,11 +1097,8 @@ AsciiStringView XmlStreamReader::asciiAttribute(const char* name) const
         return AsciiStringView();
     }
 
-    XMLElement* e = m_xml->node->ToElement();
-    if (!e) {
-        return AsciiStringView();
-    }
-    return e->Attribute(name);
+    const Xml::Attr* a = m_xml->attribute(name);
+    return a ? a->value : AsciiStringView();
 }
 
 AsciiStringView XmlStreamReader::asciiAttribute(const char* name, const AsciiStringView& def) const
@@ -368,15 +1133,11 @@ std::vector<XmlStreamReader::Attribute> XmlStreamReader::attributes() const
         return attrs;
     }
 
-    XMLElement* e = m_xml->node->ToElement();
-    if (!e) {
-        return attrs;
-    }
-
-    for (const XMLAttribute* xa = e->FirstAttribute(); xa; xa = xa->Next()) {
+    attrs.reserve(m_xml->attributes.size());
+    for (const Xml::Attr& xa : m_xml->attributes) {
         Attribute a;
-        a.name = xa->Name();
-        a.value = String::fromUtf8(xa->Value());
+        a.name = xa.name;
+        a.value = String::fromUtf8(xa.value.ascii());
         attrs.push_back(std::move(a));
     }
     return attrs;
@@ -384,16 +1145,16 @@ std::vector<XmlStreamReader::Attribute> XmlStreamReader::attributes() const
 
 String XmlStreamReader::text() const
 {
-    if (m_xml->node && (m_xml->node->ToText() || m_xml->node->ToComment())) {
-        return nodeValue(m_xml);
+    if (m_token == TokenType::Characters || m_token == TokenType::Comment) {
+        return nodeValue();
     }
     return String();
 }
 
 AsciiStringView XmlStreamReader::asciiText() const
 {
-    if (m_xml->node && (m_xml->node->ToText() || m_xml->node->ToComment())) {
-        return m_xml->node->Value();
+    if (m_token == TokenType::Characters || m_token == TokenType::Comment) {
+        return m_xml->text;
     }
     return AsciiStringView();
 }
@@ -405,14 +1166,14 @@ String XmlStreamReader::readText()
         while (1) {
             switch (readNext()) {
             case Characters:
-                result = nodeValue(m_xml);
+                result = nodeValue();
                 break;
             case EndElement:
                 return result;
-            case Comment:
-                break;
-            case StartElement:
-                break;
+            case Invalid:
+            case EndDocument:
+                // broken document, the error is reported by the reader
+                return result;
             default:
                 break;
             }
@@ -428,14 +1189,14 @@ AsciiStringView XmlStreamReader::readAsciiText()
         while (1) {
             switch (readNext()) {
             case Characters:
-                result = AsciiStringView(m_xml->node->Value());
+                result = m_xml->text;
                 break;
             case EndElement:
                 return result;
-            case Comment:
-                break;
-            case StartElement:
-                break;
+            case Invalid:
+            case EndDocument:
+                // broken document, the error is reported by the reader
+                return result;
             default:
                 break;
             }
@@ -458,7 +1219,7 @@ double XmlStreamReader::readDouble(bool* ok)
 
 int64_t XmlStreamReader::lineNumber() const
 {
-    return m_xml->doc.ErrorLineNum();
+    return m_xml->tokenLine;
 }
 
 int64_t XmlStreamReader::columnNumber() const
@@ -472,12 +1233,7 @@ XmlStreamReader::Error XmlStreamReader::error() const
         return CustomError;
     }
 
-    XMLError err = m_xml->doc.ErrorID();
-    if (err == XML_SUCCESS) {
-        return NoError;
-    }
-
-    return NotWellFormedError;
+    return m_xml->err;
 }
 
 bool XmlStreamReader::isError() const
@@ -490,7 +1246,7 @@ String XmlStreamReader::errorString() const
     if (!m_xml->customErr.empty()) {
         return m_xml->customErr;
     }
-    return String::fromUtf8(m_xml->doc.ErrorStr());
+    return m_xml->errString;
 }
 
 void XmlStreamReader::raiseError(const String& message)
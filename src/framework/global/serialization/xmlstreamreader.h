@@ -24,6 +24,7 @@
 
 #include <vector>
 #include <map>
+#include <memory>
 
 #include "io/iodevice.h"
 #include "types/bytearray.h"
@@ -34,6 +35,10 @@
 #endif
 
 namespace muse {
+//! NOTE Incremental (pull) parser: the data is tokenized in place as it is read,
+//! without building a document tree first.
+//! Names, attribute values and texts are returned as views into the reader's buffer,
+//! they stay valid until the reader is destroyed or `setData` is called.
 class XmlStreamReader
 {
 public:
@@ -65,7 +70,12 @@ public:
         String value;
     };
 
+    //! NOTE The tokens of a whole document, with the buffer they point into
+    struct Recording;
+
     XmlStreamReader();
+    //! NOTE The data is read from the device in chunks, while reading the tokens,
+    //! so the device must stay open while the reader is used
     explicit XmlStreamReader(io::IODevice* device);
     explicit XmlStreamReader(const ByteArray& data);
 #ifndef NO_QT_SUPPORT
@@ -78,6 +88,13 @@ public:
 
     void setData(const ByteArray& data);
 
+    //! NOTE Keeps the tokens while they are read, must be called before reading.
+    //! `takeRecording` reads the rest of the document and returns them, or nullptr if the document isn't well formed;
+    //! `replay` reads them again, possibly by another reader, without tokenizing the document again
+    void startRecording();
+    std::shared_ptr<const Recording> takeRecording();
+    void replay(std::shared_ptr<const Recording> recording);
+
     bool readNextStartElement();
     bool atEnd() const;
     void skipCurrentElement();
@@ -122,8 +139,18 @@ public:
 private:
     struct Xml;
 
-    void tryParseEntity(Xml* xml);
-    String nodeValue(Xml* xml) const;
+    void init();
+    bool readToken();
+    bool readMarkup();
+    bool readStartElement();
+    bool readEndElement();
+    bool readCharacters();
+    void recordToken();
+    void replayToken();
+    void parseError(Error error, const String& message);
+
+    void tryParseEntity(const char* str);
+    String nodeValue() const;
 
     Xml* m_xml = nullptr;
     TokenType m_token = TokenType::NoToken;
@@ -21,6 +21,13 @@
  */
 #include "zipwriter.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "global/concurrency/taskscheduler.h"
 #include "global/io/file.h"
 #include "internal/zipcontainer.h"
 
@@ -28,10 +35,17 @@
 
 using namespace muse;
 
+//! NOTE The size of the added files, after which they are compressed and written
+static constexpr size_t MAX_PENDING_SIZE = 32 * 1024 * 1024;
+
 struct ZipWriter::Impl
 {
     ZipContainer* zip = nullptr;
     bool isClosed = false;
+    CompressionLevel compressionLevel = CompressionLevel::Default;
+
+    std::vector<std::pair<std::string, ByteArray> > pendingFiles;
+    size_t pendingSize = 0;
 };
 
 ZipWriter::ZipWriter(const io::path_t& filePath)
@@ -65,8 +79,133 @@ ZipWriter::~ZipWriter()
     }
 }
 
+void ZipWriter::setCompressionLevel(CompressionLevel level)
+{
+    flush();
+
+    m_impl->compressionLevel = level;
+
+    switch (level) {
+    case CompressionLevel::Store:
+        m_impl->zip->setCompressionPolicy(ZipContainer::NeverCompress);
+        break;
+    case CompressionLevel::Fast:
+        m_impl->zip->setCompressionPolicy(ZipContainer::AlwaysCompress);
+        m_impl->zip->setCompressionLevel(1);
+        break;
+    case CompressionLevel::Default:
+        m_impl->zip->setCompressionPolicy(ZipContainer::AlwaysCompress);
+        m_impl->zip->setCompressionLevel(-1);
+        break;
+    }
+}
+
+ZipWriter::CompressionLevel ZipWriter::compressionLevel() const
+{
+    return m_impl->compressionLevel;
+}
+
+//! NOTE The files of a flush, taken in order by the writing thread and by the compressing tasks.
+//! Shared with the tasks, which may only start once the flush is done (and then find nothing to take)
+struct FlushedFiles
+{
+    struct File {
+        std::string fileName;
+        ByteArray data;
+        bool isCompressed = false;
+        ZipContainer::CompressedFile compressed;
+    };
+
+    std::vector<File> files;
+    size_t nextIndex = 0;
+    std::mutex mutex;
+    std::condition_variable compressedCv;
+};
+
+static void compressFlushedFiles(const std::shared_ptr<FlushedFiles>& flushed, const ZipContainer* zip)
+{
+    for (;;) {
+        FlushedFiles::File* file = nullptr;
+        {
+            const std::lock_guard lock(flushed->mutex);
+            if (flushed->nextIndex >= flushed->files.size()) {
+                return;
+            }
+            file = &flushed->files[flushed->nextIndex++];
+        }
+
+        ZipContainer::CompressedFile compressed = zip->compressFile(file->fileName, file->data);
+
+        {
+            const std::lock_guard lock(flushed->mutex);
+            file->compressed = std::move(compressed);
+            file->isCompressed = true;
+        }
+        flushed->compressedCv.notify_all();
+    }
+}
+
 void ZipWriter::flush()
 {
+    std::vector<std::pair<std::string, ByteArray> >& files = m_impl->pendingFiles;
+    if (files.empty()) {
+        return;
+    }
+
+    TRACEFUNC;
+
+    //! NOTE Nothing to do concurrently, so the files are compressed while they are written
+    if (files.size() == 1 || m_impl->compressionLevel == CompressionLevel::Store) {
+        for (const auto& [fileName, data] : files) {
+            m_impl->zip->addFile(fileName, data);
+        }
+
+        files.clear();
+        m_impl->pendingSize = 0;
+        return;
+    }
+
+    auto flushed = std::make_shared<FlushedFiles>();
+    flushed->files.reserve(files.size());
+    for (auto& [fileName, data] : files) {
+        flushed->files.push_back({ std::move(fileName), std::move(data) });
+    }
+
+    files.clear();
+    m_impl->pendingSize = 0;
+
+    //! NOTE The tasks compress the files which wait for the ones before them to be written
+    TaskScheduler& scheduler = TaskScheduler::shared();
+    const size_t taskCount = std::min(static_cast<size_t>(scheduler.threadPoolSize()), flushed->files.size() - 1);
+    const ZipContainer* zip = m_impl->zip;
+    for (size_t i = 0; i < taskCount; ++i) {
+        scheduler.push([flushed, zip]() {
+            compressFlushedFiles(flushed, zip);
+        });
+    }
+
+    for (size_t i = 0; i < flushed->files.size(); ++i) {
+        FlushedFiles::File& file = flushed->files[i];
+
+        std::unique_lock lock(flushed->mutex);
+        if (flushed->nextIndex <= i) {
+            //! NOTE Not taken by a task, so it's streamed
+            flushed->nextIndex = i + 1;
+            lock.unlock();
+
+            m_impl->zip->addFile(file.fileName, file.data);
+            file.data = ByteArray();
+            continue;
+        }
+
+        //! NOTE Taken by a task, which is already running
+        flushed->compressedCv.wait(lock, [&file]() { return file.isCompressed; });
+        lock.unlock();
+
+        m_impl->zip->addCompressedFile(file.compressed);
+        file.compressed = ZipContainer::CompressedFile();
+        file.data = ByteArray();
+    }
 }
 
 void ZipWriter::close()
@@ -75,9 +214,10 @@ void ZipWriter::close()
         return;
     }
 
+    flush();
+
     m_impl->zip->close();
     if (m_device) {
-        flush();
         m_device->close();
     }
 
@@ -91,6 +231,10 @@ bool ZipWriter::hasError() const
 
 void ZipWriter::addFile(const std::string& fileName, const ByteArray& data)
 {
-    m_impl->zip->addFile(fileName, data);
-    flush();
+    m_impl->pendingFiles.emplace_back(fileName, data);
+    m_impl->pendingSize += data.size();
+
+    if (m_impl->pendingSize >= MAX_PENDING_SIZE) {
+        flush();
+    }
 }
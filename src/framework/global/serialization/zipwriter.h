@@ -34,9 +34,22 @@ public:
     explicit ZipWriter(io::IODevice* device);
     ~ZipWriter();
 
+    enum class CompressionLevel {
+        Store,
+        Fast,
+        Default
+    };
+
+    void setCompressionLevel(CompressionLevel level);
+    CompressionLevel compressionLevel() const;
+
     void close();
     bool hasError() const;
 
+    //! NOTE The files are written to the device when flushed (ex. on close), in the order they were added.
+    //! Each file is streamed to the device while it is compressed, unless a task of TaskScheduler::shared()
+    //! has already taken it, to compress it in memory while the files before it are written.
+    //! The flush never waits for a task which has not started, so it may also be done on that scheduler
     void addFile(const std::string& fileName, const ByteArray& data);
 
 private:
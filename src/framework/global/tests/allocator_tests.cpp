@@ -21,7 +21,9 @@
  */
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -78,6 +80,30 @@ DECLARE_ITEM(3)
 DECLARE_ITEM(8)
 DECLARE_ITEM(13)
 DECLARE_ITEM(131)
+DECLARE_ITEM(21)
+DECLARE_ITEM(34)
+DECLARE_ITEM(55)
+
+//! NOTE Owns other items of the same class, like a chord owns its grace chords
+class OwnerItem
+{
+    OBJECT_ALLOCATOR(test, OwnerItem)
+
+public:
+    ~OwnerItem()
+    {
+        ++destroyedCount;
+        for (OwnerItem* item : children) {
+            delete item;
+        }
+    }
+
+    std::vector<OwnerItem*> children;
+
+    static int destroyedCount;
+};
+
+int OwnerItem::destroyedCount = 0;
 }
 
 class Global_AllocatorTests : public ::testing::Test
@@ -200,3 +226,186 @@ TEST_F(Global_AllocatorTests, Many_NewCleanup)
     EXPECT_EQ(info.totalChunks, 12); // DEFAULT_BLOCK_SIZE * 3
     EXPECT_EQ(info.freeChunks, 12);
 }
+
+TEST_F(Global_AllocatorTests, Arena_ReleaseFreesBlocks)
+{
+    //! GIVEN the default size of the allocator block is less than the size of all items
+    size_t itemSize = sizeof(Item21);
+    ObjectAllocator::DEFAULT_BLOCK_SIZE = itemSize * 4;  // bytes
+
+    //! GIVEN Arena
+    std::unique_ptr<AllocatorArena> arena = std::make_unique<AllocatorArena>("test");
+
+    //! DO Create Items in the arena
+    std::vector<ItemBase*> items;
+    {
+        AllocatorArena::Scope scope(arena.get());
+        for (size_t i = 0; i < 10; ++i) {
+            items.push_back(new Item21(static_cast<uint8_t>(i)));
+        }
+    }
+
+    //! CHECK Allocator state
+    ObjectAllocator::Info info = Item21::allocator().stateInfo();
+    EXPECT_EQ(info.arenaCount, 1);
+    EXPECT_EQ(info.totalChunks, 12); // DEFAULT_BLOCK_SIZE * 3
+    EXPECT_EQ(info.freeChunks, 2);
+
+    //! DO Destroy Items and the arena
+    for (ItemBase* item : items) {
+        delete item;
+    }
+    arena.reset();
+
+    //! CHECK The blocks are released
+    info = Item21::allocator().stateInfo();
+    EXPECT_EQ(info.arenaCount, 0);
+    EXPECT_EQ(info.blockCount, 0);
+    EXPECT_EQ(info.totalChunks, 0);
+}
+
+TEST_F(Global_AllocatorTests, Arena_ReleaseKeepsLiveObjects)
+{
+    //! GIVEN the default size of the allocator block is less than the size of all items
+    size_t itemSize = sizeof(Item34);
+    ObjectAllocator::DEFAULT_BLOCK_SIZE = itemSize * 4;  // bytes
+
+    //! GIVEN Item allocated without arena
+    ItemBase* sharedItem = new Item34(1);
+
+    //! DO Create Items in the arena
+    std::unique_ptr<AllocatorArena> arena = std::make_unique<AllocatorArena>("test");
+
+    std::vector<ItemBase*> items;
+    {
+        AllocatorArena::Scope scope(arena.get());
+        for (size_t i = 0; i < 6; ++i) {
+            items.push_back(new Item34(static_cast<uint8_t>(i)));
+        }
+    }
+
+    //! DO Destroy all of them except the last one, then release the arena
+    for (size_t i = 0; i < items.size() - 1; ++i) {
+        delete items.at(i);
+    }
+    arena.reset();
+
+    //! CHECK Only the block with the live item is kept
+    ObjectAllocator::Info info = Item34::allocator().stateInfo();
+    EXPECT_EQ(info.arenaCount, 0);
+    EXPECT_EQ(info.blockCount, 2); // shared block + block of the live item
+    EXPECT_EQ(info.usedChunks(), 2);
+
+    //! CHECK The live items are intact and can be destroyed
+    EXPECT_TRUE(items.back()->alive());
+    EXPECT_TRUE(sharedItem->alive());
+    delete items.back();
+    delete sharedItem;
+
+    info = Item34::allocator().stateInfo();
+    EXPECT_EQ(info.usedChunks(), 0);
+    EXPECT_EQ(info.freeChunks, 8);
+
+    //! CHECK The freed chunks are reused
+    ItemBase* item = new Item34(2);
+    info = Item34::allocator().stateInfo();
+    EXPECT_EQ(info.totalChunks, 8);
+    delete item;
+}
+
+TEST_F(Global_AllocatorTests, Register_LiveAndPeakBytes)
+{
+    //! DO Create Items and destroy some of them
+    std::vector<ItemBase*> items;
+    for (size_t i = 0; i < 10; ++i) {
+        items.push_back(new Item55(static_cast<uint8_t>(i)));
+    }
+
+    for (size_t i = 0; i < 6; ++i) {
+        delete items.at(i);
+    }
+
+    //! CHECK Register reports live and peak bytes per class
+    std::vector<ObjectAllocator::Info> infos = AllocatorsRegister::instance()->stateInfo("test");
+    auto it = std::find_if(infos.cbegin(), infos.cend(), [](const ObjectAllocator::Info& info) {
+        return info.name == "Item55";
+    });
+
+    ASSERT_TRUE(it != infos.cend());
+    EXPECT_EQ(it->liveBytes(), 4 * it->chunkSize);
+    EXPECT_EQ(it->peakBytes(), 10 * it->chunkSize);
+
+    //! DO Reset peaks
+    AllocatorsRegister::instance()->resetPeaks();
+
+    //! CHECK
+    EXPECT_EQ(Item55::allocator().stateInfo().peakBytes(), 4 * it->chunkSize);
+
+    for (size_t i = 6; i < items.size(); ++i) {
+        delete items.at(i);
+    }
+}
+
+TEST_F(Global_AllocatorTests, Arena_Scope)
+{
+    //! GIVEN Two arenas, like two open scores
+    std::unique_ptr<AllocatorArena> arenaA = std::make_unique<AllocatorArena>("A");
+    std::unique_ptr<AllocatorArena> arenaB = std::make_unique<AllocatorArena>("B");
+
+    //! DO Nest the scopes
+    ItemBase* itemA = nullptr;
+    ItemBase* itemB = nullptr;
+    ItemBase* itemA2 = nullptr;
+    {
+        AllocatorArena::Scope scopeA(arenaA.get());
+        itemA = new Item13(1);
+        {
+            AllocatorArena::Scope scopeB(arenaB.get());
+            EXPECT_EQ(AllocatorArena::current(), arenaB.get());
+            itemB = new Item13(2);
+        }
+
+        //! CHECK The outer arena is current again
+        EXPECT_EQ(AllocatorArena::current(), arenaA.get());
+        itemA2 = new Item13(3);
+    }
+
+    EXPECT_EQ(AllocatorArena::current(), nullptr);
+    EXPECT_EQ(Item13::allocator().stateInfo().arenaCount, 2);
+
+    //! DO Release the arena B
+    delete itemB;
+    arenaB.reset();
+
+    //! CHECK The items of the arena A are intact
+    EXPECT_TRUE(itemA->alive());
+    EXPECT_TRUE(itemA2->alive());
+    EXPECT_EQ(Item13::allocator().stateInfo().arenaCount, 1);
+
+    delete itemA;
+    delete itemA2;
+    arenaA.reset();
+
+    EXPECT_EQ(Item13::allocator().stateInfo().blockCount, 0);
+}
+
+TEST_F(Global_AllocatorTests, Cleanup_DestructorDeletesItems)
+{
+    //! GIVEN An item owning other items of the same allocator, allocated after it
+    OwnerItem::destroyedCount = 0;
+
+    OwnerItem* owner = new OwnerItem();
+    for (int i = 0; i < 3; ++i) {
+        owner->children.push_back(new OwnerItem());
+    }
+
+    //! DO Allocator cleanup
+    OwnerItem::allocator().cleanup();
+
+    //! CHECK Every item is destroyed exactly once: the children by the owner, the owner by the cleanup
+    EXPECT_EQ(OwnerItem::destroyedCount, 4);
+
+    ObjectAllocator::Info info = OwnerItem::allocator().stateInfo();
+    EXPECT_EQ(info.usedChunks(), 0);
+    EXPECT_EQ(info.totalAllocatedCount, info.totalFreeCount);
+}
@@ -0,0 +1,94 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include "concurrency/taskscheduler.h"
+
+using namespace muse;
+
+class Global_Concurrency_TaskSchedulerTests : public ::testing::Test
+{
+public:
+};
+
+TEST_F(Global_Concurrency_TaskSchedulerTests, ParallelFor_VisitsEveryIndexOnce)
+{
+    // [GIVEN]
+    TaskScheduler scheduler(4);
+    std::vector<int> hits(1000, 0);
+
+    // [WHEN]
+    scheduler.parallelFor(hits.size(), [&hits](size_t index) {
+        hits[index]++;
+    });
+
+    // [THEN]
+    for (int hit : hits) {
+        EXPECT_EQ(hit, 1);
+    }
+}
+
+TEST_F(Global_Concurrency_TaskSchedulerTests, ParallelFor_RepeatedBatches)
+{
+    // [GIVEN]
+    TaskScheduler scheduler(4);
+    std::atomic<size_t> total = 0;
+
+    // [WHEN] Running many small batches in a row, like the mixer does on every audio block
+    for (size_t batch = 0; batch < 500; ++batch) {
+        scheduler.parallelFor(batch % 9, [&total](size_t index) {
+            total += index + 1;
+        });
+    }
+
+    // [THEN] Every batch has been fully processed before the next one started
+    size_t expected = 0;
+    for (size_t batch = 0; batch < 500; ++batch) {
+        size_t count = batch % 9;
+        expected += count * (count + 1) / 2;
+    }
+
+    EXPECT_EQ(total, expected);
+}
+
+TEST_F(Global_Concurrency_TaskSchedulerTests, ParallelFor_MixedWithSubmit)
+{
+    // [GIVEN]
+    TaskScheduler scheduler(2);
+
+    // [WHEN]
+    std::future<int> future = scheduler.submit([]() { return 42; });
+
+    std::vector<int> values(16, 0);
+    scheduler.parallelFor(values.size(), [&values](size_t index) {
+        values[index] = static_cast<int>(index);
+    });
+
+    // [THEN]
+    EXPECT_EQ(future.get(), 42);
+    for (size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(values[i], static_cast<int>(i));
+    }
+}
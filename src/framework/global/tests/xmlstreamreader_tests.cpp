@@ -0,0 +1,348 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "io/buffer.h"
+#include "serialization/xmlstreamreader.h"
+#include "types/bytearray.h"
+
+using namespace muse;
+using namespace muse::io;
+
+class Global_Serialization_XmlStreamReaderTests : public ::testing::Test
+{
+public:
+    static ByteArray toByteArray(const std::string& str)
+    {
+        return ByteArray(str.c_str(), str.size());
+    }
+
+    static std::string tokenString(const XmlStreamReader& xml)
+    {
+        std::string str = std::string(xml.tokenString().ascii()) + ":" + std::to_string(xml.lineNumber()) + ":";
+        if (xml.isStartElement() || xml.isEndElement()) {
+            str += xml.name().ascii();
+        } else {
+            str += xml.text().toStdString();
+        }
+
+        for (const XmlStreamReader::Attribute& a : xml.attributes()) {
+            str += std::string(" ") + a.name.ascii() + "=" + a.value.toStdString();
+        }
+        return str;
+    }
+};
+
+TEST_F(Global_Serialization_XmlStreamReaderTests, Tokens)
+{
+    //! GIVEN A document with all kinds of tokens
+    ByteArray data = toByteArray(
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<museScore version=\"4.20\">\n"
+        "  <!-- comment -->\n"
+        "  <Part id=\"1\"><trackName>Flute &amp; Piccolo</trackName><empty/><![CDATA[<raw>]]></Part>\n"
+        "</museScore>\n");
+
+    XmlStreamReader xml(data);
+
+    //! DO Read all the tokens
+    std::vector<XmlStreamReader::TokenType> tokens;
+    std::vector<std::string> values;
+    while (xml.readNext() != XmlStreamReader::Invalid) {
+        tokens.push_back(xml.tokenType());
+        if (xml.isStartElement() || xml.isEndElement()) {
+            values.push_back(xml.name().ascii());
+        } else {
+            values.push_back(xml.text().toStdString());
+        }
+
+        if (xml.isEndDocument()) {
+            break;
+        }
+    }
+
+    //! CHECK The tokens are the expected ones
+    EXPECT_FALSE(xml.isError());
+
+    std::vector<XmlStreamReader::TokenType> expectedTokens = {
+        XmlStreamReader::StartDocument,
+        XmlStreamReader::StartElement,
+        XmlStreamReader::Comment,
+        XmlStreamReader::StartElement,
+        XmlStreamReader::StartElement,
+        XmlStreamReader::Characters,
+        XmlStreamReader::EndElement,
+        XmlStreamReader::StartElement,
+        XmlStreamReader::EndElement,
+        XmlStreamReader::Characters,
+        XmlStreamReader::EndElement,
+        XmlStreamReader::EndElement,
+        XmlStreamReader::EndDocument,
+    };
+    EXPECT_EQ(tokens, expectedTokens);
+
+    std::vector<std::string> expectedValues = {
+        "", "museScore", " comment ", "Part", "trackName", "Flute & Piccolo", "trackName", "empty", "empty", "<raw>", "Part",
+        "museScore", ""
+    };
+    EXPECT_EQ(values, expectedValues);
+}
+
+TEST_F(Global_Serialization_XmlStreamReaderTests, Attributes)
+{
+    //! GIVEN An element with plain and escaped attribute values
+    ByteArray data = toByteArray("<Note pitch=\"60\" tpc='14' name=\"a &lt;b&gt; &#x41;\" ratio=\"0.5\"/>");
+
+    XmlStreamReader xml(data);
+
+    //! DO Read the element
+    ASSERT_TRUE(xml.readNextStartElement());
+
+    //! CHECK The values are decoded
+    EXPECT_EQ(xml.name(), "Note");
+    EXPECT_TRUE(xml.hasAttribute("pitch"));
+    EXPECT_FALSE(xml.hasAttribute("velocity"));
+    EXPECT_EQ(xml.intAttribute("pitch"), 60);
+    EXPECT_EQ(xml.intAttribute("tpc"), 14);
+    EXPECT_EQ(xml.intAttribute("velocity", 80), 80);
+    EXPECT_DOUBLE_EQ(xml.doubleAttribute("ratio"), 0.5);
+    EXPECT_EQ(xml.attribute("name"), u"a <b> A");
+    EXPECT_EQ(xml.asciiAttribute("pitch"), "60");
+
+    std::vector<XmlStreamReader::Attribute> attributes = xml.attributes();
+    ASSERT_EQ(attributes.size(), 4);
+    EXPECT_EQ(attributes.at(0).name, "pitch");
+    EXPECT_EQ(attributes.at(3).value, u"0.5");
+
+    //! CHECK The views stay valid while reading on
+    AsciiStringView pitch = xml.asciiAttribute("pitch");
+    xml.skipCurrentElement();
+    EXPECT_EQ(pitch, "60");
+}
+
+TEST_F(Global_Serialization_XmlStreamReaderTests, EmptyElementFollowedByComment)
+{
+    //! GIVEN An empty element followed by a comment
+    ByteArray data = toByteArray("<Channel><program value=\"73\"/> <!--Flute--><controller ctrl=\"7\"/></Channel>");
+
+    XmlStreamReader xml(data);
+
+    //! DO Read the elements
+    ASSERT_TRUE(xml.readNextStartElement());
+    EXPECT_EQ(xml.name(), "Channel");
+
+    ASSERT_TRUE(xml.readNextStartElement());
+    EXPECT_EQ(xml.name(), "program");
+    xml.skipCurrentElement();
+
+    //! CHECK The next sibling is still read as a child of Channel
+    ASSERT_TRUE(xml.readNextStartElement());
+    EXPECT_EQ(xml.name(), "controller");
+    xml.skipCurrentElement();
+
+    EXPECT_FALSE(xml.readNextStartElement());
+    EXPECT_EQ(xml.name(), "Channel");
+    EXPECT_FALSE(xml.isError());
+}
+
+TEST_F(Global_Serialization_XmlStreamReaderTests, Entities)
+{
+    //! GIVEN A document that declares entities in the DOCTYPE, with comments in the internal subset
+    ByteArray data = toByteArray(
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<!DOCTYPE museScore [\n"
+        "  <!-- don't break on the apostrophe -->\n"
+        "  <!ENTITY maj \"ma\">\n"
+        "  <!-- <!ENTITY min \"commented out\"> -->\n"
+        "]>\n"
+        "<museScore><name>&maj;7</name><name>&min;</name></museScore>\n");
+
+    XmlStreamReader xml(data);
+
+    //! DO Read the texts
+    ASSERT_TRUE(xml.readNextStartElement());
+    ASSERT_TRUE(xml.readNextStartElement());
+    String first = xml.readText();
+    ASSERT_TRUE(xml.readNextStartElement());
+    String second = xml.readText();
+
+    //! CHECK Only the declared entity is replaced
+    EXPECT_FALSE(xml.isError());
+    EXPECT_EQ(first, u"ma7");
+    EXPECT_EQ(second, u"&min;");
+}
+
+TEST_F(Global_Serialization_XmlStreamReaderTests, ChunkedDevice)
+{
+    //! GIVEN A document much bigger than a read chunk, with Windows line endings
+    constexpr int COUNT = 20000;
+    std::string str = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\r\n<Staff>\r\n";
+    for (int i = 0; i < COUNT; ++i) {
+        str += "  <Chord n=\"" + std::to_string(i) + "\"><text>line " + std::to_string(i) + "\r\nnext</text></Chord>\r\n";
+    }
+    str += "</Staff>\r\n";
+
+    ByteArray data = toByteArray(str);
+    Buffer buf(&data);
+    buf.open(IODevice::ReadOnly);
+
+    XmlStreamReader xml(&buf);
+
+    //! DO Read the document from the device
+    ASSERT_TRUE(xml.readNextStartElement());
+    EXPECT_EQ(xml.name(), "Staff");
+
+    int count = 0;
+    bool valid = true;
+    while (xml.readNextStartElement()) {
+        valid = valid && xml.name() == "Chord" && xml.intAttribute("n") == count;
+
+        while (xml.readNextStartElement()) {
+            String expected = u"line " + String::number(count) + u"\nnext";
+            valid = valid && xml.readText() == expected;
+        }
+
+        ++count;
+    }
+
+    //! CHECK All the elements are read and the line endings are normalized
+    EXPECT_FALSE(xml.isError());
+    EXPECT_TRUE(valid);
+    EXPECT_EQ(count, COUNT);
+    EXPECT_EQ(xml.lineNumber(), 2 * COUNT + 3);
+}
+
+TEST_F(Global_Serialization_XmlStreamReaderTests, Replay)
+{
+    //! GIVEN A document read while recording the tokens, partly skipped
+    ByteArray data = toByteArray(
+        "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+        "<!DOCTYPE museScore [ <!ENTITY maj \"ma\"> ]>\n"
+        "<museScore version=\"4.20\">\n"
+        "  <Part id=\"1\" name=\"a &amp; b\"><trackName>&maj;7</trackName><empty/></Part>\n"
+        "  <Part id=\"2\"/>\n"
+        "</museScore>\n");
+
+    std::vector<std::string> expected;
+    std::shared_ptr<const XmlStreamReader::Recording> recording;
+    {
+        XmlStreamReader xml(data);
+        xml.startRecording();
+
+        ASSERT_TRUE(xml.readNextStartElement());
+        ASSERT_TRUE(xml.readNextStartElement());
+        xml.skipCurrentElement();
+
+        recording = xml.takeRecording();
+        EXPECT_TRUE(xml.atEnd());
+
+        XmlStreamReader plain(data);
+        while (plain.readNext() != XmlStreamReader::Invalid) {
+            expected.push_back(tokenString(plain));
+        }
+    }
+
+    ASSERT_TRUE(recording);
+
+    //! DO Replay the tokens, after the recording reader is gone
+    XmlStreamReader xml;
+    xml.replay(recording);
+
+    std::vector<std::string> replayed;
+    while (xml.readNext() != XmlStreamReader::Invalid) {
+        replayed.push_back(tokenString(xml));
+    }
+
+    //! CHECK The same tokens are read
+    EXPECT_FALSE(xml.isError());
+    EXPECT_EQ(replayed, expected);
+
+    //! CHECK Nothing is recorded from a broken document
+    XmlStreamReader broken(toByteArray("<museScore><Part></museScore>"));
+    broken.startRecording();
+    EXPECT_FALSE(broken.takeRecording());
+}
+
+TEST_F(Global_Serialization_XmlStreamReaderTests, Errors)
+{
+    //! GIVEN Broken documents
+    struct Case {
+        std::string data;
+        XmlStreamReader::Error error;
+    };
+
+    std::vector<Case> cases = {
+        { "", XmlStreamReader::NotWellFormedError },
+        { "<museScore><Part></museScore>", XmlStreamReader::NotWellFormedError },
+        { "<museScore><Part>", XmlStreamReader::PrematureEndOfDocumentError },
+        { "<museScore a=\"1\" a=\"2\"/>", XmlStreamReader::NotWellFormedError },
+        { "<museScore><!-- not closed", XmlStreamReader::PrematureEndOfDocumentError },
+    };
+
+    for (const Case& c : cases) {
+        //! DO Read them to the end
+        XmlStreamReader xml(toByteArray(c.data));
+        while (xml.readNext() != XmlStreamReader::Invalid) {
+        }
+
+        //! CHECK The error is reported
+        EXPECT_TRUE(xml.isError()) << c.data;
+        EXPECT_EQ(xml.error(), c.error) << c.data;
+    }
+}
+
+TEST_F(Global_Serialization_XmlStreamReaderTests, ReadTextOfBrokenDocument)
+{
+    //! GIVEN A truncated document and a document with a mismatched tag
+    XmlStreamReader truncated(toByteArray("<?xml version=\"1.0\"?>\n<a><b>text"));
+    XmlStreamReader mismatched(toByteArray("<a><b>t</c></a>"));
+    XmlStreamReader truncatedNumber(toByteArray("<a><b>12"));
+
+    //! DO Read the text of <b>
+    ASSERT_TRUE(truncated.readNextStartElement());
+    ASSERT_TRUE(truncated.readNextStartElement());
+    String text = truncated.readText();
+
+    ASSERT_TRUE(mismatched.readNextStartElement());
+    ASSERT_TRUE(mismatched.readNextStartElement());
+    AsciiStringView asciiText = mismatched.readAsciiText();
+
+    ASSERT_TRUE(truncatedNumber.readNextStartElement());
+    ASSERT_TRUE(truncatedNumber.readNextStartElement());
+    truncatedNumber.readInt();
+
+    //! CHECK The reading stops and the error is reported
+    EXPECT_TRUE(text.empty());
+    EXPECT_TRUE(truncated.isError());
+    EXPECT_EQ(truncated.error(), XmlStreamReader::PrematureEndOfDocumentError);
+
+    EXPECT_EQ(asciiText, "t");
+    EXPECT_TRUE(mismatched.isError());
+    EXPECT_EQ(mismatched.error(), XmlStreamReader::NotWellFormedError);
+
+    EXPECT_TRUE(truncatedNumber.isError());
+    EXPECT_FALSE(truncatedNumber.readNextStartElement());
+}
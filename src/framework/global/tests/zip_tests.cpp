@@ -0,0 +1,200 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "concurrency/taskscheduler.h"
+#include "io/buffer.h"
+#include "serialization/zipreader.h"
+#include "serialization/zipwriter.h"
+#include "types/bytearray.h"
+
+using namespace muse;
+using namespace muse::io;
+
+class Global_Serialization_ZipTests : public ::testing::Test
+{
+public:
+    static ByteArray makeFileData(size_t index)
+    {
+        std::string data;
+        for (size_t i = 0; i < 2000; ++i) {
+            data += "<Measure file=\"" + std::to_string(index) + "\" n=\"" + std::to_string(i) + "\"/>\n";
+        }
+
+        return ByteArray(data.c_str(), data.size());
+    }
+
+    static std::string fileName(size_t index)
+    {
+        return "Excerpts/part" + std::to_string(index) + ".mscx";
+    }
+
+    static ByteArray makeZip(size_t fileCount, ZipWriter::CompressionLevel level = ZipWriter::CompressionLevel::Default)
+    {
+        ByteArray zipData;
+        Buffer buf(&zipData);
+        buf.open(IODevice::WriteOnly);
+
+        ZipWriter writer(&buf);
+        writer.setCompressionLevel(level);
+        for (size_t i = 0; i < fileCount; ++i) {
+            writer.addFile(fileName(i), makeFileData(i));
+        }
+        writer.close();
+
+        return zipData;
+    }
+};
+
+TEST_F(Global_Serialization_ZipTests, ConcurrentFileData)
+{
+    //! GIVEN A zip with several compressed files
+    constexpr size_t FILE_COUNT = 16;
+    ByteArray zipData = makeZip(FILE_COUNT);
+
+    Buffer buf(&zipData);
+    buf.open(IODevice::ReadOnly);
+    ZipReader reader(&buf);
+
+    //! DO Read all the files from several threads at once
+    constexpr size_t THREAD_COUNT = 4;
+    std::vector<std::vector<ByteArray> > result(THREAD_COUNT, std::vector<ByteArray>(FILE_COUNT));
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREAD_COUNT; ++t) {
+        threads.emplace_back([&reader, &result, t]() {
+            for (size_t i = 0; i < FILE_COUNT; ++i) {
+                size_t fileIdx = (i + t) % FILE_COUNT;
+                result[t][fileIdx] = reader.fileData(fileName(fileIdx));
+            }
+        });
+    }
+
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    //! CHECK Every file is read completely and correctly by every thread
+    EXPECT_FALSE(reader.hasError());
+    for (size_t t = 0; t < THREAD_COUNT; ++t) {
+        for (size_t i = 0; i < FILE_COUNT; ++i) {
+            EXPECT_EQ(result[t][i], makeFileData(i)) << fileName(i);
+        }
+    }
+}
+
+TEST_F(Global_Serialization_ZipTests, CompressionLevels)
+{
+    //! GIVEN Zips of the same files, written with every compression level
+    constexpr size_t FILE_COUNT = 8;
+    ByteArray storedZip = makeZip(FILE_COUNT, ZipWriter::CompressionLevel::Store);
+    ByteArray fastZip = makeZip(FILE_COUNT, ZipWriter::CompressionLevel::Fast);
+    ByteArray defaultZip = makeZip(FILE_COUNT, ZipWriter::CompressionLevel::Default);
+
+    //! CHECK The more the files are compressed, the smaller the zip is
+    EXPECT_GT(storedZip.size(), fastZip.size());
+    EXPECT_GE(fastZip.size(), defaultZip.size());
+
+    //! CHECK All the files are read back correctly
+    for (ByteArray* zipData : { &storedZip, &fastZip, &defaultZip }) {
+        Buffer buf(zipData);
+        buf.open(IODevice::ReadOnly);
+        ZipReader reader(&buf);
+
+        std::vector<ZipReader::FileInfo> files = reader.fileInfoList();
+        ASSERT_EQ(files.size(), FILE_COUNT);
+        for (size_t i = 0; i < FILE_COUNT; ++i) {
+            EXPECT_EQ(files.at(i).filePath, fileName(i));
+            EXPECT_EQ(reader.fileData(fileName(i)), makeFileData(i)) << fileName(i);
+        }
+
+        EXPECT_FALSE(reader.hasError());
+    }
+}
+
+TEST_F(Global_Serialization_ZipTests, StreamedFile)
+{
+    //! GIVEN A file, which compressed data is much bigger than a chunk
+    std::string str;
+    uint32_t seed = 1;
+    for (size_t i = 0; i < 512 * 1024; ++i) {
+        seed = seed * 1103515245 + 12345;
+        str += static_cast<char>('a' + (seed >> 16) % 26);
+    }
+    ByteArray fileData(str.c_str(), str.size());
+
+    //! DO Write it alone, so that it is compressed while it is written
+    ByteArray zipData;
+    {
+        Buffer buf(&zipData);
+        buf.open(IODevice::WriteOnly);
+
+        ZipWriter writer(&buf);
+        writer.addFile("audio.ogg", fileData);
+        writer.close();
+        EXPECT_FALSE(writer.hasError());
+    }
+
+    //! CHECK The file is read back correctly
+    Buffer buf(&zipData);
+    buf.open(IODevice::ReadOnly);
+    ZipReader reader(&buf);
+
+    EXPECT_EQ(reader.fileData("audio.ogg"), fileData);
+    EXPECT_FALSE(reader.hasError());
+}
+
+TEST_F(Global_Serialization_ZipTests, WriteOnSharedScheduler)
+{
+    //! GIVEN As many zips to write as there are threads in the shared scheduler
+    TaskScheduler& scheduler = TaskScheduler::shared();
+    const size_t zipCount = scheduler.threadPoolSize();
+    constexpr size_t FILE_COUNT = 8;
+
+    //! DO Write them all from tasks of the shared scheduler, so that no thread is left to compress
+    std::vector<std::future<ByteArray> > zips;
+    for (size_t i = 0; i < zipCount; ++i) {
+        zips.push_back(scheduler.submit([]() {
+            return makeZip(FILE_COUNT);
+        }));
+    }
+
+    //! CHECK The writers don't wait for each other's compressing tasks, all the files are read back correctly
+    for (std::future<ByteArray>& zip : zips) {
+        ASSERT_EQ(zip.wait_for(std::chrono::seconds(30)), std::future_status::ready);
+
+        ByteArray zipData = zip.get();
+        Buffer buf(&zipData);
+        buf.open(IODevice::ReadOnly);
+        ZipReader reader(&buf);
+
+        for (size_t i = 0; i < FILE_COUNT; ++i) {
+            EXPECT_EQ(reader.fileData(fileName(i)), makeFileData(i)) << fileName(i);
+        }
+        EXPECT_FALSE(reader.hasError());
+    }
+}
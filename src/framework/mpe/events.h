@@ -47,7 +47,8 @@ using PlaybackParamList = std::vector<PlaybackParam>;
 using PlaybackParamMap = std::map<timestamp_t, PlaybackParamList>;
 using PlaybackParamLayers = std::map<layer_idx_t, PlaybackParamMap>;
 
-using MainStreamChanges = async::Channel<PlaybackEventsMap, DynamicLevelLayers, PlaybackParamLayers>;
+struct PlaybackEventsChanges;
+using MainStreamChanges = async::Channel<PlaybackEventsChanges, DynamicLevelLayers, PlaybackParamLayers>;
 using OffStreamChanges = async::Channel<PlaybackEventsMap, PlaybackParamList>;
 
 struct ArrangementContext
@@ -315,6 +316,64 @@ struct PlaybackParam {
     }
 };
 
+//! NOTE The changes of the main stream events: the events within the removed ranges are dropped,
+//! then the inserted events are appended to the remaining ones. A full update replaces all the events
+struct PlaybackEventsChanges {
+    struct Range {
+        timestamp_t from = 0;
+        timestamp_t to = 0;
+
+        bool contains(const timestamp_t timestamp) const
+        {
+            return timestamp >= from && timestamp <= to;
+        }
+    };
+
+    std::vector<Range> removedRanges;
+    PlaybackEventsMap insertedEvents;
+    bool fullUpdate = false;
+
+    static PlaybackEventsChanges makeFullUpdate(const PlaybackEventsMap& events)
+    {
+        PlaybackEventsChanges result;
+        result.insertedEvents = events;
+        result.fullUpdate = true;
+        return result;
+    }
+
+    bool isRemoved(const timestamp_t timestamp) const
+    {
+        if (fullUpdate) {
+            return true;
+        }
+
+        for (const Range& range : removedRanges) {
+            if (range.contains(timestamp)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void applyTo(PlaybackEventsMap& events) const
+    {
+        if (fullUpdate) {
+            events = insertedEvents;
+            return;
+        }
+
+        for (const Range& range : removedRanges) {
+            events.erase(events.lower_bound(range.from), events.upper_bound(range.to));
+        }
+
+        for (const auto& pair : insertedEvents) {
+            PlaybackEventList& list = events[pair.first];
+            list.insert(list.end(), pair.second.cbegin(), pair.second.cend());
+        }
+    }
+};
+
 struct PlaybackData {
     PlaybackEventsMap originEvents;
     PlaybackSetupData setupData;
@@ -109,12 +109,10 @@ samples_t MuseSamplerWrapper::process(float* buffer, samples_t samplesPerChannel
 
     if (!active) {
         msecs_t nextMicros = samplesToMsecs(samplesPerChannel, m_sampleRate);
-        MuseSamplerSequencer::EventSequenceMap sequences = m_sequencer.movePlaybackForward(nextMicros);
+        m_sequencer.movePlaybackForward(nextMicros, m_eventBlock);
 
-        for (const auto& pair : sequences) {
-            for (const MuseSamplerSequencer::EventType& event : pair.second) {
-                handleAuditionEvents(event);
-            }
+        for (const MuseSamplerSequencer::EventType* event : m_eventBlock.events) {
+            handleAuditionEvents(*event);
         }
     }
 
@@ -100,6 +100,7 @@ private:
     bool m_allNotesOffRequested = false;
 
     MuseSamplerSequencer m_sequencer;
+    MuseSamplerSequencer::EventBlock m_eventBlock;
 };
 
 using MuseSamplerWrapperPtr = std::shared_ptr<MuseSamplerWrapper>;
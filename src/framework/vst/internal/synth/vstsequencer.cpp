@@ -60,8 +60,9 @@ void VstSequencer::updateOffStreamEvents(const mpe::PlaybackEventsMap& events, c
         m_onOffStreamFlushed();
     }
 
-    updatePlaybackEvents(m_offStreamEvents, events);
-    updateOffSequenceIterator();
+    EventSequenceMap offStreamEvents;
+    updatePlaybackEvents(offStreamEvents, events);
+    setOffStreamEvents(offStreamEvents);
 }
 
 void VstSequencer::updateMainStreamEvents(const mpe::PlaybackEventsMap& events, const mpe::DynamicLevelLayers& dynamics,
@@ -78,15 +79,33 @@ void VstSequencer::updateMainStreamEvents(const mpe::PlaybackEventsMap& events,
         m_onMainStreamFlushed();
     }
 
-    updatePlaybackEvents(m_mainStreamEvents, events);
-    updateMainSequenceIterator();
+    setMainStreamEvents(events);
 
     if (m_useDynamicEvents) {
-        updateDynamicEvents(m_dynamicEvents, dynamics);
-        updateDynamicChangesIterator();
+        EventSequenceMap dynamicEvents;
+        updateDynamicEvents(dynamicEvents, dynamics);
+        setDynamicEvents(dynamicEvents);
     }
 }
 
+bool VstSequencer::applyMainStreamChanges(const mpe::PlaybackEventsChanges& changes, const mpe::DynamicLevelLayers& dynamics,
+                                          const mpe::PlaybackParamLayers&)
+{
+    if (!m_inited) {
+        return true;
+    }
+
+    spliceMainStreamEvents(changes);
+
+    if (m_useDynamicEvents) {
+        EventSequenceMap dynamicEvents;
+        updateDynamicEvents(dynamicEvents, dynamics);
+        setDynamicEvents(dynamicEvents);
+    }
+
+    return true;
+}
+
 muse::audio::gain_t VstSequencer::currentGain() const
 {
     if (m_useDynamicEvents) {
@@ -100,26 +119,31 @@ muse::audio::gain_t VstSequencer::currentGain() const
 void VstSequencer::updatePlaybackEvents(EventSequenceMap& destination, const mpe::PlaybackEventsMap& events)
 {
     for (const auto& pair : events) {
-        for (const mpe::PlaybackEvent& event : pair.second) {
-            if (!std::holds_alternative<mpe::NoteEvent>(event)) {
-                continue;
-            }
+        appendPlaybackEvents(destination, pair.second);
+    }
+}
 
-            const mpe::NoteEvent& noteEvent = std::get<mpe::NoteEvent>(event);
+void VstSequencer::appendPlaybackEvents(EventSequenceMap& destination, const mpe::PlaybackEventList& events)
+{
+    for (const mpe::PlaybackEvent& event : events) {
+        if (!std::holds_alternative<mpe::NoteEvent>(event)) {
+            continue;
+        }
 
-            mpe::timestamp_t timestampFrom = noteEvent.arrangementCtx().actualTimestamp;
-            mpe::timestamp_t timestampTo = timestampFrom + noteEvent.arrangementCtx().actualDuration;
+        const mpe::NoteEvent& noteEvent = std::get<mpe::NoteEvent>(event);
 
-            int32_t noteId = noteIndex(noteEvent.pitchCtx().nominalPitchLevel);
-            float velocityFraction = noteVelocityFraction(noteEvent);
-            float tuning = noteTuning(noteEvent, noteId);
+        mpe::timestamp_t timestampFrom = noteEvent.arrangementCtx().actualTimestamp;
+        mpe::timestamp_t timestampTo = timestampFrom + noteEvent.arrangementCtx().actualDuration;
 
-            destination[timestampFrom].emplace(buildEvent(VstEvent::kNoteOnEvent, noteId, velocityFraction, tuning));
-            destination[timestampTo].emplace(buildEvent(VstEvent::kNoteOffEvent, noteId, velocityFraction, tuning));
+        int32_t noteId = noteIndex(noteEvent.pitchCtx().nominalPitchLevel);
+        float velocityFraction = noteVelocityFraction(noteEvent);
+        float tuning = noteTuning(noteEvent, noteId);
 
-            appendControlSwitch(destination, noteEvent, PEDAL_CC_SUPPORTED_TYPES, SUSTAIN_IDX);
-            appendPitchBend(destination, noteEvent, BEND_SUPPORTED_TYPES);
-        }
+        destination[timestampFrom].emplace(buildEvent(VstEvent::kNoteOnEvent, noteId, velocityFraction, tuning));
+        destination[timestampTo].emplace(buildEvent(VstEvent::kNoteOffEvent, noteId, velocityFraction, tuning));
+
+        appendControlSwitch(destination, noteEvent, PEDAL_CC_SUPPORTED_TYPES, SUSTAIN_IDX);
+        appendPitchBend(destination, noteEvent, BEND_SUPPORTED_TYPES);
     }
 }
 
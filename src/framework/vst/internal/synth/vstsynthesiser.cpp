@@ -204,16 +204,17 @@ samples_t VstSynthesiser::process(float* buffer, samples_t samplesPerChannel)
     }
 
     const msecs_t nextMsecs = samplesToMsecs(samplesPerChannel, m_sampleRate);
-    const VstSequencer::EventSequenceMap sequences = m_sequencer.movePlaybackForward(nextMsecs);
+    m_sequencer.movePlaybackForward(nextMsecs, m_eventBlock);
     samples_t sampleOffset = 0;
     samples_t processedSamples = 0;
 
-    for (auto it = sequences.cbegin(); it != sequences.cend(); ++it) {
+    const auto& sequences = m_eventBlock.sequences;
+
+    for (size_t i = 0; i < sequences.size(); ++i) {
         samples_t durationInSamples = samplesPerChannel - sampleOffset;
 
-        auto nextIt = std::next(it);
-        if (nextIt != sequences.cend()) {
-            msecs_t duration = nextIt->first - it->first;
+        if (i + 1 < sequences.size()) {
+            msecs_t duration = sequences[i + 1].timestamp - sequences[i].timestamp;
             durationInSamples = microSecsToSamples(duration, m_sampleRate);
         }
 
@@ -221,16 +222,17 @@ samples_t VstSynthesiser::process(float* buffer, samples_t samplesPerChannel)
             break;
         }
 
-        processedSamples += processSequence(it->second, durationInSamples, buffer + sampleOffset * m_audioChannelsCount);
+        processedSamples += processSequence(sequences[i], durationInSamples, buffer + sampleOffset * m_audioChannelsCount);
         sampleOffset += durationInSamples;
     }
 
     return processedSamples;
 }
 
-samples_t VstSynthesiser::processSequence(const VstSequencer::EventSequence& sequence, const samples_t samples, float* buffer)
+samples_t VstSynthesiser::processSequence(const VstSequencer::EventBlock::Sequence& sequence, const samples_t samples, float* buffer)
 {
-    for (const VstSequencer::EventType& event : sequence) {
+    for (size_t i = 0; i < sequence.eventCount; ++i) {
+        const VstSequencer::EventType& event = m_eventBlock.event(sequence, i);
         if (std::holds_alternative<VstEvent>(event)) {
             m_vstAudioClient->handleEvent(std::get<VstEvent>(event));
         } else if (std::holds_alternative<ParamChangeEvent>(event)) {
@@ -75,7 +75,7 @@ public:
 
 private:
     void toggleVolumeGain(const bool isActive);
-    audio::samples_t processSequence(const VstSequencer::EventSequence& sequence, const audio::samples_t samples, float* buffer);
+    audio::samples_t processSequence(const VstSequencer::EventBlock::Sequence& sequence, const audio::samples_t samples, float* buffer);
 
     VstPluginPtr m_pluginPtr = nullptr;
     std::unique_ptr<VstAudioClient> m_vstAudioClient = nullptr;
@@ -84,6 +84,7 @@ private:
     async::Channel<unsigned int> m_streamsCountChanged;
 
     VstSequencer m_sequencer;
+    VstSequencer::EventBlock m_eventBlock;
 
     muse::audio::TrackId m_trackId = muse::audio::INVALID_TRACK_ID;
 
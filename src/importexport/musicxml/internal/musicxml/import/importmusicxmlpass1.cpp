@@ -1242,11 +1242,14 @@ Err MusicXmlParserPass1::parse(const ByteArray& data)
     m_logger->logDebugTrace(u"MusicXmlParserPass1::parse device");
     m_parts.clear();
     m_e.setData(data);
+    m_e.startRecording();
     Err res = parse();
     if (res != Err::NoError) {
         return res;
     }
 
+    m_tokens = m_e.takeRecording();
+
     // Determine the start tick of each measure in the part
     determineMeasureLength(m_measureLength);
     determineMeasureStart(m_measureLength, m_measureStart);
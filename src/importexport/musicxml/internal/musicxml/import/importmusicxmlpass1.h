@@ -140,6 +140,7 @@ public:
     engraving::Err parse(const muse::ByteArray& data);
     engraving::Err parse();
     muse::String errors() const { return m_errors; }
+    std::shared_ptr<const muse::XmlStreamReader::Recording> takeTokens() { return std::move(m_tokens); }
     void scorePartwise();
     void identification();
     void credit(CreditWordsList& credits);
@@ -221,6 +222,7 @@ private:
 
     // generic pass 1 data
     muse::XmlStreamReader m_e;
+    std::shared_ptr<const muse::XmlStreamReader::Recording> m_tokens;   // The tokens read, replayed by pass 2
     MusicXmlExporterSoftware m_exporterSoftware = MusicXmlExporterSoftware::OTHER;   // Software which exported the file
     int m_divs = 0;                              // Current MusicXML divisions value
     std::map<muse::String, MusicXmlPart> m_parts;      // Parts data, mapped on part id
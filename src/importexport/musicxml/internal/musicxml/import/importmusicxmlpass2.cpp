@@ -1874,7 +1874,13 @@ void MusicXmlParserPass2::skipLogCurrElem()
 Err MusicXmlParserPass2::parse(const ByteArray& data)
 {
     //LOGD("MusicXmlParserPass2::parse()");
-    m_e.setData(data);
+    // the document is tokenized only once, by pass 1
+    std::shared_ptr<const XmlStreamReader::Recording> tokens = m_pass1.takeTokens();
+    if (tokens) {
+        m_e.replay(tokens);
+    } else {
+        m_e.setData(data);
+    }
     Err res = parse();
     //LOGD("MusicXmlParserPass2::parse() res %d", int(res));
     return res;
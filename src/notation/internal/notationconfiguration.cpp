@@ -71,6 +71,7 @@ static const Settings::Key TOOLBAR_KEY(module_name, "ui/toolbar/");
 
 static const Settings::Key IS_CANVAS_ORIENTATION_VERTICAL_KEY(module_name, "ui/canvas/scroll/verticalOrientation");
 static const Settings::Key IS_LIMIT_CANVAS_SCROLL_AREA_KEY(module_name, "ui/canvas/scroll/limitScrollArea");
+static const Settings::Key IS_CANVAS_TILE_CACHE_ENABLED_KEY(module_name, "ui/canvas/tileCacheEnabled");
 
 static const Settings::Key COLOR_NOTES_OUTSIDE_OF_USABLE_PITCH_RANGE(module_name, "score/note/warnPitchRange");
 static const Settings::Key WARN_GUITAR_BENDS(module_name, "score/note/warnGuitarBends");
@@ -192,6 +193,8 @@ void NotationConfiguration::init()
         m_isLimitCanvasScrollAreaChanged.notify();
     });
 
+    settings()->setDefaultValue(IS_CANVAS_TILE_CACHE_ENABLED_KEY, Val(true));
+
     settings()->setDefaultValue(COLOR_NOTES_OUTSIDE_OF_USABLE_PITCH_RANGE, Val(true));
     settings()->setDefaultValue(WARN_GUITAR_BENDS, Val(true));
     settings()->setDefaultValue(REALTIME_DELAY, Val(750));
@@ -700,6 +703,16 @@ Notification NotationConfiguration::isLimitCanvasScrollAreaChanged() const
     return m_isLimitCanvasScrollAreaChanged;
 }
 
+bool NotationConfiguration::isCanvasTileCacheEnabled() const
+{
+    return settings()->value(IS_CANVAS_TILE_CACHE_ENABLED_KEY).toBool();
+}
+
+void NotationConfiguration::setIsCanvasTileCacheEnabled(bool enabled)
+{
+    settings()->setSharedValue(IS_CANVAS_TILE_CACHE_ENABLED_KEY, Val(enabled));
+}
+
 bool NotationConfiguration::colorNotesOutsideOfUsablePitchRange() const
 {
     return settings()->value(COLOR_NOTES_OUTSIDE_OF_USABLE_PITCH_RANGE).toBool();
@@ -127,6 +127,7 @@ void NotationUndoStack::commitChanges()
 
     score()->endCmd();
 
+    registerHistoryMetrics();
     notifyAboutStateChanged();
 }
 
@@ -210,3 +211,16 @@ void NotationUndoStack::notifyAboutRedo()
 {
     m_redoNotification.notify();
 }
+
+void NotationUndoStack::registerHistoryMetrics()
+{
+    if (!metricsRegister() || !undoStack()) {
+        return;
+    }
+
+    const mu::engraving::UndoStack::HistoryStats stats = undoStack()->historyStats();
+    metricsRegister()->reg("Undo history: size", static_cast<double>(stats.bytes) / (1024.0 * 1024.0), "MB");
+    metricsRegister()->reg("Undo history: undo steps", static_cast<double>(stats.macroCount), "steps");
+    metricsRegister()->reg("Undo history: compacted undo steps", static_cast<double>(stats.compactedMacroCount), "steps");
+    metricsRegister()->reg("Undo history: coalesced commands", static_cast<double>(stats.compactedCommandCount), "commands");
+}
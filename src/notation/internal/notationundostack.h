@@ -23,6 +23,9 @@
 #ifndef MU_NOTATION_UNDOSTACK
 #define MU_NOTATION_UNDOSTACK
 
+#include "modularity/ioc.h"
+#include "diagnostics/idiagnosticsmetricsregister.h"
+
 #include "inotationundostack.h"
 #include "igetscore.h"
 
@@ -36,6 +39,8 @@ class EditData;
 namespace mu::notation {
 class NotationUndoStack : public INotationUndoStack
 {
+    INJECT(muse::diagnostics::IDiagnosticsMetricsRegister, metricsRegister)
+
 public:
     NotationUndoStack(IGetScore* getScore, muse::async::Notification notationChanged);
 
@@ -66,6 +71,8 @@ private:
     void notifyAboutUndo();
     void notifyAboutRedo();
 
+    void registerHistoryMetrics();
+
     mu::engraving::Score* score() const;
     mu::engraving::MasterScore* masterScore() const;
     mu::engraving::UndoStack* undoStack() const;
@@ -137,6 +137,9 @@ public:
     MOCK_METHOD(void, setIsLimitCanvasScrollArea, (bool), (override));
     MOCK_METHOD(muse::async::Notification, isLimitCanvasScrollAreaChanged, (), (const, override));
 
+    MOCK_METHOD(bool, isCanvasTileCacheEnabled, (), (const, override));
+    MOCK_METHOD(void, setIsCanvasTileCacheEnabled, (bool), (override));
+
     MOCK_METHOD(bool, colorNotesOutsideOfUsablePitchRange, (), (const, override));
     MOCK_METHOD(void, setColorNotesOutsideOfUsablePitchRange, (bool), (override));
 
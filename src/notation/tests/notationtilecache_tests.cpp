@@ -0,0 +1,177 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+
+#include <QImage>
+
+#include "notation/view/notationtilecache.h"
+
+using namespace mu;
+using namespace mu::notation;
+using namespace muse;
+using namespace muse::draw;
+
+class NotationTileCacheTests : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        m_target = QImage(VIEW_WIDTH, VIEW_HEIGHT, QImage::Format_ARGB32_Premultiplied);
+        m_target.fill(Qt::transparent);
+
+        m_paintFunc = [this](Painter* painter, const RectF& logicalRect) {
+            ++m_paintCount;
+            painter->fillRect(logicalRect.intersected(PAINTED_RECT), Color::BLACK);
+        };
+
+        m_signatureFunc = [this](const RectF&) {
+            return m_signature;
+        };
+    }
+
+    void paint(NotationTileCache& cache, const Transform& matrix)
+    {
+        Painter painter(&m_target, "test");
+        cache.paint(&painter, RectF(0, 0, VIEW_WIDTH, VIEW_HEIGHT), matrix, 1.0, m_paintFunc, m_signatureFunc);
+    }
+
+    static Transform matrix(double dx, double dy, double scale)
+    {
+        Transform matrix;
+        matrix.translate(dx, dy);
+        matrix.scale(scale, scale);
+        return matrix;
+    }
+
+    static constexpr int VIEW_WIDTH = 1024;
+    static constexpr int VIEW_HEIGHT = 768;
+    const RectF PAINTED_RECT = RectF(100, 100, 50, 50);
+
+    QImage m_target;
+    std::atomic<int> m_paintCount = 0;
+    size_t m_signature = 1;
+
+    NotationTileCache::PaintFunc m_paintFunc;
+    NotationTileCache::SignatureFunc m_signatureFunc;
+};
+
+TEST_F(NotationTileCacheTests, PaintAndComposite)
+{
+    //! GIVEN An empty cache and a view showing the logical point (0, 0) at (10, 20), zoomed 2x
+    NotationTileCache cache;
+
+    //! DO Paint the view
+    paint(cache, matrix(10, 20, 2));
+
+    //! CHECK All the visible tiles are painted: 5 columns x 4 rows
+    EXPECT_EQ(m_paintCount.load(), 20);
+    EXPECT_EQ(cache.tileCount(), 20);
+    EXPECT_EQ(cache.stats().tileMisses, 20);
+    EXPECT_EQ(cache.stats().tileHits, 0);
+
+    //! CHECK The tiles are composited at the right place
+    EXPECT_EQ(m_target.pixelColor(260, 270), QColor(Qt::black));
+    EXPECT_EQ(m_target.pixelColor(150, 150).alpha(), 0);
+    EXPECT_EQ(m_target.pixelColor(330, 270).alpha(), 0);
+
+    //! DO Paint the same view again
+    m_paintCount = 0;
+    paint(cache, matrix(10, 20, 2));
+
+    //! CHECK Nothing is painted, all the tiles are reused
+    EXPECT_EQ(m_paintCount.load(), 0);
+    EXPECT_EQ(cache.stats().tileHits, 20);
+    EXPECT_DOUBLE_EQ(cache.stats().hitRate(), 0.5);
+}
+
+TEST_F(NotationTileCacheTests, Scroll)
+{
+    //! GIVEN A painted view
+    NotationTileCache cache;
+    paint(cache, matrix(10, 20, 2));
+
+    //! DO Scroll by one tile to the right
+    m_paintCount = 0;
+    paint(cache, matrix(10 - NotationTileCache::TILE_SIZE, 20, 2));
+
+    //! CHECK Only the newly exposed column is painted
+    EXPECT_EQ(m_paintCount.load(), 4);
+
+    //! DO Zoom
+    m_paintCount = 0;
+    paint(cache, matrix(10, 20, 3));
+
+    //! CHECK Everything is painted again at the new zoom
+    EXPECT_EQ(m_paintCount.load(), 20);
+    EXPECT_EQ(cache.tileCount(), 20);
+}
+
+TEST_F(NotationTileCacheTests, Invalidate)
+{
+    //! GIVEN A painted view
+    NotationTileCache cache;
+    paint(cache, matrix(10, 20, 2));
+
+    //! DO Invalidate a small logical rect inside of a tile, which covers the logical rect (0, 0, 128, 128)
+    cache.invalidate(RectF(10, 10, 5, 5));
+    m_paintCount = 0;
+    paint(cache, matrix(10, 20, 2));
+
+    //! CHECK Only that tile is painted again
+    EXPECT_EQ(m_paintCount.load(), 1);
+
+    //! DO Invalidate the tiles which signature is unchanged
+    cache.invalidateChanged(m_signatureFunc);
+
+    //! CHECK Nothing is dropped
+    EXPECT_EQ(cache.tileCount(), 20);
+
+    //! DO Change the signature of the painted content
+    m_signature = 2;
+    cache.invalidateChanged(m_signatureFunc);
+
+    //! CHECK All the tiles are dropped
+    EXPECT_EQ(cache.tileCount(), 0);
+}
+
+TEST_F(NotationTileCacheTests, MaxBytes)
+{
+    //! GIVEN A cache that may hold only 4 tiles
+    NotationTileCache cache;
+    cache.setMaxBytes(4 * NotationTileCache::TILE_SIZE * NotationTileCache::TILE_SIZE * 4);
+
+    //! DO Paint the view
+    paint(cache, matrix(10, 20, 2));
+
+    //! CHECK The visible tiles are kept anyway
+    EXPECT_EQ(cache.tileCount(), 20);
+
+    //! DO Scroll far away
+    paint(cache, matrix(10 - 10 * NotationTileCache::TILE_SIZE, 20, 2));
+
+    //! CHECK Only the visible tiles are kept
+    EXPECT_EQ(cache.tileCount(), 20);
+    EXPECT_EQ(cache.bytes(), size_t(20 * NotationTileCache::TILE_SIZE * NotationTileCache::TILE_SIZE * 4));
+}
@@ -25,6 +25,11 @@
 
 #include "actions/actiontypes.h"
 
+#include "engraving/dom/page.h"
+#include "engraving/dom/system.h"
+
+#include "hashutils.h"
+
 #include "log.h"
 
 using namespace mu;
@@ -94,6 +99,17 @@ void AbstractNotationPaintView::load()
         dispatcher()->reg(this, "diagnostic-notationview-redraw", [this]() {
             scheduleRedraw();
         });
+
+        dispatcher()->reg(this, "diagnostic-notationview-tilecache-stats", [this]() {
+            const NotationTileCache::Stats& stats = m_tileCache.stats();
+            LOGI() << "frames: " << stats.frames
+                   << ", tile hit rate: " << stats.hitRate()
+                   << ", last frame: " << stats.lastFrameMs << " ms"
+                   << ", average frame: " << stats.averageFrameMs() << " ms"
+                   << ", tiles: " << m_tileCache.tileCount()
+                   << ", bytes: " << m_tileCache.bytes();
+            m_tileCache.resetStats();
+        });
     }
 
     m_inputController->setReadonly(m_readonly);
@@ -202,7 +218,7 @@ void AbstractNotationPaintView::selectOnNavigationActive()
 
 bool AbstractNotationPaintView::canReceiveAction(const ActionCode& actionCode) const
 {
-    if (actionCode == "diagnostic-notationview-redraw") {
+    if (actionCode == "diagnostic-notationview-redraw" || actionCode == "diagnostic-notationview-tilecache-stats") {
         return true;
     }
 
@@ -241,9 +257,17 @@ void AbstractNotationPaintView::onLoadNotation(INotationPtr)
 
     INotationInteractionPtr interaction = notationInteraction();
 
+    m_tileCache.clear();
+    m_changesRangeReceived = false;
+
+    m_notation->undoStack()->changesChannel().onReceive(this, [this](const ChangesRange& range) {
+        invalidateTiles(range);
+    });
+
     m_notation->notationChanged().onNotify(this, [this, interaction]() {
         interaction->hideShadowNote();
         m_shadowNoteRect = RectF();
+        onNotationChangedForTiles();
         scheduleRedraw();
     });
 
@@ -253,9 +277,14 @@ void AbstractNotationPaintView::onLoadNotation(INotationPtr)
     });
 
     interaction->selectionChanged().onNotify(this, [this]() {
+        m_tileCache.invalidateChanged([this](const RectF& rect) { return tileSignature(rect); });
         scheduleRedraw();
     });
 
+    interaction->scoreConfigChanged().onReceive(this, [this](ScoreConfigType) {
+        m_tileCache.clear();
+    });
+
     interaction->showItemRequested().onReceive(this, [this](const INotationInteraction::ShowItemRequest& request) {
         onShowItemRequested(request);
     });
@@ -273,6 +302,8 @@ void AbstractNotationPaintView::onLoadNotation(INotationPtr)
     });
 
     interaction->dropChanged().onNotify(this, [this]() {
+        m_tileCache.invalidateChanged([this](const RectF& rect) { return tileSignature(rect); });
+
         if (!hasActiveFocus()) {
             forceFocusIn(); // grab keyboard focus after element added from palette
         }
@@ -284,6 +315,7 @@ void AbstractNotationPaintView::onLoadNotation(INotationPtr)
     });
 
     m_notation->viewModeChanged().onNotify(this, [this]() {
+        m_tileCache.clear();
         updateLoopMarkers();
         ensureViewportInsideScrollableArea();
     });
@@ -322,9 +354,11 @@ void AbstractNotationPaintView::onLoadNotation(INotationPtr)
 void AbstractNotationPaintView::onUnloadNotation(INotationPtr)
 {
     m_notation->notationChanged().resetOnNotify(this);
+    m_notation->undoStack()->changesChannel().resetOnReceive(this);
     INotationInteractionPtr interaction = m_notation->interaction();
     interaction->noteInput()->stateChanged().resetOnNotify(this);
     interaction->selectionChanged().resetOnNotify(this);
+    interaction->scoreConfigChanged().resetOnReceive(this);
 
     if (isMainView()) {
         m_notation->accessibility()->setMapToScreenFunc(nullptr);
@@ -597,7 +631,12 @@ void AbstractNotationPaintView::paint(QPainter* qp)
     painter->setWorldTransform(m_matrix * guiScalingCompensation);
 
     bool isPrinting = publishMode() || m_inputController->readonly();
-    notation()->painting()->paintView(painter, toLogical(rect), isPrinting);
+
+    if (isTileCacheUsable()) {
+        paintTiles(painter, rect, m_matrix * guiScalingCompensation, qp->device()->devicePixelRatio(), isPrinting);
+    } else {
+        notation()->painting()->paintView(painter, toLogical(rect), isPrinting);
+    }
 
     m_noteInputCursor->paint(painter);
     m_loopInMarker->paint(painter);
@@ -632,14 +671,37 @@ void AbstractNotationPaintView::onNotationSetup()
     });
 
     configuration()->foregroundChanged().onNotify(this, [this]() {
+        m_tileCache.clear();
         scheduleRedraw();
     });
 
     uiConfiguration()->currentThemeChanged().onNotify(this, [this]() {
+        m_tileCache.clear();
         scheduleRedraw();
     });
 
     engravingConfiguration()->debuggingOptionsChanged().onNotify(this, [this]() {
+        m_tileCache.clear();
+        scheduleRedraw();
+    });
+
+    engravingConfiguration()->scoreInversionChanged().onNotify(this, [this]() {
+        m_tileCache.clear();
+        scheduleRedraw();
+    });
+
+    engravingConfiguration()->selectionColorChanged().onReceive(this, [this](engraving::voice_idx_t, Color) {
+        m_tileCache.clear();
+        scheduleRedraw();
+    });
+
+    engravingConfiguration()->formattingColorChanged().onReceive(this, [this](Color) {
+        m_tileCache.clear();
+        scheduleRedraw();
+    });
+
+    engravingConfiguration()->unlinkedColorChanged().onReceive(this, [this](Color) {
+        m_tileCache.clear();
         scheduleRedraw();
     });
 }
@@ -657,6 +719,172 @@ void AbstractNotationPaintView::paintBackground(const RectF& rect, muse::draw::P
     }
 }
 
+bool AbstractNotationPaintView::isTileCacheUsable() const
+{
+    if (!configuration()->isCanvasTileCacheEnabled()) {
+        return false;
+    }
+
+    //! NOTE The edited or dragged elements change without commands, so they are painted directly
+    INotationInteractionPtr interaction = notationInteraction();
+    return !interaction->isDragStarted()
+           && !interaction->isTextEditingStarted()
+           && !interaction->isGripEditStarted()
+           && !interaction->isElementEditStarted();
+}
+
+void AbstractNotationPaintView::paintTiles(Painter* painter, const RectF& rect, const Transform& matrix, qreal devicePixelRatio,
+                                           bool isPrinting)
+{
+    TRACEFUNC;
+
+    if (m_tileCacheIsPrinting != isPrinting) {
+        m_tileCache.clear();
+        m_tileCacheIsPrinting = isPrinting;
+    }
+
+    INotationPaintingPtr painting = notation()->painting();
+
+    auto paintFunc = [&painting, isPrinting](Painter* tilePainter, const RectF& logicalRect) {
+        painting->paintViewScore(tilePainter, logicalRect, isPrinting);
+    };
+
+    auto signatureFunc = [this](const RectF& logicalRect) {
+        return tileSignature(logicalRect);
+    };
+
+    m_tileCache.paint(painter, rect, matrix, devicePixelRatio, paintFunc, signatureFunc);
+
+    painter->setWorldTransform(matrix);
+
+    if (!isPrinting) {
+        painting->paintViewInteraction(painter);
+    }
+}
+
+//! NOTE Describes the items painted in the rect with their bounding boxes and the states they are painted with,
+//! so that the tiles which items moved, appeared or disappeared are repainted
+size_t AbstractNotationPaintView::tileSignature(const RectF& logicalRect) const
+{
+    size_t signature = 0;
+
+    INotationElementsPtr elements = notationElements();
+    if (!elements) {
+        return signature;
+    }
+
+    std::hash<double> doubleHash;
+
+    for (const Page* page : elements->pages()) {
+        const RectF pageRect = page->canvasBoundingRect();
+        if (!pageRect.intersects(logicalRect)) {
+            continue;
+        }
+
+        hashCombine(signature, std::hash<const void*>()(page));
+
+        for (const EngravingItem* item : const_cast<Page*>(page)->items(logicalRect.translated(-page->pos()))) {
+            const RectF bbox = item->canvasBoundingRect();
+
+            hashCombine(signature, std::hash<const void*>()(item));
+            hashCombine(signature, doubleHash(bbox.x()));
+            hashCombine(signature, doubleHash(bbox.y()));
+            hashCombine(signature, doubleHash(bbox.width()));
+            hashCombine(signature, doubleHash(bbox.height()));
+            hashCombine(signature, (item->selected() ? 1 : 0) | (item->dropTarget() ? 2 : 0) | (item->visible() ? 4 : 0));
+        }
+    }
+
+    return signature;
+}
+
+void AbstractNotationPaintView::invalidateTiles(const ChangesRange& range)
+{
+    TRACEFUNC;
+
+    m_changesRangeReceived = true;
+
+    if (range.tickFrom == -1 || range.tickTo == -1 || !range.changedStyleIdSet.empty()) {
+        m_tileCache.clear();
+        return;
+    }
+
+    INotationElementsPtr elements = notationElements();
+    if (!elements) {
+        return;
+    }
+
+    std::vector<const System*> systems;
+    for (const Page* page : elements->pages()) {
+        systems.insert(systems.end(), page->systems().begin(), page->systems().end());
+    }
+
+    //! NOTE Spanners may continue on the neighbouring systems (ex. slurs and ties), so they are repainted too
+    std::vector<bool> changed(systems.size(), false);
+    for (size_t i = 0; i < systems.size(); ++i) {
+        const System* system = systems.at(i);
+        if (system->measures().empty()) {
+            continue;
+        }
+
+        if (system->measures().front()->tick().ticks() > range.tickTo || system->endTick().ticks() < range.tickFrom) {
+            continue;
+        }
+
+        changed[i] = true;
+        if (i > 0) {
+            changed[i - 1] = true;
+        }
+        if (i + 1 < systems.size()) {
+            changed[i + 1] = true;
+        }
+    }
+
+    //! NOTE Items can stick out of the system, so the whole space up to the neighbouring systems is repainted
+    for (size_t i = 0; i < systems.size(); ++i) {
+        if (!changed.at(i)) {
+            continue;
+        }
+
+        const System* system = systems.at(i);
+        const Page* page = system->page();
+        if (!page) {
+            continue;
+        }
+
+        const RectF pageRect = page->canvasBoundingRect();
+        double top = pageRect.top();
+        double bottom = pageRect.bottom();
+
+        if (i > 0 && systems.at(i - 1)->page() == page) {
+            top = systems.at(i - 1)->canvasBoundingRect().bottom();
+        }
+
+        if (i + 1 < systems.size() && systems.at(i + 1)->page() == page) {
+            bottom = systems.at(i + 1)->canvasBoundingRect().top();
+        }
+
+        if (bottom <= top) {
+            top = pageRect.top();
+            bottom = pageRect.bottom();
+        }
+
+        m_tileCache.invalidate(RectF(pageRect.left(), top, pageRect.width(), bottom - top));
+    }
+}
+
+void AbstractNotationPaintView::onNotationChangedForTiles()
+{
+    //! NOTE Without the changed range of a command, it is unknown what was changed
+    if (m_changesRangeReceived) {
+        m_tileCache.invalidateChanged([this](const RectF& rect) { return tileSignature(rect); });
+    } else {
+        m_tileCache.clear();
+    }
+
+    m_changesRangeReceived = false;
+}
+
 PointF AbstractNotationPaintView::canvasCenter() const
 {
     TRACEFUNC;
@@ -46,6 +46,7 @@
 #include "loopmarker.h"
 #include "continuouspanel.h"
 #include "abstractelementpopupmodel.h"
+#include "notationtilecache.h"
 
 namespace mu::notation {
 class AbstractNotationPaintView : public muse::uicomponents::QuickPaintedView, public IControlledView, public muse::Injectable,
@@ -252,6 +253,13 @@ private:
 
     void paintBackground(const muse::RectF& rect, muse::draw::Painter* painter);
 
+    bool isTileCacheUsable() const;
+    void paintTiles(muse::draw::Painter* painter, const muse::RectF& rect, const muse::draw::Transform& matrix, qreal devicePixelRatio,
+                    bool isPrinting);
+    size_t tileSignature(const muse::RectF& logicalRect) const;
+    void invalidateTiles(const ChangesRange& range);
+    void onNotationChangedForTiles();
+
     muse::PointF canvasCenter() const;
     std::pair<qreal, qreal> constraintCanvas(qreal dx, qreal dy) const;
 
@@ -265,6 +273,10 @@ private:
     std::unique_ptr<LoopMarker> m_loopOutMarker;
     std::unique_ptr<ContinuousPanel> m_continuousPanel;
 
+    NotationTileCache m_tileCache;
+    bool m_tileCacheIsPrinting = false;
+    bool m_changesRangeReceived = false;
+
     qreal m_previousVerticalScrollPosition = 0;
     qreal m_previousHorizontalScrollPosition = 0;
 
@@ -0,0 +1,260 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "notationtilecache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <vector>
+
+#include <QImage>
+
+#include "realfn.h"
+
+#include "log.h"
+
+using namespace mu::notation;
+using namespace muse;
+using namespace muse::draw;
+
+double NotationTileCache::Stats::hitRate() const
+{
+    const uint64_t total = tileHits + tileMisses;
+    return total > 0 ? static_cast<double>(tileHits) / static_cast<double>(total) : 0.0;
+}
+
+double NotationTileCache::Stats::averageFrameMs() const
+{
+    return frames > 0 ? totalFrameMs / static_cast<double>(frames) : 0.0;
+}
+
+void NotationTileCache::setMaxBytes(size_t bytes)
+{
+    m_maxBytes = bytes;
+    evict();
+}
+
+void NotationTileCache::paint(Painter* painter, const RectF& viewRect, const Transform& matrix, double devicePixelRatio,
+                              const PaintFunc& paintFunc, const SignatureFunc& signatureFunc)
+{
+    TRACEFUNC;
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    if (!RealIsEqual(matrix.m11(), m_scale) || !RealIsEqual(devicePixelRatio, m_devicePixelRatio)) {
+        clear();
+        m_scale = matrix.m11();
+        m_devicePixelRatio = devicePixelRatio;
+    }
+
+    if (m_scale <= 0.0 || m_devicePixelRatio <= 0.0 || !viewRect.isValid()) {
+        return;
+    }
+
+    //! NOTE Whole view pixels, so that the tiles are not resampled
+    const double dx = std::round(matrix.dx());
+    const double dy = std::round(matrix.dy());
+
+    const int firstColumn = static_cast<int>(std::floor((viewRect.left() - dx) / TILE_SIZE));
+    const int lastColumn = static_cast<int>(std::ceil((viewRect.right() - dx) / TILE_SIZE)) - 1;
+    const int firstRow = static_cast<int>(std::floor((viewRect.top() - dy) / TILE_SIZE));
+    const int lastRow = static_cast<int>(std::ceil((viewRect.bottom() - dy) / TILE_SIZE)) - 1;
+
+    ++m_frame;
+    ++m_stats.frames;
+
+    std::vector<TileKey> visibleTiles;
+    std::vector<TileKey> missingTiles;
+
+    for (int row = firstRow; row <= lastRow; ++row) {
+        for (int column = firstColumn; column <= lastColumn; ++column) {
+            const TileKey key = tileKey(column, row);
+            visibleTiles.push_back(key);
+
+            auto it = m_tiles.find(key);
+            if (it != m_tiles.end()) {
+                it->second.lastUsedFrame = m_frame;
+                ++m_stats.tileHits;
+                continue;
+            }
+
+            ++m_stats.tileMisses;
+            missingTiles.push_back(key);
+        }
+    }
+
+    const int pixelSize = static_cast<int>(std::lrint(TILE_SIZE * m_devicePixelRatio));
+
+    for (TileKey key : missingTiles) {
+        const RectF logicalRect = tileLogicalRect(tileColumn(key), tileRow(key));
+
+        QImage image(pixelSize, pixelSize, QImage::Format_ARGB32_Premultiplied);
+        image.setDevicePixelRatio(m_devicePixelRatio);
+        image.fill(Qt::transparent);
+
+        {
+            Painter tilePainter(&image, "notationtile");
+
+            Transform transform;
+            transform.translate(-tileColumn(key) * TILE_SIZE, -tileRow(key) * TILE_SIZE);
+            transform.scale(m_scale, m_scale);
+            tilePainter.setWorldTransform(transform);
+
+            paintFunc(&tilePainter, logicalRect);
+        }
+
+        Tile& tile = m_tiles[key];
+        tile.pixmap = QPixmap::fromImage(std::move(image));
+        tile.signature = signatureFunc ? signatureFunc(logicalRect) : 0;
+        tile.lastUsedFrame = m_frame;
+    }
+
+    painter->save();
+    painter->setWorldTransform(Transform());
+
+    for (TileKey key : visibleTiles) {
+        const Tile& tile = m_tiles.at(key);
+        painter->drawPixmap(PointF(tileColumn(key) * TILE_SIZE + dx, tileRow(key) * TILE_SIZE + dy), tile.pixmap);
+    }
+
+    painter->restore();
+
+    evict();
+
+    const std::chrono::duration<double, std::milli> frameTime = std::chrono::steady_clock::now() - startTime;
+    m_stats.lastFrameMs = frameTime.count();
+    m_stats.totalFrameMs += frameTime.count();
+}
+
+void NotationTileCache::invalidate(const RectF& logicalRect)
+{
+    if (m_tiles.empty() || !logicalRect.isValid()) {
+        return;
+    }
+
+    //! NOTE The antialiased edges may cross the bounding box by a pixel
+    const double margin = 2.0 / m_scale;
+    const RectF rect = logicalRect.adjusted(-margin, -margin, margin, margin);
+
+    for (auto it = m_tiles.begin(); it != m_tiles.end();) {
+        if (tileLogicalRect(tileColumn(it->first), tileRow(it->first)).intersects(rect)) {
+            it = m_tiles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void NotationTileCache::invalidateChanged(const SignatureFunc& signatureFunc)
+{
+    TRACEFUNC;
+
+    for (auto it = m_tiles.begin(); it != m_tiles.end();) {
+        if (signatureFunc(tileLogicalRect(tileColumn(it->first), tileRow(it->first))) != it->second.signature) {
+            it = m_tiles.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void NotationTileCache::clear()
+{
+    m_tiles.clear();
+}
+
+size_t NotationTileCache::tileCount() const
+{
+    return m_tiles.size();
+}
+
+size_t NotationTileCache::bytes() const
+{
+    return m_tiles.size() * tileBytes();
+}
+
+const NotationTileCache::Stats& NotationTileCache::stats() const
+{
+    return m_stats;
+}
+
+void NotationTileCache::resetStats()
+{
+    m_stats = Stats();
+}
+
+NotationTileCache::TileKey NotationTileCache::tileKey(int column, int row)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(column)) << 32) | static_cast<uint32_t>(row);
+}
+
+int NotationTileCache::tileColumn(TileKey key)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(key >> 32));
+}
+
+int NotationTileCache::tileRow(TileKey key)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(key));
+}
+
+RectF NotationTileCache::tileLogicalRect(int column, int row) const
+{
+    const double size = TILE_SIZE / m_scale;
+    return RectF(column * size, row * size, size, size);
+}
+
+size_t NotationTileCache::tileBytes() const
+{
+    const size_t pixelSize = static_cast<size_t>(std::lrint(TILE_SIZE * m_devicePixelRatio));
+    return pixelSize * pixelSize * 4;
+}
+
+void NotationTileCache::evict()
+{
+    const size_t bytesPerTile = tileBytes();
+    if (bytesPerTile == 0) {
+        return;
+    }
+
+    const size_t maxTiles = m_maxBytes / bytesPerTile;
+    if (m_tiles.size() <= maxTiles) {
+        return;
+    }
+
+    std::vector<std::pair<uint64_t, TileKey> > tilesByAge;
+    tilesByAge.reserve(m_tiles.size());
+    for (const auto& [key, tile] : m_tiles) {
+        tilesByAge.emplace_back(tile.lastUsedFrame, key);
+    }
+
+    std::sort(tilesByAge.begin(), tilesByAge.end());
+
+    //! NOTE The tiles of the current frame are kept, even over the budget
+    for (const auto& [lastUsedFrame, key] : tilesByAge) {
+        if (m_tiles.size() <= maxTiles || lastUsedFrame == m_frame) {
+            break;
+        }
+
+        m_tiles.erase(key);
+    }
+}
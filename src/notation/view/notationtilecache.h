@@ -0,0 +1,110 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-Studio-CLA-applies
+ *
+ * MuseScore Studio
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2024 MuseScore Limited
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MU_NOTATION_NOTATIONTILECACHE_H
+#define MU_NOTATION_NOTATIONTILECACHE_H
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+
+#include <QPixmap>
+
+#include "draw/painter.h"
+#include "draw/types/geometry.h"
+#include "draw/types/transform.h"
+
+namespace mu::notation {
+//! NOTE Keeps the painted score as square tiles of the view at the current zoom,
+//! so that scrolling only composites the cached tiles and paints the newly exposed ones.
+//! The tiles are aligned to the canvas, not to the viewport, and are dropped when the zoom changes.
+class NotationTileCache
+{
+public:
+    //! NOTE Tile side, in view pixels
+    static constexpr int TILE_SIZE = 256;
+    static constexpr size_t DEFAULT_MAX_BYTES = 128 * 1024 * 1024;
+
+    struct Stats {
+        uint64_t frames = 0;
+        uint64_t tileHits = 0;
+        uint64_t tileMisses = 0;
+        double lastFrameMs = 0.0;
+        double totalFrameMs = 0.0;
+
+        double hitRate() const;
+        double averageFrameMs() const;
+    };
+
+    //! NOTE Paints the score for the given logical rect
+    using PaintFunc = std::function<void (muse::draw::Painter* painter, const muse::RectF& logicalRect)>;
+
+    //! NOTE Describes what is painted in the given logical rect (ex. the items and their bounding boxes),
+    //! a tile is repainted when its signature changes
+    using SignatureFunc = std::function<size_t (const muse::RectF& logicalRect)>;
+
+    void setMaxBytes(size_t bytes);
+
+    //! NOTE The matrix maps the logical coordinates to the view and may only scale and translate.
+    //! The missing tiles are painted by paintFunc one by one, on the calling thread:
+    //! drawing the score writes to the items (lazy z order, image buffers) and to the draw globals
+    void paint(muse::draw::Painter* painter, const muse::RectF& viewRect, const muse::draw::Transform& matrix, double devicePixelRatio,
+               const PaintFunc& paintFunc, const SignatureFunc& signatureFunc);
+
+    void invalidate(const muse::RectF& logicalRect);
+    void invalidateChanged(const SignatureFunc& signatureFunc);
+    void clear();
+
+    size_t tileCount() const;
+    size_t bytes() const;
+
+    const Stats& stats() const;
+    void resetStats();
+
+private:
+    struct Tile {
+        QPixmap pixmap;
+        size_t signature = 0;
+        uint64_t lastUsedFrame = 0;
+    };
+
+    using TileKey = uint64_t;
+
+    static TileKey tileKey(int column, int row);
+    static int tileColumn(TileKey key);
+    static int tileRow(TileKey key);
+
+    muse::RectF tileLogicalRect(int column, int row) const;
+    size_t tileBytes() const;
+    void evict();
+
+    std::unordered_map<TileKey, Tile> m_tiles;
+
+    double m_scale = 0.0;
+    double m_devicePixelRatio = 0.0;
+    size_t m_maxBytes = DEFAULT_MAX_BYTES;
+    uint64_t m_frame = 0;
+
+    Stats m_stats;
+};
+}
+
+#endif // MU_NOTATION_NOTATIONTILECACHE_H
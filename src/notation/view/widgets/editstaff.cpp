@@ -313,10 +313,13 @@ void EditStaff::bboxClicked(QAbstractButton* button)
 
 void EditStaff::apply()
 {
-    size_t index = m_staff->score()->undoStack()->getCurIdx();
+    mu::engraving::UndoStack* undoStack = m_staff->score()->undoStack();
+    size_t index = undoStack->getCurIdx();
+    undoStack->lockCompaction();
     applyStaffProperties();
     applyPartProperties();
-    m_staff->score()->undoStack()->mergeCommands(index);
+    undoStack->mergeCommands(index);
+    undoStack->unlockCompaction();
 }
 
 void EditStaff::minPitchAClicked()
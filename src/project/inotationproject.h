@@ -70,6 +70,10 @@ public:
     virtual void setNeedAutoSave(bool val) = 0;
 
     virtual muse::Ret save(const muse::io::path_t& path = muse::io::path_t(), SaveMode saveMode = SaveMode::Save) = 0;
+
+    //! NOTE Writes the project to XML in memory on the calling thread, which is blocked for that time,
+    //! the returned task only compresses the written files and saves them to the path
+    virtual muse::RetVal<AutoSaveTask> makeAutoSaveTask(const muse::io::path_t& path) = 0;
     virtual muse::Ret writeToDevice(QIODevice* device) = 0;
 
     virtual ProjectMeta metaInfo() const = 0;
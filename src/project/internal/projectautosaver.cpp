@@ -23,6 +23,7 @@
 
 #include "engraving/infrastructure/mscio.h"
 
+#include "global/concurrency/concurrent.h"
 #include "defer.h"
 #include "log.h"
 
@@ -57,6 +58,10 @@ void ProjectAutoSaver::init()
 
     update();
 
+    m_saveFinished.onReceive(this, [this](const Ret& ret) {
+        onSaveFinished(ret);
+    });
+
     globalContext()->currentProjectChanged().onNotify(this, [this]() {
         if (auto project = currentProject()) {
             if (project->isNewlyCreated() && !project->isImported()) {
@@ -151,6 +156,11 @@ void ProjectAutoSaver::onTrySave()
         }
     };
 
+    if (m_savingProject) {
+        LOGD() << "[autosave] previous save is in progress";
+        return;
+    }
+
     INotationProjectPtr project = globalContext()->currentProject();
     if (!project) {
         LOGD() << "[autosave] no project";
@@ -170,15 +180,69 @@ void ProjectAutoSaver::onTrySave()
     muse::io::path_t projectPath = this->projectPath(project);
     muse::io::path_t savePath = project->isNewlyCreated() ? projectPath : projectAutoSavePath(projectPath);
 
-    Ret ret = project->save(savePath, SaveMode::AutoSave);
+    //! NOTE The snapshot is taken on the main thread, so the editor is blocked while the score is written to XML.
+    //! Only the compressing and the writing to the disk are done on a worker thread, see NotationProject::makeAutoSaveTask.
+    //! The freeze is reported as "Autosave: main thread freeze" to compare it on real scores
+    const auto startTime = std::chrono::steady_clock::now();
+
+    RetVal<AutoSaveTask> task = project->makeAutoSaveTask(savePath);
+    if (!task.ret) {
+        if (task.ret.code() == static_cast<int>(Ret::Code::Cancel)) {
+            LOGD() << "[autosave] project is being edited";
+        } else {
+            LOGE() << "[autosave] failed to write project, err: " << task.ret.toString();
+        }
+        return;
+    }
+
+    //! NOTE The changes made while the written files are saved need a new autosave
+    project->setNeedAutoSave(false);
+
+    const std::chrono::duration<double, std::milli> freezeTime = std::chrono::steady_clock::now() - startTime;
+
+    m_savingProject = project;
+    m_savingProjectPath = projectPath;
+    m_saveStartTime = startTime;
+    m_saveFreezeMs = freezeTime.count();
+
+    if (metricsRegister()) {
+        metricsRegister()->reg("Autosave: main thread freeze", m_saveFreezeMs, "ms");
+    }
+
+    Concurrent::run([writeTask = task.val, saveFinished = m_saveFinished]() mutable {
+        saveFinished.send(writeTask());
+    });
+}
+
+void ProjectAutoSaver::onSaveFinished(const Ret& ret)
+{
+    TRACEFUNC;
+
+    INotationProjectPtr project = std::move(m_savingProject);
+    m_savingProject = nullptr;
+
     if (!ret) {
         LOGE() << "[autosave] failed to save project, err: " << ret.toString();
+
+        if (project == currentProject() && project->needSave().val) {
+            project->setNeedAutoSave(true);
+        }
         return;
     }
 
-    project->setNeedAutoSave(false);
+    //! NOTE The project was saved or closed while its written files were saved
+    if (m_lastProjectPathNeedingAutosave != m_savingProjectPath) {
+        removeProjectUnsavedChanges(m_savingProjectPath);
+    }
 
-    LOGD() << "[autosave] successfully saved project";
+    const std::chrono::duration<double, std::milli> saveTime = std::chrono::steady_clock::now() - m_saveStartTime;
+
+    LOGI() << "[autosave] successfully saved project in " << saveTime.count() << " ms, "
+           << "the editor was blocked for " << m_saveFreezeMs << " ms";
+
+    if (metricsRegister()) {
+        metricsRegister()->reg("Autosave: total", saveTime.count(), "ms");
+    }
 }
 
 muse::io::path_t ProjectAutoSaver::projectPath(INotationProjectPtr project) const
@@ -22,13 +22,17 @@
 #ifndef MU_PROJECT_PROJECTAUTOSAVER_H
 #define MU_PROJECT_PROJECTAUTOSAVER_H
 
+#include <chrono>
+
 #include <QTimer>
 
 #include "async/asyncable.h"
+#include "async/channel.h"
 
 #include "modularity/ioc.h"
 #include "context/iglobalcontext.h"
 #include "io/ifilesystem.h"
+#include "diagnostics/idiagnosticsmetricsregister.h"
 #include "iprojectconfiguration.h"
 
 #include "../iprojectautosaver.h"
@@ -39,6 +43,7 @@ class ProjectAutoSaver : public IProjectAutoSaver, public muse::async::Asyncable
     INJECT(context::IGlobalContext, globalContext)
     INJECT(muse::io::IFileSystem, fileSystem)
     INJECT(IProjectConfiguration, configuration)
+    INJECT(muse::diagnostics::IDiagnosticsMetricsRegister, metricsRegister)
 
 public:
     ProjectAutoSaver() = default;
@@ -59,11 +64,19 @@ private:
     void update();
 
     void onTrySave();
+    void onSaveFinished(const muse::Ret& ret);
 
     muse::io::path_t projectPath(INotationProjectPtr project) const;
 
     QTimer m_timer;
     muse::io::path_t m_lastProjectPathNeedingAutosave;
+
+    //! NOTE The project which written files are being compressed and saved on a worker thread
+    INotationProjectPtr m_savingProject;
+    muse::io::path_t m_savingProjectPath;
+    std::chrono::steady_clock::time_point m_saveStartTime;
+    double m_saveFreezeMs = 0.0;
+    muse::async::Channel<muse::Ret> m_saveFinished;
 };
 }
 
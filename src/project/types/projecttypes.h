@@ -22,6 +22,7 @@
 #ifndef MU_PROJECT_PROJECTTYPES_H
 #define MU_PROJECT_PROJECTTYPES_H
 
+#include <functional>
 #include <variant>
 
 #include <QString>
@@ -75,6 +76,9 @@ enum class SaveMode
     AutoSave
 };
 
+//! NOTE Writes the autosave snapshot of a project, may be run on a worker thread
+using AutoSaveTask = std::function<muse::Ret ()>;
+
 enum class SaveLocationType
 {
     Undefined,
@@ -350,6 +350,15 @@ muse::async::Notification NotationConfigurationStub::isLimitCanvasScrollAreaChan
     return n;
 }
 
+bool NotationConfigurationStub::isCanvasTileCacheEnabled() const
+{
+    return false;
+}
+
+void NotationConfigurationStub::setIsCanvasTileCacheEnabled(bool)
+{
+}
+
 bool NotationConfigurationStub::colorNotesOutsideOfUsablePitchRange() const
 {
     return false;
@@ -27,12 +27,14 @@ SCORES_DIR="$HERE/scores"
 OUTPUT_DIR="./vtest_pngs"
 MSCORE_BIN=build.debug/install/bin/mscore
 DPI=180
+JOBS=1
 
 while [[ "$#" -gt 0 ]]; do
     case $1 in
         -s|--scores) SCORES_DIR="$2"; shift ;;
         -o|--output-dir) OUTPUT_DIR="$2"; shift ;;
         -m|--mscore) MSCORE_BIN="$2"; shift ;;
+        -j|--jobs) JOBS="$2"; shift ;;
         *) echo "Unknown parameter passed: $1"; exit 1 ;;
     esac
     shift
@@ -43,6 +45,7 @@ echo "SCORES_DIR: $SCORES_DIR"
 echo "OUTPUT_DIR: $OUTPUT_DIR"
 echo "MSCORE_BIN: $MSCORE_BIN"
 echo "DPI: $DPI"
+echo "JOBS: $JOBS"
 echo "::endgroup::"
 
 rm -rf $OUTPUT_DIR
@@ -63,7 +66,7 @@ cat $JSON_FILE
 echo "::endgroup::"
 
 echo "::group::Generating PNG files"
-$MSCORE_BIN -j $JSON_FILE -r $DPI 2>&1 | tee $LOG_FILE && SUCCESS="true"
+$MSCORE_BIN -j $JSON_FILE -r $DPI --jobs $JOBS 2>&1 | tee $LOG_FILE && SUCCESS="true"
 echo "::endgroup::"
 
 if [ -z "$SUCCESS" ]; then
@@ -30,6 +30,8 @@ static const QString MSCORE_REF_BIN(VTEST_MSCORE_REF_BIN);
 static const QString MSCORE_BIN(VTEST_MSCORE_BIN);
 static const QString REF_DIR("./reference_pngs");
 static const QString CURRENT_DIR("./current_pngs");
+static const QString SEQUENTIAL_DIR("./sequential_pngs");
+static const QString PARALLEL_DIR("./parallel_pngs");
 
 class Engraving_VTest : public ::testing::Test
 {
@@ -79,3 +81,28 @@ TEST_F(Engraving_VTest, 2_GenerateCurrentAndCompare)
                           { "--gen-gif", "0"
                           }), 0);
 }
+
+TEST_F(Engraving_VTest, 3_ParallelJobsMatchSequential)
+{
+    // Generate with one job at a time
+    ASSERT_EQ(run_command("vtest-generate-pngs.sh",
+                          { "--mscore", MSCORE_BIN,
+                            "--output-dir", SEQUENTIAL_DIR,
+                            "--jobs", "1"
+                          }), 0);
+
+    // Generate with several workers
+    ASSERT_EQ(run_command("vtest-generate-pngs.sh",
+                          { "--mscore", MSCORE_BIN,
+                            "--output-dir", PARALLEL_DIR,
+                            "--jobs", "4"
+                          }), 0);
+
+    // Compare, the workers must get the same options (dpi...) as the sequential conversion
+    ASSERT_EQ(run_command("vtest-compare-pngs.sh",
+                          { "--current-dir", PARALLEL_DIR,
+                            "--reference-dir", SEQUENTIAL_DIR,
+                            "--output-dir", "./comparison_jobs",
+                            "--gen-gif", "0"
+                          }), 0);
+}